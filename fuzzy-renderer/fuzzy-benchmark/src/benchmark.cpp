@@ -0,0 +1,434 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <thread>
+
+namespace bench
+{
+	namespace
+	{
+		struct BenchmarkDefinition
+		{
+			std::string m_name = {};
+			BenchmarkFunction m_function = {};
+			std::vector<int64_t> m_ranges = {};
+		};
+
+		struct BenchmarkResult
+		{
+			std::string m_name = {};
+			uint64_t m_iterations = {};
+			uint32_t m_repetitions = {};
+			double m_real_time_ns = {};
+			double m_min_time_ns = {};
+			double m_max_time_ns = {};
+			double m_items_per_second = {};
+			double m_bytes_per_second = {};
+			std::string m_error = {};
+		};
+
+		constexpr auto MaxIterations = uint64_t{ 1'000'000'000 };
+
+		auto GetRegistry() -> std::vector<BenchmarkDefinition>&
+		{
+			// function local, the benchmarks register from static initializers of other translation units
+			static auto registry = std::vector<BenchmarkDefinition>{};
+			return registry;
+		}
+
+		auto AppendJsonEscaped(std::string& out, const std::string_view text) -> void
+		{
+			for (const auto character : text)
+			{
+				switch (character)
+				{
+				case '"': out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				default: out += character; break;
+				}
+			}
+		}
+
+		/**
+		 * \brief Grows the iterations count until a run lasts at least min_seconds, the estimate is taken from the last run.
+		 */
+		auto FindIterationsCount(const BenchmarkDefinition& definition, const int64_t range, const double min_seconds, std::string& out_error) -> uint64_t
+		{
+			auto iterations = uint64_t{ 1 };
+
+			while (true)
+			{
+				auto state = State{ range, iterations };
+				definition.m_function(state);
+
+				if (state.GetError())
+				{
+					out_error = state.GetError().value();
+					return 0;
+				}
+
+				const auto elapsed_seconds = state.GetElapsedSeconds();
+				if (elapsed_seconds >= min_seconds || iterations >= MaxIterations)
+				{
+					return iterations;
+				}
+
+				// overshoot a little so the next run is likely the last one, but never grow by more than 10x at once
+				const auto multiplier = elapsed_seconds > 0.0 ? std::clamp(min_seconds * 1.4 / elapsed_seconds, 2.0, 10.0) : 10.0;
+				iterations = std::min(static_cast<uint64_t>(std::ceil(static_cast<double>(iterations) * multiplier)), MaxIterations);
+			}
+		}
+
+		auto RunBenchmark(const BenchmarkDefinition& definition, const int64_t range, std::string name, const RunOptions& options) -> BenchmarkResult
+		{
+			auto result = BenchmarkResult{};
+			result.m_name = std::move(name);
+
+			const auto iterations = FindIterationsCount(definition, range, options.m_min_seconds, result.m_error);
+			if (!result.m_error.empty())
+			{
+				return result;
+			}
+
+			auto times_ns = std::vector<double>{};
+			auto items_per_second = 0.0;
+			auto bytes_per_second = 0.0;
+
+			for (auto repetition_idx = 0u; repetition_idx != std::max(options.m_repetitions, 1u); ++repetition_idx)
+			{
+				auto state = State{ range, iterations };
+				definition.m_function(state);
+
+				if (state.GetError())
+				{
+					result.m_error = state.GetError().value();
+					return result;
+				}
+
+				const auto elapsed_seconds = std::max(state.GetElapsedSeconds(), 1e-12);
+				times_ns.push_back(elapsed_seconds * 1e9 / static_cast<double>(iterations));
+				items_per_second = std::max(items_per_second, static_cast<double>(state.GetItemsPerIteration()) * static_cast<double>(iterations) / elapsed_seconds);
+				bytes_per_second = std::max(bytes_per_second, static_cast<double>(state.GetBytesPerIteration()) * static_cast<double>(iterations) / elapsed_seconds);
+			}
+
+			// the median is what gets compared, it shrugs off the odd repetition disturbed by the rest of the system
+			std::ranges::sort(times_ns);
+			result.m_iterations = iterations;
+			result.m_repetitions = static_cast<uint32_t>(times_ns.size());
+			result.m_real_time_ns = times_ns[times_ns.size() / 2];
+			result.m_min_time_ns = times_ns.front();
+			result.m_max_time_ns = times_ns.back();
+			result.m_items_per_second = items_per_second;
+			result.m_bytes_per_second = bytes_per_second;
+
+			return result;
+		}
+
+		auto FormatTime(const double nanoseconds) -> std::string
+		{
+			if (nanoseconds >= 1e6)
+			{
+				return std::format("{:.3f} ms", nanoseconds * 1e-6);
+			}
+			if (nanoseconds >= 1e3)
+			{
+				return std::format("{:.3f} us", nanoseconds * 1e-3);
+			}
+			return std::format("{:.1f} ns", nanoseconds);
+		}
+
+		auto FormatRate(const double per_second, const std::string_view unit) -> std::string
+		{
+			if (per_second >= 1e9)
+			{
+				return std::format("{:.2f} G{}/s", per_second * 1e-9, unit);
+			}
+			if (per_second >= 1e6)
+			{
+				return std::format("{:.2f} M{}/s", per_second * 1e-6, unit);
+			}
+			if (per_second >= 1e3)
+			{
+				return std::format("{:.2f} k{}/s", per_second * 1e-3, unit);
+			}
+			return std::format("{:.2f} {}/s", per_second, unit);
+		}
+
+		auto PrintResult(const BenchmarkResult& result) -> void
+		{
+			if (!result.m_error.empty())
+			{
+				std::cout << std::format("{:<48} ERROR: {}\n", result.m_name, result.m_error);
+				return;
+			}
+
+			auto line = std::format("{:<48} {:>12} {:>12} {:>12} {:>12}", result.m_name, FormatTime(result.m_real_time_ns), FormatTime(result.m_min_time_ns),
+				FormatTime(result.m_max_time_ns), result.m_iterations);
+
+			if (result.m_items_per_second > 0.0)
+			{
+				line += "  " + FormatRate(result.m_items_per_second, "items");
+			}
+			if (result.m_bytes_per_second > 0.0)
+			{
+				line += "  " + FormatRate(result.m_bytes_per_second, "B");
+			}
+
+			std::cout << line << "\n";
+		}
+
+		/**
+		 * \brief Same layout as Google Benchmark reports (context + benchmarks, times in ns), one benchmark per line so that reports diff well.
+		 */
+		auto WriteReport(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results) -> bool
+		{
+			auto file = std::ofstream{ path, std::ios::binary };
+			if (!file.is_open())
+			{
+				std::cerr << "unable to write benchmark report " << path << "\n";
+				return false;
+			}
+
+#ifdef NDEBUG
+			constexpr auto build_type = "release";
+#else
+			constexpr auto build_type = "debug";
+#endif
+
+			auto json = std::format("{{\n\"context\":{{\"date\":\"{:%Y-%m-%dT%H:%M:%S}\",\"num_cpus\":{},\"library_build_type\":\"{}\"}},\n\"benchmarks\":[",
+				std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()), std::thread::hardware_concurrency(), build_type);
+
+			for (auto result_idx = size_t{ 0 }; result_idx != results.size(); ++result_idx)
+			{
+				const auto& result = results[result_idx];
+
+				json += result_idx == 0 ? "\n{\"name\":\"" : ",\n{\"name\":\"";
+				AppendJsonEscaped(json, result.m_name);
+				json += std::format("\",\"iterations\":{},\"repetitions\":{},\"real_time\":{:.3f},\"min_time\":{:.3f},\"max_time\":{:.3f},\"time_unit\":\"ns\"",
+					result.m_iterations, result.m_repetitions, result.m_real_time_ns, result.m_min_time_ns, result.m_max_time_ns);
+
+				if (result.m_items_per_second > 0.0)
+				{
+					json += std::format(",\"items_per_second\":{:.1f}", result.m_items_per_second);
+				}
+				if (result.m_bytes_per_second > 0.0)
+				{
+					json += std::format(",\"bytes_per_second\":{:.1f}", result.m_bytes_per_second);
+				}
+				if (!result.m_error.empty())
+				{
+					json += ",\"error_occurred\":true,\"error_message\":\"";
+					AppendJsonEscaped(json, result.m_error);
+					json += "\"";
+				}
+
+				json += "}";
+			}
+
+			json += "\n]\n}\n";
+			file.write(json.data(), static_cast<std::streamsize>(json.size()));
+
+			return file.good();
+		}
+
+		/**
+		 * \brief Finds "key" after offset and returns where its value starts (past the colon and the blanks).
+		 */
+		auto FindJsonValue(const std::string& json, const std::string_view key, const size_t offset, const size_t limit) -> std::optional<size_t>
+		{
+			const auto key_position = json.find(std::format("\"{}\"", key), offset);
+			if (key_position == std::string::npos || key_position >= limit)
+			{
+				return std::nullopt;
+			}
+
+			auto value_position = json.find(':', key_position);
+			if (value_position == std::string::npos)
+			{
+				return std::nullopt;
+			}
+
+			value_position = json.find_first_not_of(" \t\r\n", value_position + 1);
+			return value_position != std::string::npos ? std::optional{ value_position } : std::nullopt;
+		}
+
+		/**
+		 * \brief Reads the name -> real_time pairs of a report written by WriteReport. Not a JSON parser, it relies on
+		 * "name" opening each benchmark object and on the names not containing quotes.
+		 */
+		auto ReadReport(const std::filesystem::path& path) -> std::optional<std::map<std::string, double>>
+		{
+			auto file = std::ifstream{ path, std::ios::binary };
+			if (!file.is_open())
+			{
+				std::cerr << "unable to open benchmark baseline " << path << "\n";
+				return std::nullopt;
+			}
+
+			const auto json = std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+
+			const auto benchmarks_position = json.find("\"benchmarks\"");
+			if (benchmarks_position == std::string::npos)
+			{
+				std::cerr << path.string() << ": no \"benchmarks\" array\n";
+				return std::nullopt;
+			}
+
+			auto times_ns = std::map<std::string, double>{};
+			auto offset = benchmarks_position;
+
+			while (const auto name_position = FindJsonValue(json, "name", offset, json.size()))
+			{
+				const auto name_end = json.find('"', name_position.value() + 1);
+				if (json[name_position.value()] != '"' || name_end == std::string::npos)
+				{
+					break;
+				}
+
+				const auto next_name_position = json.find("\"name\"", name_end);
+				const auto object_end = next_name_position != std::string::npos ? next_name_position : json.size();
+
+				if (const auto time_position = FindJsonValue(json, "real_time", name_end, object_end))
+				{
+					auto time_ns = 0.0;
+					if (std::from_chars(json.data() + time_position.value(), json.data() + json.size(), time_ns).ec == std::errc{})
+					{
+						times_ns[json.substr(name_position.value() + 1, name_end - name_position.value() - 1)] = time_ns;
+					}
+				}
+
+				offset = name_end;
+			}
+
+			return times_ns;
+		}
+
+		/**
+		 * \brief Prints current against baseline times.
+		 * \return how many benchmarks got slower than the threshold
+		 */
+		auto CompareToBaseline(const std::vector<BenchmarkResult>& results, const std::map<std::string, double>& baseline, const double threshold_percent) -> uint32_t
+		{
+			std::cout << std::format("\n{:<48} {:>12} {:>12} {:>9}\n", "Comparison", "Baseline", "Current", "Change");
+			std::cout << std::string(86, '-') << "\n";
+
+			auto regressions_count = 0u;
+
+			for (const auto& result : results)
+			{
+				if (!result.m_error.empty())
+				{
+					continue;
+				}
+
+				const auto it = baseline.find(result.m_name);
+				if (it == baseline.end())
+				{
+					std::cout << std::format("{:<48} {:>12} {:>12} {:>9}\n", result.m_name, "-", FormatTime(result.m_real_time_ns), "new");
+					continue;
+				}
+
+				const auto change_percent = it->second > 0.0 ? (result.m_real_time_ns - it->second) / it->second * 100.0 : 0.0;
+
+				auto verdict = std::string_view{};
+				if (change_percent > threshold_percent)
+				{
+					verdict = "  SLOWER";
+					regressions_count++;
+				}
+				else if (change_percent < -threshold_percent)
+				{
+					verdict = "  faster";
+				}
+
+				std::cout << std::format("{:<48} {:>12} {:>12} {:>+8.1f}%{}\n", result.m_name, FormatTime(it->second), FormatTime(result.m_real_time_ns), change_percent, verdict);
+			}
+
+			std::cout << std::format("\n{} regression(s) above {:.1f}%\n", regressions_count, threshold_percent);
+			return regressions_count;
+		}
+	}
+
+	auto Register(std::string name, BenchmarkFunction function, std::vector<int64_t> ranges) -> bool
+	{
+		GetRegistry().push_back({ std::move(name), std::move(function), std::move(ranges) });
+		return true;
+	}
+
+	auto RunBenchmarks(const RunOptions& options) -> int
+	{
+		// resolve the baseline first, a typo in its path shouldn't cost a full run
+		auto baseline = std::optional<std::map<std::string, double>>{};
+		if (options.m_baseline_path)
+		{
+			baseline = ReadReport(options.m_baseline_path.value());
+			if (!baseline)
+			{
+				return 1;
+			}
+		}
+
+#ifndef NDEBUG
+		std::cout << "***WARNING*** benchmarks built in debug, timings are not representative\n";
+#endif
+
+		if (!options.m_list_only)
+		{
+			std::cout << std::format("{:<48} {:>12} {:>12} {:>12} {:>12}\n", "Benchmark", "Time", "Min", "Max", "Iterations");
+			std::cout << std::string(100, '-') << "\n";
+		}
+
+		auto results = std::vector<BenchmarkResult>{};
+
+		for (const auto& definition : GetRegistry())
+		{
+			const auto ranges = definition.m_ranges.empty() ? std::vector<int64_t>{ 0 } : definition.m_ranges;
+
+			for (const auto range : ranges)
+			{
+				auto name = definition.m_ranges.empty() ? definition.m_name : std::format("{}/{}", definition.m_name, range);
+
+				if (!options.m_filter.empty() && name.find(options.m_filter) == std::string::npos)
+				{
+					continue;
+				}
+
+				if (options.m_list_only)
+				{
+					std::cout << name << "\n";
+					continue;
+				}
+
+				results.push_back(RunBenchmark(definition, range, std::move(name), options));
+				PrintResult(results.back());
+			}
+		}
+
+		if (options.m_list_only)
+		{
+			return 0;
+		}
+
+		auto exit_code = std::ranges::any_of(results, [](const BenchmarkResult& result) { return !result.m_error.empty(); }) ? 1 : 0;
+
+		if (options.m_output_path && !WriteReport(options.m_output_path.value(), results))
+		{
+			exit_code = 1;
+		}
+
+		if (baseline && CompareToBaseline(results, baseline.value(), options.m_regression_threshold_percent) != 0)
+		{
+			exit_code = 1;
+		}
+
+		return exit_code;
+	}
+}
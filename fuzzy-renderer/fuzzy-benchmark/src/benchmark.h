@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace bench
+{
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * \brief Handed to a benchmark function, which loops on KeepRunning and times only the loop.
+	 * Set up before the loop, anything that must not be measured inside it goes between PauseTiming and ResumeTiming.
+	 */
+	class State
+	{
+	public:
+		State(const int64_t range, const uint64_t iterations) : m_range{ range }, m_iterations{ iterations } {}
+
+		auto KeepRunning() -> bool
+		{
+			if (m_done_iterations == 0 && !m_is_running)
+			{
+				m_is_running = true;
+				m_start_time = Clock::now();
+			}
+
+			if (m_done_iterations != m_iterations)
+			{
+				m_done_iterations++;
+				return true;
+			}
+
+			PauseTiming();
+			return false;
+		}
+
+		auto PauseTiming() -> void
+		{
+			if (m_is_running)
+			{
+				m_elapsed += Clock::now() - m_start_time;
+				m_is_running = false;
+			}
+		}
+
+		auto ResumeTiming() -> void
+		{
+			m_is_running = true;
+			m_start_time = Clock::now();
+		}
+
+		/**
+		 * \brief The argument this run was registered with (entities count, triangles, image size..), 0 when there is none.
+		 */
+		[[nodiscard]] auto GetRange() const -> int64_t { return m_range; }
+		[[nodiscard]] auto GetIterations() const -> uint64_t { return m_iterations; }
+
+		/**
+		 * \brief Per iteration counts, reported as throughput (items/s, bytes/s).
+		 */
+		auto SetItemsPerIteration(const int64_t items) -> void { m_items_per_iteration = items; }
+		auto SetBytesPerIteration(const int64_t bytes) -> void { m_bytes_per_iteration = bytes; }
+
+		/**
+		 * \brief Skips the benchmark (missing input file..), the message ends up in the report.
+		 */
+		auto SkipWithError(std::string message) -> void { m_error = std::move(message); }
+
+		[[nodiscard]] auto GetElapsedSeconds() const -> double { return std::chrono::duration<double>(m_elapsed).count(); }
+		[[nodiscard]] auto GetItemsPerIteration() const -> int64_t { return m_items_per_iteration; }
+		[[nodiscard]] auto GetBytesPerIteration() const -> int64_t { return m_bytes_per_iteration; }
+		[[nodiscard]] auto GetError() const -> const std::optional<std::string>& { return m_error; }
+
+	private:
+		int64_t m_range = {};
+		uint64_t m_iterations = {};
+		uint64_t m_done_iterations = {};
+
+		bool m_is_running = {};
+		Clock::time_point m_start_time = {};
+		Clock::duration m_elapsed = {};
+
+		int64_t m_items_per_iteration = {};
+		int64_t m_bytes_per_iteration = {};
+		std::optional<std::string> m_error = {};
+	};
+
+	using BenchmarkFunction = std::function<void(State&)>;
+
+	/**
+	 * \brief Adds a benchmark, run once per range (or once with range 0 when the list is empty).
+	 * \return always true, it only exists to be called from a static initializer (see CX_BENCHMARK)
+	 */
+	auto Register(std::string name, BenchmarkFunction function, std::vector<int64_t> ranges = {}) -> bool;
+
+	struct RunOptions
+	{
+		std::string m_filter = {};
+		double m_min_seconds = 0.5;
+		uint32_t m_repetitions = 3;
+		std::optional<std::filesystem::path> m_output_path = {};
+		std::optional<std::filesystem::path> m_baseline_path = {};
+		double m_regression_threshold_percent = 5.0;
+		bool m_list_only = {};
+	};
+
+	/**
+	 * \brief Runs the registered benchmarks matching the filter, prints them, writes the JSON report and compares it to the baseline.
+	 * \return process exit code, 1 when a benchmark failed or got slower than the baseline by more than the threshold
+	 */
+	auto RunBenchmarks(const RunOptions& options) -> int;
+
+	/**
+	 * \brief Keeps the compiler from optimizing away a result that is otherwise unused.
+	 */
+	template <typename T>
+	auto DoNotOptimize(const T& value) -> void
+	{
+#ifdef _MSC_VER
+		const volatile auto* sink = reinterpret_cast<const volatile char*>(&value);
+		static_cast<void>(*sink);
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+}
+
+#define CX_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define CX_BENCHMARK_CONCAT(a, b) CX_BENCHMARK_CONCAT_INNER(a, b)
+
+// Registers function (void(bench::State&)) for each of the optional ranges, e.g. CX_BENCHMARK(BM_Something, 1 << 10, 1 << 16)
+#define CX_BENCHMARK(function, ...) static const auto CX_BENCHMARK_CONCAT(benchmark_registered_, __LINE__) = ::bench::Register(#function, function, { __VA_ARGS__ })
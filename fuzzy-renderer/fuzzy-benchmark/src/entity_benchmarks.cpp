@@ -0,0 +1,142 @@
+#include "benchmark.h"
+
+#include <entity_manager.h>
+#include <components/component.h>
+#include <components/transform.h>
+#include <entities/entity.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+	using libgraphics::Component;
+	using libgraphics::Entity;
+	using libgraphics::EntityManager;
+	using libgraphics::Transform;
+
+	// stand-ins for gameplay components, so the lookups don't run on a single entry map
+	class HealthComponent final : public Component {};
+	class ColliderComponent final : public Component {};
+	class ScriptComponent final : public Component {};
+	class AudioComponent final : public Component {};
+	class MissingComponent final : public Component {};
+
+	auto MakeEntity() -> std::shared_ptr<Entity>
+	{
+		auto entity = std::make_shared<Entity>();
+		entity->AddComponent<HealthComponent>();
+		entity->AddComponent<ColliderComponent>();
+		entity->AddComponent<ScriptComponent>();
+		entity->AddComponent<AudioComponent>();
+		return entity;
+	}
+
+	auto BM_EntityGetComponent(bench::State& state) -> void
+	{
+		const auto entity = MakeEntity();
+
+		while (state.KeepRunning())
+		{
+			bench::DoNotOptimize(entity->GetComponent<Transform>());
+		}
+
+		state.SetItemsPerIteration(1);
+	}
+	CX_BENCHMARK(BM_EntityGetComponent);
+
+	auto BM_EntityGetComponentMiss(bench::State& state) -> void
+	{
+		const auto entity = MakeEntity();
+
+		while (state.KeepRunning())
+		{
+			bench::DoNotOptimize(entity->GetComponent<MissingComponent>());
+		}
+
+		state.SetItemsPerIteration(1);
+	}
+	CX_BENCHMARK(BM_EntityGetComponentMiss);
+
+	/**
+	 * \brief Lookups spread over many entities, closer to a system visiting the scene than the hot cache loops above.
+	 */
+	auto BM_EntityGetComponentScattered(bench::State& state) -> void
+	{
+		auto entities = std::vector<std::shared_ptr<Entity>>{};
+		for (auto entity_idx = int64_t{ 0 }; entity_idx != state.GetRange(); ++entity_idx)
+		{
+			entities.push_back(MakeEntity());
+		}
+
+		while (state.KeepRunning())
+		{
+			for (const auto& entity : entities)
+			{
+				bench::DoNotOptimize(entity->GetComponent<ScriptComponent>());
+			}
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_EntityGetComponentScattered, 1 << 10, 1 << 14);
+
+	auto MakeEntityManager(const int64_t entities_count) -> std::unique_ptr<EntityManager>
+	{
+		// heap allocated, the manager holds atomics and can't be moved
+		auto entity_manager = std::make_unique<EntityManager>();
+
+		// one child each, like a model and its mesh
+		for (auto entity_idx = int64_t{ 0 }; entity_idx != entities_count / 2; ++entity_idx)
+		{
+			auto entity = MakeEntity();
+			entity->GetTransformComponent()->SetLocalTranslation({ static_cast<float>(entity_idx), 0.0f, 0.0f });
+			entity->AddChild(std::make_shared<Entity>());
+			entity_manager->AddEntity(entity);
+		}
+
+		return entity_manager;
+	}
+
+	/**
+	 * \brief A static scene: every component is updated but no transform is dirty.
+	 */
+	auto BM_EntityManagerUpdate(bench::State& state) -> void
+	{
+		const auto entity_manager = MakeEntityManager(state.GetRange());
+		entity_manager->Update(0.016f);
+
+		while (state.KeepRunning())
+		{
+			entity_manager->Update(0.016f);
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_EntityManagerUpdate, 1 << 10, 1 << 14, 1 << 17);
+
+	/**
+	 * \brief Every root moved since the last frame, the model matrices of the whole scene are recomputed.
+	 */
+	auto BM_EntityManagerUpdateAllDirty(bench::State& state) -> void
+	{
+		const auto entity_manager = MakeEntityManager(state.GetRange());
+		auto x = 0.0f;
+
+		while (state.KeepRunning())
+		{
+			state.PauseTiming();
+			x += 0.01f;
+			for (const auto& entity : entity_manager->GetEntities())
+			{
+				entity->GetTransformComponent()->SetLocalTranslation({ x, 0.0f, 0.0f });
+			}
+			state.ResumeTiming();
+
+			entity_manager->Update(0.016f);
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_EntityManagerUpdateAllDirty, 1 << 10, 1 << 14, 1 << 17);
+}
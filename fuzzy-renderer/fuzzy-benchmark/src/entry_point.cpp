@@ -0,0 +1,70 @@
+#include "benchmark.h"
+
+#include <core.h>
+#include <enums.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+int main(int argc, char** argv)
+{
+	auto options = bench::RunOptions{};
+
+	try
+	{
+		for (auto arg_idx = 1; arg_idx < argc; ++arg_idx)
+		{
+			const auto argument = std::string_view{ argv[arg_idx] };
+			const auto has_value = arg_idx + 1 < argc;
+
+			if (argument == "--list")
+			{
+				options.m_list_only = true;
+			}
+			else if (argument == "--filter" && has_value)
+			{
+				options.m_filter = argv[++arg_idx];
+			}
+			else if (argument == "--min-time" && has_value)
+			{
+				options.m_min_seconds = std::stod(argv[++arg_idx]);
+			}
+			else if (argument == "--repetitions" && has_value)
+			{
+				options.m_repetitions = static_cast<uint32_t>(std::stoul(argv[++arg_idx]));
+			}
+			else if (argument == "--out" && has_value)
+			{
+				options.m_output_path = argv[++arg_idx];
+			}
+			else if (argument == "--baseline" && has_value)
+			{
+				options.m_baseline_path = argv[++arg_idx];
+			}
+			else if (argument == "--threshold" && has_value)
+			{
+				options.m_regression_threshold_percent = std::stod(argv[++arg_idx]);
+			}
+			else
+			{
+				std::cerr << "usage: fuzzy-benchmark [--list] [--filter text] [--min-time seconds] [--repetitions N] [--out report.json] [--baseline report.json] [--threshold percent]\n";
+				return 1;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		std::cerr << "malformed option value\n";
+		return 1;
+	}
+
+	// the model import creates its meshes through the core, the software backend needs neither a GPU nor a window
+	auto& core = libgraphics::Core::GetInstance();
+	core.Init(libgraphics::GraphicsAPI::software, 64, 64, "Benchmark");
+
+	const auto exit_code = bench::RunBenchmarks(options);
+
+	core.Shutdown();
+
+	return exit_code;
+}
@@ -0,0 +1,265 @@
+#include "benchmark.h"
+
+#include <loaders.h>
+#include <entities/model.h>
+#include <interfaces/imesh.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/**
+	 * \brief Writes (once per size) a grid_side x grid_side quads OBJ with positions, uvs and normals, in the temp directory.
+	 */
+	auto GetGridObjPath(const int64_t grid_side) -> std::filesystem::path
+	{
+		static auto written_paths = std::map<int64_t, std::filesystem::path>{};
+		if (const auto it = written_paths.find(grid_side); it != written_paths.end())
+		{
+			return it->second;
+		}
+
+		const auto directory = std::filesystem::temp_directory_path() / "fuzzy-benchmark";
+		std::filesystem::create_directories(directory);
+
+		const auto path = directory / std::format("grid_{}.obj", grid_side);
+		auto file = std::ofstream{ path };
+
+		const auto vertices_per_side = grid_side + 1;
+		for (auto y = int64_t{ 0 }; y != vertices_per_side; ++y)
+		{
+			for (auto x = int64_t{ 0 }; x != vertices_per_side; ++x)
+			{
+				const auto u = static_cast<float>(x) / static_cast<float>(grid_side);
+				const auto v = static_cast<float>(y) / static_cast<float>(grid_side);
+				file << std::format("v {:.6f} {:.6f} {:.6f}\nvt {:.6f} {:.6f}\nvn 0 1 0\n", u * 2.0f - 1.0f, 0.0f, v * 2.0f - 1.0f, u, v);
+			}
+		}
+
+		for (auto y = int64_t{ 0 }; y != grid_side; ++y)
+		{
+			for (auto x = int64_t{ 0 }; x != grid_side; ++x)
+			{
+				// obj indices start at 1
+				const auto corner = y * vertices_per_side + x + 1;
+				const auto right = corner + 1;
+				const auto up = corner + vertices_per_side;
+				const auto up_right = up + 1;
+				file << std::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\nf {1}/{1}/{1} {3}/{3}/{3} {2}/{2}/{2}\n", corner, right, up, up_right);
+			}
+		}
+
+		written_paths[grid_side] = path;
+		return path;
+	}
+
+	auto BM_LoadObj(bench::State& state) -> void
+	{
+		const auto path = GetGridObjPath(state.GetRange());
+		auto triangles_count = int64_t{ 0 };
+
+		while (state.KeepRunning())
+		{
+			const auto mesh = libgraphics::loaders::load_obj(path);
+			if (!mesh)
+			{
+				state.SkipWithError("the obj load failed");
+				return;
+			}
+
+			triangles_count = static_cast<int64_t>(mesh->m_indices.size() / 3);
+			bench::DoNotOptimize(mesh->m_vertices.data());
+		}
+
+		state.SetItemsPerIteration(triangles_count);
+		state.SetBytesPerIteration(static_cast<int64_t>(std::filesystem::file_size(path)));
+	}
+	CX_BENCHMARK(BM_LoadObj, 32, 256);
+
+	/**
+	 * \brief Full assimp import and mesh creation (software meshes here, the GL upload is not measured). The mesh cache
+	 * is bypassed, every iteration imports the file.
+	 */
+	auto BM_LoadModelObj(bench::State& state) -> void
+	{
+		const auto path = GetGridObjPath(state.GetRange()).string();
+		auto meshes = std::vector<std::shared_ptr<libgraphics::IMesh>>{};
+		auto triangles_count = int64_t{ 0 };
+
+		while (state.KeepRunning())
+		{
+			meshes.clear();
+			libgraphics::LoadModel(path, meshes, libgraphics::MeshDataPolicy::keep_positions, libgraphics::MeshCacheMode::bypass);
+
+			if (meshes.empty())
+			{
+				state.SkipWithError("the model import failed");
+				return;
+			}
+		}
+
+		for (const auto& mesh : meshes)
+		{
+			triangles_count += mesh->GetIndexCount() / 3;
+		}
+
+		state.SetItemsPerIteration(triangles_count);
+		state.SetBytesPerIteration(static_cast<int64_t>(std::filesystem::file_size(path)));
+	}
+	CX_BENCHMARK(BM_LoadModelObj, 32, 256);
+
+	/**
+	 * \brief Same meshes as BM_LoadModelObj read back from a warm mesh cache, written by a load before the timed loop.
+	 */
+	auto BM_LoadModelObjCached(bench::State& state) -> void
+	{
+		const auto path = GetGridObjPath(state.GetRange()).string();
+		auto meshes = std::vector<std::shared_ptr<libgraphics::IMesh>>{};
+		auto triangles_count = int64_t{ 0 };
+
+		libgraphics::LoadModel(path, meshes, libgraphics::MeshDataPolicy::keep_positions, libgraphics::MeshCacheMode::rewrite);
+
+		while (state.KeepRunning())
+		{
+			meshes.clear();
+			libgraphics::LoadModel(path, meshes);
+
+			if (meshes.empty())
+			{
+				state.SkipWithError("the model load failed");
+				return;
+			}
+		}
+
+		for (const auto& mesh : meshes)
+		{
+			triangles_count += mesh->GetIndexCount() / 3;
+		}
+
+		state.SetItemsPerIteration(triangles_count);
+		state.SetBytesPerIteration(static_cast<int64_t>(std::filesystem::file_size(path)));
+	}
+	CX_BENCHMARK(BM_LoadModelObjCached, 32, 256);
+
+	/**
+	 * \brief Import of the .glb (GlbScene) with the mesh cache bypassed, like BM_LoadModelObj.
+	 */
+	auto BM_LoadModelGlb(bench::State& state) -> void
+	{
+		// relative to the project directory, like the default scene
+		const auto path = std::string{ "../resources/Cube.glb" };
+		if (!std::filesystem::exists(path))
+		{
+			state.SkipWithError(path + " not found, run from the fuzzy-benchmark directory");
+			return;
+		}
+
+		auto meshes = std::vector<std::shared_ptr<libgraphics::IMesh>>{};
+
+		while (state.KeepRunning())
+		{
+			meshes.clear();
+			libgraphics::LoadModel(path, meshes, libgraphics::MeshDataPolicy::keep_positions, libgraphics::MeshCacheMode::bypass);
+		}
+
+		state.SetBytesPerIteration(static_cast<int64_t>(std::filesystem::file_size(path)));
+	}
+	CX_BENCHMARK(BM_LoadModelGlb);
+
+	/**
+	 * \brief Smooth gradients plus some noise, so neither the png filters nor the jpeg quantization have it too easy.
+	 */
+	auto MakeImage(const int size) -> std::vector<uint8_t>
+	{
+		auto generator = std::mt19937{ 42 };
+		auto noise = std::uniform_int_distribution{ 0, 15 };
+
+		auto pixels = std::vector<uint8_t>(static_cast<size_t>(size) * size * 4);
+		for (auto y = 0; y != size; ++y)
+		{
+			for (auto x = 0; x != size; ++x)
+			{
+				auto* pixel = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+				pixel[0] = static_cast<uint8_t>((x * 255 / size + noise(generator)) & 0xFF);
+				pixel[1] = static_cast<uint8_t>((y * 255 / size + noise(generator)) & 0xFF);
+				pixel[2] = static_cast<uint8_t>((x ^ y) & 0xFF);
+				pixel[3] = 255;
+			}
+		}
+
+		return pixels;
+	}
+
+	auto AppendToVector(void* context, void* data, const int size) -> void
+	{
+		auto& bytes = *static_cast<std::vector<uint8_t>*>(context);
+		bytes.insert(bytes.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+	}
+
+	auto EncodeImage(const int size, const bool jpeg) -> std::vector<uint8_t>
+	{
+		const auto pixels = MakeImage(size);
+		auto encoded = std::vector<uint8_t>{};
+
+		if (jpeg)
+		{
+			stbi_write_jpg_to_func(AppendToVector, &encoded, size, size, 4, pixels.data(), 90);
+		}
+		else
+		{
+			stbi_write_png_to_func(AppendToVector, &encoded, size, size, 4, pixels.data(), size * 4);
+		}
+
+		return encoded;
+	}
+
+	auto DecodeImage(bench::State& state, const bool jpeg) -> void
+	{
+		const auto size = static_cast<int>(state.GetRange());
+		const auto encoded = EncodeImage(size, jpeg);
+
+		while (state.KeepRunning())
+		{
+			auto width = 0;
+			auto height = 0;
+			auto channels = 0;
+
+			auto* pixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, 4);
+			if (!pixels)
+			{
+				state.SkipWithError(stbi_failure_reason());
+				return;
+			}
+
+			bench::DoNotOptimize(pixels[0]);
+			stbi_image_free(pixels);
+		}
+
+		// throughput in decoded pixels, bytes are the compressed input
+		state.SetItemsPerIteration(static_cast<int64_t>(size) * size);
+		state.SetBytesPerIteration(static_cast<int64_t>(encoded.size()));
+	}
+
+	auto BM_StbiDecodePng(bench::State& state) -> void
+	{
+		DecodeImage(state, false);
+	}
+	CX_BENCHMARK(BM_StbiDecodePng, 256, 1024, 2048);
+
+	auto BM_StbiDecodeJpeg(bench::State& state) -> void
+	{
+		DecodeImage(state, true);
+	}
+	CX_BENCHMARK(BM_StbiDecodeJpeg, 256, 1024, 2048);
+}
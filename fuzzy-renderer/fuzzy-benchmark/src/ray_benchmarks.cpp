@@ -0,0 +1,75 @@
+#include "benchmark.h"
+
+#include <ray_hit.h>
+#include <utils.h>
+#include <opengl/gl_mesh.h>
+
+#include <optional>
+#include <vector>
+
+namespace
+{
+	using libgraphics::GLMesh;
+	using libgraphics::Vertex;
+
+	/**
+	 * \brief Flat grid of quads_per_side x quads_per_side quads on the z = 0 plane, from -1 to 1.
+	 * Built with the vertices/indices constructor, which only keeps the data on the CPU.
+	 */
+	auto MakeGridMesh(const int64_t quads_per_side) -> GLMesh
+	{
+		const auto vertices_per_side = static_cast<uint32_t>(quads_per_side + 1);
+
+		auto vertices = std::vector<Vertex>{};
+		vertices.reserve(static_cast<size_t>(vertices_per_side) * vertices_per_side);
+
+		for (auto y = 0u; y != vertices_per_side; ++y)
+		{
+			for (auto x = 0u; x != vertices_per_side; ++x)
+			{
+				auto vertex = Vertex{};
+				vertex.m_position = { static_cast<float>(x) / quads_per_side * 2.0f - 1.0f, static_cast<float>(y) / quads_per_side * 2.0f - 1.0f, 0.0f };
+				vertex.m_normal = { 0.0f, 0.0f, 1.0f };
+				vertices.push_back(vertex);
+			}
+		}
+
+		auto indices = std::vector<uint32_t>{};
+		indices.reserve(static_cast<size_t>(quads_per_side) * quads_per_side * 6);
+
+		for (auto y = 0u; y != vertices_per_side - 1; ++y)
+		{
+			for (auto x = 0u; x != vertices_per_side - 1; ++x)
+			{
+				const auto corner = y * vertices_per_side + x;
+				indices.insert(indices.end(), { corner, corner + 1, corner + vertices_per_side, corner + 1, corner + vertices_per_side + 1, corner + vertices_per_side });
+			}
+		}
+
+		return GLMesh{ std::move(vertices), std::move(indices) };
+	}
+
+	/**
+	 * \brief Range is the grid side in quads, the mesh has 2 * range^2 triangles.
+	 */
+	auto BM_RayMeshIntersection(bench::State& state) -> void
+	{
+		const auto mesh = MakeGridMesh(state.GetRange());
+		const auto ray_origin = glm::vec3{ 0.13f, -0.27f, 5.0f };
+		const auto ray_direction = glm::vec3{ 0.0f, 0.0f, -1.0f };
+
+		if (!utils::gl::CheckRayMeshIntersection(ray_origin, ray_direction, mesh))
+		{
+			state.SkipWithError("the ray doesn't hit the grid");
+			return;
+		}
+
+		while (state.KeepRunning())
+		{
+			bench::DoNotOptimize(utils::gl::CheckRayMeshIntersection(ray_origin, ray_direction, mesh));
+		}
+
+		state.SetItemsPerIteration(mesh.GetIndexCount() / 3);
+	}
+	CX_BENCHMARK(BM_RayMeshIntersection, 16, 128, 512);
+}
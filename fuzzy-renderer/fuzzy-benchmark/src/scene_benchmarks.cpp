@@ -0,0 +1,58 @@
+#include "benchmark.h"
+
+#include <entity_manager.h>
+#include <components/transform.h>
+#include <entities/entity.h>
+#include <rendering/scene_generator.h>
+
+#include <memory>
+
+namespace
+{
+	using libgraphics::SceneGeneratorParams;
+
+	/**
+	 * \brief Meshes, materials and entities of a generated scene (software meshes, no lights or textures involved).
+	 */
+	auto BM_GenerateScene(bench::State& state) -> void
+	{
+		auto params = SceneGeneratorParams{};
+		params.m_entities_count = static_cast<uint32_t>(state.GetRange());
+
+		while (state.KeepRunning())
+		{
+			bench::DoNotOptimize(libgraphics::GenerateScene(params).m_root.get());
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_GenerateScene, 1 << 10, 1 << 14);
+
+	/**
+	 * \brief The same 4096 entities as chains of range nested entities, every transform dirty each update.
+	 */
+	auto BM_GeneratedSceneUpdateDepth(bench::State& state) -> void
+	{
+		auto params = SceneGeneratorParams{};
+		params.m_entities_count = 1 << 12;
+		params.m_hierarchy_depth = static_cast<uint32_t>(state.GetRange());
+		params.m_hierarchy_branching = 1;
+
+		// heap allocated, the manager holds atomics and can't be moved
+		const auto entity_manager = std::make_unique<libgraphics::EntityManager>();
+		const auto scene = libgraphics::GenerateScene(params);
+		entity_manager->AddEntity(scene.m_root);
+
+		while (state.KeepRunning())
+		{
+			state.PauseTiming();
+			scene.m_root->GetTransformComponent()->SetLocalTranslation({});
+			state.ResumeTiming();
+
+			entity_manager->Update(0.016f);
+		}
+
+		state.SetItemsPerIteration(params.m_entities_count);
+	}
+	CX_BENCHMARK(BM_GeneratedSceneUpdateDepth, 1, 8, 64);
+}
@@ -0,0 +1,84 @@
+#include "benchmark.h"
+
+#include <rendering/texture_cooker.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	using libgraphics::TextureRole;
+
+	/**
+	 * \brief Smooth gradients with some noise, closer to real albedo/normal data than a flat image.
+	 */
+	auto MakeImage(const int size) -> std::vector<uint8_t>
+	{
+		auto pixels = std::vector<uint8_t>(static_cast<size_t>(size) * size * 4);
+		auto seed = uint32_t{ 0x9E3779B9u };
+
+		for (auto texel_idx = size_t{ 0 }; texel_idx != pixels.size() / 4; ++texel_idx)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			const auto x = static_cast<int>(texel_idx % size);
+			const auto y = static_cast<int>(texel_idx / size);
+			pixels[texel_idx * 4] = static_cast<uint8_t>(x * 255 / size + (seed >> 29));
+			pixels[texel_idx * 4 + 1] = static_cast<uint8_t>(y * 255 / size + (seed >> 29));
+			pixels[texel_idx * 4 + 2] = static_cast<uint8_t>(255 - (seed >> 28));
+			pixels[texel_idx * 4 + 3] = 255;
+		}
+
+		return pixels;
+	}
+
+	/**
+	 * \brief Linear space mip chain of a range x range color image, the filtering half of the cooker.
+	 */
+	auto BM_GenerateMipChain(bench::State& state) -> void
+	{
+		const auto size = static_cast<int>(state.GetRange());
+		const auto pixels = MakeImage(size);
+
+		while (state.KeepRunning())
+		{
+			bench::DoNotOptimize(libgraphics::GenerateMipChain(pixels, size, size, TextureRole::color).data());
+		}
+
+		state.SetBytesPerIteration(static_cast<int64_t>(pixels.size()));
+	}
+	CX_BENCHMARK(BM_GenerateMipChain, 256, 1024, 2048);
+
+	/**
+	 * \brief Mip chain and BC1 compression of every level.
+	 */
+	auto BM_CookColorTexture(bench::State& state) -> void
+	{
+		const auto size = static_cast<int>(state.GetRange());
+		const auto pixels = MakeImage(size);
+
+		while (state.KeepRunning())
+		{
+			bench::DoNotOptimize(libgraphics::CookTexture(pixels, size, size, TextureRole::color).m_mips.data());
+		}
+
+		state.SetBytesPerIteration(static_cast<int64_t>(pixels.size()));
+	}
+	CX_BENCHMARK(BM_CookColorTexture, 256, 1024, 2048);
+
+	/**
+	 * \brief Renormalized mip chain and BC5 compression, the normal map path.
+	 */
+	auto BM_CookNormalTexture(bench::State& state) -> void
+	{
+		const auto size = static_cast<int>(state.GetRange());
+		const auto pixels = MakeImage(size);
+
+		while (state.KeepRunning())
+		{
+			bench::DoNotOptimize(libgraphics::CookTexture(pixels, size, size, TextureRole::normal).m_mips.data());
+		}
+
+		state.SetBytesPerIteration(static_cast<int64_t>(pixels.size()));
+	}
+	CX_BENCHMARK(BM_CookNormalTexture, 256, 1024);
+}
@@ -0,0 +1,155 @@
+#include "benchmark.h"
+
+#include <components/transform.h>
+#include <entities/entity.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using libgraphics::Entity;
+	using libgraphics::Transform;
+
+	auto RandomTransform(Transform& transform, std::mt19937& generator) -> void
+	{
+		auto distribution = std::uniform_real_distribution{ -10.0f, 10.0f };
+
+		transform.Initialize();
+		transform.SetLocalTranslation({ distribution(generator), distribution(generator), distribution(generator) });
+		transform.SetLocalRotation({ distribution(generator) * 18.0f, distribution(generator) * 18.0f, distribution(generator) * 18.0f });
+		transform.SetLocalScale(glm::vec3{ 1.0f + std::abs(distribution(generator)) * 0.1f });
+	}
+
+	/**
+	 * \brief Synthetic scene tree, every entity gets branching_factor children until entities_count is reached (breadth first).
+	 */
+	auto BuildTree(const int64_t entities_count, const size_t branching_factor) -> std::shared_ptr<Entity>
+	{
+		auto generator = std::mt19937{ 42 };
+
+		auto root = std::make_shared<Entity>();
+		RandomTransform(*root->GetTransformComponent(), generator);
+
+		auto parents = std::vector<std::shared_ptr<Entity>>{ root };
+		auto created_count = int64_t{ 1 };
+
+		for (auto parent_idx = size_t{ 0 }; created_count < entities_count; ++parent_idx)
+		{
+			for (auto child_idx = size_t{ 0 }; child_idx != branching_factor && created_count < entities_count; ++child_idx)
+			{
+				auto child = std::make_shared<Entity>();
+				RandomTransform(*child->GetTransformComponent(), generator);
+
+				parents[parent_idx]->AddChild(child);
+				parents.push_back(std::move(child));
+				created_count++;
+			}
+		}
+
+		return root;
+	}
+
+	auto BM_TransformComputeModelMatrix(bench::State& state) -> void
+	{
+		auto generator = std::mt19937{ 42 };
+		auto transforms = std::vector<Transform>(static_cast<size_t>(state.GetRange()));
+		for (auto& transform : transforms)
+		{
+			RandomTransform(transform, generator);
+		}
+
+		while (state.KeepRunning())
+		{
+			for (auto& transform : transforms)
+			{
+				transform.ComputeModelMatrix();
+			}
+			bench::DoNotOptimize(transforms.back().GetWorldModelMatrix());
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_TransformComputeModelMatrix, 1 << 10, 1 << 14);
+
+	auto BM_TransformComputeModelMatrixWithParent(bench::State& state) -> void
+	{
+		auto generator = std::mt19937{ 42 };
+		auto transforms = std::vector<Transform>(static_cast<size_t>(state.GetRange()));
+		for (auto& transform : transforms)
+		{
+			RandomTransform(transform, generator);
+		}
+
+		const auto parent_model_matrix = transforms.front().GetLocalModelMatrix();
+
+		while (state.KeepRunning())
+		{
+			for (auto& transform : transforms)
+			{
+				transform.ComputeModelMatrix(parent_model_matrix);
+			}
+			bench::DoNotOptimize(transforms.back().GetWorldModelMatrix());
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_TransformComputeModelMatrixWithParent, 1 << 10, 1 << 14);
+
+	/**
+	 * \brief The root moves every frame, so the whole tree is recomputed (worst case of Entity::Update).
+	 */
+	auto BM_HierarchyPropagationDirtyRoot(bench::State& state) -> void
+	{
+		const auto root = BuildTree(state.GetRange(), 4);
+		const auto root_transform = root->GetTransformComponent();
+		auto x = 0.0f;
+
+		while (state.KeepRunning())
+		{
+			root_transform->SetLocalTranslation({ x += 0.01f, 0.0f, 0.0f });
+			root->Update(0.016f);
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_HierarchyPropagationDirtyRoot, 1 << 8, 1 << 12, 1 << 16);
+
+	/**
+	 * \brief Nothing moves, what's left is the cost of walking the tree and checking the dirty flags.
+	 */
+	auto BM_HierarchyPropagationClean(bench::State& state) -> void
+	{
+		const auto root = BuildTree(state.GetRange(), 4);
+		root->Update(0.016f);
+
+		while (state.KeepRunning())
+		{
+			root->Update(0.016f);
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_HierarchyPropagationClean, 1 << 8, 1 << 12, 1 << 16);
+
+	/**
+	 * \brief Deep and narrow (a chain) against the wide trees above, the depth is what the recursion pays for.
+	 */
+	auto BM_HierarchyPropagationChain(bench::State& state) -> void
+	{
+		const auto root = BuildTree(state.GetRange(), 1);
+		const auto root_transform = root->GetTransformComponent();
+		auto x = 0.0f;
+
+		while (state.KeepRunning())
+		{
+			root_transform->SetLocalTranslation({ x += 0.01f, 0.0f, 0.0f });
+			root->Update(0.016f);
+		}
+
+		state.SetItemsPerIteration(state.GetRange());
+	}
+	CX_BENCHMARK(BM_HierarchyPropagationChain, 1 << 6, 1 << 10);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <framework.h>
+#include <mapped_file.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Bytes of an asset file, valid as long as the AssetData (or a copy of it) is: m_owner is what they live in,
+	 * the archive mapping, the decompressed copy or the mapping of the loose file.
+	 */
+	struct AssetData
+	{
+		std::span<const uint8_t> m_bytes = {};
+		std::shared_ptr<const void> m_owner = {};
+
+		[[nodiscard]] auto GetText() const -> std::string_view { return { reinterpret_cast<const char*>(m_bytes.data()), m_bytes.size() }; }
+	};
+
+	enum class ArchiveCompression : uint32_t
+	{
+		none,		// stored as is, 4 KB aligned, read in place from the mapping
+		lz4			// LZ4 block, decompressed on every read
+	};
+
+	/**
+	 * \brief An entry of the table of contents, sorted by m_hash (FNV-1a of the name, its path relative to the root the
+	 * archive was packed from, with forward slashes).
+	 */
+	struct AssetArchiveEntry
+	{
+		uint64_t m_hash = {};
+		uint64_t m_offset = {};
+		uint64_t m_stored_size = {};
+		uint64_t m_size = {};
+		uint32_t m_name_offset = {};
+		uint32_t m_name_size = {};
+		ArchiveCompression m_compression = {};
+		uint32_t m_padding = {};
+	};
+
+	/**
+	 * \brief A .fzpak, many asset files in one mapped file. The table of contents is looked up by hash, stored entries
+	 * are handed out as views into the mapping (no copy, no read until their pages are touched), compressed ones are
+	 * decompressed into a buffer of their own. Any thread once opened.
+	 */
+	class AssetArchive : public std::enable_shared_from_this<AssetArchive>
+	{
+	public:
+		/**
+		 * \return nullptr when the file is missing or malformed
+		 */
+		LIBGRAPHICS_API static auto Open(const std::filesystem::path& path) -> std::shared_ptr<AssetArchive>;
+
+		[[nodiscard]] LIBGRAPHICS_API static auto HashName(const std::string_view name) -> uint64_t;
+
+		/**
+		 * \return nothing when no entry has that name or it doesn't decompress
+		 */
+		[[nodiscard]] LIBGRAPHICS_API auto Read(const std::string_view name) const -> std::optional<AssetData>;
+
+		[[nodiscard]] auto Contains(const std::string_view name) const -> bool { return Find(name) != nullptr; }
+
+		/**
+		 * \brief Directory the archive was packed from, relative to the working directory of the packer.
+		 */
+		[[nodiscard]] auto GetRoot() const -> const std::filesystem::path& { return m_root; }
+		[[nodiscard]] auto GetEntries() const -> std::span<const AssetArchiveEntry> { return m_entries; }
+		[[nodiscard]] LIBGRAPHICS_API auto GetName(const AssetArchiveEntry& entry) const -> std::string_view;
+
+	private:
+		[[nodiscard]] auto Find(const std::string_view name) const -> const AssetArchiveEntry*;
+
+		MappedFile m_file = {};
+		std::span<const AssetArchiveEntry> m_entries = {};
+		std::span<const char> m_names = {};
+		std::filesystem::path m_root = {};
+	};
+
+	struct AssetArchiveStats
+	{
+		size_t m_entries_count = {};
+		size_t m_compressed_count = {};
+		uint64_t m_source_bytes = {};
+		uint64_t m_archive_bytes = {};
+	};
+
+	/**
+	 * \brief Packs the inputs (files or directories, recursively, relative to root) in an archive. Entries are LZ4
+	 * compressed when that saves an eighth of them at least, except the cooked textures which are streamed a level at a
+	 * time and read in place.
+	 * \return nothing when an input is missing or the archive can't be written
+	 */
+	LIBGRAPHICS_API auto WriteAssetArchive(const std::filesystem::path& archive_path, const std::filesystem::path& root, const std::span<const std::filesystem::path> inputs) -> std::optional<AssetArchiveStats>;
+
+	/**
+	 * \brief LZ4 block format (no frame), the compressed size is at most LZ4's bound of the input.
+	 */
+	LIBGRAPHICS_API auto Lz4Compress(const std::span<const uint8_t> input) -> std::vector<uint8_t>;
+
+	/**
+	 * \return nothing when the block is malformed or doesn't decompress to exactly size bytes
+	 */
+	LIBGRAPHICS_API auto Lz4Decompress(const std::span<const uint8_t> input, const size_t size) -> std::optional<std::vector<uint8_t>>;
+}
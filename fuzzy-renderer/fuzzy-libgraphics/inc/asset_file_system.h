@@ -0,0 +1,67 @@
+#pragma once
+
+#include <asset_archive.h>
+#include <framework.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Where the loaders read asset files from. A path is looked up in the mounted archives first (the last mounted
+	 * wins), relative to the root each was packed from, then on disk; either way the bytes are mapped, not copied, unless
+	 * the archive entry is compressed. Paths are the ones the loaders always took, relative to the working directory.
+	 */
+	class AssetFileSystem
+	{
+	public:
+		AssetFileSystem(const AssetFileSystem&) = delete;
+		AssetFileSystem& operator=(const AssetFileSystem&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> AssetFileSystem&;
+
+		/**
+		 * \param root directory the entries are relative to, the one the archive was packed from when not set
+		 * \return false when the archive is missing or malformed
+		 */
+		LIBGRAPHICS_API auto Mount(const std::filesystem::path& archive_path, const std::optional<std::filesystem::path>& root = {}) -> bool;
+		LIBGRAPHICS_API auto UnmountAll() -> void;
+
+		/**
+		 * \brief Bytes of the file at path, from an archive or the disk. Any thread.
+		 * \return nothing when no archive has it and it isn't on disk either
+		 */
+		[[nodiscard]] LIBGRAPHICS_API auto Read(const std::filesystem::path& path) const -> std::optional<AssetData>;
+
+		[[nodiscard]] LIBGRAPHICS_API auto Exists(const std::filesystem::path& path) const -> bool;
+
+		/**
+		 * \brief Files right in the directory (not in its subdirectories), from the archives and the disk, sorted.
+		 */
+		[[nodiscard]] LIBGRAPHICS_API auto ListFiles(const std::filesystem::path& directory) const -> std::vector<std::filesystem::path>;
+
+		[[nodiscard]] LIBGRAPHICS_API auto GetMountedCount() const -> size_t;
+
+	private:
+		AssetFileSystem() = default;
+
+		struct MountedArchive
+		{
+			std::shared_ptr<AssetArchive> m_archive = {};
+			std::filesystem::path m_root = {};
+		};
+
+		/**
+		 * \brief The archive which has the file at path, the last mounted first, and the name of the file in it.
+		 */
+		[[nodiscard]] auto FindArchive(const std::filesystem::path& path, std::string& out_name) const -> std::shared_ptr<AssetArchive>;
+
+		mutable std::shared_mutex m_mutex = {};
+		std::vector<MountedArchive> m_archives = {};
+	};
+}
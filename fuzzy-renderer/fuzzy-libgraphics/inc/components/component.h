@@ -1,5 +1,7 @@
 #pragma once
 
+#include <framework.h>
+
 namespace libgraphics
 {
     class Entity;
@@ -14,8 +16,8 @@ namespace libgraphics
         virtual auto Update(float delta_time) -> void {}
         virtual auto Render() -> void {}
 
-        [[nodiscard]] auto GetEntity() const -> Entity&;
-        auto SetEntity(Entity* entity) -> void;
+        LIBGRAPHICS_API [[nodiscard]] auto GetEntity() const -> Entity&;
+        LIBGRAPHICS_API auto SetEntity(Entity* entity) -> void;
 
         bool m_active = {};
 
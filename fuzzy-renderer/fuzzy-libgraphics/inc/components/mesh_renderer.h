@@ -2,21 +2,40 @@
 
 #include <memory>
 #include <components/component.h>
-#include <opengl/gl_mesh.h>
+#include <interfaces/imesh.h>
 
 #include <rendering/material.h>
 
 namespace libgraphics
 {
+	class CommandList;
+	struct RenderView;
+
 	class MeshRenderer : public Component
     {
     public:
-        MeshRenderer(GLMesh mesh) : m_mesh(std::move(mesh)) {}
+        MeshRenderer(std::shared_ptr<IMesh> mesh) : m_mesh(std::move(mesh)) {}
         auto Initialize() -> void override;
         auto Render() -> void override;
 
+        /**
+         * \brief Checks the world space bounds of the mesh against the view frustum.
+         */
+        [[nodiscard]] auto IsVisible(const RenderView& view) const -> bool;
+
+        /**
+         * \brief Approximate height in pixels the bounds of the mesh cover in the view, from their bounding sphere.
+         */
+        [[nodiscard]] auto GetScreenSize(const RenderView& view) const -> float;
+
+        /**
+         * \brief Records material constants, textures, model matrix and the draw. The pipeline (and its per-view
+         * constants) must already be bound in the list. Only reads this component so it can run on any thread.
+         */
+        auto Record(CommandList& command_list) const -> void;
+
         [[nodiscard]] auto& GetMesh() const { return m_mesh; }
-        auto SetMesh(const GLMesh& mesh) -> void { m_mesh = mesh; }
+        auto SetMesh(const std::shared_ptr<IMesh>& mesh) -> void { m_mesh = mesh; }
 
         [[nodiscard]] auto& GetShader() const { return m_shader; }
         auto SetShader(const std::shared_ptr<IShader>& shader) -> void { m_shader = shader; }
@@ -25,10 +44,7 @@ namespace libgraphics
         auto SetMaterial(const std::shared_ptr<lighting::Material>& material) -> void { m_default_material = material; }
 
     private:
-
-        auto UpdateMatrix() const -> void;
-
-        GLMesh m_mesh;
+        std::shared_ptr<IMesh> m_mesh = {};
         std::shared_ptr<IShader> m_shader = {};
         std::shared_ptr<lighting::Material> m_default_material = {};
 
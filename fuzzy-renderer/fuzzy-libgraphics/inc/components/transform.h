@@ -13,23 +13,23 @@ namespace libgraphics
 	public:
 		Transform() = default;
 
-		void Initialize() override;
+		LIBGRAPHICS_API void Initialize() override;
 
-		auto SetLocalTranslation(const glm::vec3& translation) -> void;
+		LIBGRAPHICS_API auto SetLocalTranslation(const glm::vec3& translation) -> void;
 		auto SetLocalScale(const glm::vec3& scale) { m_local_scale = scale; m_is_dirty = true; }
-		auto SetLocalRotation(const glm::vec3& rotation) -> void;
+		LIBGRAPHICS_API auto SetLocalRotation(const glm::vec3& rotation) -> void;
 		[[nodiscard]] auto& GetLocalTranslation() const { return m_local_translation; }
 		[[nodiscard]] auto& GetLocalScale() const { return m_local_scale; }
 		[[nodiscard]] auto& GetLocalRotation() const { return m_local_rotation; }
 
-		auto Reset() -> void;
+		LIBGRAPHICS_API auto Reset() -> void;
 
-		[[nodiscard]] auto GetLocalModelMatrix() const->glm::mat4;
+		LIBGRAPHICS_API [[nodiscard]] auto GetLocalModelMatrix() const->glm::mat4;
 		[[nodiscard]] auto GetWorldModelMatrix() const { return m_model_matrix; }
 		[[nodiscard]] auto IsDirty() const { return m_is_dirty; }
 
-		auto ComputeModelMatrix() -> void;
-		auto ComputeModelMatrix(const glm::mat4& parent_global_model_matrix) -> void;
+		LIBGRAPHICS_API auto ComputeModelMatrix() -> void;
+		LIBGRAPHICS_API auto ComputeModelMatrix(const glm::mat4& parent_global_model_matrix) -> void;
 
 	private:
 		glm::vec3 m_local_translation = {};
@@ -1,17 +1,43 @@
 #pragma once
 
+#include <engine_constants.h>
 #include <interfaces/igraphics_window.h>
+#include <interfaces/imesh.h>
 #include <opengl/camera.h>
+#include <rendering/camera_path.h>
+#include <rendering/captured_frame.h>
+#include <rendering/mesh_data.h>
+#include <resource_manager.h>
+
+#include <chrono>
+#include <optional>
 
 namespace libgraphics
 {
+	class CommandList;
 	class EntityManager;
+	class GLDynamicResolution;
+	class GLFrameCapture;
+	class GLShader;
+	class IMesh;
 	struct Light;
 	class GLSkybox;
+	class ModelLoader;
+	class ModelLoadHandle;
+	class RenderGraph;
+	struct RenderView;
+	struct SceneGeneratorParams;
 	class IGraphicsWindow;
 	class IShader;
+	class Texture;
+	struct Vertex;
 	enum class GraphicsAPI;
 
+	namespace gui
+	{
+		class GUIObjectBase;
+	}
+
 	using RenderFunction = std::function<void(double)>;
 
 	class CoreImpl
@@ -20,6 +46,24 @@ namespace libgraphics
 		GraphicsAPI m_graphics_api = {};
 		Camera m_main_camera = {};
 		std::shared_ptr<IGraphicsWindow> m_graphics_window = {};
+		std::shared_ptr<IShader> m_default_shader = {};
+		ResourceHandle<GLShader> m_default_shader_handle = {};
+		ResourceHandle<GLShader> m_skybox_shader_handle = {};
+		std::shared_ptr<GLFrameCapture> m_frame_capture = {};
+		std::shared_ptr<GLDynamicResolution> m_dynamic_resolution = {};
+		std::shared_ptr<ModelLoader> m_model_loader = {};
+		CaptureCallback m_capture_callback = {};
+		uint64_t m_captured_frames_count = {};
+		std::vector<std::shared_ptr<gui::GUIObjectBase>> m_gui_objects = {};
+		std::optional<std::chrono::steady_clock::time_point> m_previous_frame_time = {};
+		std::optional<std::filesystem::path> m_camera_recording_path = {};
+		CameraPath m_camera_recording = {};
+		CameraPath m_camera_replay = {};
+		std::vector<std::shared_ptr<Light>> m_generated_lights = {};
+		uint64_t m_memory_checkpoint = {};
+		size_t m_camera_replay_frame_idx = {};
+		float m_camera_replay_delta_time = {};
+		bool m_is_replaying_camera = {};
 	};
 
 	class Core final
@@ -31,8 +75,30 @@ namespace libgraphics
 		Core& operator=(const Core&) = delete;
 		Core& operator=(Core&&) = delete;
 
+		/**
+		 * \brief Creates the context, the default resources and the scene. With GraphicsAPI::opengl_headless there is no
+		 * window (and no imgui/input): frames are rendered into an offscreen framebuffer of context_width x context_height.
+		 * GraphicsAPI::software renders on the CPU (no skybox, no textures) and doesn't need a GPU at all.
+		 */
 		LIBGRAPHICS_API auto Init(const GraphicsAPI api_type, const int context_width, const int context_height, const std::string_view context_title) -> void;
+
+		/**
+		 * \brief Blocking loop, renders frames until the window is closed then shuts down.
+		 */
 		LIBGRAPHICS_API auto Update(const RenderFunction&) -> void;
+
+		/**
+		 * \brief Renders (and presents, when there is a window) exactly one frame, for callers driving the loop themselves.
+		 */
+		LIBGRAPHICS_API auto RenderFrame(const RenderFunction&) -> void;
+
+		/**
+		 * \brief Releases the context, to be called once after the last RenderFrame.
+		 */
+		LIBGRAPHICS_API auto Shutdown() -> void;
+
+		LIBGRAPHICS_API [[nodiscard]] auto IsHeadless() const -> bool;
+		LIBGRAPHICS_API [[nodiscard]] auto GetGraphicsAPI() const -> GraphicsAPI { return m_p_impl->m_graphics_api; }
 		LIBGRAPHICS_API static auto GetInstance() -> Core&;
 
 		LIBGRAPHICS_API auto AddLight(const std::shared_ptr<Light>&) -> void;
@@ -45,16 +111,120 @@ namespace libgraphics
 
 		LIBGRAPHICS_API [[nodiscard]] auto GetEntityManager () const -> std::shared_ptr<EntityManager> { return m_entity_manager; }
 
+		/**
+		 * \brief Replaces the model of the default scene with the one at model_path (any format assimp reads), or with a
+		 * generated scene when model_path is a scene generator spec ("generated:entities=1000,...").
+		 */
+		LIBGRAPHICS_API auto LoadScene(const std::string_view model_path) -> void;
+
+		/**
+		 * \brief Replaces the model of the default scene (and the lights of the previously generated one) with a
+		 * generated scene. Lights past constants::MaxNumberOfLights are dropped.
+		 */
+		LIBGRAPHICS_API auto LoadScene(const SceneGeneratorParams& params) -> void;
+
+		/**
+		 * \brief Adds the model at model_path to the scene without blocking: it is imported on the job system, then
+		 * uploaded a few meshes and textures per frame (constants::ModelUploadBytesPerFrame) and added once complete.
+		 * \param mesh_data_policy what its meshes keep in system memory once uploaded
+		 */
+		LIBGRAPHICS_API auto LoadModelAsync(const std::string_view model_path, const MeshDataPolicy mesh_data_policy = MeshDataPolicy::keep_positions) -> std::shared_ptr<ModelLoadHandle>;
+
+		/**
+		 * \brief The asynchronous loads not completed yet, oldest first.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetModelLoads() const -> const std::vector<std::shared_ptr<ModelLoadHandle>>&;
+
+		/**
+		 * \brief Camera matrices and frustum of the main camera for the current window size.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetMainRenderView() const -> RenderView;
+
+		/**
+		 * \brief Program the mesh renderers start with, a GLShader or an SWShader depending on the backend.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetDefaultShader() const -> const std::shared_ptr<IShader>& { return m_p_impl->m_default_shader; }
+
+		/**
+		 * \brief Creates a mesh of the active backend (GLMesh uploads it right away), bounds are computed from the vertices
+		 * unless given. data_policy is what a GLMesh keeps in system memory after the upload, an SWMesh keeps everything.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto CreateMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<Texture> textures, std::string name, const std::optional<BoundingBox>& bounds = {},
+			const MeshDataPolicy data_policy = MeshDataPolicy::keep_positions) const -> std::shared_ptr<IMesh>;
+
+		/**
+		 * \brief Replays a command list with the executor of the active backend.
+		 */
+		LIBGRAPHICS_API auto ExecuteCommandList(const CommandList& command_list) const -> void;
+
+		/**
+		 * \brief Starts handing every rendered frame (before imgui) to the callback. On GL the readback is asynchronous
+		 * so frames arrive CaptureRingSize - 1 frames late, on the render thread, in order.
+		 */
+		LIBGRAPHICS_API auto BeginCapture(CaptureCallback callback) -> void;
+
+		/**
+		 * \brief Delivers the frames still in flight and stops capturing.
+		 */
+		LIBGRAPHICS_API auto EndCapture() -> void;
+
+		/**
+		 * \brief Renders the 3D scene at a resolution picked from the GPU frame times to meet target_frame_ms, then
+		 * upscales it to the window (imgui stays at native resolution). GL backends only.
+		 */
+		LIBGRAPHICS_API auto SetDynamicResolution(const bool enabled, const float target_frame_ms = constants::DynamicResolutionTargetFrameMs) -> void;
+
+		/**
+		 * \brief Per axis scale the scene is currently rendered at, 1 when dynamic resolution is off.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetResolutionScale() const -> float;
+
+		/**
+		 * \brief Records the main camera pose and the delta time of every frame, written to path by EndCameraRecording
+		 * (or by Shutdown).
+		 */
+		LIBGRAPHICS_API auto BeginCameraRecording(const std::filesystem::path& path) -> void;
+
+		/**
+		 * \brief Writes the frames recorded since BeginCameraRecording and stops recording.
+		 * \return false when nothing was being recorded or the file couldn't be written
+		 */
+		LIBGRAPHICS_API auto EndCameraRecording() -> bool;
+
+		/**
+		 * \brief Drives the main camera from camera_path, one recorded frame per rendered frame, and advances the scene by
+		 * fixed_delta_time every frame instead of the measured time. Past the last frame the camera holds its last pose.
+		 */
+		LIBGRAPHICS_API auto BeginCameraReplay(CameraPath camera_path, const float fixed_delta_time = constants::CameraReplayDeltaTime) -> void;
+
+		/**
+		 * \brief Gives the camera back to the input and the scene back to the measured delta time.
+		 */
+		LIBGRAPHICS_API auto EndCameraReplay() -> void;
+
+		/**
+		 * \brief True once every frame of the replayed path has been rendered (or when nothing is being replayed).
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto IsCameraReplayFinished() const -> bool;
+
 	private:
 		Core() = default;
 
+		auto CreateDefaultScene() -> void;
+		auto BuildFrameGraph(const RenderFunction&) -> void;
+		auto RenderSoftwareFrame(const RenderFunction&) -> void;
+		auto CountSceneObjects() const -> void;
+		auto UpdateCameraPath() -> void;
+		auto UpdateModelLoads() -> void;
+
 		std::shared_ptr<EntityManager> m_entity_manager = {};
 
 		float m_delta_time = {};
 
-		std::shared_ptr<class Model> m_entity_model = {};
+		std::shared_ptr<class Entity> m_entity_model = {};
 		std::shared_ptr<class Model> m_entity_model2 = {};
-		std::shared_ptr<GLSkybox> m_sky_box = {};
+		ResourceHandle<GLSkybox> m_sky_box_handle = {};
+		std::shared_ptr<RenderGraph> m_render_graph = {};
 
 		std::vector<std::shared_ptr<Light>> m_lights = {};
 
@@ -1,8 +1,62 @@
 #pragma once
 
+#include <cstddef>
 #include <limits>
+#include <string_view>
 
 namespace libgraphics::constants
 {
 	static constexpr int MaxNumberOfLights = std::numeric_limits<unsigned char>::max();
+
+	// transient render targets not reused by the render graph for this many frames are released
+	static constexpr unsigned RenderGraphPoolMaxUnusedFrames = 120;
+
+	// below this many renderers per partition recording on another thread costs more than it saves
+	static constexpr size_t RenderersPerCommandList = 64;
+
+	// frame capture readback buffers, a frame is handed to the consumer up to CaptureRingSize - 1 frames after being rendered
+	static constexpr unsigned CaptureRingSize = 3;
+
+	// frames the capture writers/encoders can hold before making the producer wait (no frame is ever dropped)
+	static constexpr size_t CaptureMaxQueuedFrames = 8;
+
+	// dynamic resolution: per axis scale range of the 3D scene and the frame time it aims for by default
+	static constexpr float DynamicResolutionMinScale = 0.5f;
+	static constexpr float DynamicResolutionMaxScale = 1.0f;
+	static constexpr float DynamicResolutionTargetFrameMs = 1000.0f / 60.0f;
+
+	// profiler: zones a thread can record before the render thread collects them, frames kept for the window and
+	// the trace export, GPU zones (query pairs) per frame
+	static constexpr size_t ProfilerZonesPerThread = 8192;
+	static constexpr size_t ProfilerFramesHistory = 300;
+	static constexpr size_t ProfilerGpuZonesPerFrame = 64;
+
+	// frames kept by RenderStats for the rolling frame time summary and the sparklines
+	static constexpr size_t RenderStatsHistoryFrames = 240;
+
+	// asynchronous model loads: vertex, index and texel bytes uploaded per frame (at least one mesh or texture is, whatever its size)
+	static constexpr uint64_t ModelUploadBytesPerFrame = 8ull * 1024 * 1024;
+
+	// texture streaming: bytes the streamed textures can keep resident, size (texels) under which levels are always resident,
+	// level bytes uploaded per frame (at least one level is, whatever its size), upload ring segments and file reads in flight
+	static constexpr uint64_t TextureStreamingBudgetBytes = 512ull * 1024 * 1024;
+	static constexpr int TextureStreamingMipTailSize = 128;
+	static constexpr uint64_t TextureStreamingUploadBytesPerFrame = 8ull * 1024 * 1024;
+	static constexpr unsigned TextureStreamingRingSize = 3;
+	static constexpr size_t TextureStreamingMaxReads = 8;
+
+	// imported models are cached there (relative to the working directory) as GPU ready vertices and indices, see mesh_cache.h
+	static constexpr std::string_view MeshCacheDirectory = "cache/meshes";
+
+	// mounted by Core::Init when there is one in the working directory, see asset_archive.h (--pack writes it)
+	static constexpr std::string_view AssetArchivePath = "assets.fzpak";
+
+	// resource manager: bytes loaded per resource type past which the least recently used resources nothing references are evicted
+	static constexpr uint64_t ResourceBudgetBytes = 256ull * 1024 * 1024;
+
+	// hot reload: a changed file is reloaded once it went unchanged this long, editors save in several writes
+	static constexpr uint32_t HotReloadSettleMs = 100;
+
+	// camera path replays advance the scene by this much every frame, so that runs don't depend on the frame times
+	static constexpr float CameraReplayDeltaTime = 1.0f / 60.0f;
 }
\ No newline at end of file
@@ -16,7 +16,8 @@ namespace libgraphics
 		virtual ~Entity() = default;
 		Entity() { AddComponent<Transform>(); }
 
-		auto AddChild(const std::shared_ptr<Entity>& child) -> void;
+		LIBGRAPHICS_API auto AddChild(const std::shared_ptr<Entity>& child) -> void;
+		LIBGRAPHICS_API auto RemoveChildren() -> void;
 		[[nodiscard]] auto& GetChildrens() const { return m_childrens; }
 
 		template <std::derived_from<Component> Component>
@@ -80,13 +81,14 @@ namespace libgraphics
 			m_components.erase(component_type);
 		}
 
-		virtual auto Update(float delta_time) -> void;
-		virtual auto Render() -> void;
+		LIBGRAPHICS_API virtual auto Update(float delta_time) -> void;
+		LIBGRAPHICS_API virtual auto Render() -> void;
 
 		auto SetName(const std::string& name) { m_name = name; }
 		[[nodiscard]] auto& GetName() const { return m_name; }
 
 		[[nodiscard]] auto GetTransformComponent() const { return GetComponent<Transform>(); }
+		[[nodiscard]] auto GetComponentsCount() const -> size_t { return m_components.size(); }
 
 	private:
 		Entity* m_parent = {};
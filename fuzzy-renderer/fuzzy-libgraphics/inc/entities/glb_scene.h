@@ -0,0 +1,97 @@
+#pragma once
+
+#include <asset_archive.h>
+#include <entities/imported_model.h>
+
+#include <glm/mat4x4.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief A binary glTF (.glb) file mapped in memory with its JSON chunk parsed, what the model import reads instead of
+	 * an assimp scene. Accessors are read straight out of the binary chunk: positions, normals, uvs and tangents in one
+	 * strided pass each, 32 bit indices copied as they are, bounds from the accessor min/max, embedded images decoded from
+	 * their buffer views by the import jobs. Node transforms are baked in the vertices, like aiProcess_OptimizeGraph does.
+	 */
+	class GlbScene
+	{
+	public:
+		/**
+		 * \return nothing when the file isn't a GLB or uses what the reader doesn't take (external or data uri buffers,
+		 * sparse or non float attributes, primitives other than triangle lists, missing normals, normal maps without
+		 * tangents), the import falls back to assimp then
+		 */
+		[[nodiscard]] static auto Open(const std::filesystem::path& path) -> std::optional<GlbScene>;
+
+		/**
+		 * \brief Lists the textures and the meshes (one per primitive of every node, in node order) and the nodes, the
+		 * vertices and indices are left to ExtractMesh.
+		 */
+		auto Collect(ImportedModel& out_model, std::vector<ImportedNode>& out_nodes) const -> void;
+
+		/**
+		 * \brief Vertices, indices and bounds of the mesh_idx-th mesh Collect listed, any thread.
+		 */
+		auto ExtractMesh(const size_t mesh_idx, ImportedMesh& out_mesh) const -> void;
+
+	private:
+		struct Accessor
+		{
+			// from the first element, m_stride apart
+			std::span<const uint8_t> m_data = {};
+			size_t m_stride = {};
+			size_t m_count = {};
+			uint32_t m_component_type = {};
+			uint32_t m_components = {};
+			std::optional<BoundingBox> m_bounds = {};
+		};
+
+		struct Primitive
+		{
+			size_t m_position = {};
+			size_t m_normal = {};
+			std::optional<size_t> m_tex_coords = {};
+			std::optional<size_t> m_tangent = {};
+			std::optional<size_t> m_indices = {};
+			std::optional<size_t> m_material = {};
+		};
+
+		struct MaterialTexture
+		{
+			TextureType m_type = {};
+			size_t m_image = {};
+		};
+
+		struct Image
+		{
+			std::string m_source = {};
+			std::optional<EmbeddedImage> m_embedded = {};
+		};
+
+		// a primitive where a node puts it
+		struct MeshInstance
+		{
+			std::string m_name = {};
+			size_t m_primitive = {};
+			glm::mat4 m_transform = {};
+			bool m_is_identity = {};
+		};
+
+		// the accessors and the embedded images are views into it
+		AssetData m_file = {};
+		std::vector<Accessor> m_accessors = {};
+		std::vector<Primitive> m_primitives = {};
+		std::vector<std::vector<MaterialTexture>> m_materials = {};
+		std::vector<Image> m_images = {};
+
+		// depth first from the roots of the scene, nodes and meshes in the order Collect lists them
+		std::vector<ImportedNode> m_scene_nodes = {};
+		std::vector<MeshInstance> m_instances = {};
+	};
+}
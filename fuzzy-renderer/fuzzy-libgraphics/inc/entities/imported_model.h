@@ -0,0 +1,75 @@
+#pragma once
+
+#include <interfaces/imesh.h>
+#include <rendering/mesh_cache.h>
+#include <rendering/texture.h>
+#include <rendering/texture_streamer.h>
+
+#include <glm/mat4x4.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace libgraphics
+{
+	// What the model import produces on the job system, for the readers of the formats it takes (assimp, GLB, mesh
+	// cache). Internal to the library.
+
+	struct ImportedTexture
+	{
+		// texture path relative to the model folder, or the name of an embedded texture
+		std::string m_source = {};
+		TextureType m_type = {};
+
+		// canonical path or content hash, see TextureCache
+		std::string m_cache_key = {};
+
+		// found in the cache by the import, nothing to decode nor upload
+		std::optional<Texture> m_cached_texture = {};
+
+		// decoded RGBA8 texels, released once uploaded
+		std::vector<uint8_t> m_pixels = {};
+		int m_width = {};
+		int m_height = {};
+
+		// mip tail of the cooked .ktx2 next to the image, read instead of decoding it
+		std::optional<StreamableTexture> m_cooked_texture = {};
+
+		// image stored in the model file, a view of the imported file (or of the mesh cache) valid during the import only
+		std::optional<EmbeddedImage> m_embedded = {};
+	};
+
+	struct ImportedMesh
+	{
+		std::string m_name = {};
+		std::vector<Vertex> m_vertices = {};
+		std::vector<uint32_t> m_indices = {};
+		std::optional<BoundingBox> m_bounds = {};
+
+		// indices in ImportedModel::m_textures
+		std::vector<uint32_t> m_textures = {};
+	};
+
+	/**
+	 * \brief A node of the imported scene, kept for the mesh cache
+	 */
+	struct ImportedNode
+	{
+		std::string m_name = {};
+		int32_t m_parent = -1;
+		glm::mat4 m_transform = {};
+
+		// indices in ImportedModel::m_meshes
+		std::vector<uint32_t> m_meshes = {};
+	};
+
+	/**
+	 * \brief A model parsed and decoded on the CPU, nothing left but creating its GL objects.
+	 */
+	struct ImportedModel
+	{
+		std::vector<ImportedTexture> m_textures = {};
+		std::vector<ImportedMesh> m_meshes = {};
+	};
+}
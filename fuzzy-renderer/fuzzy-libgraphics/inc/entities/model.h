@@ -1,12 +1,152 @@
 #pragma once
 
 #include <entities/entity.h>
+#include <rendering/mesh_data.h>
+#include <rendering/texture.h>
+
+#include <atomic>
 
 namespace libgraphics
 {
+	class IMesh;
+	struct ImportedModel;
+
+	/**
+	 * \brief How an import uses the mesh cache (.fzmesh) next to the model file.
+	 */
+	enum class MeshCacheMode : uint8_t
+	{
+		// read when valid, written after importing the file otherwise
+		read_write,
+		// the file is always imported and the cache written over
+		rewrite,
+		// the file is always imported, the cache is neither read nor written
+		bypass
+	};
+
+	/**
+	 * \brief Imports every mesh of a model file (anything assimp reads) through Core::CreateMesh
+	 * \param path model file path
+	 * \param out_meshes receives the meshes, in node order
+	 * \param mesh_data_policy what the meshes keep in system memory once uploaded
+	 * \param mesh_cache_mode bypass to measure or debug the import of the file itself
+	 */
+	LIBGRAPHICS_API auto LoadModel(const std::string_view path, std::vector<std::shared_ptr<IMesh>>& out_meshes, const MeshDataPolicy mesh_data_policy = MeshDataPolicy::keep_positions,
+	                               const MeshCacheMode mesh_cache_mode = MeshCacheMode::read_write) -> void;
+
 	class Model : public Entity
 	{
 	public:
-		explicit Model(const std::string_view path);
+		explicit Model(const std::string_view path, const MeshDataPolicy mesh_data_policy = MeshDataPolicy::keep_positions);
+
+		/**
+		 * \brief One child entity per mesh, for meshes already created (LoadModelAsync)
+		 */
+		Model(const std::string_view name, const std::vector<std::shared_ptr<IMesh>>& meshes);
+
+		/**
+		 * \brief The file the model was read from, empty for models made of meshes created elsewhere
+		 */
+		[[nodiscard]] auto GetSourcePath() const -> const std::string& { return m_source_path; }
+		auto SetSourcePath(std::string source_path) -> void { m_source_path = std::move(source_path); }
+
+		/**
+		 * \brief Swaps in the meshes of a new version of the model. The mesh entities (with their transform) are kept when
+		 * the mesh count is the same, rebuilt otherwise.
+		 */
+		LIBGRAPHICS_API auto ReplaceMeshes(const std::vector<std::shared_ptr<IMesh>>& meshes) -> void;
+
+	private:
+		auto AddMeshEntities(const std::vector<std::shared_ptr<IMesh>>& meshes) -> void;
+
+		std::string m_source_path = {};
+	};
+
+	enum class ModelLoadState
+	{
+		importing,
+		uploading,
+		ready,
+		failed
+	};
+
+	/**
+	 * \brief Progress and result of a Core::LoadModelAsync, shared by the import job and the render thread.
+	 */
+	class ModelLoadHandle
+	{
+	public:
+		ModelLoadHandle(std::string path, const MeshDataPolicy mesh_data_policy);
+		LIBGRAPHICS_API ~ModelLoadHandle();
+		ModelLoadHandle(const ModelLoadHandle&) = delete;
+		ModelLoadHandle& operator=(const ModelLoadHandle&) = delete;
+
+		[[nodiscard]] auto GetPath() const -> const std::string& { return m_path; }
+		[[nodiscard]] auto GetState() const -> ModelLoadState { return m_state.load(std::memory_order_acquire); }
+		[[nodiscard]] auto IsDone() const -> bool { return GetState() == ModelLoadState::ready || GetState() == ModelLoadState::failed; }
+
+		/**
+		 * \brief From 0 to 1, the first half covers the import (meshes extracted and textures decoded), the second the uploads
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetProgress() const -> float;
+
+		/**
+		 * \brief The model, already added to the scene, once ready. Render thread only.
+		 */
+		[[nodiscard]] auto GetModel() const -> const std::shared_ptr<Model>& { return m_model; }
+
+	private:
+		friend class ModelLoader;
+
+		std::string m_path = {};
+		MeshDataPolicy m_mesh_data_policy = {};
+		std::atomic<ModelLoadState> m_state = ModelLoadState::importing;
+
+		// import progress, written by the workers
+		std::atomic<uint32_t> m_imported_items_count = {};
+		std::atomic<uint32_t> m_items_count = {};
+
+		// upload progress, written by the render thread
+		std::atomic<uint64_t> m_uploaded_bytes = {};
+		uint64_t m_upload_bytes = {};
+
+		// handed over by the import job with the uploading state
+		std::unique_ptr<ImportedModel> m_imported_model;
+
+		std::vector<Texture> m_textures = {};
+		std::vector<std::shared_ptr<IMesh>> m_meshes = {};
+		std::shared_ptr<Model> m_model = {};
+	};
+
+	/**
+	 * \brief Runs the asynchronous loads for Core: the file is parsed and its meshes and textures extracted and decoded
+	 * on the job system, the GL objects are then created on the render thread a few per frame.
+	 */
+	class ModelLoader
+	{
+	public:
+		ModelLoader() = default;
+		~ModelLoader();
+		ModelLoader(const ModelLoader&) = delete;
+		ModelLoader& operator=(const ModelLoader&) = delete;
+
+		auto Load(std::string path, const MeshDataPolicy mesh_data_policy = MeshDataPolicy::keep_positions) -> std::shared_ptr<ModelLoadHandle>;
+
+		/**
+		 * \brief Creates textures and meshes of the imported models until budget_bytes are uploaded (at least one per frame,
+		 * whatever its size, so big assets still make progress). Render thread, once per frame.
+		 * \return the models completed this frame
+		 */
+		auto Update(const uint64_t budget_bytes) -> std::vector<std::shared_ptr<Model>>;
+
+		/**
+		 * \brief Fails the loads in flight, the import jobs still running drop their result
+		 */
+		auto CancelAll() -> void;
+
+		[[nodiscard]] auto GetLoads() const -> const std::vector<std::shared_ptr<ModelLoadHandle>>& { return m_loads; }
+
+	private:
+		std::vector<std::shared_ptr<ModelLoadHandle>> m_loads = {};
 	};
 }
@@ -1,19 +1,30 @@
 #pragma once
 
+#include <job_system.h>
 #include <memory>
+#include <span>
 #include <string_view>
 #include <vector>
+#include <rendering/command_list.h>
 
 namespace libgraphics
 {
 	class Entity;
+	class MeshRenderer;
+
+	struct SceneCounts
+	{
+		uint32_t m_entities = {};
+		uint32_t m_components = {};
+	};
 
 	class EntityManager
 	{
 	public:
 		EntityManager() = default;
 
-		auto AddEntity(const std::shared_ptr<Entity>& entity) -> void;
+		LIBGRAPHICS_API auto AddEntity(const std::shared_ptr<Entity>& entity) -> void;
+		LIBGRAPHICS_API auto RemoveEntity(const std::shared_ptr<Entity>& entity) -> void;
 		[[nodiscard]] auto GetEntityByName(std::string_view name) const->std::shared_ptr<Entity>;
 		[[nodiscard]] auto& GetEntities() const { return m_entities; }
 
@@ -31,9 +42,39 @@ namespace libgraphics
 		}
 
 		auto Render() const -> void;
-		auto Update(float delta_time) const -> void;
+		LIBGRAPHICS_API auto Update(float delta_time) const -> void;
+
+		/**
+		 * \brief Gathers the mesh renderers and starts recording them on the job system, one command list per partition.
+		 * Each worker culls its partition against the view, sorts what's left by pipeline/texture/mesh and records it.
+		 * Entities must not be changed until FinishRecording returns.
+		 */
+		auto BeginRecording(const RenderView& view) -> void;
+
+		/**
+		 * \brief Waits for the recording started by BeginRecording (helping the workers meanwhile).
+		 * \return the lists in submission order, valid until the next BeginRecording
+		 */
+		auto FinishRecording() -> std::span<const CommandList>;
+
+		[[nodiscard]] auto GetCulledCount() const -> uint32_t { return m_culled_count.load(std::memory_order_relaxed); }
+		[[nodiscard]] auto GetRecordedRenderersCount() const -> uint32_t { return static_cast<uint32_t>(m_renderers.size()); }
+
+		/**
+		 * \brief Entities (children included) and their components, walks the whole hierarchy.
+		 */
+		[[nodiscard]] auto CountSceneObjects() const -> SceneCounts;
 
 	private:
+		auto CollectRenderers(const Entity& entity) -> void;
+		auto RecordPartition(const RenderView& view, const size_t partition_idx, const size_t begin, const size_t end) -> void;
+
 		std::vector<std::shared_ptr<Entity>> m_entities = {};
+
+		std::vector<const MeshRenderer*> m_renderers = {};
+		std::vector<CommandList> m_command_lists = {};
+		RenderView m_recording_view = {};
+		JobCounter m_recording_counter = {};
+		std::atomic<uint32_t> m_culled_count = {};
 	};
 }
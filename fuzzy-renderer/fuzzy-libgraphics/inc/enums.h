@@ -7,6 +7,8 @@ namespace libgraphics
 	enum class GraphicsAPI
 	{
 		opengl,
+		opengl_headless,
+		software,
 		directx
 		// add more..
 	};
@@ -22,7 +24,9 @@ namespace libgraphics
 	{
 		shaders,
 		textures,
+		meshes,
 		materials,
+		cubemaps,
 
 		max_enum
 	};
@@ -47,7 +51,9 @@ namespace libgraphics
 		{
 		case ResourceType::shaders: return "Shaders";
 		case ResourceType::textures: return "Textures";
+		case ResourceType::meshes: return "Meshes";
 		case ResourceType::materials: return "Materials";
+		case ResourceType::cubemaps: return "Cubemaps";
 		case ResourceType::max_enum: return "Invalid";
 		default: break;
 		}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <framework.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Reports the files written or replaced in a set of directories (not their subdirectories), from inotify on
+	 * Linux and ReadDirectoryChangesW on Windows. The OS is listened to by a thread of its own.
+	 */
+	class FileWatcher
+	{
+	public:
+		LIBGRAPHICS_API FileWatcher();
+		LIBGRAPHICS_API ~FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		/**
+		 * \brief Starts reporting the changes of the files right in directory. Any thread, watching a directory twice
+		 * does nothing.
+		 */
+		LIBGRAPHICS_API auto Watch(const std::filesystem::path& directory) -> void;
+
+		/**
+		 * \brief Files changed since the last call, once no change came for them in settle_time: editors and exporters
+		 * write a file in several steps, it is reported once they are done.
+		 */
+		[[nodiscard]] LIBGRAPHICS_API auto TakeChanges(const std::chrono::milliseconds settle_time) -> std::vector<std::filesystem::path>;
+
+	private:
+		struct WatchedDirectory;
+
+		auto Run() -> void;
+		auto OpenPendingDirectories() -> void;
+		auto ReadEvents() -> void;
+		auto CloseDirectories() -> void;
+		auto AddChange(const std::filesystem::path& path) -> void;
+
+		std::mutex m_mutex = {};
+		std::vector<std::filesystem::path> m_pending_directories = {};
+		std::vector<std::filesystem::path> m_known_directories = {};
+		std::map<std::filesystem::path, std::chrono::steady_clock::time_point> m_changes = {};
+
+		// owned by the watching thread
+		std::vector<std::unique_ptr<WatchedDirectory>> m_directories;
+
+#ifdef _WIN32
+		static auto IssueRead(WatchedDirectory& directory) -> bool;
+#else
+		int m_inotify_fd = -1;
+#endif
+
+		std::atomic<bool> m_is_stopping = {};
+		std::thread m_thread = {};
+	};
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gui/base/gui_window_base.h>
+
+#include <optional>
+
+namespace libgraphics::gui
+{
+	/**
+	 * \brief Frame times of the profiler history and the zones of one frame: a flame chart per thread plus the GPU,
+	 * and a table of the time spent per zone. Clicking a bar of the frame times selects that frame.
+	 */
+	class GUIWindowProfiler : public GUIWindowBase
+	{
+	public:
+		GUIWindowProfiler();
+
+		auto Render() -> void override;
+
+	private:
+		std::optional<uint64_t> m_selected_frame_index = {};
+		float m_zoom = 1.0f;
+		std::string m_export_status = {};
+	};
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <engine_constants.h>
+#include <file_watcher.h>
+#include <framework.h>
+#include <job_system.h>
+#include <entities/model.h>
+#include <rendering/texture_cooker.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace libgraphics
+{
+	class EntityManager;
+	class GLShader;
+
+	/**
+	 * \brief Rebuilds what was loaded from a file when the file changes: the shaders using it are recompiled, the
+	 * texture read from it decoded again (on the job system) and the models read from it imported again (by a model
+	 * loader of its own, so the uploads keep to their budget). The new versions replace the old ones in Update, a
+	 * whole resource at once and between two recordings: the textures keep their storage, which every copy shares, and
+	 * the mesh entities of a model keep their transform, shader and material, so whatever references them sees the new
+	 * version from the next frame on.
+	 * The directories of everything loaded are watched once enabled, loads before then included.
+	 */
+	class HotReloader
+	{
+	public:
+		HotReloader(const HotReloader&) = delete;
+		HotReloader& operator=(const HotReloader&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> HotReloader&;
+
+		/**
+		 * \brief Starts (or stops) watching the files of the resources loaded. Render thread.
+		 */
+		LIBGRAPHICS_API auto SetEnabled(const bool is_enabled) -> void;
+		[[nodiscard]] auto IsEnabled() const -> bool { return m_watcher != nullptr; }
+
+		/**
+		 * \brief Watches the directory of a file a resource was loaded from. Any thread.
+		 */
+		auto WatchFile(const std::filesystem::path& path) -> void;
+
+		/**
+		 * \brief Shaders register themselves when built and leave when deleted. Render thread.
+		 */
+		auto TrackShader(GLShader& shader) -> void;
+		auto UntrackShader(const GLShader& shader) -> void;
+
+		/**
+		 * \brief Starts rebuilding what the files changed since the last call were read by, and swaps in what is
+		 * rebuilt. Render thread, once per frame, while no recording is in flight.
+		 */
+		auto Update(EntityManager& entity_manager) -> void;
+
+		/**
+		 * \brief Drops the reloads in flight and stops watching. Render thread.
+		 */
+		auto Clear() -> void;
+
+		[[nodiscard]] auto GetReloadsCount() const -> size_t { return m_reloads_count; }
+		[[nodiscard]] auto GetFailedReloadsCount() const -> size_t { return m_failed_reloads_count; }
+
+	private:
+		HotReloader();
+		~HotReloader();
+
+		/**
+		 * \brief A texture decoded again by a job, swapped in once m_is_decoded is set.
+		 */
+		struct TextureReload
+		{
+			std::string m_cache_key = {};
+			std::filesystem::path m_path = {};
+			// the image itself changed, its cooked version is out of date and isn't read
+			bool m_use_cooked = {};
+			std::atomic<bool> m_is_decoded = {};
+
+			// the cooked version (all its levels) when there is one, RGBA8 texels otherwise; neither when unreadable
+			std::unique_ptr<CookedTexture> m_cooked_texture = {};
+			std::vector<uint8_t> m_pixels = {};
+			int m_width = {};
+			int m_height = {};
+		};
+
+		auto ReloadShaders(const std::filesystem::path& changed_path) -> void;
+		auto ReloadTextures(const std::filesystem::path& changed_path) -> void;
+		auto ReloadModels(const std::filesystem::path& changed_path, const EntityManager& entity_manager) -> void;
+
+		auto SwapTextures() -> void;
+		auto SwapModels(EntityManager& entity_manager) -> void;
+
+		std::unique_ptr<FileWatcher> m_watcher = {};
+
+		// directories of the files loaded, watched once enabled
+		std::mutex m_mutex = {};
+		std::unordered_set<std::string> m_directories = {};
+
+		std::vector<GLShader*> m_shaders = {};
+		std::vector<std::shared_ptr<TextureReload>> m_texture_reloads = {};
+		std::unique_ptr<ModelLoader> m_model_loader = {};
+		JobCounter m_decode_counter = {};
+
+		size_t m_reloads_count = {};
+		size_t m_failed_reloads_count = {};
+	};
+}
@@ -17,6 +17,12 @@ namespace libgraphics
 		virtual auto Destroy() -> void = 0; 
 		virtual auto Clear() -> void = 0;
 		virtual auto SwapBuffers() -> void = 0;
+		[[nodiscard]] virtual auto ShouldClose() const -> bool = 0;
+
+		/**
+		 * \brief Framebuffer frames end up in (0 is the default one of a visible window)
+		 */
+		[[nodiscard]] virtual auto GetBackbufferID() const -> uint32_t = 0;
 		[[nodiscard]]  virtual auto GetNativeHandle() const -> const std::shared_ptr<IGraphicsContext>& = 0;
 	};
 }
\ No newline at end of file
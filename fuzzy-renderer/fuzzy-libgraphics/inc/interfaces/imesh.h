@@ -5,9 +5,13 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include <span>
+
 namespace libgraphics
 {
     class IShader;
+    class MeshData;
+    class Texture;
 
     struct Vertex
     {
@@ -18,6 +22,15 @@ namespace libgraphics
         glm::vec3 m_bitangent = {};
     };
 
+    /**
+     * \brief Axis aligned box in mesh local space, used for visibility culling.
+     */
+    struct BoundingBox
+    {
+        glm::vec3 m_min = {};
+        glm::vec3 m_max = {};
+    };
+
     class LIBGRAPHICS_API IMesh
     {
     public:
@@ -25,10 +38,16 @@ namespace libgraphics
 
         virtual auto Draw(const std::shared_ptr<IShader>& shader) -> void = 0;
 
-        [[nodiscard]] virtual auto GetVertexBuffer() const->std::vector<Vertex> = 0;
-        [[nodiscard]] virtual auto GetIndexBuffer() const -> std::vector<uint32_t> = 0;
-
-        virtual auto SetVertexBuffer(const std::vector<Vertex>& vertex_buffer) -> void = 0;
-        virtual auto SetIndexBuffer(const std::vector<uint32_t>& index_buffer) -> void = 0;
+        /**
+         * \brief The system memory copy, shared, empty once released after the upload (see MeshDataPolicy)
+         */
+        [[nodiscard]] virtual auto GetData() const -> const std::shared_ptr<const MeshData>& = 0;
+        [[nodiscard]] virtual auto GetVertexBuffer() const -> std::span<const Vertex> = 0;
+        [[nodiscard]] virtual auto GetIndexBuffer() const -> std::span<const uint32_t> = 0;
+
+        [[nodiscard]] virtual auto GetIndexCount() const -> uint32_t = 0;
+        [[nodiscard]] virtual auto GetBounds() const -> const BoundingBox& = 0;
+        [[nodiscard]] virtual auto GetTextures() const -> const std::vector<Texture>& = 0;
+        [[nodiscard]] virtual auto GetName() const -> const std::string& = 0;
     };
 }
\ No newline at end of file
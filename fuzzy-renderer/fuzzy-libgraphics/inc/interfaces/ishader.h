@@ -1,6 +1,7 @@
 #pragma once
 
 #include <framework.h>
+#include <glad/gl.h>
 #include <glm/glm.hpp>
 
 namespace libgraphics
@@ -17,6 +18,11 @@ namespace libgraphics
         virtual auto SetInt(const std::string_view name, const int value) -> void = 0;
         virtual auto SetUint(const std::string_view name, const uint32_t value) -> void = 0;
         virtual auto SetBool(const std::string_view name, const bool value) -> void = 0;
+        /**
+         * \brief Slot of a constant (uniform location for GL), negative when the shader doesn't use it.
+         * Safe to call from any thread once the shader is built.
+         */
+        [[nodiscard]] virtual auto GetConstantSlot(const std::string_view name) const -> int32_t = 0;
         virtual auto GetID() const -> GLuint = 0;
         virtual auto GetLightsBufferID() const -> GLuint = 0;
     };
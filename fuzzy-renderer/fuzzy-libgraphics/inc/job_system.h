@@ -0,0 +1,95 @@
+#pragma once
+
+#include <framework.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace libgraphics
+{
+	using Job = std::function<void()>;
+
+	/**
+	 * \brief Counts the jobs of a group still in flight, Wait() on it to join them. The first exception thrown by one
+	 * of them is kept for Wait to rethrow.
+	 */
+	struct JobCounter
+	{
+		std::atomic<uint32_t> m_pending = {};
+
+		std::mutex m_exception_mutex = {};
+		std::exception_ptr m_exception = {};
+	};
+
+	/**
+	 * \brief Fixed pool of worker threads pulling from a shared queue.
+	 * Waiting threads help executing queued jobs, so nested Dispatch/Wait from inside a job can't deadlock. Long jobs
+	 * (imports, file decodes) go to a background queue only the workers take from, once the shared one is empty: a
+	 * thread waiting on a short job can't end up running one of them.
+	 */
+	class JobSystem
+	{
+	public:
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		~JobSystem();
+
+		LIBGRAPHICS_API static auto GetInstance() -> JobSystem&;
+
+		/**
+		 * \brief Runs the queued jobs and joins the workers. Called by Core::Shutdown: joining threads from the
+		 * destructor of a static, while the process unloads the library, can deadlock on the loader lock. Jobs dispatched
+		 * afterwards run right away on the dispatching thread.
+		 */
+		LIBGRAPHICS_API auto Shutdown() -> void;
+
+		/**
+		 * \brief Queues a job, counter (optional) is incremented now and decremented once the job has run.
+		 */
+		LIBGRAPHICS_API auto Dispatch(Job job, JobCounter* counter = nullptr) -> void;
+
+		/**
+		 * \brief Queues a long job on the background queue, see Dispatch.
+		 */
+		LIBGRAPHICS_API auto DispatchBackground(Job job, JobCounter* counter = nullptr) -> void;
+
+		/**
+		 * \brief Blocks until the counter reaches zero, running jobs of the shared queue in the meantime. Rethrows the
+		 * first exception a job of the counter threw (once, the counter can be used again).
+		 */
+		LIBGRAPHICS_API auto Wait(JobCounter& counter) -> void;
+
+		/**
+		 * \brief Splits [0, count) in ranges of at least min_batch_size and runs range_function(begin, end) on them in parallel.
+		 * Returns when every range has been processed.
+		 */
+		LIBGRAPHICS_API auto ParallelFor(const size_t count, const size_t min_batch_size, const std::function<void(size_t, size_t)>& range_function) -> void;
+
+		[[nodiscard]] auto GetWorkersCount() const -> size_t { return m_workers.size(); }
+
+	private:
+		JobSystem();
+
+		struct QueuedJob
+		{
+			Job m_job = {};
+			JobCounter* m_counter = {};
+		};
+
+		auto Enqueue(std::deque<QueuedJob>& queue, Job job, JobCounter* counter) -> void;
+		static auto RunJob(QueuedJob& queued_job) -> void;
+		auto TryRunOne() -> bool;
+		auto WorkerLoop() -> void;
+
+		std::vector<std::thread> m_workers = {};
+		std::deque<QueuedJob> m_queue = {};
+		std::deque<QueuedJob> m_background_queue = {};
+		std::mutex m_queue_mutex = {};
+		std::condition_variable m_queue_condition = {};
+		bool m_stop = {};
+	};
+}
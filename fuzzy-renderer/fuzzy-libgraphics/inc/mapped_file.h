@@ -0,0 +1,43 @@
+#pragma once
+
+#include <framework.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Read only memory mapping of a whole file, its pages are read by the OS as they are first touched.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		LIBGRAPHICS_API ~MappedFile();
+		LIBGRAPHICS_API MappedFile(MappedFile&& other) noexcept;
+		LIBGRAPHICS_API MappedFile& operator=(MappedFile&& other) noexcept;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * \return nothing when the file is missing, empty or can't be mapped
+		 */
+		LIBGRAPHICS_API static auto Open(const std::filesystem::path& path) -> std::optional<MappedFile>;
+
+		[[nodiscard]] auto GetData() const -> std::span<const uint8_t> { return { m_data, m_size }; }
+
+	private:
+		auto Close() -> void;
+
+		const uint8_t* m_data = {};
+		size_t m_size = {};
+
+#ifdef _WIN32
+		void* m_file = {};
+		void* m_mapping = {};
+#endif
+	};
+}
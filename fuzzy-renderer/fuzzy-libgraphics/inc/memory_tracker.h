@@ -0,0 +1,166 @@
+#pragma once
+
+#include <framework.h>
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace libgraphics
+{
+	enum class MemoryCategory
+	{
+		vertex_buffer,
+		index_buffer,
+		uniform_buffer,
+		storage_buffer,
+		readback_buffer,
+		upload_buffer,
+		texture,
+		render_target,
+		mesh_cpu_copy,
+
+		max_enum
+	};
+
+	LIBGRAPHICS_API auto MemoryCategoryToString(const MemoryCategory category) -> std::string_view;
+
+	/**
+	 * \brief Everything but the CPU copies of the meshes lives in GL objects.
+	 */
+	[[nodiscard]] constexpr auto IsGpuMemory(const MemoryCategory category) -> bool { return category != MemoryCategory::mesh_cpu_copy; }
+
+	/**
+	 * \brief Bytes of a 2D texture, with its whole mip chain when has_mips (down to 1x1).
+	 */
+	LIBGRAPHICS_API auto ComputeTextureBytes(const int width, const int height, const size_t bytes_per_texel, const bool has_mips) -> uint64_t;
+
+	struct MemoryAllocationInfo
+	{
+		uint64_t m_id = {};
+		MemoryCategory m_category = {};
+		uint64_t m_bytes = {};
+		std::string m_owner = {};
+		std::string m_detail = {};
+	};
+
+	struct MemoryCategoryTotals
+	{
+		uint64_t m_bytes = {};
+		uint64_t m_peak_bytes = {};
+		uint32_t m_allocations_count = {};
+	};
+
+	struct MemoryConsumer
+	{
+		std::string m_owner = {};
+		uint64_t m_cpu_bytes = {};
+		uint64_t m_gpu_bytes = {};
+		uint32_t m_allocations_count = {};
+	};
+
+	/**
+	 * \brief Registry of the live buffers, textures and mesh copies of the engine: byte size, category and owner asset
+	 * of each. Allocations are registered by the objects owning them through TrackedMemory, from any thread.
+	 */
+	class MemoryTracker
+	{
+	public:
+		MemoryTracker(const MemoryTracker&) = delete;
+		MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> MemoryTracker&;
+
+		LIBGRAPHICS_API [[nodiscard]] auto GetCategoryTotals() const -> std::array<MemoryCategoryTotals, static_cast<size_t>(MemoryCategory::max_enum)>;
+		LIBGRAPHICS_API [[nodiscard]] auto GetCpuBytes() const -> uint64_t;
+		LIBGRAPHICS_API [[nodiscard]] auto GetGpuBytes() const -> uint64_t;
+
+		/**
+		 * \brief Owners sorted by their total (CPU + GPU) bytes, the biggest first.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetTopConsumers(const size_t count) const -> std::vector<MemoryConsumer>;
+
+		/**
+		 * \brief Id the next allocation will get. Allocations are numbered in order, so a checkpoint taken before
+		 * loading something and GetAllocations(checkpoint) after unloading it lists what was leaked.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetCheckpoint() const -> uint64_t;
+
+		/**
+		 * \brief The live allocations registered since checkpoint, in registration order.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetAllocations(const uint64_t checkpoint = 0) const -> std::vector<MemoryAllocationInfo>;
+
+		/**
+		 * \brief Logs the live allocations registered since checkpoint, grouped by owner.
+		 * \return how many there are
+		 */
+		LIBGRAPHICS_API auto LogAllocations(const uint64_t checkpoint = 0) const -> size_t;
+
+	private:
+		friend class TrackedMemory;
+
+		MemoryTracker() = default;
+
+		auto Register(const MemoryCategory category, const uint64_t bytes, std::string detail) -> uint64_t;
+		auto Resize(const uint64_t id, const uint64_t bytes) -> void;
+		auto Release(const uint64_t id) -> void;
+		[[nodiscard]] auto GetBytes(const uint64_t id) const -> uint64_t;
+
+		mutable std::mutex m_mutex = {};
+		std::unordered_map<uint64_t, MemoryAllocationInfo> m_allocations = {};
+		std::array<MemoryCategoryTotals, static_cast<size_t>(MemoryCategory::max_enum)> m_totals = {};
+		uint64_t m_next_id = 1;
+	};
+
+	/**
+	 * \brief Names the asset the allocations registered by this thread belong to while the scope lives (model path,
+	 * generated scene spec...). Scopes nest, the innermost wins. Without a scope the owner is the allocation detail.
+	 */
+	class MemoryOwnerScope
+	{
+	public:
+		LIBGRAPHICS_API explicit MemoryOwnerScope(std::string owner);
+		LIBGRAPHICS_API ~MemoryOwnerScope();
+		MemoryOwnerScope(const MemoryOwnerScope&) = delete;
+		MemoryOwnerScope& operator=(const MemoryOwnerScope&) = delete;
+
+	private:
+		std::string m_previous_owner = {};
+	};
+
+	/**
+	 * \brief One registered allocation, released with the object owning it. Move only.
+	 */
+	class TrackedMemory
+	{
+	public:
+		TrackedMemory() = default;
+		LIBGRAPHICS_API TrackedMemory(const MemoryCategory category, const uint64_t bytes, std::string detail);
+		LIBGRAPHICS_API ~TrackedMemory();
+
+		TrackedMemory(const TrackedMemory&) = delete;
+		TrackedMemory& operator=(const TrackedMemory&) = delete;
+		TrackedMemory(TrackedMemory&& other) noexcept : m_id{ std::exchange(other.m_id, 0) } {}
+		LIBGRAPHICS_API auto operator=(TrackedMemory&& other) noexcept -> TrackedMemory&;
+
+		/**
+		 * \brief The object reallocated its storage (a buffer grown, a render target resized).
+		 */
+		LIBGRAPHICS_API auto Resize(const uint64_t bytes) -> void;
+
+		LIBGRAPHICS_API auto Reset() -> void;
+
+		/**
+		 * \brief 0 once reset
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetBytes() const -> uint64_t;
+
+	private:
+		uint64_t m_id = {};
+	};
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <rendering/command_list.h>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Replays command lists on the GL context thread. Every command maps to the driver call(s) it stands for,
+	 * state changes still go through the GLStateCache so lists recorded in isolation don't rebind what's already bound.
+	 */
+	class GLCommandExecutor
+	{
+	public:
+		static auto Execute(const CommandList& command_list) -> void;
+	};
+}
@@ -19,6 +19,11 @@ namespace libgraphics
 		auto Data() -> ContextData& override { return m_context_data; }
 		[[nodiscard]] auto GetNativeHandle() const -> void* override { return reinterpret_cast<GLFWwindow*>(m_glfw_native_window_handle); }
 
+		/**
+		 * \brief Default pipeline state every GL context starts with (depth test, face culling, viewport)
+		 */
+		static auto SetupDefaultState(const int width, const int height) -> void;
+
 	private:
 
 		GLFWwindow* m_glfw_native_window_handle = {};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory_tracker.h>
+#include <rendering/resolution_controller.h>
+
+#include <glad/gl.h>
+
+#include <array>
+#include <memory>
+
+namespace libgraphics
+{
+	class GLShader;
+
+	/**
+	 * \brief Renders the 3D scene in an offscreen color/depth pair at a fraction of the output resolution.
+	 * The targets are allocated at the output size and the scene only uses their bottom-left corner (the viewport),
+	 * so a new scale never reallocates anything. GPU frame times come from GL_TIME_ELAPSED queries read a few frames
+	 * later (never waited on) and drive a ResolutionController. Upscale() stretches the rendered area back to the
+	 * output with a bilinear filter and an optional contrast limited sharpening.
+	 */
+	class GLDynamicResolution
+	{
+	public:
+		explicit GLDynamicResolution(const float target_frame_ms = constants::DynamicResolutionTargetFrameMs);
+		~GLDynamicResolution();
+
+		GLDynamicResolution(const GLDynamicResolution&) = delete;
+		GLDynamicResolution& operator=(const GLDynamicResolution&) = delete;
+
+		/**
+		 * \brief Collects the finished timings, updates the scale and starts timing this frame.
+		 */
+		auto BeginFrame() -> void;
+		auto EndFrame() -> void;
+
+		/**
+		 * \brief Computes this frame's render size, (re)allocates the targets when the output size changes (returns true then).
+		 */
+		auto PrepareTargets(const int output_width, const int output_height) -> bool;
+
+		/**
+		 * \brief Draws the rendered area into the bound framebuffer, stretched over the output size.
+		 */
+		auto Upscale() const -> void;
+
+		auto SetSharpness(const float sharpness) -> void { m_sharpness = sharpness; }
+
+		[[nodiscard]] auto GetColorTexture() const -> GLuint { return m_color_texture; }
+		[[nodiscard]] auto GetDepthTexture() const -> GLuint { return m_depth_texture; }
+		[[nodiscard]] auto GetRenderWidth() const -> int { return m_render_width; }
+		[[nodiscard]] auto GetRenderHeight() const -> int { return m_render_height; }
+		[[nodiscard]] auto GetController() -> ResolutionController& { return m_controller; }
+		[[nodiscard]] auto GetController() const -> const ResolutionController& { return m_controller; }
+		[[nodiscard]] auto GetLastGpuFrameMs() const -> float { return m_last_gpu_frame_ms; }
+
+	private:
+		static constexpr auto QueriesCount = 4;
+
+		auto ReleaseTargets() -> void;
+
+		ResolutionController m_controller;
+		std::shared_ptr<GLShader> m_upscale_shader = {};
+		GLuint m_empty_vao = {};
+
+		GLuint m_color_texture = {};
+		GLuint m_depth_texture = {};
+		TrackedMemory m_targets_memory = {};
+		int m_output_width = {};
+		int m_output_height = {};
+		int m_render_width = {};
+		int m_render_height = {};
+		float m_sharpness = 0.2f;
+
+		std::array<GLuint, QueriesCount> m_queries = {};
+		std::array<bool, QueriesCount> m_is_query_pending = {};
+		size_t m_next_query = {};
+		size_t m_oldest_query = {};
+		bool m_is_timing = {};
+		float m_last_gpu_frame_ms = {};
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <engine_constants.h>
+#include <memory_tracker.h>
+#include <rendering/captured_frame.h>
+
+#include <glad/gl.h>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Asynchronous framebuffer readback through a ring of persistently mapped pixel buffer objects.
+	 * Capture() only queues the copy (and a fence) on the GPU, Poll() hands the frames whose fence has signaled
+	 * to the callback, oldest first, without ever waiting. With a ring of N buffers a frame is delivered up to
+	 * N - 1 frames later; the render thread only blocks when all of them are still in flight.
+	 */
+	class GLFrameCapture
+	{
+	public:
+		LIBGRAPHICS_API explicit GLFrameCapture(CaptureCallback callback, const uint32_t ring_size = constants::CaptureRingSize);
+		LIBGRAPHICS_API ~GLFrameCapture();
+
+		GLFrameCapture(const GLFrameCapture&) = delete;
+		GLFrameCapture& operator=(const GLFrameCapture&) = delete;
+
+		/**
+		 * \brief Queues the copy of the color buffer of framebuffer_id (0 is the back buffer). The ring is reallocated
+		 * (after delivering what's in flight) when the size changes.
+		 */
+		LIBGRAPHICS_API auto Capture(const GLuint framebuffer_id, const int width, const int height) -> void;
+
+		/**
+		 * \brief Delivers the completed frames, never blocks. Call it once per frame.
+		 */
+		LIBGRAPHICS_API auto Poll() -> void;
+
+		/**
+		 * \brief Blocks until every queued frame has been delivered.
+		 */
+		LIBGRAPHICS_API auto Flush() -> void;
+
+		[[nodiscard]] auto GetCapturedFramesCount() const -> uint64_t { return m_frame_index; }
+
+		/**
+		 * \brief Number of times Capture had to wait for a buffer of the ring (the consumer is too slow or the ring too small)
+		 */
+		[[nodiscard]] auto GetStallsCount() const -> uint64_t { return m_stalls_count; }
+
+	private:
+		struct Slot
+		{
+			GLuint m_buffer = {};
+			const uint8_t* m_mapped = {};
+			GLsync m_fence = {};
+			uint64_t m_frame_index = {};
+			TrackedMemory m_memory = {};
+		};
+
+		auto Allocate(const int width, const int height) -> void;
+		auto Release() -> void;
+
+		/**
+		 * \brief Delivers the oldest slot in flight, returns false (and leaves it queued) if its copy isn't done yet
+		 */
+		auto DeliverOldest(const bool wait) -> bool;
+
+		CaptureCallback m_callback = {};
+		std::vector<Slot> m_slots = {};
+		uint32_t m_ring_size = {};
+		size_t m_next_slot = {};
+		size_t m_pending_count = {};
+		int m_width = {};
+		int m_height = {};
+		uint64_t m_frame_index = {};
+		uint64_t m_stalls_count = {};
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "interfaces/igraphics_context.h"
+
+struct GLFWwindow;
+
+namespace libgraphics
+{
+	/**
+	 * \brief GL context without any visible window: a hidden GLFW window, so a display (a window station on Windows)
+	 * and a GL driver are still required. Rendering without any display server (EGL + Mesa llvmpipe) isn't supported.
+	 * Nothing is presented: rendering targets the framebuffer owned by GLHeadlessWindow.
+	 */
+	class GLHeadlessContext : public IGraphicsContext
+	{
+	public:
+		GLHeadlessContext() = default;
+		GLHeadlessContext(const GLHeadlessContext&) = delete;
+		GLHeadlessContext(GLHeadlessContext&&) = delete;
+
+		auto Init(const int width, const int height, const std::string_view title) -> void override;
+		auto Shutdown() -> void override;
+		auto Data() const -> const ContextData& override { return m_context_data; }
+		auto Data() -> ContextData& override { return m_context_data; }
+
+		/**
+		 * \brief The hidden GLFWwindow
+		 */
+		[[nodiscard]] auto GetNativeHandle() const -> void* override;
+
+		[[nodiscard]] auto IsValid() const -> bool { return m_is_valid; }
+
+	private:
+		ContextData m_context_data = {};
+		bool m_is_valid = {};
+
+		GLFWwindow* m_glfw_native_window_handle = {};
+
+		const int MajorVersion = 4;
+		const int MinorVersion = 6;
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <interfaces/igraphics_window.h>
+#include <color.h>
+#include <memory_tracker.h>
+
+#include <glad/gl.h>
+
+namespace libgraphics
+{
+	class IGraphicsContext;
+
+	/**
+	 * \brief Offscreen "window": a headless context plus a framebuffer of the requested size (RGBA8 color, depth24/stencil8).
+	 * Frames never get presented, read them back with ReadPixels (or sample the color texture).
+	 */
+	class GLHeadlessWindow final : public IGraphicsWindow
+	{
+	public:
+		auto Create(const int width, const int height, const std::string_view title) -> void override;
+		auto Destroy() -> void override;
+		auto Clear() -> void override;
+		auto SwapBuffers() -> void override;
+		[[nodiscard]] auto ShouldClose() const -> bool override { return false; }
+		[[nodiscard]] auto GetBackbufferID() const -> uint32_t override { return m_framebuffer; }
+		[[nodiscard]] auto GetNativeHandle() const -> const std::shared_ptr<IGraphicsContext>& override { return m_graphics_context; }
+		auto SetClearColor(const Color&) -> void override;
+
+		[[nodiscard]] auto GetColorTextureID() const -> GLuint { return m_color_texture; }
+
+		/**
+		 * \brief Synchronous read of the last frame, tightly packed RGBA8 rows, bottom row first.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto ReadPixels() const -> std::vector<uint8_t>;
+
+	private:
+		auto CreateFramebuffer(const int width, const int height) -> void;
+
+		Color m_clear_color = {};
+		std::shared_ptr<IGraphicsContext> m_graphics_context;
+
+		GLuint m_framebuffer = {};
+		GLuint m_color_texture = {};
+		GLuint m_depth_renderbuffer = {};
+		TrackedMemory m_framebuffer_memory = {};
+	};
+}
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <interfaces/imesh.h>
+#include <memory_tracker.h>
 #include <opengl/gl_shader.h>
+#include <rendering/mesh_data.h>
 #include <rendering/texture.h>
 
+#include <optional>
+
 namespace libgraphics
 {
 	class Entity;
@@ -12,11 +16,6 @@ namespace libgraphics
 	{
 	public:
 
-		/**
-		 * \brief Default constructor of Mesh (use SetVertexBuffer and SetIndexBuffer)
-		 */
-		LIBGRAPHICS_API GLMesh() = default;
-
 		/**
 		 * \brief Creates raw mesh
 		 * \param vertices vertices of mesh
@@ -30,9 +29,20 @@ namespace libgraphics
 		 * \param indices indices of mesh
 		 * \param textures textures of mesh (albedo, metallic, roughness etc..)
 		 * \param name name of mesh (optional)
+		 * \param bounds bounds of the vertices when already known (mesh cache), computed otherwise
+		 * \param data_policy what is kept in system memory once uploaded
 		 */
 		LIBGRAPHICS_API GLMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices,
-		                       std::vector<Texture> textures, std::string name);
+		                       std::vector<Texture> textures, std::string name, const std::optional<BoundingBox>& bounds = {},
+		                       const MeshDataPolicy data_policy = MeshDataPolicy::keep_positions);
+
+		/**
+		 * \brief Deletes the vertex array and buffers, the GL context must still be current
+		 */
+		LIBGRAPHICS_API ~GLMesh() override;
+
+		GLMesh(const GLMesh&) = delete;
+		GLMesh& operator=(const GLMesh&) = delete;
 
 		/**
 		 * \brief Standard Draw for a mesh 
@@ -41,53 +51,77 @@ namespace libgraphics
 		LIBGRAPHICS_API auto Draw(const std::shared_ptr<IShader>& shader) -> void override;
 
 		/**
-		 * \brief Get this mesh vertex buffer
-		 * \return Value reference vector containing all mesh vertices
+		 * \brief Issues the draw call only, program, constants, textures and lights must already be set
+		 * \param instance_count number of instances to draw
 		 */
-		LIBGRAPHICS_API  [[nodiscard]] auto GetVertexBuffer() const -> std::vector<Vertex> override { return m_vertices; }
+		auto Submit(const uint32_t instance_count) const -> void;
 
 		/**
-		 * \brief Get this mesh index buffer
-		 * \return Value reference vector containing all mesh normals
+		 * \brief Get the system memory copy of this mesh, shared with whoever holds it
+		 * \return nullptr once discarded after the upload
 		 */
-		LIBGRAPHICS_API  [[nodiscard]] auto GetIndexBuffer() const -> std::vector<uint32_t> override { return m_indices; }
+		LIBGRAPHICS_API [[nodiscard]] auto GetData() const -> const std::shared_ptr<const MeshData>& override { return m_data; }
 
 		/**
-		 * \brief Set this mesh vertex buffer
+		 * \brief Get this mesh vertex buffer, without copying
+		 * \return View of all mesh vertices, empty unless they are all kept after the upload
 		 */
-		LIBGRAPHICS_API auto SetVertexBuffer(const std::vector<Vertex>& vertices) -> void override { m_vertices = vertices; }
+		LIBGRAPHICS_API [[nodiscard]] auto GetVertexBuffer() const -> std::span<const Vertex> override { return m_data ? m_data->GetVertices() : std::span<const Vertex>{}; }
 
 		/**
-		 * \brief Set this mesh index buffer
+		 * \brief Get this mesh index buffer, without copying
+		 * \return View of all mesh indices, empty once discarded after the upload
 		 */
-		LIBGRAPHICS_API auto SetIndexBuffer(const std::vector<uint32_t>& indices) -> void override { m_indices = indices; }
+		LIBGRAPHICS_API [[nodiscard]] auto GetIndexBuffer() const -> std::span<const uint32_t> override { return m_data ? m_data->GetIndices() : std::span<const uint32_t>{}; }
+
+		/**
+		 * \brief Get the number of indices without copying the index buffer
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetIndexCount() const -> uint32_t override { return m_index_count; }
+
+		/**
+		 * \brief Get the local space bounds of this mesh, computed when the vertices are set
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetBounds() const -> const BoundingBox& override { return m_bounds; }
 
 		/**
 		 * \brief Get this mesh texture buffer
 		 * \return Value reference vector containing all mesh textures (if any)
 		 */
-		LIBGRAPHICS_API [[nodiscard]] auto GetTextures() -> std::vector<Texture> { return m_textures; }
+		LIBGRAPHICS_API [[nodiscard]] auto GetTextures() const -> const std::vector<Texture>& override { return m_textures; }
 
 		/**
 		 * \brief Get this mesh name
 		 * \return String representing low-level mesh name
 		 */
-		LIBGRAPHICS_API [[nodiscard]] auto GetName() const -> const std::string& { return m_name; }
+		LIBGRAPHICS_API [[nodiscard]] auto GetName() const -> const std::string& override { return m_name; }
 
 	private:
-		std::vector<Vertex> m_vertices = {};
-		std::vector<uint32_t> m_indices = {};
+		std::shared_ptr<const MeshData> m_data = {};
 		std::vector<Texture> m_textures = {};
 
+		// the buffers are drawn with these whatever is kept of the data
+		uint32_t m_vertex_count = {};
+		uint32_t m_index_count = {};
+
 		std::string m_name = { };
 
+		BoundingBox m_bounds = {};
+
 		unsigned int m_vao = {};
 		unsigned int m_vbo = {};
 		unsigned int m_ebo = {};
 
+		// the data accounts for the system memory side
+		TrackedMemory m_vertex_memory = {};
+		TrackedMemory m_index_memory = {};
+
 		static auto SendGPUData(const unsigned slot, const int slot_size, const unsigned attrib_array_index, const void* ptr) -> void;
 		auto GenerateVaoVboEbo() -> void;
 		auto GenerateMeshDataAndSendToGPU() -> void;
-		auto GenerateIndexBuffer() const -> void;
+		auto GenerateIndexBuffer() -> void;
+		auto ComputeBounds() -> void;
+		auto SetData(std::vector<Vertex> vertices, std::vector<uint32_t> indices) -> void;
+		auto ApplyDataPolicy(const MeshDataPolicy data_policy) -> void;
 	};
 }
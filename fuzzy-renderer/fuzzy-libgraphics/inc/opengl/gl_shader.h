@@ -2,31 +2,83 @@
 
 #include <glad/gl.h>
 #include <interfaces/ishader.h>
+#include <memory_tracker.h>
+#include <opengl/gl_state_cache.h>
+#include <rendering/render_stats.h>
+
+#include <unordered_map>
 
 namespace libgraphics
 {
+	struct Light;
+
+	/**
+	 * \brief Lets unordered_map<std::string, ..> be searched with a string_view without building a string.
+	 */
+	struct TransparentStringHash
+	{
+		using is_transparent = void;
+		auto operator()(const std::string_view value) const -> size_t { return std::hash<std::string_view>{}(value); }
+	};
+
 	class GLShader final : public IShader
 	{
 	public:
 		GLShader() = default;
 		GLShader(const std::string_view vertex, const std::string_view fragment);
+		~GLShader() override;
+		GLShader(const GLShader&) = delete;
+		GLShader& operator=(const GLShader&) = delete;
+
+		/**
+		 * \brief Rebuilds the program from its files, the previous one is deleted once the new one links. Render thread,
+		 * between two recordings.
+		 * \return false when a stage doesn't compile or link, the previous program is kept then
+		 */
+		auto Reload() -> bool;
+
+		[[nodiscard]] auto GetVertexPath() const -> const std::string& { return m_vertex_path; }
+		[[nodiscard]] auto GetFragmentPath() const -> const std::string& { return m_fragment_path; }
 
-		auto Bind() const -> void override { glUseProgram(m_program_id); }
-		auto Unbind() const -> void override { glUseProgram(0); }
+		auto Bind() const -> void override { GLStateCache::GetInstance().UseProgram(m_program_id); }
+		auto Unbind() const -> void override { GLStateCache::GetInstance().UseProgram(0); }
 		auto AllocateLightsBuffer(const std::string& uniform_block_name) -> void;
 
-		auto SetMatrix4x4(const std::string_view name, const glm::mat4& m) -> void override { glUniformMatrix4fv(glGetUniformLocation(m_program_id, name.data()), 1, false, &m[0][0]); }
-		auto SetFloat(const std::string_view name, const float value) -> void override { glUniform1f(glGetUniformLocation(m_program_id, name.data()), value); }
-		auto SetVec3(const std::string_view name, const glm::vec3& value) -> void override { glUniform3fv(glGetUniformLocation(m_program_id, name.data()), 1, &value[0]); }
-		auto SetInt(const std::string_view name, const int value) -> void override { glUniform1i(glGetUniformLocation(m_program_id, name.data()), value); }
-		auto SetUint(const std::string_view name, const uint32_t value) -> void override { glUniform1ui(glGetUniformLocation(m_program_id, name.data()), value); }
-		auto SetBool(const std::string_view name, const bool value) -> void override { glUniform1i(glGetUniformLocation(m_program_id, name.data()), value); }
+		/**
+		 * \brief Packs the lights and uploads them to the lights uniform buffer, once per frame is enough.
+		 */
+		auto UploadLights(const std::vector<std::shared_ptr<Light>>& lights) const -> void;
 
+		auto SetMatrix4x4(const std::string_view name, const glm::mat4& m) -> void override { RenderStats::GetInstance().CountUniformUpload(); glUniformMatrix4fv(GetUniformLocation(name), 1, false, &m[0][0]); }
+		auto SetFloat(const std::string_view name, const float value) -> void override { RenderStats::GetInstance().CountUniformUpload(); glUniform1f(GetUniformLocation(name), value); }
+		auto SetVec3(const std::string_view name, const glm::vec3& value) -> void override { RenderStats::GetInstance().CountUniformUpload(); glUniform3fv(GetUniformLocation(name), 1, &value[0]); }
+		auto SetInt(const std::string_view name, const int value) -> void override { RenderStats::GetInstance().CountUniformUpload(); glUniform1i(GetUniformLocation(name), value); }
+		auto SetUint(const std::string_view name, const uint32_t value) -> void override { RenderStats::GetInstance().CountUniformUpload(); glUniform1ui(GetUniformLocation(name), value); }
+		auto SetBool(const std::string_view name, const bool value) -> void override { RenderStats::GetInstance().CountUniformUpload(); glUniform1i(GetUniformLocation(name), value); }
+
+		[[nodiscard]] auto GetConstantSlot(const std::string_view name) const -> int32_t override { return GetUniformLocation(name); }
 		auto GetID() const -> GLuint override { return m_program_id; }
 		auto GetLightsBufferID() const -> GLuint override { return m_lights_buffer; }
 
+		/**
+		 * \brief Location of an active uniform, looked up in the table built at link time (-1 when not active).
+		 */
+		[[nodiscard]] auto GetUniformLocation(const std::string_view name) const -> GLint;
+
 	private:
+		auto CacheUniformLocations() -> void;
+
+		std::string m_vertex_path = {};
+		std::string m_fragment_path = {};
+
 		GLuint m_program_id = {};
 		GLuint m_lights_buffer = {};
+		// reset next to each glDeleteBuffers of m_lights_buffer, never on its own
+		TrackedMemory m_lights_buffer_memory = {};
+
+		// slots written by the previous upload, cleared when the lights get fewer
+		mutable size_t m_uploaded_lights_count = {};
+
+		std::unordered_map<std::string, GLint, TransparentStringHash, std::equal_to<>> m_uniform_locations = {};
 	};
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <framework.h>
+#include <memory_tracker.h>
 
 namespace libgraphics
 {
@@ -10,6 +11,9 @@ namespace libgraphics
 	{
 	public:
 		GLSkybox();
+		~GLSkybox();
+		GLSkybox(const GLSkybox&) = delete;
+		GLSkybox& operator=(const GLSkybox&) = delete;
 		auto Render(const std::shared_ptr<IShader>& shader) const -> void;
 
 	private:
@@ -19,5 +23,7 @@ namespace libgraphics
 		uint32_t m_cube_vao = {}, m_cube_vbo = {};
 		uint32_t m_sky_vao = {}, m_sky_vbo = {};
 		uint32_t m_cubemap_tex_id = {};
+		TrackedMemory m_vbo_memory = {};
+		TrackedMemory m_cubemap_memory = {};
 	};
 }
\ No newline at end of file
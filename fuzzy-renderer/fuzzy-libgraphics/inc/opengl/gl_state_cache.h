@@ -0,0 +1,107 @@
+#pragma once
+
+#include <framework.h>
+#include <glad/gl.h>
+
+#include <array>
+#include <optional>
+
+namespace libgraphics
+{
+	struct GLStateCounters
+	{
+		uint32_t m_issued = {};
+		uint32_t m_elided = {};
+	};
+
+	/**
+	 * \brief Shadow copy of the GL state the engine touches. Every bind/enable goes through here and is
+	 * skipped when it wouldn't change anything. Unknown state (after Invalidate) is always issued.
+	 * Objects must be deleted through the Delete* functions so recycled names are never considered bound.
+	 */
+	class GLStateCache
+	{
+	public:
+		GLStateCache(const GLStateCache&) = delete;
+		GLStateCache& operator=(const GLStateCache&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> GLStateCache&;
+
+		// exported, GLShader::Bind and Unbind are inline and called from the client
+		LIBGRAPHICS_API auto UseProgram(const GLuint program) -> void;
+		auto BindVertexArray(const GLuint vao) -> void;
+		auto BindBuffer(const GLenum target, const GLuint buffer) -> void;
+		auto BindFramebuffer(const GLenum target, const GLuint framebuffer) -> void;
+		auto BindTexture(const GLuint unit, const GLenum target, const GLuint texture) -> void;
+		auto ActiveTexture(const GLuint unit) -> void;
+
+		auto SetCapability(const GLenum capability, const bool enabled) -> void;
+		auto DepthMask(const bool enabled) -> void;
+		auto DepthFunc(const GLenum func) -> void;
+		auto CullFace(const GLenum mode) -> void;
+		auto FrontFace(const GLenum mode) -> void;
+		auto BlendFunc(const GLenum source_factor, const GLenum destination_factor) -> void;
+		auto Viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height) -> void;
+		auto ClearColor(const float r, const float g, const float b, const float a) -> void;
+
+		auto DeleteProgram(const GLuint program) -> void;
+		auto DeleteVertexArray(const GLuint vao) -> void;
+		auto DeleteBuffer(const GLuint buffer) -> void;
+		auto DeleteTexture(const GLuint texture) -> void;
+		auto DeleteFramebuffer(const GLuint framebuffer) -> void;
+
+		/**
+		 * \brief Forget everything, call it after code that touches GL behind our back (imgui, third party libs..)
+		 */
+		auto Invalidate() -> void;
+
+		/**
+		 * \brief Closes the counters of the frame that just ended and starts new ones.
+		 */
+		auto BeginFrame() -> void;
+
+		[[nodiscard]] auto GetFrameCounters() const -> const GLStateCounters& { return m_last_frame_counters; }
+
+	private:
+		GLStateCache() = default;
+
+		static constexpr auto MaxTextureUnits = 32;
+		static constexpr auto TextureTargetsCount = 3;
+		static constexpr auto BufferTargetsCount = 9;
+		static constexpr auto CapabilitiesCount = 5;
+
+		// returns false (and counts an elision) when the cached value already matches
+		template <typename T>
+		auto Update(std::optional<T>& cached, const T& value) -> bool
+		{
+			if (cached.has_value() && cached.value() == value)
+			{
+				m_counters.m_elided++;
+				return false;
+			}
+
+			cached = value;
+			m_counters.m_issued++;
+			return true;
+		}
+
+		std::optional<GLuint> m_program = {};
+		std::optional<GLuint> m_vao = {};
+		std::optional<GLuint> m_draw_framebuffer = {};
+		std::optional<GLuint> m_read_framebuffer = {};
+		std::optional<GLuint> m_active_texture_unit = {};
+		std::array<std::optional<GLuint>, BufferTargetsCount> m_buffers = {};
+		std::array<std::array<std::optional<GLuint>, TextureTargetsCount>, MaxTextureUnits> m_textures = {};
+		std::array<std::optional<bool>, CapabilitiesCount> m_capabilities = {};
+		std::optional<bool> m_depth_mask = {};
+		std::optional<GLenum> m_depth_func = {};
+		std::optional<GLenum> m_cull_face = {};
+		std::optional<GLenum> m_front_face = {};
+		std::optional<std::array<GLenum, 2>> m_blend_func = {};
+		std::optional<std::array<GLint, 4>> m_viewport = {};
+		std::optional<std::array<float, 4>> m_clear_color = {};
+
+		GLStateCounters m_counters = {};
+		GLStateCounters m_last_frame_counters = {};
+	};
+}
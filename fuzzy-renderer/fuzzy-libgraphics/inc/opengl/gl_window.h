@@ -14,6 +14,8 @@ namespace libgraphics
 		auto Destroy() -> void override;
 		auto Clear() -> void override;
 		auto SwapBuffers() -> void override;
+		[[nodiscard]] auto ShouldClose() const -> bool override;
+		[[nodiscard]] auto GetBackbufferID() const -> uint32_t override { return 0; }
 		[[nodiscard]] auto GetNativeHandle() const -> const std::shared_ptr<IGraphicsContext> & override { return m_graphics_context; }
 		auto SetClearColor(const Color&) -> void override;
 
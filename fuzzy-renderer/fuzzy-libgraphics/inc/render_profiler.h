@@ -1,19 +1,187 @@
 #pragma once
 
-class IMesh;
+#include <framework.h>
+#include <engine_constants.h>
+
+#include <glad/gl.h>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_set>
 
 namespace libgraphics::utils::profiling
 {
+	/**
+	 * \brief A timed scope. Times are nanoseconds of the steady clock, GPU zones are converted to it as well.
+	 */
+	struct ProfileZone
+	{
+		const char* m_name = {};
+		int64_t m_start_ns = {};
+		int64_t m_end_ns = {};
+		uint32_t m_depth = {};
+		uint32_t m_thread_index = {};
+	};
+
+	struct ProfiledFrame
+	{
+		uint64_t m_frame_index = {};
+		int64_t m_start_ns = {};
+		int64_t m_end_ns = {};
+		std::vector<ProfileZone> m_cpu_zones = {};
+		std::vector<ProfileZone> m_gpu_zones = {};
+	};
+
+	struct ThreadZoneRing;
+
+	/**
+	 * \brief Hierarchical frame profiler. CPU zones are pushed by the recording thread into its own ring (single
+	 * producer/single consumer, no lock on the hot path) and collected by Update() on the render thread. GPU zones
+	 * are GL_TIMESTAMP query pairs in two sets used on alternate frames, a set is read back when it comes around
+	 * again (two frames later) so the GPU is never waited on. The last ProfilerFramesHistory frames are kept for
+	 * the profiler window and the Chrome trace export.
+	 */
 	class RenderProfiler
 	{
 	public:
-        RenderProfiler(const RenderProfiler&) = delete;
-        RenderProfiler& operator=(const RenderProfiler&) = delete;
+		RenderProfiler(const RenderProfiler&) = delete;
+		RenderProfiler& operator=(const RenderProfiler&) = delete;
+		~RenderProfiler();
+
+		LIBGRAPHICS_API static auto GetInstance() -> RenderProfiler&;
+
+		/**
+		 * \brief Closes the current frame and opens the next one, once per frame on the render thread.
+		 */
+		LIBGRAPHICS_API auto Update() -> void;
+
+		/**
+		 * \brief Deletes the GPU queries, to be called before the GL context goes away.
+		 */
+		LIBGRAPHICS_API auto ReleaseGpuResources() -> void;
+
+		LIBGRAPHICS_API auto SetEnabled(const bool enabled) -> void { m_is_enabled.store(enabled, std::memory_order_relaxed); }
+		[[nodiscard]] auto IsEnabled() const -> bool { return m_is_enabled.load(std::memory_order_relaxed); }
+
+		/**
+		 * \brief While paused zones are still collected (the rings never fill up) but the history isn't updated.
+		 */
+		auto SetPaused(const bool paused) -> void { m_is_paused = paused; }
+		[[nodiscard]] auto IsPaused() const -> bool { return m_is_paused; }
+
+		/**
+		 * \brief Name of the calling thread in the profiler window and in the exported traces.
+		 */
+		LIBGRAPHICS_API auto SetThreadName(const std::string_view name) -> void;
+
+		/**
+		 * \brief Zones keep a pointer to their name, names built at runtime must be interned to outlive the history.
+		 */
+		LIBGRAPHICS_API auto InternName(const std::string_view name) -> const char*;
+
+		LIBGRAPHICS_API auto RecordZone(const char* name, const int64_t start_ns, const int64_t end_ns, const uint32_t depth) -> void;
+
+		/**
+		 * \brief GPU zones nest like the CPU ones, render thread only.
+		 */
+		LIBGRAPHICS_API auto BeginGpuZone(const char* name) -> void;
+		LIBGRAPHICS_API auto EndGpuZone() -> void;
+
+		/**
+		 * \brief Writes the frames in the history as a Chrome trace event file (chrome://tracing, Perfetto).
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto ExportChromeTrace(const std::filesystem::path& path) const -> bool;
+
+		[[nodiscard]] auto GetFrames() const -> const std::deque<ProfiledFrame>& { return m_frames; }
+		LIBGRAPHICS_API [[nodiscard]] auto GetThreadNames() const -> std::vector<std::string>;
+		[[nodiscard]] auto GetDroppedZonesCount() const -> uint64_t { return m_dropped_zones_count.load(std::memory_order_relaxed); }
+
+		/**
+		 * \brief Index of the frame opened by the last Update, its GPU zones are attached to it two frames later.
+		 */
+		[[nodiscard]] auto GetCurrentFrameIndex() const -> uint64_t { return m_current_frame.m_frame_index; }
 
-        static auto GetInstance() -> RenderProfiler&;
-        static auto Update() -> void;
+		[[nodiscard]] static auto Now() -> int64_t;
 
-    private:
-        RenderProfiler() = default;
+	private:
+		RenderProfiler();
+
+		struct GpuQuerySet
+		{
+			std::vector<GLuint> m_queries = {};
+			std::vector<ProfileZone> m_zones = {};
+			std::vector<bool> m_closed_zones = {}; // the end query of a zone still open was never issued
+			GLuint m_last_issued_query = {};
+			uint64_t m_frame_index = {};
+			int64_t m_cpu_minus_gpu_ns = {};
+			bool m_has_clock_offset = {};
+		};
+
+		auto GetThreadRing() -> ThreadZoneRing&;
+		auto CollectCpuZones(std::vector<ProfileZone>& out_zones) -> void;
+		auto CollectGpuZones(GpuQuerySet& query_set) -> void;
+
+		std::atomic<bool> m_is_enabled = true;
+		std::atomic<uint64_t> m_dropped_zones_count = {};
+		bool m_is_paused = {};
+
+		mutable std::mutex m_threads_mutex = {};
+		std::vector<std::unique_ptr<ThreadZoneRing>> m_thread_rings; // no initializer, it would need the complete type here
+
+		std::mutex m_names_mutex = {};
+		std::unordered_set<std::string> m_interned_names = {};
+
+		std::deque<ProfiledFrame> m_frames = {};
+		ProfiledFrame m_current_frame = {};
+		bool m_has_current_frame = {};
+
+		std::array<GpuQuerySet, 2> m_gpu_query_sets = {};
+		std::vector<size_t> m_open_gpu_zones = {};
+	};
+
+	/**
+	 * \brief Records the time between its construction and destruction as a zone of the calling thread.
+	 */
+	class ScopedZone
+	{
+	public:
+		LIBGRAPHICS_API explicit ScopedZone(const char* name);
+		LIBGRAPHICS_API ~ScopedZone();
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+
+	private:
+		const char* m_name = {};
+		int64_t m_start_ns = {};
+		bool m_is_recording = {};
+	};
+
+	class ScopedGpuZone
+	{
+	public:
+		explicit ScopedGpuZone(const char* name) { RenderProfiler::GetInstance().BeginGpuZone(name); }
+		~ScopedGpuZone() { RenderProfiler::GetInstance().EndGpuZone(); }
+
+		ScopedGpuZone(const ScopedGpuZone&) = delete;
+		ScopedGpuZone& operator=(const ScopedGpuZone&) = delete;
 	};
-}
\ No newline at end of file
+}
+
+#define CX_PROFILE_CONCAT_INNER(a, b) a##b
+#define CX_PROFILE_CONCAT(a, b) CX_PROFILE_CONCAT_INNER(a, b)
+
+// Profiling Macros, names must outlive the profiler history (literals, or RenderProfiler::InternName)
+#ifndef CX_DISABLE_PROFILING
+#define CX_PROFILE_ZONE(name)		const ::libgraphics::utils::profiling::ScopedZone CX_PROFILE_CONCAT(profile_zone_, __LINE__){ name }
+#define CX_PROFILE_FUNCTION()		CX_PROFILE_ZONE(__FUNCTION__)
+#define CX_PROFILE_GPU_ZONE(name)	const ::libgraphics::utils::profiling::ScopedGpuZone CX_PROFILE_CONCAT(profile_gpu_zone_, __LINE__){ name }
+#else
+#define CX_PROFILE_ZONE(name)
+#define CX_PROFILE_FUNCTION()
+#define CX_PROFILE_GPU_ZONE(name)
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <framework.h>
+
+#include <glm/vec3.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief State of the main camera during one frame and the delta time that frame was rendered with.
+	 */
+	struct CameraPathFrame
+	{
+		glm::dvec3 m_position = {};
+		double m_yaw = {};
+		double m_pitch = {};
+		float m_delta_time = {};
+	};
+
+	using CameraPath = std::vector<CameraPathFrame>;
+
+	/**
+	 * \brief Writes a camera path as a small header ("CXCP", version, frames count) followed by the packed frames
+	 * (5 doubles and a float each, little endian). Doubles keep the replayed poses bit exact.
+	 * \return false when the file can't be written
+	 */
+	LIBGRAPHICS_API auto SaveCameraPath(const std::filesystem::path& path, const CameraPath& camera_path) -> bool;
+
+	/**
+	 * \brief Reads a file written by SaveCameraPath.
+	 * \return nothing when the file is missing, truncated or of another version
+	 */
+	LIBGRAPHICS_API auto LoadCameraPath(const std::filesystem::path& path) -> std::optional<CameraPath>;
+}
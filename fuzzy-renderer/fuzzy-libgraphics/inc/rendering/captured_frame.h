@@ -0,0 +1,22 @@
+#pragma once
+
+#include <framework.h>
+
+#include <span>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Pixels of a captured frame, tightly packed RGBA8 rows, bottom row first (GL convention).
+	 * The span points straight into the readback memory and is only valid during the callback it's passed to.
+	 */
+	struct CapturedFrame
+	{
+		std::span<const uint8_t> m_pixels = {};
+		int m_width = {};
+		int m_height = {};
+		uint64_t m_frame_index = {};
+	};
+
+	using CaptureCallback = std::function<void(const CapturedFrame&)>;
+}
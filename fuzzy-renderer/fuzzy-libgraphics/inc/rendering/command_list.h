@@ -0,0 +1,139 @@
+#pragma once
+
+#include <framework.h>
+#include <rendering/frustum.h>
+
+#include <glm/glm.hpp>
+
+#include <span>
+
+namespace libgraphics
+{
+	class IMesh;
+	class IShader;
+
+	/**
+	 * \brief Camera data a frame is recorded with, built once on the render thread and shared (read only) with the recorders.
+	 */
+	struct RenderView
+	{
+		glm::mat4 m_view = {};
+		glm::mat4 m_projection = {};
+		glm::vec3 m_eye = {};
+		Frustum m_frustum = {};
+
+		// output height in pixels, what screen sizes are measured in
+		float m_viewport_height = {};
+	};
+
+	enum class RenderCommandType : uint8_t
+	{
+		bind_pipeline,
+		set_constant,
+		bind_texture,
+		draw_indexed
+	};
+
+	enum class ConstantType : uint8_t
+	{
+		mat4,
+		vec3,
+		float1,
+		int1,
+		uint1,
+		bool1
+	};
+
+	enum class TextureTarget : uint8_t
+	{
+		texture_2d,
+		texture_cube
+	};
+
+	struct BindPipelineCommand
+	{
+		const IShader* m_shader;
+	};
+
+	struct SetConstantCommand
+	{
+		int32_t m_slot;
+		uint32_t m_offset;
+		ConstantType m_constant_type;
+	};
+
+	struct BindTextureCommand
+	{
+		uint32_t m_unit;
+		uint32_t m_texture_id;
+		TextureTarget m_target;
+	};
+
+	struct DrawIndexedCommand
+	{
+		const IMesh* m_mesh;
+		uint32_t m_index_count;
+		uint32_t m_instance_count;
+	};
+
+	struct RenderCommand
+	{
+		RenderCommandType m_type;
+		union
+		{
+			BindPipelineCommand m_bind_pipeline;
+			SetConstantCommand m_set_constant;
+			BindTextureCommand m_bind_texture;
+			DrawIndexedCommand m_draw_indexed;
+		};
+	};
+
+	/**
+	 * \brief API agnostic list of render commands. Recording only touches CPU memory so any thread can fill its own list,
+	 * replaying it is up to the backend executor on the thread that owns the context.
+	 * Constants are resolved to shader slots and packed in a byte arena while recording.
+	 * Shaders and meshes are referenced, not owned: they have to outlive the list (one frame).
+	 */
+	class CommandList
+	{
+	public:
+		/**
+		 * \brief Clears the commands keeping the memory, lists are meant to be reused every frame.
+		 */
+		auto Reset() -> void;
+
+		/**
+		 * \brief Records a pipeline switch, skipped when the pipeline is already the current one.
+		 * \return true when the pipeline changed (per-pipeline constants have to be recorded again)
+		 */
+		auto BindPipeline(const IShader* shader) -> bool;
+
+		auto SetConstant(const std::string_view name, const glm::mat4& value) -> void { PushConstant(name, ConstantType::mat4, &value, sizeof value); }
+		auto SetConstant(const std::string_view name, const glm::vec3& value) -> void { PushConstant(name, ConstantType::vec3, &value, sizeof value); }
+		auto SetConstant(const std::string_view name, const float value) -> void { PushConstant(name, ConstantType::float1, &value, sizeof value); }
+		auto SetConstant(const std::string_view name, const int value) -> void { PushConstant(name, ConstantType::int1, &value, sizeof value); }
+		auto SetConstant(const std::string_view name, const uint32_t value) -> void { PushConstant(name, ConstantType::uint1, &value, sizeof value); }
+		auto SetConstant(const std::string_view name, const bool value) -> void { const auto int_value = static_cast<int>(value); PushConstant(name, ConstantType::bool1, &int_value, sizeof int_value); }
+
+		auto BindTexture(const uint32_t unit, const TextureTarget target, const uint32_t texture_id) -> void;
+
+		/**
+		 * \brief Records an indexed draw of the whole mesh, instanced when instance_count is greater than one.
+		 */
+		auto DrawIndexed(const IMesh& mesh, const uint32_t instance_count = 1) -> void;
+
+		[[nodiscard]] auto GetCommands() const -> std::span<const RenderCommand> { return m_commands; }
+		[[nodiscard]] auto GetConstantData(const uint32_t offset) const -> const std::byte* { return m_constants.data() + offset; }
+
+		[[nodiscard]] auto GetDrawsCount() const -> uint32_t { return m_draws_count; }
+		[[nodiscard]] auto IsEmpty() const -> bool { return m_commands.empty(); }
+
+	private:
+		auto PushConstant(const std::string_view name, const ConstantType type, const void* data, const size_t size) -> void;
+
+		std::vector<RenderCommand> m_commands = {};
+		std::vector<std::byte> m_constants = {};
+		const IShader* m_current_pipeline = {};
+		uint32_t m_draws_count = {};
+	};
+}
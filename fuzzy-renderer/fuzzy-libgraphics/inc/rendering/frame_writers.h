@@ -0,0 +1,128 @@
+#pragma once
+
+#include <rendering/captured_frame.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace libgraphics
+{
+	enum class FrameStreamFormat : uint8_t
+	{
+		y4m,	// YUV4MPEG2, 4:2:0 full range BT.601, readable by ffmpeg/mpv as is
+		rgba	// headerless RGBA8 frames (ffmpeg -f rawvideo -pix_fmt rgba -s WxH)
+	};
+
+	/**
+	 * \brief Writes captured frames one after the other in a single file. Frames are flipped top row first and
+	 * (for Y4M) converted on the job system while the pixels are still mapped, the file itself is written by a
+	 * dedicated thread. At most CaptureMaxQueuedFrames are queued: past that Write waits, frames are never dropped.
+	 */
+	class FrameStreamWriter
+	{
+	public:
+		LIBGRAPHICS_API FrameStreamWriter(const std::filesystem::path& path, const FrameStreamFormat format, const int fps = 60);
+		LIBGRAPHICS_API ~FrameStreamWriter();
+
+		FrameStreamWriter(const FrameStreamWriter&) = delete;
+		FrameStreamWriter& operator=(const FrameStreamWriter&) = delete;
+
+		/**
+		 * \brief Queues a frame, usable as CaptureCallback. Every frame must have the size of the first one.
+		 */
+		LIBGRAPHICS_API auto Write(const CapturedFrame& frame) -> void;
+
+		/**
+		 * \brief Writes what's still queued and closes the file.
+		 */
+		LIBGRAPHICS_API auto Close() -> void;
+
+		[[nodiscard]] auto IsOpen() const -> bool { return m_stream.is_open(); }
+		[[nodiscard]] auto GetWrittenFramesCount() const -> uint64_t { return m_written_frames_count; }
+
+	private:
+		auto AcquireBuffer() -> std::vector<uint8_t>;
+		auto WriterLoop() -> void;
+
+		std::ofstream m_stream = {};
+		FrameStreamFormat m_format = {};
+		int m_fps = {};
+		int m_width = {};
+		int m_height = {};
+
+		std::thread m_writer = {};
+		std::mutex m_mutex = {};
+		std::condition_variable m_queue_condition = {};
+		std::condition_variable m_pool_condition = {};
+		std::deque<std::vector<uint8_t>> m_queue = {};
+		std::vector<std::vector<uint8_t>> m_free_buffers = {};
+		size_t m_allocated_buffers_count = {};
+		bool m_stop = {};
+
+		std::atomic<uint64_t> m_written_frames_count = {};
+	};
+
+	/**
+	 * \brief Encodes captured frames to PNG files on the job system. The pixels are copied (flipped) out of the
+	 * readback memory on the calling thread, compression happens on the workers.
+	 * At most CaptureMaxQueuedFrames are in flight: past that Encode waits, frames are never dropped.
+	 */
+	class PNGFrameEncoder
+	{
+	public:
+		/**
+		 * \brief Frames passed to Encode(frame) are named <file_prefix>_<frame index, 6 digits>.png
+		 */
+		LIBGRAPHICS_API explicit PNGFrameEncoder(std::filesystem::path output_directory, std::string file_prefix = "frame");
+		LIBGRAPHICS_API ~PNGFrameEncoder();
+
+		PNGFrameEncoder(const PNGFrameEncoder&) = delete;
+		PNGFrameEncoder& operator=(const PNGFrameEncoder&) = delete;
+
+		/**
+		 * \brief Queues a frame, usable as CaptureCallback.
+		 */
+		LIBGRAPHICS_API auto Encode(const CapturedFrame& frame) -> void;
+
+		/**
+		 * \brief Queues a frame with an explicit file name (relative to the output directory).
+		 */
+		LIBGRAPHICS_API auto Encode(const CapturedFrame& frame, const std::filesystem::path& file_name) -> void;
+
+		/**
+		 * \brief Blocks until every queued frame is on disk.
+		 */
+		LIBGRAPHICS_API auto Wait() -> void;
+
+		[[nodiscard]] auto GetEncodedFramesCount() const -> uint64_t { return m_encoded_frames_count; }
+		[[nodiscard]] auto GetFailedFramesCount() const -> uint64_t { return m_failed_frames_count; }
+
+		/**
+		 * \brief Time spent compressing and writing, summed over the workers
+		 */
+		[[nodiscard]] auto GetEncodeSeconds() const -> double { return static_cast<double>(m_encode_nanoseconds) * 1e-9; }
+
+	private:
+		auto AcquireBuffer(const size_t size) -> std::vector<uint8_t>;
+		auto ReleaseBuffer(std::vector<uint8_t> buffer) -> void;
+
+		std::filesystem::path m_output_directory = {};
+		std::string m_file_prefix = {};
+
+		std::mutex m_mutex = {};
+		std::condition_variable m_pool_condition = {};
+		std::vector<std::vector<uint8_t>> m_free_buffers = {};
+		size_t m_allocated_buffers_count = {};
+		size_t m_in_flight_count = {};
+
+		std::atomic<uint64_t> m_encoded_frames_count = {};
+		std::atomic<uint64_t> m_failed_frames_count = {};
+		std::atomic<uint64_t> m_encode_nanoseconds = {};
+	};
+}
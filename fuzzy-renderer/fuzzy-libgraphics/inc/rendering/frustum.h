@@ -0,0 +1,29 @@
+#pragma once
+
+#include <interfaces/imesh.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+namespace libgraphics
+{
+	/**
+	 * \brief View frustum as 6 inward facing planes (xyz = normal, w = distance), extracted from a view-projection matrix.
+	 */
+	class Frustum
+	{
+	public:
+		Frustum() = default;
+		explicit Frustum(const glm::mat4& view_projection);
+
+		/**
+		 * \brief Conservative test of a local space box placed in the world by model.
+		 * \return false only when the box is entirely outside one of the planes
+		 */
+		[[nodiscard]] auto Intersects(const BoundingBox& local_bounds, const glm::mat4& model) const -> bool;
+
+	private:
+		std::array<glm::vec4, 6> m_planes = {};
+	};
+}
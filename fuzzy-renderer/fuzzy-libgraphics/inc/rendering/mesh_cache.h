@@ -0,0 +1,114 @@
+#pragma once
+
+#include <framework.h>
+#include <enums.h>
+#include <mapped_file.h>
+#include <interfaces/imesh.h>
+
+#include <glm/mat4x4.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief An image stored in a model file, the bytes of an image file (png, jpg...) when m_height is 0, RGBA8 texels
+	 * otherwise (assimp's convention).
+	 */
+	struct EmbeddedImage
+	{
+		std::span<const uint8_t> m_data = {};
+		uint32_t m_width = {};
+		uint32_t m_height = {};
+	};
+
+	/**
+	 * \brief Indices drawn at a level of detail, from the screen size (pixels) it is used at.
+	 */
+	struct MeshLodRange
+	{
+		uint32_t m_first_index = {};
+		uint32_t m_indices_count = {};
+		float m_min_screen_size = {};
+		uint32_t m_padding = {};
+	};
+
+	struct MeshCacheTexture
+	{
+		// assimp texture path, relative to the model folder or naming an embedded texture
+		std::string_view m_source = {};
+		TextureType m_type = {};
+		std::optional<EmbeddedImage> m_embedded = {};
+	};
+
+	struct MeshCacheMesh
+	{
+		std::string_view m_name = {};
+		std::span<const Vertex> m_vertices = {};
+		std::span<const uint32_t> m_indices = {};
+		BoundingBox m_bounds = {};
+
+		// indices in MeshCacheContents::m_textures
+		std::span<const uint32_t> m_textures = {};
+
+		// finest first, at least one
+		std::span<const MeshLodRange> m_lods = {};
+	};
+
+	struct MeshCacheNode
+	{
+		std::string_view m_name = {};
+
+		// index in MeshCacheContents::m_nodes, -1 for the root
+		int32_t m_parent = -1;
+		glm::mat4 m_transform = {};
+
+		// indices in MeshCacheContents::m_meshes
+		std::span<const uint32_t> m_meshes = {};
+	};
+
+	/**
+	 * \brief What a mesh cache holds, as views: of the imported model when writing, of the mapped file when read.
+	 */
+	struct MeshCacheContents
+	{
+		std::vector<MeshCacheTexture> m_textures = {};
+		std::vector<MeshCacheMesh> m_meshes = {};
+
+		// depth first, parents before their children
+		std::vector<MeshCacheNode> m_nodes = {};
+	};
+
+	/**
+	 * \brief A mesh cache file mapped in memory, the views of its contents are valid as long as it lives.
+	 */
+	struct MappedMeshCache
+	{
+		MappedFile m_file = {};
+		MeshCacheContents m_contents = {};
+	};
+
+	/**
+	 * \brief Where the cache of a model imported with import_flags goes, named after a hash of the model file contents so
+	 * that an edited model misses it.
+	 * \return nothing when the model file can't be read
+	 */
+	LIBGRAPHICS_API auto GetMeshCachePath(const std::filesystem::path& model_path, const uint32_t import_flags) -> std::optional<std::filesystem::path>;
+
+	/**
+	 * \brief Writes the cache to a temporary file moved over cache_path once complete, so a reader never maps a partial
+	 * one. Every array starts 16 bytes aligned in the file.
+	 * \return false when it can't be written
+	 */
+	LIBGRAPHICS_API auto WriteMeshCache(const std::filesystem::path& cache_path, const MeshCacheContents& contents) -> bool;
+
+	/**
+	 * \brief Maps a cache and checks its header and the bounds of every array, nothing is copied.
+	 * \return nothing when the file is missing, malformed or from another version of the format
+	 */
+	LIBGRAPHICS_API auto OpenMeshCache(const std::filesystem::path& cache_path) -> std::optional<MappedMeshCache>;
+}
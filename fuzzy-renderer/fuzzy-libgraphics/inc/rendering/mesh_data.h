@@ -0,0 +1,63 @@
+#pragma once
+
+#include <framework.h>
+#include <interfaces/imesh.h>
+#include <memory_tracker.h>
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief What a mesh keeps in system memory once its buffers are uploaded: every vertex attribute, only the positions
+	 * and indices ray picking reads, or nothing (the GPU copy is all there is).
+	 */
+	enum class MeshDataPolicy : uint8_t
+	{
+		keep_all,
+		keep_positions,
+		discard
+	};
+
+	/**
+	 * \brief Vertices and indices of a mesh, never modified once built so that they can be shared and read from any
+	 * thread without copying. Either full vertices or positions alone are held, see MakePickingCopy.
+	 */
+	class MeshData
+	{
+	public:
+		/**
+		 * \param detail what the memory tracker reports the copy as
+		 */
+		LIBGRAPHICS_API MeshData(std::vector<Vertex> vertices, std::vector<uint32_t> indices, const std::string& detail);
+		MeshData(const MeshData&) = delete;
+		MeshData& operator=(const MeshData&) = delete;
+
+		/**
+		 * \brief The positions and indices alone, about a fifth of the full vertices
+		 */
+		[[nodiscard]] auto MakePickingCopy(const std::string& detail) const -> std::shared_ptr<const MeshData>;
+
+		/**
+		 * \brief Empty for picking copies
+		 */
+		[[nodiscard]] auto GetVertices() const -> std::span<const Vertex> { return m_vertices; }
+		[[nodiscard]] auto GetIndices() const -> std::span<const uint32_t> { return m_indices; }
+
+		[[nodiscard]] auto GetVertexCount() const -> size_t { return m_vertices.empty() ? m_positions.size() : m_vertices.size(); }
+		[[nodiscard]] auto GetPosition(const uint32_t vertex_idx) const -> const glm::vec3& { return m_vertices.empty() ? m_positions[vertex_idx] : m_vertices[vertex_idx].m_position; }
+
+	private:
+		MeshData(std::vector<glm::vec3> positions, std::vector<uint32_t> indices, const std::string& detail);
+
+		auto TrackMemory(const std::string& detail) -> void;
+
+		std::vector<Vertex> m_vertices = {};
+		std::vector<glm::vec3> m_positions = {};
+		std::vector<uint32_t> m_indices = {};
+
+		TrackedMemory m_memory = {};
+	};
+}
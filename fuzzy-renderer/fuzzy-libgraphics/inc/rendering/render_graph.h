@@ -0,0 +1,232 @@
+#pragma once
+
+#include <framework.h>
+#include <memory_tracker.h>
+#include <glad/gl.h>
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace libgraphics
+{
+	using RenderResourceHandle = uint32_t;
+	constexpr auto InvalidRenderResource = std::numeric_limits<RenderResourceHandle>::max();
+
+	enum class RenderResourceType
+	{
+		texture,
+		buffer
+	};
+
+	/**
+	 * \brief How a pass touches a resource, used to derive the memory barriers between passes.
+	 */
+	enum class RenderResourceAccess
+	{
+		render_target,
+		sampled,
+		storage,
+		uniform,
+		vertex
+	};
+
+	struct RenderTextureDesc
+	{
+		int m_width = {};
+		int m_height = {};
+		GLenum m_internal_format = GL_RGBA8;
+
+		auto operator==(const RenderTextureDesc&) const -> bool = default;
+	};
+
+	struct RenderBufferDesc
+	{
+		size_t m_size = {};
+
+		auto operator==(const RenderBufferDesc&) const -> bool = default;
+	};
+
+	class RenderGraph;
+
+	/**
+	 * \brief Handed to a pass setup function so it can declare what it reads and writes.
+	 */
+	class RenderGraphBuilder
+	{
+	public:
+		RenderGraphBuilder(RenderGraph& graph, const uint32_t pass_index) : m_graph{ graph }, m_pass_index{ pass_index } {}
+
+		auto CreateTexture(const std::string_view name, const RenderTextureDesc& desc) const -> RenderResourceHandle;
+		auto CreateBuffer(const std::string_view name, const RenderBufferDesc& desc) const -> RenderResourceHandle;
+
+		/**
+		 * \brief Declares a read of the given resource version.
+		 * \return the same handle, for chaining
+		 */
+		auto Read(const RenderResourceHandle handle, const RenderResourceAccess access = RenderResourceAccess::sampled) const -> RenderResourceHandle;
+
+		/**
+		 * \brief Declares a write, the previous contents are preserved (load) so the previous version is read as well.
+		 * \return a new handle identifying the written version, later passes must read this one
+		 */
+		auto Write(const RenderResourceHandle handle, const RenderResourceAccess access = RenderResourceAccess::render_target) const -> RenderResourceHandle;
+
+		/**
+		 * \brief Marks the pass as having effects outside of the graph (presenting, readback..) so it's never culled.
+		 */
+		auto SideEffect() const -> void;
+
+	private:
+		RenderGraph& m_graph;
+		uint32_t m_pass_index = {};
+	};
+
+	/**
+	 * \brief Handed to a pass execute function, resolves virtual handles into GL objects.
+	 */
+	class RenderPassContext
+	{
+	public:
+		explicit RenderPassContext(const RenderGraph& graph) : m_graph{ graph } {}
+
+		[[nodiscard]] auto GetTexture(const RenderResourceHandle handle) const -> GLuint;
+		[[nodiscard]] auto GetBuffer(const RenderResourceHandle handle) const -> GLuint;
+		[[nodiscard]] auto GetTextureDesc(const RenderResourceHandle handle) const -> const RenderTextureDesc&;
+
+	private:
+		const RenderGraph& m_graph;
+	};
+
+	using RenderPassSetup = std::function<void(RenderGraphBuilder&)>;
+	using RenderPassExecute = std::function<void(const RenderPassContext&)>;
+
+	/**
+	 * \brief Frame graph: passes declare their resources, Compile() derives the execution order, culls
+	 * passes whose outputs are never consumed and computes resource lifetimes so that transient textures,
+	 * buffers and framebuffers are recycled across passes that don't overlap.
+	 * Build it again every frame (Reset -> AddPass.. -> Compile -> Execute), physical resources are pooled.
+	 */
+	class RenderGraph
+	{
+	public:
+		RenderGraph() = default;
+		~RenderGraph();
+		RenderGraph(const RenderGraph&) = delete;
+		RenderGraph& operator=(const RenderGraph&) = delete;
+
+		auto Reset() -> void;
+
+		auto AddPass(const std::string_view name, const RenderPassSetup& setup, RenderPassExecute execute) -> void;
+
+		/**
+		 * \brief Imports the framebuffer frames are presented from (the default one, or an offscreen one when headless),
+		 * writes to it are always considered used.
+		 */
+		auto ImportBackbuffer(const std::string_view name, const RenderTextureDesc& desc, const GLuint framebuffer_id = 0) -> RenderResourceHandle;
+
+		/**
+		 * \brief Imports an externally owned texture, writes to it are always considered used.
+		 */
+		auto ImportTexture(const std::string_view name, const GLuint texture_id, const RenderTextureDesc& desc) -> RenderResourceHandle;
+
+		auto Compile() -> void;
+		auto Execute() -> void;
+
+		/**
+		 * \brief Releases pooled resources not used for the given amount of frames.
+		 */
+		auto TrimPool(const uint32_t max_unused_frames) -> void;
+
+		/**
+		 * \brief Drops the cached framebuffers, needed when an imported texture is recreated (its id may be reused).
+		 */
+		auto ReleaseFramebuffers() -> void;
+
+		[[nodiscard]] auto GetCulledPassesCount() const -> uint32_t { return m_culled_passes_count; }
+		[[nodiscard]] auto GetPooledTexturesCount() const -> size_t { return m_texture_pool.size(); }
+		[[nodiscard]] auto GetPooledBuffersCount() const -> size_t { return m_buffer_pool.size(); }
+
+	private:
+		friend class RenderGraphBuilder;
+		friend class RenderPassContext;
+
+		struct ResourceAccessInfo
+		{
+			RenderResourceHandle m_node = InvalidRenderResource;
+			RenderResourceAccess m_access = {};
+		};
+
+		struct RenderPass
+		{
+			std::string m_name = {};
+			const char* m_profile_name = {};
+			RenderPassExecute m_execute = {};
+			std::vector<ResourceAccessInfo> m_reads = {};
+			std::vector<ResourceAccessInfo> m_writes = {};
+			std::vector<uint32_t> m_acquire = {};
+			std::vector<uint32_t> m_release = {};
+			GLbitfield m_barriers = {};
+			uint32_t m_ref_count = {};
+			bool m_has_side_effect = {};
+		};
+
+		// A physical resource (a texture or a buffer) as seen by the graph
+		struct RenderResource
+		{
+			std::string m_name = {};
+			RenderResourceType m_type = {};
+			RenderTextureDesc m_texture_desc = {};
+			RenderBufferDesc m_buffer_desc = {};
+			GLuint m_id = {};
+			bool m_imported = {};
+			bool m_backbuffer = {};
+			uint32_t m_first_pass = std::numeric_limits<uint32_t>::max();
+			uint32_t m_last_pass = {};
+		};
+
+		// A version of a physical resource, every write produces a new node
+		struct ResourceNode
+		{
+			uint32_t m_resource = {};
+			uint32_t m_producer = std::numeric_limits<uint32_t>::max();
+			uint32_t m_ref_count = {};
+			RenderResourceAccess m_last_write_access = {};
+		};
+
+		struct PooledTexture
+		{
+			RenderTextureDesc m_desc = {};
+			GLuint m_id = {};
+			bool m_in_use = {};
+			uint32_t m_unused_frames = {};
+			TrackedMemory m_memory = {};
+		};
+
+		struct PooledBuffer
+		{
+			RenderBufferDesc m_desc = {};
+			GLuint m_id = {};
+			bool m_in_use = {};
+			uint32_t m_unused_frames = {};
+			TrackedMemory m_memory = {};
+		};
+
+		auto CreateResource(const std::string_view name, const RenderResourceType type) -> RenderResourceHandle;
+		auto AcquireTexture(const RenderTextureDesc& desc) -> GLuint;
+		auto ReleaseTexture(const GLuint id) -> void;
+		auto AcquireBuffer(const RenderBufferDesc& desc) -> GLuint;
+		auto ReleaseBuffer(const GLuint id) -> void;
+		auto BindPassFramebuffer(const RenderPass& pass) -> void;
+
+		std::vector<RenderPass> m_passes = {};
+		std::vector<RenderResource> m_resources = {};
+		std::vector<ResourceNode> m_nodes = {};
+		bool m_compiled = {};
+		uint32_t m_culled_passes_count = {};
+
+		std::vector<PooledTexture> m_texture_pool = {};
+		std::vector<PooledBuffer> m_buffer_pool = {};
+		std::unordered_map<std::string, GLuint> m_framebuffers = {};
+	};
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <framework.h>
+
+#include <deque>
+
+namespace libgraphics
+{
+	/**
+	 * \brief What the rendering path submitted during one frame. Binds only count calls that reached GL
+	 * (the ones elided by GLStateCache aren't), triangles and vertices include the instances.
+	 */
+	struct FrameRenderStats
+	{
+		uint64_t m_frame_index = {};
+		float m_frame_ms = {};
+
+		uint32_t m_draw_calls = {};
+		uint64_t m_triangles = {};
+		uint64_t m_vertices = {};
+
+		uint32_t m_program_binds = {};
+		uint32_t m_vao_binds = {};
+		uint32_t m_texture_binds = {};
+		uint32_t m_uniform_uploads = {};
+		uint64_t m_buffer_upload_bytes = {};
+
+		uint32_t m_visible_objects = {};
+		uint32_t m_culled_objects = {};
+		uint32_t m_entities = {};
+		uint32_t m_components = {};
+	};
+
+	struct FrameTimeSummary
+	{
+		float m_min_ms = {};
+		float m_avg_ms = {};
+		float m_max_ms = {};
+		float m_p99_ms = {};
+	};
+
+	/**
+	 * \brief Per frame counters filled by the render path (render thread only) and the history of the last
+	 * RenderStatsHistoryFrames frames. Whoever needs numbers (the stats window, tests) reads the closed frames only.
+	 */
+	class RenderStats
+	{
+	public:
+		RenderStats(const RenderStats&) = delete;
+		RenderStats& operator=(const RenderStats&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> RenderStats&;
+
+		/**
+		 * \brief Closes the frame being counted, previous_frame_ms is how long it took from start to start.
+		 */
+		LIBGRAPHICS_API auto BeginFrame(const float previous_frame_ms) -> void;
+
+		/**
+		 * \brief Drops the history, the frame being counted is kept.
+		 */
+		LIBGRAPHICS_API auto Reset() -> void;
+
+		auto CountDraw(const uint64_t vertices_count, const uint64_t indices_count, const uint32_t instance_count) -> void
+		{
+			m_current_frame.m_draw_calls++;
+			m_current_frame.m_vertices += vertices_count * instance_count;
+			m_current_frame.m_triangles += indices_count / 3 * instance_count;
+		}
+
+		auto CountProgramBind() -> void { m_current_frame.m_program_binds++; }
+		auto CountVaoBind() -> void { m_current_frame.m_vao_binds++; }
+		auto CountTextureBind() -> void { m_current_frame.m_texture_binds++; }
+		auto CountUniformUpload() -> void { m_current_frame.m_uniform_uploads++; }
+		auto CountBufferUpload(const uint64_t bytes) -> void { m_current_frame.m_buffer_upload_bytes += bytes; }
+
+		auto SetObjectCounts(const uint32_t visible_objects, const uint32_t culled_objects, const uint32_t entities, const uint32_t components) -> void
+		{
+			m_current_frame.m_visible_objects = visible_objects;
+			m_current_frame.m_culled_objects = culled_objects;
+			m_current_frame.m_entities = entities;
+			m_current_frame.m_components = components;
+		}
+
+		/**
+		 * \brief Counters of the last closed frame.
+		 */
+		[[nodiscard]] auto GetLastFrame() const -> const FrameRenderStats& { return m_last_frame; }
+		[[nodiscard]] auto GetHistory() const -> const std::deque<FrameRenderStats>& { return m_history; }
+
+		/**
+		 * \brief Min/avg/max/99th percentile of the frame times in the history.
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetFrameTimeSummary() const -> FrameTimeSummary;
+
+	private:
+		RenderStats() = default;
+
+		FrameRenderStats m_current_frame = {};
+		FrameRenderStats m_last_frame = {};
+		std::deque<FrameRenderStats> m_history = {};
+		bool m_is_counting = {};
+	};
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <engine_constants.h>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Picks the per axis render scale from the measured GPU frame times. Times are smoothed (EMA), the cost
+	 * is assumed to scale with the pixel count (scale^2). The scale drops quickly when over budget and recovers
+	 * slowly, with a dead zone around the target so it doesn't oscillate.
+	 */
+	class ResolutionController
+	{
+	public:
+		explicit ResolutionController(const float target_frame_ms = constants::DynamicResolutionTargetFrameMs,
+			const float min_scale = constants::DynamicResolutionMinScale, const float max_scale = constants::DynamicResolutionMaxScale);
+
+		/**
+		 * \brief Feeds the GPU time of a frame (rendered at the current scale) and returns the scale for the next one.
+		 */
+		auto Update(const float gpu_frame_ms) -> float;
+
+		auto SetTargetFrameMs(const float target_frame_ms) -> void { m_target_frame_ms = target_frame_ms; }
+
+		[[nodiscard]] auto GetScale() const -> float { return m_scale; }
+		[[nodiscard]] auto GetTargetFrameMs() const -> float { return m_target_frame_ms; }
+		[[nodiscard]] auto GetSmoothedFrameMs() const -> float { return m_smoothed_frame_ms; }
+
+	private:
+		float m_target_frame_ms = {};
+		float m_min_scale = {};
+		float m_max_scale = {};
+		float m_scale = {};
+		float m_smoothed_frame_ms = {};
+		bool m_has_samples = {};
+	};
+}
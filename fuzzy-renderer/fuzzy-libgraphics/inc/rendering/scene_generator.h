@@ -0,0 +1,78 @@
+#pragma once
+
+#include <framework.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libgraphics
+{
+	class Entity;
+	struct Light;
+
+	// scene specs starting with this are generated instead of loaded, see ParseSceneGeneratorSpec
+	inline constexpr auto SceneGeneratorSpecPrefix = std::string_view{ "generated:" };
+
+	/**
+	 * \brief What GenerateScene builds. The same parameters give the same scene on every run and every backend.
+	 */
+	struct SceneGeneratorParams
+	{
+		uint32_t m_seed = 1;
+
+		// renderable entities, each one a mesh renderer (the scene root is not counted)
+		uint32_t m_entities_count = 1000;
+
+		// entities are grouped in trees of at most m_hierarchy_depth levels with m_hierarchy_branching children per
+		// node: depth 1 is a flat list, branching 1 gives chains of m_hierarchy_depth nested entities
+		uint32_t m_hierarchy_depth = 1;
+		uint32_t m_hierarchy_branching = 4;
+
+		// distinct meshes shared by the entities, 1 instances a single mesh everywhere
+		uint32_t m_meshes_count = 16;
+
+		// rings of the generated rocks, a mesh has about 4 * detail^2 triangles
+		uint32_t m_mesh_detail = 12;
+
+		// distinct materials (random albedo, metallic, roughness) shared by the entities
+		uint32_t m_materials_count = 16;
+
+		// distinct albedo textures of m_texture_size texels, shared by the meshes (0 untextured, ignored by the software backend)
+		uint32_t m_textures_count = 0;
+		uint32_t m_texture_size = 256;
+
+		uint32_t m_point_lights_count = 8;
+		uint32_t m_spot_lights_count = 0;
+
+		// the entities are placed in a 2 * extent wide box in front of the default camera
+		float m_extent = 50.0f;
+	};
+
+	struct GeneratedScene
+	{
+		std::shared_ptr<Entity> m_root = {};
+		std::vector<std::shared_ptr<Light>> m_lights = {};
+		uint64_t m_triangles_count = {};
+	};
+
+	/**
+	 * \brief Builds the scene with the meshes of the active backend (Core::CreateMesh), so Core must be initialized.
+	 * The lights are returned, not added to the core, see Core::LoadScene.
+	 */
+	LIBGRAPHICS_API auto GenerateScene(const SceneGeneratorParams& params) -> GeneratedScene;
+
+	/**
+	 * \brief Parses "generated:key=value,key=value..." with the keys seed, entities, depth, branching, meshes, detail,
+	 * materials, textures, texture_size, points, spots and extent. Missing keys keep their default.
+	 * \return nothing when spec doesn't start with SceneGeneratorSpecPrefix or has an unknown key or a bad value
+	 */
+	LIBGRAPHICS_API auto ParseSceneGeneratorSpec(const std::string_view spec) -> std::optional<SceneGeneratorParams>;
+
+	/**
+	 * \brief The spec ParseSceneGeneratorSpec reads back into params, every key included.
+	 */
+	LIBGRAPHICS_API auto ToSceneGeneratorSpec(const SceneGeneratorParams& params) -> std::string;
+}
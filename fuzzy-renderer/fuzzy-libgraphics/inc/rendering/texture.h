@@ -1,11 +1,25 @@
 #pragma once
 
 #include <enums.h>
+#include <memory_tracker.h>
+#include <memory>
 #include <string_view>
 #include <glad/gl.h>
 
 namespace libgraphics
 {
+	enum class BlockFormat;
+	struct CookedTexture;
+	struct StreamedTexture;
+
+	[[nodiscard]] auto ToGLFormat(const BlockFormat format, const bool is_srgb) -> GLenum;
+
+	/**
+	 * \brief Immutable storage for levels_count mips of a block compressed texture, bound to unit 0 and sampled like
+	 * every texture. The texels are left undefined.
+	 */
+	[[nodiscard]] auto CreateCompressedTexture(const BlockFormat format, const bool is_srgb, const int width, const int height, const int levels_count) -> GLuint;
+
 	class Texture
 	{
 	public:
@@ -13,16 +27,47 @@ namespace libgraphics
 		explicit Texture(const std::string_view file_path, const TextureType type);
 		explicit Texture(unsigned char* data, const unsigned int width, const unsigned int height, const TextureType type);
 
+		/**
+		 * \brief Uploads a block compressed texture and its mips as they are (see texture_cooker.h)
+		 * \param source what the memory tracker reports the texture as
+		 */
+		explicit Texture(const CookedTexture& cooked_texture, const std::string_view source, const TextureType type);
+
 		[[nodiscard]] auto GetFilePath() const -> std::string_view { return m_file_path; }
-		[[nodiscard]] auto GetTextureID() const -> GLuint { return m_texture_id; }
+		[[nodiscard]] auto GetTextureID() const -> GLuint { return m_storage ? m_storage->m_texture_id : 0; }
 		[[nodiscard]] auto GetType() const -> TextureType { return m_type; }
 		[[nodiscard]] auto GetIndex() const -> int { return m_index; }
 
 		auto SetIndex(const int index) -> void { m_index = index; }
 
+		/**
+		 * \brief Tells a streamed texture that a mesh using it covers about pixels on screen, so that its mips down to
+		 * that resolution get loaded. Nothing for the other textures. Thread safe, called while recording.
+		 */
+		auto RequestScreenSize(const float pixels) const -> void;
+
 	private:
+		friend class TextureCache;
+		friend class TextureStreamer;
+
+		/**
+		 * \brief The GL texture and its accounting, shared by the copies of a Texture and deleted with the last one.
+		 * The streamer replaces the texture of streamed ones as their resident mips change.
+		 */
+		struct Storage
+		{
+			GLuint m_texture_id = {};
+			TrackedMemory m_memory = {};
+			std::shared_ptr<StreamedTexture> m_streamed = {};
+
+			~Storage();
+		};
+
+		auto SetStorage(const GLuint texture_id, const int width, const int height, const GLenum format, const std::string_view source) -> void;
+		auto SetCompressedStorage(const CookedTexture& cooked_texture, const std::string_view source) -> void;
+
 		std::string_view m_file_path = {};
-		GLuint m_texture_id = {};
+		std::shared_ptr<Storage> m_storage = {};
 		TextureType m_type = {};
 		int m_index = {};
 	};
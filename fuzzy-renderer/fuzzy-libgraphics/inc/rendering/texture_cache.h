@@ -0,0 +1,88 @@
+#pragma once
+
+#include <framework.h>
+#include <rendering/texture.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief The textures of the engine by source, so that an image used by many meshes or models is decoded and
+	 * uploaded once. Keys are canonical file paths or content hashes of embedded images (see MakeFileKey/MakeContentKey).
+	 * The ResourceManager owns the textures, the cache only finds them: an unused one stays until the textures go over
+	 * their budget. Lookups are thread safe; only the render thread inserts and trims, so GL textures are never deleted
+	 * elsewhere.
+	 */
+	class TextureCache
+	{
+	public:
+		TextureCache(const TextureCache&) = delete;
+		TextureCache& operator=(const TextureCache&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> TextureCache&;
+
+		[[nodiscard]] static auto MakeFileKey(const std::string_view file_path) -> std::string;
+		[[nodiscard]] static auto MakeContentKey(const std::span<const uint8_t> data) -> std::string;
+
+		/**
+		 * \brief The cached texture for key, sharing its GL texture, with type as its role
+		 */
+		[[nodiscard]] auto Find(const std::string_view key, const TextureType type) -> std::optional<Texture>;
+
+		/**
+		 * \brief Hands the texture over to the resource manager under key, see ResourceManager::Track
+		 */
+		auto Insert(std::string key, const Texture& texture) -> void;
+
+		/**
+		 * \brief The keys of the textures read from a file, either the image itself or its cooked version
+		 * \param changed_path canonical path of the file
+		 */
+		[[nodiscard]] auto FindFileKeys(const std::filesystem::path& changed_path) const -> std::vector<std::string>;
+
+		/**
+		 * \brief Gives the cached texture for key the GL texture of replacement, every copy of it sees the new one.
+		 * replacement gets the previous GL texture, deleted with it. Render thread, while no recording is in flight.
+		 * \return false when replacement has no texture or key isn't cached
+		 */
+		auto Replace(const std::string_view key, Texture& replacement) -> bool;
+
+		/**
+		 * \brief Forgets the textures the resource manager evicted. Render thread, once per frame.
+		 */
+		auto Trim() -> void;
+
+		/**
+		 * \brief Forgets every texture. Render thread.
+		 */
+		auto Clear() -> void;
+
+		LIBGRAPHICS_API [[nodiscard]] auto GetTexturesCount() const -> size_t;
+		[[nodiscard]] auto GetHitsCount() const -> uint64_t { return m_hits_count.load(std::memory_order_relaxed); }
+		[[nodiscard]] auto GetMissesCount() const -> uint64_t { return m_misses_count.load(std::memory_order_relaxed); }
+
+	private:
+		TextureCache() = default;
+
+		struct CachedTexture
+		{
+			Texture m_texture = {};
+			std::weak_ptr<Texture::Storage> m_storage = {};
+		};
+
+		mutable std::mutex m_mutex = {};
+		std::unordered_map<std::string, CachedTexture> m_textures = {};
+		std::atomic<uint64_t> m_hits_count = {};
+		std::atomic<uint64_t> m_misses_count = {};
+	};
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <framework.h>
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief What a texture holds, which decides how it is filtered and compressed.
+	 */
+	enum class TextureRole
+	{
+		color,			// sRGB albedo/emissive, BC1
+		color_alpha,	// sRGB with alpha, BC3
+		normal,			// tangent space normal map, BC5 (x, y; z is rebuilt in the shader)
+		mask			// one linear channel (roughness, metallic, ao, height), BC4
+	};
+
+	enum class BlockFormat
+	{
+		bc1,
+		bc3,
+		bc4,
+		bc5
+	};
+
+	/**
+	 * \brief An image decoded to RGBA8, the input of the cooker.
+	 */
+	struct SourceImage
+	{
+		int m_width = {};
+		int m_height = {};
+		std::vector<uint8_t> m_pixels = {};
+		bool m_has_alpha = {};
+	};
+
+	LIBGRAPHICS_API auto TextureRoleToString(const TextureRole role) -> std::string_view;
+	LIBGRAPHICS_API auto ParseTextureRole(const std::string_view name) -> std::optional<TextureRole>;
+
+	/**
+	 * \brief Role from the usual file name suffixes (_n, _normal, _rough, _ao...), color_alpha when the image has
+	 * translucent texels, color otherwise.
+	 */
+	LIBGRAPHICS_API auto GuessTextureRole(const std::filesystem::path& path, const bool has_alpha) -> TextureRole;
+
+	[[nodiscard]] constexpr auto GetBlockFormat(const TextureRole role) -> BlockFormat
+	{
+		switch (role)
+		{
+		case TextureRole::color_alpha: return BlockFormat::bc3;
+		case TextureRole::normal: return BlockFormat::bc5;
+		case TextureRole::mask: return BlockFormat::bc4;
+		default: return BlockFormat::bc1;
+		}
+	}
+
+	/**
+	 * \brief Bytes of a 4x4 block
+	 */
+	[[nodiscard]] constexpr auto GetBlockBytes(const BlockFormat format) -> size_t { return format == BlockFormat::bc1 || format == BlockFormat::bc4 ? 8 : 16; }
+
+	struct CookedMip
+	{
+		int m_width = {};
+		int m_height = {};
+		std::vector<uint8_t> m_data = {};
+	};
+
+	/**
+	 * \brief A block compressed texture with its whole mip chain, level 0 first.
+	 */
+	struct CookedTexture
+	{
+		BlockFormat m_format = {};
+		bool m_is_srgb = {};
+		std::vector<CookedMip> m_mips = {};
+	};
+
+	/**
+	 * \brief Decodes any image stb reads, has_alpha is set when a texel isn't opaque.
+	 * \return nothing when the file is missing or can't be decoded
+	 */
+	LIBGRAPHICS_API auto LoadSourceImage(const std::filesystem::path& path) -> std::optional<SourceImage>;
+
+	/**
+	 * \brief RGBA8 mip chain down to 1x1, level 0 (a copy of rgba) first. Color roles are averaged in linear space,
+	 * normal maps are renormalized at every level so they don't flatten in the distance.
+	 */
+	LIBGRAPHICS_API auto GenerateMipChain(const std::span<const uint8_t> rgba, const int width, const int height, const TextureRole role) -> std::vector<CookedMip>;
+
+	/**
+	 * \brief Builds the mip chain and compresses every level with the format of the role, blocks are encoded in parallel
+	 * on the job system.
+	 */
+	LIBGRAPHICS_API auto CookTexture(const std::span<const uint8_t> rgba, const int width, const int height, const TextureRole role) -> CookedTexture;
+
+	/**
+	 * \brief Writes a KTX2 container (no supercompression).
+	 * \return false when the file can't be written
+	 */
+	LIBGRAPHICS_API auto WriteKtx2(const std::filesystem::path& path, const CookedTexture& texture) -> bool;
+
+	struct Ktx2Level
+	{
+		uint64_t m_offset = {};
+		uint64_t m_size = {};
+		int m_width = {};
+		int m_height = {};
+	};
+
+	/**
+	 * \brief Format and level index of a KTX2 file, level 0 first, enough to read any of its levels alone.
+	 */
+	struct Ktx2Layout
+	{
+		BlockFormat m_format = {};
+		bool m_is_srgb = {};
+		std::vector<Ktx2Level> m_levels = {};
+	};
+
+	/**
+	 * \brief Reads the header and level index of a KTX2 file, none of its texels.
+	 * \return nothing when the file is missing, malformed or in a format ReadKtx2 doesn't take
+	 */
+	LIBGRAPHICS_API auto ReadKtx2Layout(const std::filesystem::path& path) -> std::optional<Ktx2Layout>;
+
+	/**
+	 * \brief Reads levels_count levels from first_level, the first mip of the result is first_level.
+	 */
+	LIBGRAPHICS_API auto ReadKtx2Levels(const std::filesystem::path& path, const Ktx2Layout& layout, const size_t first_level, const size_t levels_count) -> std::optional<CookedTexture>;
+
+	/**
+	 * \brief Reads a KTX2 file written by WriteKtx2 (or any 2D, single layer KTX2 in one of the block formats).
+	 * \return nothing when the file is missing, malformed or in another format
+	 */
+	LIBGRAPHICS_API auto ReadKtx2(const std::filesystem::path& path) -> std::optional<CookedTexture>;
+
+	/**
+	 * \brief Where the cooked version of an image is looked for: next to it, same name, .ktx2 extension.
+	 */
+	LIBGRAPHICS_API auto GetCookedTexturePath(const std::filesystem::path& image_path) -> std::filesystem::path;
+}
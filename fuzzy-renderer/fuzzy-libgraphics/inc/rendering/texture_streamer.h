@@ -0,0 +1,167 @@
+#pragma once
+
+#include <engine_constants.h>
+#include <job_system.h>
+#include <memory_tracker.h>
+#include <rendering/texture.h>
+#include <rendering/texture_cooker.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace libgraphics
+{
+	/**
+	 * \brief A cooked texture with only its mip tail read, what the streamer creates a texture from.
+	 */
+	struct StreamableTexture
+	{
+		std::filesystem::path m_path = {};
+		Ktx2Layout m_layout = {};
+
+		// the levels from m_tail_level to the last one, the ones always resident
+		CookedTexture m_mip_tail = {};
+		size_t m_tail_level = {};
+	};
+
+	/**
+	 * \brief Streaming state of a texture, shared by its storage (which the recording workers reach it through) and the
+	 * streamer.
+	 */
+	struct StreamedTexture
+	{
+		std::filesystem::path m_path = {};
+		Ktx2Layout m_layout = {};
+		size_t m_tail_level = {};
+
+		// finest level resident, the coarser ones all are
+		size_t m_resident_level = {};
+		uint64_t m_resident_bytes = {};
+
+		// widest a mesh using the texture covered on screen (pixels) since the last update, written by the recording workers
+		std::atomic<uint32_t> m_requested_pixels = {};
+		size_t m_wanted_level = {};
+		uint64_t m_last_needed_frame = {};
+
+		// level being read by a job, its texels are there once m_is_read is set
+		std::optional<size_t> m_reading_level = {};
+		std::atomic<bool> m_is_read = {};
+		std::optional<CookedTexture> m_read_level = {};
+	};
+
+	/**
+	 * \brief Streams the mips of the cooked (KTX2) textures. They are created with their mip tail only, finer levels are
+	 * asked for by the recording workers from the screen size of the visible meshes using them, read on the job system
+	 * and uploaded through a ring of persistently mapped pixel buffers a few MB per frame. Over the residency budget the
+	 * finest levels of the least recently needed textures are dropped. Every texture change happens in Update, on the
+	 * render thread, between two recordings.
+	 */
+	class TextureStreamer
+	{
+	public:
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> TextureStreamer&;
+
+		/**
+		 * \brief Reads the level index and the mip tail (levels of MipTailSize texels or less) of a cooked file. Any thread.
+		 * \return nothing when the file is missing or malformed
+		 */
+		[[nodiscard]] static auto LoadMipTail(const std::filesystem::path& cooked_path) -> std::optional<StreamableTexture>;
+
+		/**
+		 * \brief Uploads the mip tail, the texture is streamed from then on if it has finer levels. Render thread.
+		 * \param source what the memory tracker reports the texture as
+		 */
+		[[nodiscard]] auto CreateTexture(StreamableTexture streamable_texture, const std::string_view source, const TextureType type) -> Texture;
+
+		/**
+		 * \brief Turns the requests of the last recording into reads, uploads the levels read and evicts over the
+		 * budget. Render thread, once per frame, while no recording is in flight.
+		 */
+		auto Update() -> void;
+
+		/**
+		 * \brief Stops streaming a texture whose storage is about to get another GL texture, dropped (with its reads and
+		 * resident bytes) by the next Update. Render thread.
+		 */
+		auto Forget(const Texture::Storage& storage) -> void;
+
+		/**
+		 * \brief Waits for the reads in flight, forgets every texture (they keep the levels they have) and releases the
+		 * upload ring. Render thread.
+		 */
+		auto Clear() -> void;
+
+		LIBGRAPHICS_API auto SetBudget(const uint64_t budget_bytes) -> void { m_budget_bytes = budget_bytes; }
+		[[nodiscard]] auto GetBudget() const -> uint64_t { return m_budget_bytes; }
+
+		[[nodiscard]] auto GetStreamedTexturesCount() const -> size_t { return m_textures.size(); }
+		[[nodiscard]] auto GetResidentBytes() const -> uint64_t { return m_resident_bytes; }
+		[[nodiscard]] auto GetReadsCount() const -> size_t { return m_reads_count; }
+		[[nodiscard]] auto GetUploadedBytes() const -> uint64_t { return m_uploaded_bytes; }
+		[[nodiscard]] auto GetEvictedBytes() const -> uint64_t { return m_evicted_bytes; }
+
+	private:
+		TextureStreamer() = default;
+
+		struct Entry
+		{
+			std::weak_ptr<Texture::Storage> m_storage = {};
+			std::shared_ptr<StreamedTexture> m_streamed = {};
+		};
+
+		struct RingSegment
+		{
+			GLsync m_fence = {};
+		};
+
+		auto IssueReads() -> void;
+		auto UploadReadLevels() -> void;
+
+		/**
+		 * \brief Drops the finest level of the least recently needed textures until bytes more fit in the budget. Textures
+		 * needed this frame are kept.
+		 * \return false when they still don't
+		 */
+		auto MakeRoom(const uint64_t bytes) -> bool;
+
+		/**
+		 * \brief Moves the texture to a new GL texture holding the levels from resident_level, the levels both have are
+		 * copied on the GPU. level_data, when set, is the texels of the one level the new texture adds.
+		 */
+		auto SetResidentLevel(Texture::Storage& storage, StreamedTexture& streamed, const size_t resident_level, const void* level_data) -> void;
+
+		/**
+		 * \brief Room for size bytes in this frame segment of the upload ring.
+		 * \return the offset of the room in the ring buffer, nothing when the segment is full
+		 */
+		auto AllocateUpload(const uint64_t size) -> std::optional<uint64_t>;
+		auto AllocateRing() -> void;
+		auto ReleaseRing() -> void;
+
+		std::vector<Entry> m_textures = {};
+		uint64_t m_budget_bytes = constants::TextureStreamingBudgetBytes;
+		uint64_t m_resident_bytes = {};
+		uint64_t m_reserved_bytes = {};
+		uint64_t m_frame_index = {};
+		size_t m_reads_count = {};
+		JobCounter m_reads_counter = {};
+
+		// upload ring, one segment per frame in flight
+		GLuint m_ring_buffer = {};
+		uint8_t* m_ring_mapped = {};
+		std::vector<RingSegment> m_ring_segments = {};
+		size_t m_ring_segment_idx = {};
+		uint64_t m_ring_segment_used = {};
+		TrackedMemory m_ring_memory = {};
+
+		// totals since startup, for the stats window
+		uint64_t m_uploaded_bytes = {};
+		uint64_t m_evicted_bytes = {};
+	};
+}
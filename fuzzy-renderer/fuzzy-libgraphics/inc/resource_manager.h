@@ -1,53 +1,175 @@
 #pragma once
 
-#include <logger.h>
+#include <enums.h>
+#include <framework.h>
 
+#include <array>
+#include <functional>
+#include <limits>
 #include <memory>
-#include <optional>
-#include <ranges>
-
-#include <enums.h>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 
 namespace libgraphics
 {
-	class IShader;
+	constexpr auto InvalidResourceId = std::numeric_limits<uint32_t>::max();
 
-	template <std::derived_from<IShader> Resource>
-	struct ResourceParams
+	/**
+	 * \brief Names a resource of the ResourceManager, typed so that a shader handle can't be used for a mesh. Stays
+	 * valid when the resource is evicted, it is loaded again when asked for. Ids are never reused, a handle outliving
+	 * its resource (forgotten, or the manager cleared) finds nothing rather than another one.
+	 */
+	template <typename Resource>
+	class ResourceHandle
 	{
-		ResourceType m_resource_type = {};
-		std::string m_name = {};
-		std::shared_ptr<Resource> m_resource = {}; // this can even be removed and i can use an Object_Ref -> Resource& m_resource = {};
+	public:
+		ResourceHandle() = default;
+
+		[[nodiscard]] auto IsValid() const -> bool { return m_id != InvalidResourceId; }
+		[[nodiscard]] auto GetId() const -> uint32_t { return m_id; }
+
+		auto operator==(const ResourceHandle&) const -> bool = default;
+
+	private:
+		friend class ResourceManager;
+
+		explicit ResourceHandle(const uint32_t id) : m_id{ id } {}
+
+		uint32_t m_id = InvalidResourceId;
 	};
 
-	template <std::derived_from<IShader> Resource>
-	using Resources = std::vector<ResourceParams<Resource>>;
+	/**
+	 * \brief What the stats window shows of a resource.
+	 */
+	struct ResourceInfo
+	{
+		std::string m_name = {};
+		uint64_t m_bytes = {};
+		uint32_t m_users_count = {};
+		bool m_is_loaded = {};
+	};
 
+	/**
+	 * \brief The named resources of the engine (shaders, textures, meshes, materials, cubemaps), loaded once and found
+	 * by name. A resource nothing uses anymore (no copy of its pointer outside the manager) is evicted, least recently
+	 * used first, when its type goes over its budget: one registered with the function loading it is loaded again when
+	 * asked for, one created elsewhere and tracked (the textures of the texture cache, the meshes of the models) is
+	 * forgotten. Keep handles rather than pointers for what can be evicted. Render thread only, loaders create GL objects.
+	 */
 	class ResourceManager
 	{
 	public:
-		template <std::derived_from<IShader> Resource>
-		static void RegisterResource(const ResourceParams<Resource>& params)
+		ResourceManager(const ResourceManager&) = delete;
+		ResourceManager& operator=(const ResourceManager&) = delete;
+
+		LIBGRAPHICS_API static auto GetInstance() -> ResourceManager&;
+
+		/**
+		 * \brief Registers the resource, the one already registered under name is kept. Loaded by the first Get.
+		 * \param loader creates the resource, called again after an eviction; a nullptr result is an error
+		 * \return an invalid handle when name is registered with another resource type
+		 */
+		template <typename Resource>
+		auto Load(const ResourceType type, std::string name, std::function<std::shared_ptr<Resource>()> loader) -> ResourceHandle<Resource>
 		{
-		  if (!find_private(params)) m_resources<Resource>.push_back(params);
-			else CX_CORE_ERROR("This resource will not be loaded as it's already registered, please use GetFromCache() to retrieve it.");
+			auto id = FindId(type, name, typeid(Resource));
+			if (id == InvalidResourceId && !IsRegistered(type, name))
+			{
+				id = Register(type, std::move(name), typeid(Resource), [loader = std::move(loader)]() -> std::shared_ptr<void> { return loader(); });
+			}
+			return ResourceHandle<Resource>{ id };
 		}
 
-		template <std::derived_from<IShader> Resource>
-		[[nodiscard]] static auto GetFromCache(const ResourceParams<Resource>& params) -> std::optional<decltype(std::declval<ResourceParams<Resource>>().m_resource)> { return find_private(params).value().m_resource; }
+		/**
+		 * \brief Accounts for a resource created elsewhere, it can't be loaded again and is forgotten once evicted. The
+		 * one tracked under name before is replaced: it stays alive with its users, no longer accounted for.
+		 * \param bytes its size, for the budget
+		 * \return an invalid handle when name is registered with another resource type
+		 */
+		template <typename Resource>
+		auto Track(const ResourceType type, std::string name, std::shared_ptr<Resource> resource, const uint64_t bytes) -> ResourceHandle<Resource>
+		{
+			return ResourceHandle<Resource>{ Adopt(type, std::move(name), typeid(Resource), std::move(resource), bytes) };
+		}
 
-		template <std::derived_from<IShader> Resource>
-		static auto GetAllFromCache() { return m_resources<Resource>; }
+		/**
+		 * \brief The handle of a registered resource, without loading it
+		 * \return an invalid handle when there is none (of this resource type)
+		 */
+		template <typename Resource>
+		[[nodiscard]] auto Find(const ResourceType type, const std::string_view name) const -> ResourceHandle<Resource>
+		{
+			return ResourceHandle<Resource>{ FindId(type, name, typeid(Resource)) };
+		}
+
+		/**
+		 * \brief The resource, loaded again if it was evicted. Marks it as used this frame, it isn't evicted by this Update.
+		 * \return nullptr for an invalid or stale handle, or when loading fails
+		 */
+		template <typename Resource>
+		[[nodiscard]] auto Get(const ResourceHandle<Resource> handle) -> std::shared_ptr<Resource>
+		{
+			return std::static_pointer_cast<Resource>(GetResource(handle.m_id));
+		}
+
+		/**
+		 * \brief Evicts the least recently used resources nothing uses of each type over its budget. Once per frame, at its end.
+		 */
+		auto Update() -> void;
+
+		/**
+		 * \brief Forgets every resource (the copies still in use stay alive), the handles find nothing anymore
+		 */
+		auto Clear() -> void;
+
+		LIBGRAPHICS_API auto SetBudget(const ResourceType type, const uint64_t budget_bytes) -> void { m_budgets[static_cast<size_t>(type)] = budget_bytes; }
+		[[nodiscard]] auto GetBudget(const ResourceType type) const -> uint64_t { return m_budgets[static_cast<size_t>(type)]; }
+		[[nodiscard]] auto GetLoadedBytes(const ResourceType type) const -> uint64_t { return m_loaded_bytes[static_cast<size_t>(type)]; }
+		[[nodiscard]] auto GetEvictionsCount() const -> size_t { return m_evictions_count; }
+
+		/**
+		 * \brief The resources of a type in registration order, loaded or evicted
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto GetResources(const ResourceType type) const -> std::vector<ResourceInfo>;
 
 	private:
-		template <std::derived_from<libgraphics::IShader> Resource>
-		inline static Resources<Resource> m_resources = {};
+		ResourceManager();
 
-		template <std::derived_from<libgraphics::IShader> Resource, typename ReturnType = typename std::optional<ResourceParams<Resource>>::value_type>
-		static auto find_private(const ResourceParams<Resource>& params) -> std::optional<ReturnType>
+		static constexpr auto TypesCount = static_cast<size_t>(ResourceType::max_enum);
+
+		struct Entry
 		{
-			auto it = std::ranges::find(m_resources<Resource>, params.m_name, &ResourceParams<Resource>::m_name);
-			return it != m_resources<Resource>.end() ? *it : std::optional<ReturnType>{};
-		}
+			std::string m_name = {};
+			ResourceType m_type = {};
+			std::type_index m_resource_type = typeid(void);
+			std::function<std::shared_ptr<void>()> m_loader = {};
+
+			std::shared_ptr<void> m_resource = {};
+			uint64_t m_bytes = {};
+			uint64_t m_last_used_frame = {};
+		};
+
+		LIBGRAPHICS_API [[nodiscard]] auto FindId(const ResourceType type, const std::string_view name, const std::type_index resource_type) const -> uint32_t;
+		LIBGRAPHICS_API [[nodiscard]] auto IsRegistered(const ResourceType type, const std::string_view name) const -> bool;
+		LIBGRAPHICS_API auto Register(const ResourceType type, std::string name, const std::type_index resource_type, std::function<std::shared_ptr<void>()> loader) -> uint32_t;
+		LIBGRAPHICS_API auto Adopt(const ResourceType type, std::string name, const std::type_index resource_type, std::shared_ptr<void> resource, const uint64_t bytes) -> uint32_t;
+		LIBGRAPHICS_API [[nodiscard]] auto GetResource(const uint32_t id) -> std::shared_ptr<void>;
+
+		auto LoadEntry(Entry& entry) -> void;
+		auto Evict(const ResourceType type) -> void;
+
+		// ids only grow, Clear included
+		std::unordered_map<uint32_t, Entry> m_entries = {};
+		std::array<std::unordered_map<std::string, uint32_t>, TypesCount> m_ids_by_name = {};
+		uint32_t m_next_id = {};
+
+		std::array<uint64_t, TypesCount> m_budgets = {};
+		std::array<uint64_t, TypesCount> m_loaded_bytes = {};
+
+		uint64_t m_frame_index = {};
+		size_t m_evictions_count = {};
 	};
 }
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <rendering/command_list.h>
+
+namespace libgraphics
+{
+	class SWRasterizer;
+
+	/**
+	 * \brief Replays command lists into the software rasterizer. Constants are tracked in a local copy of the bound
+	 * program's constants, every draw takes a snapshot of them. Texture bindings are ignored.
+	 */
+	class SWCommandExecutor
+	{
+	public:
+		static auto Execute(const CommandList& command_list, SWRasterizer& rasterizer) -> void;
+	};
+}
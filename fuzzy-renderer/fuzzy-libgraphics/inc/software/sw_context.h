@@ -0,0 +1,36 @@
+#pragma once
+
+#include "interfaces/igraphics_context.h"
+
+namespace libgraphics
+{
+	class SWRasterizer;
+
+	/**
+	 * \brief "Context" of the software backend: no driver and no window, just the rasterizer and its framebuffer.
+	 */
+	class SWContext : public IGraphicsContext
+	{
+	public:
+		SWContext() = default;
+		SWContext(const SWContext&) = delete;
+		SWContext(SWContext&&) = delete;
+		~SWContext() override;
+
+		auto Init(const int width, const int height, const std::string_view title) -> void override;
+		auto Shutdown() -> void override;
+		auto Data() const -> const ContextData& override { return m_context_data; }
+		auto Data() -> ContextData& override { return m_context_data; }
+
+		/**
+		 * \brief The SWRasterizer
+		 */
+		[[nodiscard]] auto GetNativeHandle() const -> void* override { return m_rasterizer.get(); }
+
+		[[nodiscard]] auto GetRasterizer() const -> SWRasterizer& { return *m_rasterizer; }
+
+	private:
+		ContextData m_context_data = {};
+		std::unique_ptr<SWRasterizer> m_rasterizer = {};
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <interfaces/imesh.h>
+#include <rendering/mesh_data.h>
+#include <rendering/texture.h>
+
+#include <optional>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Mesh of the software backend, vertices and indices stay in system memory and are read by the rasterizer.
+	 * Textures aren't supported so GetTextures is always empty.
+	 */
+	class SWMesh final : public IMesh
+	{
+	public:
+		SWMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::string name = {}, const std::optional<BoundingBox>& bounds = {});
+
+		/**
+		 * \brief Rasterizes the mesh right away with the current constants of the shader (an SWShader)
+		 */
+		auto Draw(const std::shared_ptr<IShader>& shader) -> void override;
+
+		[[nodiscard]] auto GetData() const -> const std::shared_ptr<const MeshData>& override { return m_data; }
+		[[nodiscard]] auto GetVertexBuffer() const -> std::span<const Vertex> override { return GetVertices(); }
+		[[nodiscard]] auto GetIndexBuffer() const -> std::span<const uint32_t> override { return GetIndices(); }
+
+		[[nodiscard]] auto GetIndexCount() const -> uint32_t override { return static_cast<uint32_t>(GetIndices().size()); }
+		[[nodiscard]] auto GetBounds() const -> const BoundingBox& override { return m_bounds; }
+		[[nodiscard]] auto GetTextures() const -> const std::vector<Texture>& override { return m_textures; }
+		[[nodiscard]] auto GetName() const -> const std::string& override { return m_name; }
+
+		/**
+		 * \brief Non copying access for the rasterizer
+		 */
+		[[nodiscard]] auto GetVertices() const -> std::span<const Vertex> { return m_data ? m_data->GetVertices() : std::span<const Vertex>{}; }
+		[[nodiscard]] auto GetIndices() const -> std::span<const uint32_t> { return m_data ? m_data->GetIndices() : std::span<const uint32_t>{}; }
+
+	private:
+		auto ComputeBounds() -> void;
+		auto SetData(std::vector<Vertex> vertices, std::vector<uint32_t> indices) -> void;
+
+		// the only copy there is, whatever the policy, accounted as CPU mesh memory
+		std::shared_ptr<const MeshData> m_data = {};
+		std::vector<Texture> m_textures = {};
+		std::string m_name = {};
+
+		BoundingBox m_bounds = {};
+	};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <framework.h>
+#include <rendering/light.h>
+#include <software/sw_shader.h>
+
+#include <array>
+#include <optional>
+
+namespace libgraphics
+{
+	class SWMesh;
+
+	/**
+	 * \brief Color (RGBA8) and depth planes, rows are stored bottom first like glReadPixels returns them.
+	 */
+	struct SWFramebuffer
+	{
+		int m_width = {};
+		int m_height = {};
+		std::vector<uint32_t> m_color = {};
+		std::vector<float> m_depth = {};
+	};
+
+	/**
+	 * \brief Tile based CPU rasterizer. Draws are transformed, clipped and set up on the job system as they are
+	 * submitted, then binned into screen tiles. Flush() rasterizes the tiles in parallel: every tile belongs to a
+	 * single job and walks its triangles in submission order, so results don't depend on the number of threads.
+	 * Edge functions and depth test run 8 pixels at a time with AVX2 when the CPU has it (scalar otherwise,
+	 * both evaluate the same operations in the same order). Pipeline state mirrors the GL one: depth less,
+	 * clockwise faces culled, top-left fill rule.
+	 */
+	class SWRasterizer
+	{
+	public:
+		SWRasterizer(const int width, const int height);
+
+		/**
+		 * \brief Clears color and depth, applied by the tiles at the beginning of the next Flush.
+		 */
+		auto Clear(const glm::vec4& color) -> void;
+
+		/**
+		 * \brief Lights used by the draws flushed from now on.
+		 */
+		auto SetLights(const std::vector<std::shared_ptr<Light>>& lights) -> void;
+
+		auto DrawIndexed(const SWMesh& mesh, const SWShaderConstants& constants, const uint32_t instance_count = 1) -> void;
+
+		/**
+		 * \brief Rasterizes everything submitted since the last flush into the framebuffer.
+		 */
+		auto Flush() -> void;
+
+		[[nodiscard]] auto GetFramebuffer() const -> const SWFramebuffer& { return m_framebuffer; }
+		[[nodiscard]] auto IsUsingAVX2() const -> bool { return m_use_avx2; }
+		[[nodiscard]] auto GetFlushedTrianglesCount() const -> uint32_t { return m_flushed_triangles_count; }
+
+	private:
+		static constexpr auto TileSize = 64;
+
+		struct ClipVertex
+		{
+			glm::vec4 m_clip_position = {};
+			glm::vec3 m_world_position = {};
+			glm::vec3 m_world_normal = {};
+		};
+
+		// everything the tiles need, in window space (y up), attributes pre-divided by w
+		struct Triangle
+		{
+			std::array<float, 3> m_x = {};
+			std::array<float, 3> m_y = {};
+			std::array<float, 3> m_z = {};
+			std::array<float, 3> m_inv_w = {};
+			std::array<glm::vec3, 3> m_world_position = {};
+			std::array<glm::vec3, 3> m_world_normal = {};
+			float m_inv_area = {};
+			int m_min_x = {};
+			int m_min_y = {};
+			int m_max_x = {};
+			int m_max_y = {};
+			uint32_t m_draw = {};
+		};
+
+		auto SetupTriangle(const std::array<ClipVertex, 3>& vertices, const uint32_t draw_idx, std::vector<Triangle>& out_triangles) const -> void;
+		auto RasterizeTile(const int tile_idx) -> void;
+		auto ShadePixel(const Triangle& triangle, const float l0, const float l1, const float l2) const -> uint32_t;
+
+		SWFramebuffer m_framebuffer = {};
+		int m_tiles_x = {};
+		int m_tiles_y = {};
+		bool m_use_avx2 = {};
+
+		std::optional<uint32_t> m_pending_clear_color = {};
+		std::vector<Light> m_lights = {};
+
+		std::vector<SWShaderConstants> m_draws = {};
+		std::vector<Triangle> m_triangles = {};
+		std::vector<std::vector<uint32_t>> m_tile_bins = {};
+		std::vector<ClipVertex> m_clip_vertices = {};
+		std::vector<std::vector<Triangle>> m_setup_batches = {};
+		uint32_t m_flushed_triangles_count = {};
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <interfaces/ishader.h>
+
+namespace libgraphics
+{
+	/**
+	 * \brief Constants of the software default program, same names as the GLSL default shader uniforms.
+	 * Textures aren't supported by the software backend so the samplers have no counterpart.
+	 */
+	struct SWShaderConstants
+	{
+		glm::mat4 m_model = glm::mat4{ 1.0f };
+		glm::mat4 m_view = glm::mat4{ 1.0f };
+		glm::mat4 m_projection = glm::mat4{ 1.0f };
+		glm::vec3 m_eye = {};
+		glm::vec3 m_albedo_color = glm::vec3{ 1.0f };
+		glm::vec3 m_emission_color = {};
+		float m_metallic = {};
+		float m_roughness = {};
+		int m_use_textures = {};
+	};
+
+	/**
+	 * \brief IShader of the software rasterizer. It only holds constants (the C++ port of the default lighting lives
+	 * in the rasterizer), draws take a snapshot of them the same way GL uniforms are latched at draw time.
+	 */
+	class SWShader final : public IShader
+	{
+	public:
+		SWShader() = default;
+
+		auto Bind() const -> void override {}
+		auto Unbind() const -> void override {}
+
+		auto SetMatrix4x4(const std::string_view name, const glm::mat4& m) -> void override { SetConstantData(GetConstantSlot(name), &m); }
+		auto SetFloat(const std::string_view name, const float value) -> void override { SetConstantData(GetConstantSlot(name), &value); }
+		auto SetVec3(const std::string_view name, const glm::vec3& value) -> void override { SetConstantData(GetConstantSlot(name), &value); }
+		auto SetInt(const std::string_view name, const int value) -> void override { SetConstantData(GetConstantSlot(name), &value); }
+		auto SetUint(const std::string_view name, const uint32_t value) -> void override { SetConstantData(GetConstantSlot(name), &value); }
+		auto SetBool(const std::string_view name, const bool value) -> void override { const auto int_value = static_cast<int>(value); SetConstantData(GetConstantSlot(name), &int_value); }
+
+		[[nodiscard]] auto GetConstantSlot(const std::string_view name) const -> int32_t override;
+		auto GetID() const -> GLuint override { return 0; }
+		auto GetLightsBufferID() const -> GLuint override { return 0; }
+
+		auto SetConstantData(const int32_t slot, const void* data) -> void { WriteConstant(m_constants, slot, data); }
+
+		/**
+		 * \brief Writes a constant from raw data, the size is implied by the slot. Negative slots are ignored.
+		 */
+		static auto WriteConstant(SWShaderConstants& constants, const int32_t slot, const void* data) -> void;
+
+		[[nodiscard]] auto GetConstants() const -> const SWShaderConstants& { return m_constants; }
+
+	private:
+		SWShaderConstants m_constants = {};
+	};
+}
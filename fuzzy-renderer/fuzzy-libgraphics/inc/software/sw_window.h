@@ -0,0 +1,35 @@
+#pragma once
+
+#include <interfaces/igraphics_window.h>
+#include <color.h>
+
+namespace libgraphics
+{
+	class IGraphicsContext;
+
+	/**
+	 * \brief Window of the software backend, frames live in the rasterizer framebuffer and are never presented.
+	 * SwapBuffers flushes the rasterizer, read the result back with ReadPixels.
+	 */
+	class SWWindow final : public IGraphicsWindow
+	{
+	public:
+		auto Create(const int width, const int height, const std::string_view title) -> void override;
+		auto Destroy() -> void override;
+		auto Clear() -> void override;
+		auto SwapBuffers() -> void override;
+		[[nodiscard]] auto ShouldClose() const -> bool override { return false; }
+		[[nodiscard]] auto GetBackbufferID() const -> uint32_t override { return 0; }
+		[[nodiscard]] auto GetNativeHandle() const -> const std::shared_ptr<IGraphicsContext>& override { return m_graphics_context; }
+		auto SetClearColor(const Color&) -> void override;
+
+		/**
+		 * \brief Last flushed frame, tightly packed RGBA8 rows, bottom row first (same layout as GLHeadlessWindow::ReadPixels).
+		 */
+		LIBGRAPHICS_API [[nodiscard]] auto ReadPixels() const -> std::vector<uint8_t>;
+
+	private:
+		Color m_clear_color = {};
+		std::shared_ptr<IGraphicsContext> m_graphics_context;
+	};
+}
@@ -19,7 +19,7 @@ namespace utils::gl
 	 */
 	auto LoadCubemap(const std::string_view folder_path) -> uint32_t;
 
-	auto CheckRayMeshIntersection(const glm::vec3& ray_origin, const glm::vec3& ray_direction, const libgraphics::GLMesh& mesh) -> std::optional<libgraphics::RayHit>;
+	LIBGRAPHICS_API auto CheckRayMeshIntersection(const glm::vec3& ray_origin, const glm::vec3& ray_direction, const libgraphics::GLMesh& mesh) -> std::optional<libgraphics::RayHit>;
 }
 
 namespace utils::common
@@ -69,7 +69,9 @@ float calculateSpecular(vec3 lightDir, vec3 viewDir, vec3 normal)
 
 vec3 calculateNormal(vec3 worldNormal, vec3 worldTangent, vec3 worldBitangent, vec3 textureNormal) 
 {
-    vec3 normal = textureNormal * 2.0 - 1.0;
+    // z is rebuilt from x and y: BC5 normal maps only store those two
+    vec3 normal = vec3(textureNormal.xy * 2.0 - 1.0, 0.0);
+    normal.z = sqrt(max(1.0 - dot(normal.xy, normal.xy), 0.0));
     vec3 tangent = normalize(worldTangent);
     vec3 bitangent = normalize(worldBitangent);
     mat3 TBN = mat3(tangent, bitangent, worldNormal);
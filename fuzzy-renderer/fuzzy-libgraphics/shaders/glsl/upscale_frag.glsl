@@ -0,0 +1,44 @@
+#version 460 core
+
+out vec4 FragColor;
+
+in vec2 out_uv;
+
+uniform sampler2D source;
+
+// rendered area of the source texture (in uv) and the size of one of its texels
+uniform vec2 uv_scale;
+uniform vec2 texel_size;
+
+// 0 = plain bilinear, 1 = strongest sharpening
+uniform float sharpness;
+
+vec3 sampleSource(vec2 uv)
+{
+    // never filter texels outside of the rendered area
+    return texture(source, clamp(uv, texel_size * 0.5, uv_scale - texel_size * 0.5)).rgb;
+}
+
+void main()
+{
+    vec2 uv = out_uv * uv_scale;
+    vec3 center = sampleSource(uv);
+
+    if (sharpness <= 0.0)
+    {
+        FragColor = vec4(center, 1.0);
+        return;
+    }
+
+    vec3 north = sampleSource(uv + vec2(0.0, texel_size.y));
+    vec3 south = sampleSource(uv - vec2(0.0, texel_size.y));
+    vec3 east = sampleSource(uv + vec2(texel_size.x, 0.0));
+    vec3 west = sampleSource(uv - vec2(texel_size.x, 0.0));
+
+    // unsharp mask, limited by the local contrast so edges don't ring
+    vec3 minimum = min(center, min(min(north, south), min(east, west)));
+    vec3 maximum = max(center, max(max(north, south), max(east, west)));
+    vec3 sharpened = center + (4.0 * center - north - south - east - west) * (sharpness * 0.25);
+
+    FragColor = vec4(clamp(sharpened, minimum, maximum), 1.0);
+}
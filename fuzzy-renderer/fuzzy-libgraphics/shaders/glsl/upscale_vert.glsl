@@ -0,0 +1,10 @@
+#version 460 core
+
+out vec2 out_uv;
+
+// fullscreen triangle, no vertex buffer needed
+void main()
+{
+	out_uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(out_uv * 2.0 - 1.0, 0.0, 1.0);
+}
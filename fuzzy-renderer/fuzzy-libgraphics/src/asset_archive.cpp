@@ -0,0 +1,483 @@
+#include <asset_archive.h>
+
+#include <logger.h>
+#include <render_profiler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <type_traits>
+
+namespace libgraphics
+{
+	namespace
+	{
+		constexpr auto ArchiveMagic = std::array<char, 8>{ 'F', 'Z', 'P', 'A', 'K', '\r', '\n', '\x1a' };
+		constexpr uint32_t ArchiveVersion = 1;
+
+		// stored entries start on a page, so that the view of one never shares a page with another entry
+		constexpr uint64_t StoredAlignment = 4096;
+		constexpr uint64_t ArchiveAlignment = 16;
+
+		// an eighth of the entry at least, or it is stored
+		constexpr uint64_t MinCompressionSaving = 8;
+
+		struct ArchiveHeader
+		{
+			std::array<char, 8> m_magic = {};
+			uint32_t m_version = {};
+			uint32_t m_entries_count = {};
+			uint64_t m_entries_offset = {};
+			uint64_t m_names_offset = {};
+			uint64_t m_names_size = {};
+			uint32_t m_root_offset = {};
+			uint32_t m_root_size = {};
+			uint64_t m_file_size = {};
+			uint64_t m_padding = {};
+		};
+
+		static_assert(sizeof(ArchiveHeader) == 64 && sizeof(AssetArchiveEntry) == 48 && std::is_trivially_copyable_v<AssetArchiveEntry>);
+
+		// LZ4 block format: a sequence is a token (literals count, match length - 4), the literals, a 2 bytes offset and
+		// the match; the last one is literals only. The last 5 bytes are always literals and the last match starts 12
+		// bytes before the end at least, what the reference decoder relies on.
+		constexpr size_t Lz4MinMatch = 4;
+		constexpr size_t Lz4LastLiterals = 5;
+		constexpr size_t Lz4MatchStartLimit = 12;
+		constexpr size_t Lz4MaxOffset = 65535;
+		constexpr uint32_t Lz4HashBits = 16;
+
+		auto ReadU32(const std::span<const uint8_t> bytes, const size_t offset) -> uint32_t
+		{
+			auto value = uint32_t{};
+			std::memcpy(&value, bytes.data() + offset, sizeof(value));
+			return value;
+		}
+
+		auto AppendLength(std::vector<uint8_t>& output, size_t length) -> void
+		{
+			for (; length >= 255; length -= 255)
+			{
+				output.push_back(255);
+			}
+			output.push_back(static_cast<uint8_t>(length));
+		}
+
+		auto AppendSequence(std::vector<uint8_t>& output, const std::span<const uint8_t> literals, const size_t offset, const size_t match_length) -> void
+		{
+			const auto match_extra = match_length - Lz4MinMatch;
+			output.push_back(static_cast<uint8_t>(std::min<size_t>(literals.size(), 15) << 4 | std::min<size_t>(match_extra, 15)));
+			if (literals.size() >= 15)
+			{
+				AppendLength(output, literals.size() - 15);
+			}
+			output.insert(output.end(), literals.begin(), literals.end());
+
+			output.push_back(static_cast<uint8_t>(offset & 0xff));
+			output.push_back(static_cast<uint8_t>(offset >> 8));
+			if (match_extra >= 15)
+			{
+				AppendLength(output, match_extra - 15);
+			}
+		}
+
+		auto AppendLastLiterals(std::vector<uint8_t>& output, const std::span<const uint8_t> literals) -> void
+		{
+			output.push_back(static_cast<uint8_t>(std::min<size_t>(literals.size(), 15) << 4));
+			if (literals.size() >= 15)
+			{
+				AppendLength(output, literals.size() - 15);
+			}
+			output.insert(output.end(), literals.begin(), literals.end());
+		}
+
+		/**
+		 * \brief Adds the extra length bytes of a 15 in a token to length.
+		 * \return false when the input ends first
+		 */
+		auto ReadLength(const std::span<const uint8_t> input, size_t& input_idx, size_t& length) -> bool
+		{
+			auto byte = uint8_t{ 255 };
+			while (byte == 255)
+			{
+				if (input_idx == input.size())
+				{
+					return false;
+				}
+				byte = input[input_idx++];
+				length += byte;
+			}
+			return true;
+		}
+
+		auto ReadWholeFile(const std::filesystem::path& path) -> std::optional<std::vector<uint8_t>>
+		{
+			auto file = std::ifstream{ path, std::ios::binary | std::ios::ate };
+			if (!file.is_open())
+			{
+				return std::nullopt;
+			}
+
+			auto bytes = std::vector<uint8_t>(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+			{
+				return std::nullopt;
+			}
+			return bytes;
+		}
+
+		auto AlignUp(const uint64_t value, const uint64_t alignment) -> uint64_t { return (value + alignment - 1) / alignment * alignment; }
+	}
+
+	auto Lz4Compress(const std::span<const uint8_t> input) -> std::vector<uint8_t>
+	{
+		auto output = std::vector<uint8_t>{};
+		output.reserve(input.size() + input.size() / 255 + 16);
+
+		auto anchor = size_t{ 0 };
+
+		if (input.size() > Lz4MatchStartLimit)
+		{
+			// last position each 4 bytes were seen at, greedy: the first match found is taken
+			auto positions = std::vector<uint32_t>(size_t{ 1 } << Lz4HashBits);
+			const auto match_start_end = input.size() - Lz4MatchStartLimit;
+			const auto match_end_limit = input.size() - Lz4LastLiterals;
+
+			auto position = size_t{ 0 };
+			while (position < match_start_end)
+			{
+				const auto sequence = ReadU32(input, position);
+				const auto hash = (sequence * 2654435761u) >> (32 - Lz4HashBits);
+				const auto candidate = static_cast<size_t>(positions[hash]);
+				positions[hash] = static_cast<uint32_t>(position);
+
+				if (candidate >= position || position - candidate > Lz4MaxOffset || ReadU32(input, candidate) != sequence)
+				{
+					position++;
+					continue;
+				}
+
+				auto match_end = position + Lz4MinMatch;
+				while (match_end < match_end_limit && input[match_end] == input[candidate + (match_end - position)])
+				{
+					match_end++;
+				}
+
+				AppendSequence(output, input.subspan(anchor, position - anchor), position - candidate, match_end - position);
+				position = match_end;
+				anchor = position;
+			}
+		}
+
+		AppendLastLiterals(output, input.subspan(anchor));
+		return output;
+	}
+
+	auto Lz4Decompress(const std::span<const uint8_t> input, const size_t size) -> std::optional<std::vector<uint8_t>>
+	{
+		auto output = std::vector<uint8_t>(size);
+		auto input_idx = size_t{ 0 };
+		auto output_idx = size_t{ 0 };
+
+		while (input_idx != input.size())
+		{
+			const auto token = input[input_idx++];
+
+			auto literals_count = static_cast<size_t>(token >> 4);
+			if (literals_count == 15 && !ReadLength(input, input_idx, literals_count))
+			{
+				return std::nullopt;
+			}
+			if (literals_count > input.size() - input_idx || literals_count > size - output_idx)
+			{
+				return std::nullopt;
+			}
+			std::memcpy(output.data() + output_idx, input.data() + input_idx, literals_count);
+			input_idx += literals_count;
+			output_idx += literals_count;
+
+			// the last sequence has no match
+			if (input_idx == input.size())
+			{
+				break;
+			}
+
+			if (input.size() - input_idx < 2)
+			{
+				return std::nullopt;
+			}
+			const auto offset = static_cast<size_t>(input[input_idx]) | static_cast<size_t>(input[input_idx + 1]) << 8;
+			input_idx += 2;
+
+			auto match_length = static_cast<size_t>(token & 15);
+			if (match_length == 15 && !ReadLength(input, input_idx, match_length))
+			{
+				return std::nullopt;
+			}
+			match_length += Lz4MinMatch;
+
+			if (offset == 0 || offset > output_idx || match_length > size - output_idx)
+			{
+				return std::nullopt;
+			}
+
+			// byte by byte, the match overlaps what it copies when the offset is shorter than it
+			const auto match_start = output_idx - offset;
+			for (auto byte_idx = size_t{ 0 }; byte_idx != match_length; ++byte_idx)
+			{
+				output[output_idx + byte_idx] = output[match_start + byte_idx];
+			}
+			output_idx += match_length;
+		}
+
+		if (output_idx != size)
+		{
+			return std::nullopt;
+		}
+		return output;
+	}
+
+	auto AssetArchive::HashName(const std::string_view name) -> uint64_t
+	{
+		auto hash = uint64_t{ 14695981039346656037ull };
+		for (const auto character : name)
+		{
+			hash = (hash ^ static_cast<uint8_t>(character)) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	auto AssetArchive::Open(const std::filesystem::path& path) -> std::shared_ptr<AssetArchive>
+	{
+		CX_PROFILE_FUNCTION();
+
+		auto file = MappedFile::Open(path);
+		if (!file)
+		{
+			return nullptr;
+		}
+
+		const auto data = file->GetData();
+		auto header = ArchiveHeader{};
+		if (data.size() < sizeof(header))
+		{
+			return nullptr;
+		}
+		std::memcpy(&header, data.data(), sizeof(header));
+
+		if (header.m_magic != ArchiveMagic || header.m_version != ArchiveVersion || header.m_file_size != data.size()
+			|| header.m_entries_offset % alignof(AssetArchiveEntry) != 0 || header.m_entries_offset > data.size()
+			|| header.m_entries_count > (data.size() - header.m_entries_offset) / sizeof(AssetArchiveEntry)
+			|| header.m_names_offset > data.size() || header.m_names_size > data.size() - header.m_names_offset
+			|| static_cast<uint64_t>(header.m_root_offset) + header.m_root_size > header.m_names_size)
+		{
+			CX_CORE_WARN("Malformed asset archive {}", path.string());
+			return nullptr;
+		}
+
+		auto archive = std::make_shared<AssetArchive>();
+		archive->m_entries = { reinterpret_cast<const AssetArchiveEntry*>(data.data() + header.m_entries_offset), header.m_entries_count };
+		archive->m_names = { reinterpret_cast<const char*>(data.data() + header.m_names_offset), static_cast<size_t>(header.m_names_size) };
+		archive->m_root = std::string{ archive->m_names.data() + header.m_root_offset, header.m_root_size };
+
+		// checked once here, Read takes the entries as they are
+		for (auto entry_idx = size_t{ 0 }; entry_idx != archive->m_entries.size(); ++entry_idx)
+		{
+			const auto& entry = archive->m_entries[entry_idx];
+			const auto is_sorted = entry_idx == 0 || archive->m_entries[entry_idx - 1].m_hash <= entry.m_hash;
+			const auto is_stored = entry.m_compression == ArchiveCompression::none;
+
+			if (!is_sorted || entry.m_offset > data.size() || entry.m_stored_size > data.size() - entry.m_offset
+				|| static_cast<uint64_t>(entry.m_name_offset) + entry.m_name_size > header.m_names_size
+				|| (is_stored && entry.m_stored_size != entry.m_size) || (!is_stored && entry.m_compression != ArchiveCompression::lz4))
+			{
+				CX_CORE_WARN("Malformed asset archive {}", path.string());
+				return nullptr;
+			}
+		}
+
+		archive->m_file = std::move(file.value());
+		return archive;
+	}
+
+	auto AssetArchive::GetName(const AssetArchiveEntry& entry) const -> std::string_view
+	{
+		return { m_names.data() + entry.m_name_offset, entry.m_name_size };
+	}
+
+	auto AssetArchive::Find(const std::string_view name) const -> const AssetArchiveEntry*
+	{
+		const auto hash = HashName(name);
+		auto entry = std::ranges::lower_bound(m_entries, hash, {}, &AssetArchiveEntry::m_hash);
+
+		for (; entry != m_entries.end() && entry->m_hash == hash; ++entry)
+		{
+			if (GetName(*entry) == name)
+			{
+				return &*entry;
+			}
+		}
+		return nullptr;
+	}
+
+	auto AssetArchive::Read(const std::string_view name) const -> std::optional<AssetData>
+	{
+		CX_PROFILE_FUNCTION();
+
+		const auto entry = Find(name);
+		if (!entry)
+		{
+			return std::nullopt;
+		}
+
+		const auto stored_bytes = m_file.GetData().subspan(entry->m_offset, entry->m_stored_size);
+		if (entry->m_compression == ArchiveCompression::none)
+		{
+			return AssetData{ stored_bytes, shared_from_this() };
+		}
+
+		auto bytes = Lz4Decompress(stored_bytes, entry->m_size);
+		if (!bytes)
+		{
+			CX_CORE_ERROR("Unable to decompress {} from its archive", name);
+			return std::nullopt;
+		}
+
+		auto owner = std::make_shared<std::vector<uint8_t>>(std::move(bytes.value()));
+		return AssetData{ *owner, owner };
+	}
+
+	auto WriteAssetArchive(const std::filesystem::path& archive_path, const std::filesystem::path& root, const std::span<const std::filesystem::path> inputs) -> std::optional<AssetArchiveStats>
+	{
+		CX_PROFILE_FUNCTION();
+
+		// by entry name, which also makes the archive the same whatever the order of the inputs
+		auto files = std::map<std::string, std::filesystem::path>{};
+		for (const auto& input : inputs)
+		{
+			const auto input_path = root / input;
+			if (std::filesystem::is_directory(input_path))
+			{
+				for (const auto& entry : std::filesystem::recursive_directory_iterator{ input_path })
+				{
+					if (entry.is_regular_file())
+					{
+						files.emplace(entry.path().lexically_relative(root).lexically_normal().generic_string(), entry.path());
+					}
+				}
+			}
+			else if (std::filesystem::is_regular_file(input_path))
+			{
+				files.emplace(input_path.lexically_relative(root).lexically_normal().generic_string(), input_path);
+			}
+			else
+			{
+				CX_CORE_ERROR("Asset archive input {} not found", input_path.string());
+				return std::nullopt;
+			}
+		}
+
+		auto temporary_path = archive_path;
+		temporary_path += ".tmp";
+
+		auto stats = AssetArchiveStats{};
+		auto entries = std::vector<AssetArchiveEntry>{};
+		// the root is the first name, the entry names follow it
+		const auto root_name = root.lexically_normal().generic_string();
+		auto names = root_name;
+
+		{
+			auto file = std::ofstream{ temporary_path, std::ios::binary | std::ios::trunc };
+			auto offset = uint64_t{ sizeof(ArchiveHeader) };
+
+			// a failed write leaves no partial archive behind
+			const auto discard_temporary = [&] {
+				file.close();
+				auto error = std::error_code{};
+				std::filesystem::remove(temporary_path, error);
+			};
+			file.write(std::string(sizeof(ArchiveHeader), '\0').data(), sizeof(ArchiveHeader));
+
+			const auto write_aligned = [&](const std::span<const uint8_t> bytes, const uint64_t alignment) {
+				const auto aligned_offset = AlignUp(offset, alignment);
+				file.write(std::string(aligned_offset - offset, '\0').data(), static_cast<std::streamsize>(aligned_offset - offset));
+				file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+				offset = aligned_offset + bytes.size();
+				return aligned_offset;
+			};
+
+			for (const auto& [name, path] : files)
+			{
+				const auto bytes = ReadWholeFile(path);
+				if (!bytes)
+				{
+					CX_CORE_ERROR("Unable to read asset {}", path.string());
+					discard_temporary();
+					return std::nullopt;
+				}
+
+				auto entry = AssetArchiveEntry{ AssetArchive::HashName(name) };
+				entry.m_size = bytes->size();
+				entry.m_name_offset = static_cast<uint32_t>(names.size());
+				entry.m_name_size = static_cast<uint32_t>(name.size());
+				names += name;
+
+				auto compressed = path.extension() == ".ktx2" ? std::vector<uint8_t>{} : Lz4Compress(bytes.value());
+				if (!compressed.empty() && compressed.size() <= bytes->size() - bytes->size() / MinCompressionSaving)
+				{
+					entry.m_compression = ArchiveCompression::lz4;
+					entry.m_stored_size = compressed.size();
+					entry.m_offset = write_aligned(compressed, ArchiveAlignment);
+					stats.m_compressed_count++;
+				}
+				else
+				{
+					entry.m_compression = ArchiveCompression::none;
+					entry.m_stored_size = bytes->size();
+					entry.m_offset = write_aligned(bytes.value(), StoredAlignment);
+				}
+
+				stats.m_source_bytes += bytes->size();
+				entries.push_back(entry);
+			}
+
+			std::ranges::stable_sort(entries, {}, &AssetArchiveEntry::m_hash);
+
+			auto header = ArchiveHeader{};
+			header.m_magic = ArchiveMagic;
+			header.m_version = ArchiveVersion;
+			header.m_entries_count = static_cast<uint32_t>(entries.size());
+			header.m_entries_offset = write_aligned({ reinterpret_cast<const uint8_t*>(entries.data()), entries.size() * sizeof(AssetArchiveEntry) }, ArchiveAlignment);
+			header.m_names_offset = write_aligned({ reinterpret_cast<const uint8_t*>(names.data()), names.size() }, ArchiveAlignment);
+			header.m_names_size = names.size();
+			header.m_root_size = static_cast<uint32_t>(root_name.size());
+			header.m_file_size = offset;
+
+			file.seekp(0);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			if (!file)
+			{
+				CX_CORE_ERROR("Unable to write asset archive {}", temporary_path.string());
+				discard_temporary();
+				return std::nullopt;
+			}
+
+			stats.m_entries_count = entries.size();
+			stats.m_archive_bytes = offset;
+		}
+
+		auto error = std::error_code{};
+		std::filesystem::rename(temporary_path, archive_path, error);
+		if (error)
+		{
+			CX_CORE_ERROR("Unable to write asset archive {}: {}", archive_path.string(), error.message());
+			std::filesystem::remove(temporary_path, error);
+			return std::nullopt;
+		}
+
+		return stats;
+	}
+}
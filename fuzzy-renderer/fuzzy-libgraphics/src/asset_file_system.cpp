@@ -0,0 +1,139 @@
+#include <asset_file_system.h>
+
+#include <logger.h>
+
+#include <algorithm>
+#include <mutex>
+#include <ranges>
+
+namespace libgraphics
+{
+	auto AssetFileSystem::GetInstance() -> AssetFileSystem&
+	{
+		static auto instance = AssetFileSystem{};
+		return instance;
+	}
+
+	auto AssetFileSystem::Mount(const std::filesystem::path& archive_path, const std::optional<std::filesystem::path>& root) -> bool
+	{
+		auto archive = AssetArchive::Open(archive_path);
+		if (!archive)
+		{
+			CX_CORE_ERROR("Unable to mount asset archive {}", archive_path.string());
+			return false;
+		}
+
+		const auto archive_root = root.value_or(archive->GetRoot()).lexically_normal();
+		CX_CORE_INFO("Mounted asset archive {} ({} files) at {}", archive_path.string(), archive->GetEntries().size(), archive_root.string());
+
+		const auto lock = std::unique_lock{ m_mutex };
+		m_archives.push_back({ std::move(archive), archive_root });
+		return true;
+	}
+
+	auto AssetFileSystem::UnmountAll() -> void
+	{
+		const auto lock = std::unique_lock{ m_mutex };
+		m_archives.clear();
+	}
+
+	auto AssetFileSystem::GetMountedCount() const -> size_t
+	{
+		const auto lock = std::shared_lock{ m_mutex };
+		return m_archives.size();
+	}
+
+	auto AssetFileSystem::FindArchive(const std::filesystem::path& path, std::string& out_name) const -> std::shared_ptr<AssetArchive>
+	{
+		const auto lock = std::shared_lock{ m_mutex };
+
+		const auto normal_path = path.lexically_normal();
+		for (const auto& mounted : m_archives | std::views::reverse)
+		{
+			// outside of the root the relative path climbs out of it (or there is none, absolute against relative)
+			const auto relative_path = normal_path.lexically_relative(mounted.m_root);
+			if (relative_path.empty() || *relative_path.begin() == "..")
+			{
+				continue;
+			}
+
+			out_name = relative_path.generic_string();
+			if (mounted.m_archive->Contains(out_name))
+			{
+				return mounted.m_archive;
+			}
+		}
+		return nullptr;
+	}
+
+	auto AssetFileSystem::Read(const std::filesystem::path& path) const -> std::optional<AssetData>
+	{
+		auto name = std::string{};
+		if (const auto archive = FindArchive(path, name))
+		{
+			return archive->Read(name);
+		}
+
+		auto file = MappedFile::Open(path);
+		if (!file)
+		{
+			// empty files aren't mapped
+			auto error = std::error_code{};
+			return std::filesystem::is_regular_file(path, error) ? std::optional{ AssetData{} } : std::nullopt;
+		}
+
+		auto owner = std::make_shared<MappedFile>(std::move(file.value()));
+		return AssetData{ owner->GetData(), owner };
+	}
+
+	auto AssetFileSystem::Exists(const std::filesystem::path& path) const -> bool
+	{
+		auto name = std::string{};
+		auto error = std::error_code{};
+		return FindArchive(path, name) || std::filesystem::is_regular_file(path, error);
+	}
+
+	auto AssetFileSystem::ListFiles(const std::filesystem::path& directory) const -> std::vector<std::filesystem::path>
+	{
+		auto files = std::vector<std::filesystem::path>{};
+
+		{
+			const auto lock = std::shared_lock{ m_mutex };
+
+			const auto normal_directory = directory.lexically_normal();
+			for (const auto& mounted : m_archives)
+			{
+				const auto relative_directory = normal_directory.lexically_relative(mounted.m_root);
+				if (relative_directory.empty() || *relative_directory.begin() == "..")
+				{
+					continue;
+				}
+
+				// "." for the root itself, whose files have no prefix
+				const auto prefix = relative_directory == "." ? std::string{} : relative_directory.generic_string() + "/";
+				for (const auto& entry : mounted.m_archive->GetEntries())
+				{
+					const auto name = mounted.m_archive->GetName(entry);
+					if (name.starts_with(prefix) && name.find('/', prefix.size()) == std::string_view::npos)
+					{
+						files.push_back(directory / name.substr(prefix.size()));
+					}
+				}
+			}
+		}
+
+		auto error = std::error_code{};
+		for (const auto& entry : std::filesystem::directory_iterator{ directory, error })
+		{
+			if (entry.is_regular_file())
+			{
+				files.push_back(entry.path());
+			}
+		}
+
+		std::ranges::sort(files);
+		const auto duplicates = std::ranges::unique(files);
+		files.erase(duplicates.begin(), duplicates.end());
+		return files;
+	}
+}
@@ -4,19 +4,17 @@
 #include <components/mesh_renderer.h>
 #include <components/transform.h>
 #include <entities/entity.h>
-#include <opengl/gl_context.h>
+#include <interfaces/ishader.h>
+#include <rendering/command_list.h>
 #include <rendering/texture.h>
-#include <utils.h>
-#include <GLFW/glfw3.h>
-#include <iostream>
-#include <ray_hit.h>
+
+#include <algorithm>
 
 namespace libgraphics
 {
 	auto MeshRenderer::Initialize() -> void
 	{
-		const auto& default_shader = libgraphics::ResourceManager::GetFromCache<GLShader>({ libgraphics::ResourceType::shaders, "default_shader" });
-		SetShader(default_shader.value());
+		SetShader(Core::GetInstance().GetDefaultShader());
 
 		m_shader->Bind();
 
@@ -27,78 +25,85 @@ namespace libgraphics
 
 	auto MeshRenderer::Render() -> void
 	{
-		m_shader->Bind();
+		// immediate path, the frame loop records every renderer in parallel through EntityManager instead
+		const auto view = Core::GetInstance().GetMainRenderView();
 
-		auto textures = m_mesh.GetTextures();
+		auto command_list = CommandList{};
+		command_list.BindPipeline(m_shader.get());
+		command_list.SetConstant("view", view.m_view);
+		command_list.SetConstant("projection", view.m_projection);
+		command_list.SetConstant("eye", view.m_eye);
 
-		if (!textures.empty())
-		{
-			std::ranges::for_each(std::views::iota(0ul) | std::views::take(textures.size()), [&](const int texture_idx) {
-				glActiveTexture(GL_TEXTURE0 + texture_idx);
+		Record(command_list);
 
-				auto& texture = textures[texture_idx];
-				const auto& texture_type = texture.GetType();
-				texture.SetIndex(texture_idx);
+		Core::GetInstance().ExecuteCommandList(command_list);
+	}
 
-				if (texture_type == TextureType::albedo) { m_default_material->SetAlbedoMap(texture); }
-				else if (texture_type == TextureType::specular) { m_default_material->SetMetallicMap(texture); }
-				else if (texture_type == TextureType::normals) { m_default_material->SetNormalMap(texture); }
+	auto MeshRenderer::IsVisible(const RenderView& view) const -> bool
+	{
+		return view.m_frustum.Intersects(m_mesh->GetBounds(), GetEntity().GetTransformComponent()->GetWorldModelMatrix());
+	}
 
-				glBindTexture(GL_TEXTURE_2D, texture.GetTextureID());
-			});
+	auto MeshRenderer::GetScreenSize(const RenderView& view) const -> float
+	{
+		const auto& bounds = m_mesh->GetBounds();
+		const auto& model = GetEntity().GetTransformComponent()->GetWorldModelMatrix();
 
-			// todo: support other textures
-			m_shader->SetInt("material.albedo_map", m_default_material->GetAlbedoMap()->GetIndex());
-			m_shader->SetInt("material.metallic_map", m_default_material->GetMetallicMap()->GetIndex());
-			m_shader->SetInt("material.normal_map", m_default_material->GetNormalMap()->GetIndex());
-		}
-		else
+		const auto center = glm::vec3{ model * glm::vec4{ (bounds.m_min + bounds.m_max) * 0.5f, 1.0f } };
+		const auto scale = std::max({ glm::length(glm::vec3{ model[0] }), glm::length(glm::vec3{ model[1] }), glm::length(glm::vec3{ model[2] }) });
+		const auto radius = glm::length(bounds.m_max - bounds.m_min) * 0.5f * scale;
+		const auto distance = glm::length(center - view.m_eye);
+
+		// the camera is inside
+		if (distance <= radius)
 		{
-			m_shader->SetVec3("material.albedo_color", m_default_material->GetAlbedoColor());
-			m_shader->SetVec3("material.emission_color", m_default_material->GetEmissionColor());
+			return view.m_viewport_height;
 		}
 
-		m_shader->SetFloat("material.metallic", m_default_material->GetMetallic());
-		m_shader->SetFloat("material.roughness", m_default_material->GetRoughness());
-		m_shader->SetBool("material.use_textures", !textures.empty());
-
-		UpdateMatrix();
-
-		const auto& core = Core::GetInstance();
-		const auto gl_context = ::std::static_pointer_cast<GLContext>(core.GetGraphicsWindow()->GetNativeHandle());
+		// projection[1][1] is 1 / tan(fov / 2), the diameter over the distance in half viewports
+		return radius / distance * view.m_projection[1][1] * view.m_viewport_height;
+	}
 
-		double mouseX, mouseY;
-		glfwGetCursorPos(static_cast<GLFWwindow*>(gl_context->GetNativeHandle()), &mouseX, &mouseY);
+	auto MeshRenderer::Record(CommandList& command_list) const -> void
+	{
+		const auto& textures = m_mesh->GetTextures();
 
-		/*const auto ray = core.GetMainCamera().ScreenPointToRay3D(glm::vec2(mouseX, mouseY));
-		if (const auto ray_hit = utils::gl::CheckRayMeshIntersection(core.GetMainCamera().GetWorldPosition(), ray.m_direction, m_mesh))
+		if (!textures.empty())
 		{
-			if (ray_hit.has_value())
+			// the material samples the last texture of each type, the texture unit is the texture index
+			auto albedo_unit = 0;
+			auto metallic_unit = 0;
+			auto normal_unit = 0;
+
+			for (auto texture_idx = 0u; texture_idx != textures.size(); ++texture_idx)
 			{
-				const auto& hit_point = ray_hit.value();
+				const auto& texture = textures[texture_idx];
+				const auto& texture_type = texture.GetType();
 
-				const std::string output = std::format("Ray hit at distance: {} and hit point: ({}, {}, {})", hit_point.distance, hit_point.hit_point.x, hit_point.hit_point.y, hit_point.hit_point.z);
-				CX_CORE_DEBUG(output);
-			}
-		}*/
+				if (texture_type == TextureType::albedo) { albedo_unit = static_cast<int>(texture_idx); }
+				else if (texture_type == TextureType::specular) { metallic_unit = static_cast<int>(texture_idx); }
+				else if (texture_type == TextureType::normals) { normal_unit = static_cast<int>(texture_idx); }
 
-		m_mesh.Draw(m_shader);
-	}
+				command_list.BindTexture(texture_idx, TextureTarget::texture_2d, texture.GetTextureID());
+			}
 
-	auto MeshRenderer::UpdateMatrix() const -> void
-	{
-		const auto& transform_component = GetEntity().GetTransformComponent();
+			// todo: support other textures
+			command_list.SetConstant("material.albedo_map", albedo_unit);
+			command_list.SetConstant("material.metallic_map", metallic_unit);
+			command_list.SetConstant("material.normal_map", normal_unit);
+		}
+		else
+		{
+			command_list.SetConstant("material.albedo_color", m_default_material->GetAlbedoColor());
+			command_list.SetConstant("material.emission_color", m_default_material->GetEmissionColor());
+		}
 
-		const auto& core = Core::GetInstance();
-		const auto gl_context = ::std::static_pointer_cast<GLContext>(core.GetGraphicsWindow()->GetNativeHandle());
+		command_list.SetConstant("material.metallic", m_default_material->GetMetallic());
+		command_list.SetConstant("material.roughness", m_default_material->GetRoughness());
+		command_list.SetConstant("material.use_textures", !textures.empty());
 
-		const auto& view = GetViewMatrix(core.GetMainCamera().m_camera_props);
-		const auto& projection = ComputeCameraProjection(60.0, gl_context->Data().m_width, gl_context->Data().m_height, 0.01, 1000.0);
-		const auto& eye = core.GetMainCamera().GetWorldPosition();
+		command_list.SetConstant("model", GetEntity().GetTransformComponent()->GetWorldModelMatrix());
 
-		m_shader->SetMatrix4x4("model", transform_component->GetWorldModelMatrix());
-		m_shader->SetMatrix4x4("view", view);
-		m_shader->SetMatrix4x4("projection", projection);
-		m_shader->SetVec3("eye", eye);
+		command_list.DrawIndexed(*m_mesh);
 	}
 }
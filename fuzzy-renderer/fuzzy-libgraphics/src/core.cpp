@@ -1,14 +1,32 @@
+#include <asset_file_system.h>
 #include <core.h>
+#include <engine_constants.h>
 #include <enums.h>
 #include <filesystem>
+#include <hot_reloader.h>
+#include <job_system.h>
 
 #include <logger.h>
+#include <memory_tracker.h>
+#include <render_profiler.h>
 #include <resource_manager.h>
 #include <entities/model.h>
+#include <opengl/gl_command_executor.h>
 #include <opengl/gl_context.h>
+#include <opengl/gl_dynamic_resolution.h>
+#include <opengl/gl_frame_capture.h>
+#include <opengl/gl_headless_window.h>
+#include <opengl/gl_mesh.h>
 #include <opengl/gl_shader.h>
 #include <opengl/gl_skybox.h>
+#include <opengl/gl_state_cache.h>
 #include <opengl/gl_window.h>
+#include <software/sw_command_executor.h>
+#include <software/sw_context.h>
+#include <software/sw_mesh.h>
+#include <software/sw_rasterizer.h>
+#include <software/sw_shader.h>
+#include <software/sw_window.h>
 
 #include <gui_utils.h>
 
@@ -19,61 +37,100 @@
 #include <GLFW/glfw3.h>
 
 #include <gui/windows/gui_window_left_panel.h>
+#include <gui/windows/gui_window_profiler.h>
 #include <gui/windows/gui_window_stats.h>
 #include <gui/windows/gui_menu_bar.h>
+#include <rendering/command_list.h>
 #include <rendering/light.h>
+#include <rendering/texture_cache.h>
+#include <rendering/texture_streamer.h>
+#include <rendering/render_graph.h>
+#include <rendering/render_stats.h>
+#include <rendering/scene_generator.h>
 
 #include <entity_manager.h>
 
+#include <algorithm>
+
 namespace libgraphics
 {
 	auto Core::Init(const GraphicsAPI api_type, const int context_width, const int context_height, const std::string_view context_title) -> void
 	{
 		m_p_impl = new CoreImpl();
 		m_p_impl->m_graphics_api = api_type;
+		m_p_impl->m_model_loader = std::make_shared<ModelLoader>();
 
 		// Init logger
 		libgraphics::logger::Logger::Init();
 
+		utils::profiling::RenderProfiler::GetInstance().SetThreadName("render");
+
+		// deployments ship their assets packed, whatever the archive doesn't have is read from the loose files
+		if (auto error = std::error_code{}; std::filesystem::is_regular_file(constants::AssetArchivePath, error))
+		{
+			AssetFileSystem::GetInstance().Mount(constants::AssetArchivePath);
+		}
+
 		switch (api_type)
 		{
 		case GraphicsAPI::opengl:
+		case GraphicsAPI::opengl_headless:
 		{
-			// Create window
-			m_p_impl->m_graphics_window = std::make_shared<GLWindow>();
+			// Create window (or the offscreen framebuffer standing in for it)
+			if (api_type == GraphicsAPI::opengl_headless)
+			{
+				m_p_impl->m_graphics_window = std::make_shared<GLHeadlessWindow>();
+			}
+			else
+			{
+				m_p_impl->m_graphics_window = std::make_shared<GLWindow>();
+
+				m_p_impl->m_gui_objects.push_back(std::make_shared<gui::GUIMenuBar>());
+				m_p_impl->m_gui_objects.push_back(std::make_shared<gui::GUIWindowLeftPanel>());
+				m_p_impl->m_gui_objects.push_back(std::make_shared<gui::GUIWindowProfiler>());
+				m_p_impl->m_gui_objects.push_back(std::make_shared<gui::GUIWindowStats>());
+
+				// edits to the loose files show up while running, packed assets don't change
+				HotReloader::GetInstance().SetEnabled(AssetFileSystem::GetInstance().GetMountedCount() == 0);
+			}
 			m_p_impl->m_graphics_window->Create(context_width, context_height, context_title);
 			m_p_impl->m_graphics_window->SetClearColor({ 0.3f, 0.4f, 0.5f });
 
 			// Register default resources shaders
-			libgraphics::ResourceManager::RegisterResource(ResourceParams{ libgraphics::ResourceType::shaders, "default_shader", std::make_shared<GLShader>("../fuzzy-libgraphics/shaders/glsl/vertex.glsl", "../fuzzy-libgraphics/shaders/glsl/fragment.glsl") });
-			libgraphics::ResourceManager::RegisterResource(ResourceParams{ libgraphics::ResourceType::shaders, "skybox_shader", std::make_shared<GLShader>("../fuzzy-libgraphics/shaders/glsl/skybox_vert.glsl", "../fuzzy-libgraphics/shaders/glsl/skybox_frag.glsl") });
+			auto& resource_manager = ResourceManager::GetInstance();
+			m_p_impl->m_default_shader_handle = resource_manager.Load<GLShader>(ResourceType::shaders, "default_shader", [] {
+				return std::make_shared<GLShader>("../fuzzy-libgraphics/shaders/glsl/vertex.glsl", "../fuzzy-libgraphics/shaders/glsl/fragment.glsl");
+			});
+			m_p_impl->m_skybox_shader_handle = resource_manager.Load<GLShader>(ResourceType::shaders, "skybox_shader", [] {
+				return std::make_shared<GLShader>("../fuzzy-libgraphics/shaders/glsl/skybox_vert.glsl", "../fuzzy-libgraphics/shaders/glsl/skybox_frag.glsl");
+			});
 
-			const auto& default_shader = libgraphics::ResourceManager::GetFromCache<GLShader>({ libgraphics::ResourceType::shaders, "default_shader" });
+			const auto default_shader = resource_manager.Get(m_p_impl->m_default_shader_handle);
 
-			default_shader.value()->AllocateLightsBuffer("LightsBlock");
+			default_shader->AllocateLightsBuffer("LightsBlock");
+			m_p_impl->m_default_shader = default_shader;
 
-			const auto directional_light = std::make_shared<Light>();
-			directional_light->m_direction = glm::vec3{ 0.7f, 0.7f, 0.0 };
-			directional_light->m_type = 0;
-			directional_light->m_intensity = 1.0f;
-			directional_light->m_color = glm::vec4(1.0f);
-			directional_light->m_is_active = true;
+			m_sky_box_handle = resource_manager.Load<GLSkybox>(ResourceType::cubemaps, "sky_01", [] { return std::make_shared<GLSkybox>(); });
 
-			AddLight(directional_light);
+			m_render_graph = std::make_shared<RenderGraph>();
 
-			m_entity_manager = std::make_shared<EntityManager>();
+			// what the engine allocates from here on belongs to the scene, see Shutdown
+			m_p_impl->m_memory_checkpoint = MemoryTracker::GetInstance().GetCheckpoint();
 
-			m_sky_box = std::make_shared<GLSkybox>();
+			CreateDefaultScene();
+		}
+		break;
+		case GraphicsAPI::software:
+		{
+			m_p_impl->m_graphics_window = std::make_shared<SWWindow>();
+			m_p_impl->m_graphics_window->Create(context_width, context_height, context_title);
+			m_p_impl->m_graphics_window->SetClearColor({ 0.3f, 0.4f, 0.5f });
 
-			m_p_impl->m_main_camera = {};
+			m_p_impl->m_default_shader = std::make_shared<SWShader>();
 
-			m_entity_model = std::make_shared<Model>("../resources/Cube.glb");
-			m_entity_model->SetName("Cube");
-			m_entity_manager->AddEntity(m_entity_model);
+			m_p_impl->m_memory_checkpoint = MemoryTracker::GetInstance().GetCheckpoint();
 
-			/*m_entity_model2 = std::make_shared<Model>("../resources/rock_fountain.glb");
-			m_entity_model2->SetName("rock_fountain");
-			m_entity_manager->AddEntity(m_entity_model2);*/
+			CreateDefaultScene();
 		}
 		break;
 		case GraphicsAPI::directx: break;
@@ -81,34 +138,102 @@ namespace libgraphics
 		}
 	}
 
+	auto Core::CreateDefaultScene() -> void
+	{
+		const auto directional_light = std::make_shared<Light>();
+		directional_light->m_direction = glm::vec3{ 0.7f, 0.7f, 0.0 };
+		directional_light->m_type = 0;
+		directional_light->m_intensity = 1.0f;
+		directional_light->m_color = glm::vec4(1.0f);
+		directional_light->m_is_active = true;
+
+		AddLight(directional_light);
+
+		m_entity_manager = std::make_shared<EntityManager>();
+
+		m_p_impl->m_main_camera = {};
+
+		m_entity_model = std::make_shared<Model>("../resources/Cube.glb");
+		m_entity_model->SetName("Cube");
+		m_entity_manager->AddEntity(m_entity_model);
+
+		/*m_entity_model2 = std::make_shared<Model>("../resources/rock_fountain.glb");
+		m_entity_model2->SetName("rock_fountain");
+		m_entity_manager->AddEntity(m_entity_model2);*/
+	}
+
 	auto Core::Update(const RenderFunction& render_function) -> void
 	{
-		const auto glfw_window = static_cast<GLFWwindow*>(m_p_impl->m_graphics_window->GetNativeHandle()->GetNativeHandle());
+		while (!m_p_impl->m_graphics_window->ShouldClose())
+		{
+			RenderFrame(render_function);
+		}
+
+		Shutdown();
+	}
+
+	auto Core::RenderFrame(const RenderFunction& render_function) -> void
+	{
+		utils::profiling::RenderProfiler::GetInstance().Update();
+		CX_PROFILE_ZONE("RenderFrame");
 
-		auto previous_time = glfwGetTime();
+		const auto current_time = std::chrono::steady_clock::now();
+		const auto previous_time = m_p_impl->m_previous_frame_time.value_or(current_time);
+		const auto frame_seconds = std::chrono::duration<float>(current_time - previous_time).count();
+		m_p_impl->m_previous_frame_time = current_time;
 
-		const auto& skybox_shader = libgraphics::ResourceManager::GetFromCache<GLShader>({ libgraphics::ResourceType::shaders, "skybox_shader" });
+		// a replay advances the scene by the same step every frame, whatever the frames actually take
+		m_delta_time = m_p_impl->m_is_replaying_camera ? m_p_impl->m_camera_replay_delta_time : frame_seconds;
 
-		auto gui_menu_bar = libgraphics::gui::GUIMenuBar{};
-		auto test_win = libgraphics::gui::GUIWindowStats{};
-		auto gui_lp = libgraphics::gui::GUIWindowLeftPanel{};
+		RenderStats::GetInstance().BeginFrame(frame_seconds * 1000.0f);
 
-		while (!glfwWindowShouldClose(glfw_window))
+		if (m_p_impl->m_graphics_api == GraphicsAPI::software)
 		{
+			UpdateModelLoads();
+			UpdateCameraPath();
+			RenderSoftwareFrame(render_function);
+			CountSceneObjects();
+
+			m_entity_manager->Update(m_delta_time);
+
+			// flushes the rasterizer
+			{
+				CX_PROFILE_ZONE("SwapBuffers");
+				m_p_impl->m_graphics_window->SwapBuffers();
+			}
+
+			// the framebuffer is plain memory, frames can be handed over right away
+			if (m_p_impl->m_capture_callback)
+			{
+				const auto& framebuffer = std::static_pointer_cast<SWContext>(m_p_impl->m_graphics_window->GetNativeHandle())->GetRasterizer().GetFramebuffer();
+				const auto pixels = std::as_bytes(std::span{ framebuffer.m_color });
+				m_p_impl->m_capture_callback({ { reinterpret_cast<const uint8_t*>(pixels.data()), pixels.size() }, framebuffer.m_width, framebuffer.m_height, m_p_impl->m_captured_frames_count++ });
+			}
+			return;
+		}
+
+		GLStateCache::GetInstance().BeginFrame();
+
+		if (m_p_impl->m_frame_capture)
+		{
+			m_p_impl->m_frame_capture->Poll();
+		}
+
+		if (!IsHeadless())
+		{
+			CX_PROFILE_ZONE("GUI");
+
 			ImGui_ImplOpenGL3_NewFrame();
 			ImGui_ImplGlfw_NewFrame();
 			ImGui::NewFrame();
 
 			ImGui::ShowDemoWindow();
-			gui_menu_bar.Render();
-			gui_lp.Render();
-
-			const auto current_time = glfwGetTime();
-			m_delta_time = static_cast<float>(current_time - previous_time);
-			previous_time = current_time;
-
-			m_p_impl->m_graphics_window->Clear();
+			for (const auto& gui_object : m_p_impl->m_gui_objects)
+			{
+				gui_object->Render();
+			}
 
+			const auto glfw_window = static_cast<GLFWwindow*>(m_p_impl->m_graphics_window->GetNativeHandle()->GetNativeHandle());
 			if (glfwGetMouseButton(glfw_window, GLFW_MOUSE_BUTTON_2))
 			{
 				m_p_impl->m_main_camera.RotateByMouse(m_p_impl->m_graphics_window);
@@ -118,24 +243,452 @@ namespace libgraphics
 				m_p_impl->m_main_camera.Reset();
 			}
 			m_p_impl->m_main_camera.Animate(m_p_impl->m_graphics_window, m_delta_time);
+		}
 
-			m_sky_box->Render(skybox_shader.value());
+		UpdateModelLoads();
+		UpdateCameraPath();
 
-			m_entity_manager->Render();
-			m_entity_manager->Update(m_delta_time);
+		// before the recording starts, it reads the programs, textures and meshes these replace
+		HotReloader::GetInstance().Update(*m_entity_manager);
+		TextureStreamer::GetInstance().Update();
+
+		if (m_p_impl->m_dynamic_resolution)
+		{
+			m_p_impl->m_dynamic_resolution->BeginFrame();
+		}
+
+		BuildFrameGraph(render_function);
+		m_render_graph->Compile();
+
+		{
+			CX_PROFILE_GPU_ZONE("Frame");
+			m_render_graph->Execute();
+		}
+
+		if (m_p_impl->m_dynamic_resolution)
+		{
+			m_p_impl->m_dynamic_resolution->EndFrame();
+		}
+
+		CountSceneObjects();
+		m_render_graph->TrimPool(constants::RenderGraphPoolMaxUnusedFrames);
+		TextureCache::GetInstance().Trim();
+		ResourceManager::GetInstance().Update();
+
+		m_entity_manager->Update(m_delta_time);
+
+		CX_PROFILE_ZONE("SwapBuffers");
+		m_p_impl->m_graphics_window->SwapBuffers();
+	}
+
+	auto Core::Shutdown() -> void
+	{
+		EndCapture();
+
+		if (m_p_impl->m_camera_recording_path)
+		{
+			EndCameraRecording();
+		}
+
+		m_p_impl->m_dynamic_resolution.reset();
+		if (m_p_impl->m_graphics_api != GraphicsAPI::software)
+		{
+			utils::profiling::RenderProfiler::GetInstance().ReleaseGpuResources();
+		}
+
+		// imports still running drop their result
+		m_p_impl->m_model_loader.reset();
+
+		// the scene is released while its GL objects can still be deleted, anything allocated after Init that
+		// survives it was leaked
+		m_entity_manager.reset();
+		m_entity_model.reset();
+		m_entity_model2.reset();
+		m_p_impl->m_default_shader.reset();
+		m_render_graph.reset();
+		ResourceManager::GetInstance().Clear();
+		HotReloader::GetInstance().Clear();
+		TextureCache::GetInstance().Clear();
+		TextureStreamer::GetInstance().Clear();
+
+		// joined here rather than when the library unloads
+		JobSystem::GetInstance().Shutdown();
+
+		if (const auto leaked_count = MemoryTracker::GetInstance().LogAllocations(m_p_impl->m_memory_checkpoint); leaked_count != 0)
+		{
+			CX_CORE_WARN("{} allocation(s) of the scene outlived it", leaked_count);
+		}
+
+		m_p_impl->m_graphics_window->Destroy();
+	}
+
+	auto Core::IsHeadless() const -> bool
+	{
+		return m_p_impl->m_graphics_api != GraphicsAPI::opengl;
+	}
+
+	auto Core::CreateMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<Texture> textures, std::string name, const std::optional<BoundingBox>& bounds,
+		const MeshDataPolicy data_policy) const -> std::shared_ptr<IMesh>
+	{
+		if (m_p_impl->m_graphics_api == GraphicsAPI::software)
+		{
+			return std::make_shared<SWMesh>(std::move(vertices), std::move(indices), std::move(name), bounds);
+		}
+
+		return std::make_shared<GLMesh>(std::move(vertices), std::move(indices), std::move(textures), std::move(name), bounds, data_policy);
+	}
+
+	auto Core::ExecuteCommandList(const CommandList& command_list) const -> void
+	{
+		if (m_p_impl->m_graphics_api == GraphicsAPI::software)
+		{
+			SWCommandExecutor::Execute(command_list, std::static_pointer_cast<SWContext>(m_p_impl->m_graphics_window->GetNativeHandle())->GetRasterizer());
+			return;
+		}
+
+		GLCommandExecutor::Execute(command_list);
+	}
+
+	auto Core::LoadScene(const std::string_view model_path) -> void
+	{
+		if (model_path.starts_with(SceneGeneratorSpecPrefix))
+		{
+			if (const auto params = ParseSceneGeneratorSpec(model_path))
+			{
+				LoadScene(params.value());
+			}
+			return;
+		}
+
+		if (m_entity_model)
+		{
+			m_entity_manager->RemoveEntity(m_entity_model);
+		}
+
+		m_entity_model = std::make_shared<Model>(model_path);
+		m_entity_model->SetName(std::filesystem::path{ model_path }.stem().string());
+		m_entity_manager->AddEntity(m_entity_model);
+	}
+
+	auto Core::LoadScene(const SceneGeneratorParams& params) -> void
+	{
+		if (m_entity_model)
+		{
+			m_entity_manager->RemoveEntity(m_entity_model);
+		}
+
+		std::erase_if(m_lights, [this](const auto& light) { return std::ranges::find(m_p_impl->m_generated_lights, light) != m_p_impl->m_generated_lights.end(); });
+		m_p_impl->m_generated_lights.clear();
+
+		auto scene = GenerateScene(params);
+
+		const auto free_lights_count = static_cast<size_t>(constants::MaxNumberOfLights) - std::min<size_t>(m_lights.size(), constants::MaxNumberOfLights);
+		if (scene.m_lights.size() > free_lights_count)
+		{
+			CX_CORE_WARN("Generated scene has {} lights, only {} fit in the lights buffer", scene.m_lights.size(), free_lights_count);
+			scene.m_lights.resize(free_lights_count);
+		}
+
+		for (const auto& light : scene.m_lights)
+		{
+			AddLight(light);
+		}
+		m_p_impl->m_generated_lights = std::move(scene.m_lights);
+
+		m_entity_model = std::move(scene.m_root);
+		m_entity_manager->AddEntity(m_entity_model);
+	}
+
+	auto Core::LoadModelAsync(const std::string_view model_path, const MeshDataPolicy mesh_data_policy) -> std::shared_ptr<ModelLoadHandle>
+	{
+		return m_p_impl->m_model_loader->Load(std::string{ model_path }, mesh_data_policy);
+	}
+
+	auto Core::GetModelLoads() const -> const std::vector<std::shared_ptr<ModelLoadHandle>>&
+	{
+		return m_p_impl->m_model_loader->GetLoads();
+	}
+
+	auto Core::UpdateModelLoads() -> void
+	{
+		CX_PROFILE_ZONE("ModelUploads");
+
+		for (const auto& model : m_p_impl->m_model_loader->Update(constants::ModelUploadBytesPerFrame))
+		{
+			CX_CORE_INFO("Model {} loaded", model->GetName());
+			m_entity_manager->AddEntity(model);
+		}
+	}
+
+	auto Core::BeginCapture(CaptureCallback callback) -> void
+	{
+		EndCapture();
+
+		m_p_impl->m_captured_frames_count = 0;
+
+		if (m_p_impl->m_graphics_api == GraphicsAPI::software)
+		{
+			m_p_impl->m_capture_callback = std::move(callback);
+			return;
+		}
+
+		m_p_impl->m_frame_capture = std::make_shared<GLFrameCapture>(std::move(callback));
+	}
+
+	auto Core::EndCapture() -> void
+	{
+		// flushed and released by the destructor
+		m_p_impl->m_frame_capture.reset();
+		m_p_impl->m_capture_callback = {};
+	}
+
+	auto Core::SetDynamicResolution(const bool enabled, const float target_frame_ms) -> void
+	{
+		if (m_p_impl->m_graphics_api == GraphicsAPI::software)
+		{
+			CX_CORE_WARN("Dynamic resolution is not supported by the software backend");
+			return;
+		}
+
+		if (!enabled)
+		{
+			m_p_impl->m_dynamic_resolution.reset();
+			return;
+		}
+
+		if (m_p_impl->m_dynamic_resolution)
+		{
+			m_p_impl->m_dynamic_resolution->GetController().SetTargetFrameMs(target_frame_ms);
+			return;
+		}
+
+		m_p_impl->m_dynamic_resolution = std::make_shared<GLDynamicResolution>(target_frame_ms);
+	}
+
+	auto Core::GetResolutionScale() const -> float
+	{
+		return m_p_impl->m_dynamic_resolution ? m_p_impl->m_dynamic_resolution->GetController().GetScale() : 1.0f;
+	}
+
+	auto Core::BeginCameraRecording(const std::filesystem::path& path) -> void
+	{
+		m_p_impl->m_camera_recording_path = path;
+		m_p_impl->m_camera_recording.clear();
+
+		CX_CORE_INFO("Recording the camera path to {}", path.string());
+	}
+
+	auto Core::EndCameraRecording() -> bool
+	{
+		if (!m_p_impl->m_camera_recording_path)
+		{
+			return false;
+		}
+
+		const auto path = std::move(m_p_impl->m_camera_recording_path.value());
+		m_p_impl->m_camera_recording_path.reset();
+
+		const auto is_saved = SaveCameraPath(path, m_p_impl->m_camera_recording);
+		if (is_saved)
+		{
+			CX_CORE_INFO("Camera path of {} frames written to {}", m_p_impl->m_camera_recording.size(), path.string());
+		}
+
+		m_p_impl->m_camera_recording.clear();
+		return is_saved;
+	}
+
+	auto Core::BeginCameraReplay(CameraPath camera_path, const float fixed_delta_time) -> void
+	{
+		m_p_impl->m_camera_replay = std::move(camera_path);
+		m_p_impl->m_camera_replay_frame_idx = 0;
+		m_p_impl->m_camera_replay_delta_time = fixed_delta_time;
+		m_p_impl->m_is_replaying_camera = true;
+	}
+
+	auto Core::EndCameraReplay() -> void
+	{
+		m_p_impl->m_camera_replay.clear();
+		m_p_impl->m_is_replaying_camera = false;
+	}
+
+	auto Core::IsCameraReplayFinished() const -> bool
+	{
+		return m_p_impl->m_camera_replay_frame_idx >= m_p_impl->m_camera_replay.size();
+	}
+
+	auto Core::UpdateCameraPath() -> void
+	{
+		auto& camera_props = m_p_impl->m_main_camera.m_camera_props;
+
+		// overrides whatever the input did to the camera this frame
+		if (m_p_impl->m_is_replaying_camera && !m_p_impl->m_camera_replay.empty())
+		{
+			const auto frame_idx = std::min(m_p_impl->m_camera_replay_frame_idx, m_p_impl->m_camera_replay.size() - 1);
+			const auto& frame = m_p_impl->m_camera_replay[frame_idx];
+
+			camera_props.m_world_position = frame.m_position;
+			camera_props.m_yaw = frame.m_yaw;
+			camera_props.m_pitch = frame.m_pitch;
+
+			m_p_impl->m_camera_replay_frame_idx++;
+		}
+
+		if (m_p_impl->m_camera_recording_path)
+		{
+			m_p_impl->m_camera_recording.push_back({ camera_props.m_world_position, camera_props.m_yaw, camera_props.m_pitch, m_delta_time });
+		}
+	}
+
+	auto Core::CountSceneObjects() const -> void
+	{
+		// the recording of this frame is over, its culling results are final
+		const auto renderers_count = m_entity_manager->GetRecordedRenderersCount();
+		const auto culled_count = m_entity_manager->GetCulledCount();
+		const auto [entities_count, components_count] = m_entity_manager->CountSceneObjects();
+
+		RenderStats::GetInstance().SetObjectCounts(renderers_count - culled_count, culled_count, entities_count, components_count);
+	}
+
+	auto Core::RenderSoftwareFrame(const RenderFunction& render_function) -> void
+	{
+		CX_PROFILE_FUNCTION();
+
+		// same passes as the frame graph minus the skybox (and imgui, there is no window)
+		m_p_impl->m_graphics_window->Clear();
+
+		m_entity_manager->BeginRecording(GetMainRenderView());
+
+		auto& rasterizer = std::static_pointer_cast<SWContext>(m_p_impl->m_graphics_window->GetNativeHandle())->GetRasterizer();
+		rasterizer.SetLights(m_lights);
+
+		for (const auto& command_list : m_entity_manager->FinishRecording())
+		{
+			SWCommandExecutor::Execute(command_list, rasterizer);
+		}
+
+		if (render_function)
+		{
+			render_function(m_delta_time);
+		}
+	}
+
+	auto Core::BuildFrameGraph(const RenderFunction& render_function) -> void
+	{
+		CX_PROFILE_FUNCTION();
+
+		const auto& context_data = m_p_impl->m_graphics_window->GetNativeHandle()->Data();
+
+		m_render_graph->Reset();
+
+		// workers record the scene while this thread goes through the passes before "entities"
+		m_entity_manager->BeginRecording(GetMainRenderView());
+
+		auto backbuffer = m_render_graph->ImportBackbuffer("backbuffer", { context_data.m_width, context_data.m_height, GL_RGBA8 }, m_p_impl->m_graphics_window->GetBackbufferID());
+
+		// with dynamic resolution the scene goes to a smaller color/depth pair that "upscale" stretches over the backbuffer
+		const auto& dynamic_resolution = m_p_impl->m_dynamic_resolution;
+		auto scene_color = backbuffer;
+		auto scene_depth = InvalidRenderResource;
+
+		if (dynamic_resolution)
+		{
+			if (dynamic_resolution->PrepareTargets(context_data.m_width, context_data.m_height))
+			{
+				m_render_graph->ReleaseFramebuffers();
+			}
 
+			const auto render_width = dynamic_resolution->GetRenderWidth();
+			const auto render_height = dynamic_resolution->GetRenderHeight();
+			scene_color = m_render_graph->ImportTexture("scene_color", dynamic_resolution->GetColorTexture(), { render_width, render_height, GL_RGBA8 });
+			scene_depth = m_render_graph->ImportTexture("scene_depth", dynamic_resolution->GetDepthTexture(), { render_width, render_height, GL_DEPTH24_STENCIL8 });
+		}
+
+		const auto write_scene_targets = [&](const RenderGraphBuilder& builder) {
+			scene_color = builder.Write(scene_color);
+			if (scene_depth != InvalidRenderResource)
+			{
+				scene_depth = builder.Write(scene_depth);
+			}
+		};
+
+		m_render_graph->AddPass("clear", [&](const RenderGraphBuilder& builder) {
+			write_scene_targets(builder);
+		}, [this](const RenderPassContext&) {
+			m_p_impl->m_graphics_window->Clear();
+		});
+
+		m_render_graph->AddPass("skybox", [&](const RenderGraphBuilder& builder) {
+			write_scene_targets(builder);
+		}, [this](const RenderPassContext&) {
+			auto& resource_manager = ResourceManager::GetInstance();
+			if (const auto sky_box = resource_manager.Get(m_sky_box_handle))
+			{
+				sky_box->Render(resource_manager.Get(m_p_impl->m_skybox_shader_handle));
+			}
+		});
+
+		m_render_graph->AddPass("entities", [&](const RenderGraphBuilder& builder) {
+			write_scene_targets(builder);
+		}, [this](const RenderPassContext&) {
+			ResourceManager::GetInstance().Get(m_p_impl->m_default_shader_handle)->UploadLights(m_lights);
+
+			for (const auto& command_list : m_entity_manager->FinishRecording())
+			{
+				GLCommandExecutor::Execute(command_list);
+			}
+		});
+
+		// the client callback can issue anything (even imgui widgets) so it must always run
+		m_render_graph->AddPass("client", [&](const RenderGraphBuilder& builder) {
+			write_scene_targets(builder);
+			builder.SideEffect();
+		}, [this, &render_function](const RenderPassContext&) {
 			if (render_function)
 			{
 				render_function(m_delta_time);
 			}
+		});
 
-			ImGui::Render();
+		if (dynamic_resolution)
+		{
+			m_render_graph->AddPass("upscale", [&](const RenderGraphBuilder& builder) {
+				scene_color = builder.Read(scene_color);
+				backbuffer = builder.Write(backbuffer);
+			}, [&dynamic_resolution](const RenderPassContext&) {
+				dynamic_resolution->Upscale();
+			});
+		}
+		else
+		{
+			backbuffer = scene_color;
+		}
 
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-			m_p_impl->m_graphics_window->SwapBuffers();
+		if (m_p_impl->m_frame_capture)
+		{
+			m_render_graph->AddPass("capture", [&](const RenderGraphBuilder& builder) {
+				backbuffer = builder.Read(backbuffer);
+				builder.SideEffect();
+			}, [this, &context_data](const RenderPassContext&) {
+				m_p_impl->m_frame_capture->Capture(m_p_impl->m_graphics_window->GetBackbufferID(), context_data.m_width, context_data.m_height);
+			});
 		}
 
-		m_p_impl->m_graphics_window->Destroy();
+		if (IsHeadless())
+		{
+			return;
+		}
+
+		m_render_graph->AddPass("imgui", [&](const RenderGraphBuilder& builder) {
+			backbuffer = builder.Write(backbuffer);
+			builder.SideEffect();
+		}, [](const RenderPassContext&) {
+			ImGui::Render();
+			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+			// the imgui backend changes (and restores) state behind our back
+			GLStateCache::GetInstance().Invalidate();
+		});
 	}
 
 	auto Core::GetInstance() -> Core&
@@ -144,6 +697,20 @@ namespace libgraphics
 		return core;
 	}
 
+	auto Core::GetMainRenderView() const -> RenderView
+	{
+		const auto& context_data = m_p_impl->m_graphics_window->GetNativeHandle()->Data();
+		const auto& camera = m_p_impl->m_main_camera;
+
+		auto view = RenderView{};
+		view.m_view = GetViewMatrix(camera.m_camera_props);
+		view.m_projection = ComputeCameraProjection(60.0, context_data.m_width, context_data.m_height, 0.01, 1000.0);
+		view.m_eye = camera.GetWorldPosition();
+		view.m_frustum = Frustum{ view.m_projection * view.m_view };
+		view.m_viewport_height = static_cast<float>(context_data.m_height);
+		return view;
+	}
+
 	auto Core::AddLight(const std::shared_ptr<Light>& light) -> void
 	{
 		m_lights.push_back(light);
@@ -22,6 +22,15 @@ namespace libgraphics
 		m_childrens.push_back(child);
 	}
 
+	auto Entity::RemoveChildren() -> void
+	{
+		for (auto&& child : m_childrens)
+		{
+			child->m_parent = nullptr;
+		}
+		m_childrens.clear();
+	}
+
 	auto Entity::Update(const float delta_time) -> void
 	{
 		for (auto&& component_ptr : std::views::values(m_components))
@@ -0,0 +1,911 @@
+#include <entities/glb_scene.h>
+
+#include <asset_file_system.h>
+#include <logger.h>
+#include <render_profiler.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+
+namespace libgraphics
+{
+	namespace
+	{
+		constexpr uint32_t GlbMagic = 0x46546C67;		// "glTF"
+		constexpr uint32_t GlbJsonChunk = 0x4E4F534A;	// "JSON"
+		constexpr uint32_t GlbBinaryChunk = 0x004E4942;	// "BIN\0"
+		constexpr size_t GlbHeaderSize = 12;
+		constexpr size_t GlbChunkHeaderSize = 8;
+
+		// accessor component types and primitive modes of the spec
+		constexpr uint32_t GltfByte = 5120;
+		constexpr uint32_t GltfUnsignedByte = 5121;
+		constexpr uint32_t GltfShort = 5122;
+		constexpr uint32_t GltfUnsignedShort = 5123;
+		constexpr uint32_t GltfUnsignedInt = 5125;
+		constexpr uint32_t GltfFloat = 5126;
+		constexpr size_t GltfTriangles = 4;
+
+		/**
+		 * \brief Just enough of a JSON document for the glTF chunk, object members kept in file order.
+		 */
+		struct JsonValue
+		{
+			using Array = std::vector<JsonValue>;
+			using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+			std::variant<std::nullptr_t, bool, double, std::string, Array, Object> m_value = nullptr;
+
+			/**
+			 * \return the member, null when this isn't an object or has no such member
+			 */
+			[[nodiscard]] auto operator[](const std::string_view key) const -> const JsonValue&
+			{
+				if (const auto object = std::get_if<Object>(&m_value))
+				{
+					for (const auto& [member_key, member] : *object)
+					{
+						if (member_key == key)
+						{
+							return member;
+						}
+					}
+				}
+				return GetNull();
+			}
+
+			/**
+			 * \return the element, null when this isn't an array or is shorter
+			 */
+			[[nodiscard]] auto operator[](const size_t idx) const -> const JsonValue&
+			{
+				const auto array = std::get_if<Array>(&m_value);
+				return array && idx < array->size() ? (*array)[idx] : GetNull();
+			}
+
+			[[nodiscard]] auto IsNull() const -> bool { return std::holds_alternative<std::nullptr_t>(m_value); }
+
+			[[nodiscard]] auto GetSize() const -> size_t
+			{
+				const auto array = std::get_if<Array>(&m_value);
+				return array ? array->size() : 0;
+			}
+
+			[[nodiscard]] auto GetNumber(const double fallback = 0.0) const -> double
+			{
+				const auto number = std::get_if<double>(&m_value);
+				return number ? *number : fallback;
+			}
+
+			/**
+			 * \return nothing unless this is a non negative integer
+			 */
+			[[nodiscard]] auto GetIndex() const -> std::optional<size_t>
+			{
+				const auto number = std::get_if<double>(&m_value);
+				if (!number || *number < 0.0 || *number != static_cast<double>(static_cast<size_t>(*number)))
+				{
+					return std::nullopt;
+				}
+				return static_cast<size_t>(*number);
+			}
+
+			[[nodiscard]] auto GetString() const -> std::string_view
+			{
+				const auto text = std::get_if<std::string>(&m_value);
+				return text ? std::string_view{ *text } : std::string_view{};
+			}
+
+			static auto GetNull() -> const JsonValue&
+			{
+				static const auto null = JsonValue{};
+				return null;
+			}
+		};
+
+		class JsonParser
+		{
+		public:
+			explicit JsonParser(const std::string_view text) : m_text{ text } {}
+
+			/**
+			 * \return nothing when the text isn't one well formed JSON value
+			 */
+			auto Parse() -> std::optional<JsonValue>
+			{
+				auto value = ParseValue(0);
+				SkipSpaces();
+				return value && m_position == m_text.size() ? std::move(value) : std::nullopt;
+			}
+
+		private:
+			static constexpr int MaxDepth = 64;
+
+			auto SkipSpaces() -> void
+			{
+				while (m_position != m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\t' || m_text[m_position] == '\n' || m_text[m_position] == '\r'))
+				{
+					++m_position;
+				}
+			}
+
+			auto Consume(const char expected) -> bool
+			{
+				SkipSpaces();
+				if (m_position != m_text.size() && m_text[m_position] == expected)
+				{
+					++m_position;
+					return true;
+				}
+				return false;
+			}
+
+			auto ParseValue(const int depth) -> std::optional<JsonValue>
+			{
+				SkipSpaces();
+				if (m_position == m_text.size() || depth == MaxDepth)
+				{
+					return std::nullopt;
+				}
+
+				switch (m_text[m_position])
+				{
+				case '{': return ParseObject(depth);
+				case '[': return ParseArray(depth);
+				case '"':
+				{
+					auto text = ParseString();
+					return text ? std::optional{ JsonValue{ std::move(text.value()) } } : std::nullopt;
+				}
+				case 't': return ParseLiteral("true", JsonValue{ true });
+				case 'f': return ParseLiteral("false", JsonValue{ false });
+				case 'n': return ParseLiteral("null", JsonValue{});
+				default: return ParseNumber();
+				}
+			}
+
+			auto ParseObject(const int depth) -> std::optional<JsonValue>
+			{
+				++m_position;
+
+				auto object = JsonValue::Object{};
+				if (Consume('}'))
+				{
+					return JsonValue{ std::move(object) };
+				}
+
+				do
+				{
+					SkipSpaces();
+					auto key = ParseString();
+					if (!key || !Consume(':'))
+					{
+						return std::nullopt;
+					}
+
+					auto member = ParseValue(depth + 1);
+					if (!member)
+					{
+						return std::nullopt;
+					}
+					object.emplace_back(std::move(key.value()), std::move(member.value()));
+				} while (Consume(','));
+
+				return Consume('}') ? std::optional{ JsonValue{ std::move(object) } } : std::nullopt;
+			}
+
+			auto ParseArray(const int depth) -> std::optional<JsonValue>
+			{
+				++m_position;
+
+				auto array = JsonValue::Array{};
+				if (Consume(']'))
+				{
+					return JsonValue{ std::move(array) };
+				}
+
+				do
+				{
+					auto element = ParseValue(depth + 1);
+					if (!element)
+					{
+						return std::nullopt;
+					}
+					array.push_back(std::move(element.value()));
+				} while (Consume(','));
+
+				return Consume(']') ? std::optional{ JsonValue{ std::move(array) } } : std::nullopt;
+			}
+
+			auto ParseHex4() -> std::optional<uint32_t>
+			{
+				auto code_unit = uint32_t{};
+				if (m_text.size() - m_position < 4 || std::from_chars(m_text.data() + m_position, m_text.data() + m_position + 4, code_unit, 16).ptr != m_text.data() + m_position + 4)
+				{
+					return std::nullopt;
+				}
+				m_position += 4;
+				return code_unit;
+			}
+
+			static auto AppendUtf8(std::string& text, const uint32_t code_point) -> void
+			{
+				if (code_point < 0x80)
+				{
+					text += static_cast<char>(code_point);
+				}
+				else if (code_point < 0x800)
+				{
+					text += static_cast<char>(0xC0 | code_point >> 6);
+					text += static_cast<char>(0x80 | (code_point & 0x3F));
+				}
+				else if (code_point < 0x10000)
+				{
+					text += static_cast<char>(0xE0 | code_point >> 12);
+					text += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+					text += static_cast<char>(0x80 | (code_point & 0x3F));
+				}
+				else
+				{
+					text += static_cast<char>(0xF0 | code_point >> 18);
+					text += static_cast<char>(0x80 | (code_point >> 12 & 0x3F));
+					text += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+					text += static_cast<char>(0x80 | (code_point & 0x3F));
+				}
+			}
+
+			auto ParseString() -> std::optional<std::string>
+			{
+				if (m_position == m_text.size() || m_text[m_position] != '"')
+				{
+					return std::nullopt;
+				}
+				++m_position;
+
+				auto text = std::string{};
+				while (m_position != m_text.size())
+				{
+					const auto character = m_text[m_position++];
+					if (character == '"')
+					{
+						return text;
+					}
+					if (character != '\\')
+					{
+						text += character;
+						continue;
+					}
+
+					if (m_position == m_text.size())
+					{
+						return std::nullopt;
+					}
+
+					switch (m_text[m_position++])
+					{
+					case '"': text += '"'; break;
+					case '\\': text += '\\'; break;
+					case '/': text += '/'; break;
+					case 'b': text += '\b'; break;
+					case 'f': text += '\f'; break;
+					case 'n': text += '\n'; break;
+					case 'r': text += '\r'; break;
+					case 't': text += '\t'; break;
+					case 'u':
+					{
+						auto code_point = ParseHex4();
+						if (!code_point)
+						{
+							return std::nullopt;
+						}
+
+						// characters past the basic plane come as a surrogate pair
+						if (*code_point >= 0xD800 && *code_point < 0xDC00 && m_text.substr(m_position, 2) == "\\u")
+						{
+							m_position += 2;
+							const auto low_surrogate = ParseHex4();
+							if (!low_surrogate)
+							{
+								return std::nullopt;
+							}
+							code_point = 0x10000 + ((*code_point - 0xD800) << 10) + (*low_surrogate - 0xDC00);
+						}
+
+						AppendUtf8(text, code_point.value());
+						break;
+					}
+					default: return std::nullopt;
+					}
+				}
+
+				return std::nullopt;
+			}
+
+			auto ParseNumber() -> std::optional<JsonValue>
+			{
+				auto number = 0.0;
+				const auto [next, error] = std::from_chars(m_text.data() + m_position, m_text.data() + m_text.size(), number);
+				if (error != std::errc{})
+				{
+					return std::nullopt;
+				}
+
+				m_position = static_cast<size_t>(next - m_text.data());
+				return JsonValue{ number };
+			}
+
+			auto ParseLiteral(const std::string_view literal, JsonValue value) -> std::optional<JsonValue>
+			{
+				if (m_text.substr(m_position, literal.size()) != literal)
+				{
+					return std::nullopt;
+				}
+
+				m_position += literal.size();
+				return value;
+			}
+
+			std::string_view m_text = {};
+			size_t m_position = {};
+		};
+
+		auto ReadU32(const std::span<const uint8_t> data, const size_t offset) -> uint32_t
+		{
+			auto value = uint32_t{};
+			std::memcpy(&value, data.data() + offset, sizeof(value));
+			return value;
+		}
+
+		auto GetComponentSize(const uint32_t component_type) -> size_t
+		{
+			switch (component_type)
+			{
+			case GltfByte:
+			case GltfUnsignedByte: return 1;
+			case GltfShort:
+			case GltfUnsignedShort: return 2;
+			default: return 4;
+			}
+		}
+
+		auto GetComponentsCount(const std::string_view type) -> uint32_t
+		{
+			if (type == "SCALAR") return 1;
+			if (type == "VEC2") return 2;
+			if (type == "VEC3") return 3;
+			if (type == "VEC4") return 4;
+			if (type == "MAT4") return 16;
+			return 0;
+		}
+
+		auto GetNodeTransform(const JsonValue& node) -> glm::mat4
+		{
+			// column major, like glm
+			if (const auto& matrix = node["matrix"]; matrix.GetSize() == 16)
+			{
+				auto transform = glm::mat4{};
+				for (auto column = 0; column != 4; ++column)
+				{
+					for (auto row = 0; row != 4; ++row)
+					{
+						transform[column][row] = static_cast<float>(matrix[static_cast<size_t>(column * 4 + row)].GetNumber());
+					}
+				}
+				return transform;
+			}
+
+			const auto& translation = node["translation"];
+			const auto& rotation = node["rotation"];
+			const auto& scale = node["scale"];
+
+			const auto get_vec3 = [](const JsonValue& value, const float fallback) {
+				return glm::vec3{ static_cast<float>(value[0].GetNumber(fallback)), static_cast<float>(value[1].GetNumber(fallback)), static_cast<float>(value[2].GetNumber(fallback)) };
+			};
+
+			// rotation is x, y, z, w
+			const auto orientation = glm::quat{ static_cast<float>(rotation[3].GetNumber(1.0)), static_cast<float>(rotation[0].GetNumber()), static_cast<float>(rotation[1].GetNumber()), static_cast<float>(rotation[2].GetNumber()) };
+
+			return glm::translate(glm::mat4{ 1.0f }, get_vec3(translation, 0.0f)) * glm::mat4_cast(orientation) * glm::scale(glm::mat4{ 1.0f }, get_vec3(scale, 1.0f));
+		}
+
+		auto Unsupported(const std::filesystem::path& path, const std::string_view reason) -> std::nullopt_t
+		{
+			CX_CORE_DEBUG("{} isn't read natively ({}), importing it with assimp", path.string(), reason);
+			return std::nullopt;
+		}
+
+		template <typename T>
+		auto CopyAttribute(const std::span<const uint8_t> data, const size_t stride, std::vector<Vertex>& vertices, T Vertex::* member) -> void
+		{
+			for (auto vertex_idx = size_t{ 0 }; vertex_idx != vertices.size(); ++vertex_idx)
+			{
+				std::memcpy(&(vertices[vertex_idx].*member), data.data() + vertex_idx * stride, sizeof(T));
+			}
+		}
+
+		template <typename T>
+		auto WidenIndices(const std::span<const uint8_t> data, const size_t stride, std::vector<uint32_t>& indices) -> void
+		{
+			for (auto index_idx = size_t{ 0 }; index_idx != indices.size(); ++index_idx)
+			{
+				auto index = T{};
+				std::memcpy(&index, data.data() + index_idx * stride, sizeof(T));
+				indices[index_idx] = index;
+			}
+		}
+	}
+
+	auto GlbScene::Open(const std::filesystem::path& path) -> std::optional<GlbScene>
+	{
+		CX_PROFILE_FUNCTION();
+
+		auto file = AssetFileSystem::GetInstance().Read(path);
+		if (!file)
+		{
+			return std::nullopt;
+		}
+
+		const auto data = file->m_bytes;
+		if (data.size() < GlbHeaderSize + GlbChunkHeaderSize || ReadU32(data, 0) != GlbMagic || ReadU32(data, 4) != 2)
+		{
+			return Unsupported(path, "not a glTF 2 binary");
+		}
+
+		// the JSON chunk comes first, the binary one (optional) right after it
+		const auto file_size = std::min<size_t>(ReadU32(data, 8), data.size());
+		const auto json_size = static_cast<size_t>(ReadU32(data, GlbHeaderSize));
+		const auto json_offset = GlbHeaderSize + GlbChunkHeaderSize;
+		if (ReadU32(data, GlbHeaderSize + 4) != GlbJsonChunk || json_size > file_size - json_offset)
+		{
+			return Unsupported(path, "malformed JSON chunk");
+		}
+
+		auto binary = std::span<const uint8_t>{};
+		if (const auto binary_offset = json_offset + json_size; binary_offset + GlbChunkHeaderSize <= file_size && ReadU32(data, binary_offset + 4) == GlbBinaryChunk)
+		{
+			const auto binary_size = std::min<size_t>(ReadU32(data, binary_offset), file_size - binary_offset - GlbChunkHeaderSize);
+			binary = data.subspan(binary_offset + GlbChunkHeaderSize, binary_size);
+		}
+
+		const auto document = JsonParser{ { reinterpret_cast<const char*>(data.data() + json_offset), json_size } }.Parse();
+		if (!document)
+		{
+			return Unsupported(path, "malformed JSON chunk");
+		}
+
+		const auto& json = document.value();
+		auto scene = GlbScene{};
+
+		// the binary chunk is the only buffer taken
+		for (auto buffer_idx = size_t{ 0 }; buffer_idx != json["buffers"].GetSize(); ++buffer_idx)
+		{
+			if (!json["buffers"][buffer_idx]["uri"].IsNull())
+			{
+				return Unsupported(path, "buffer outside the binary chunk");
+			}
+		}
+
+		const auto& buffer_views = json["bufferViews"];
+		const auto get_buffer_view = [&](const size_t view_idx) -> std::optional<std::span<const uint8_t>> {
+			const auto& buffer_view = buffer_views[view_idx];
+			const auto offset = buffer_view["byteOffset"].GetIndex().value_or(0);
+			const auto size = buffer_view["byteLength"].GetIndex().value_or(0);
+			if (buffer_view.IsNull() || buffer_view["buffer"].GetIndex() != 0 || offset > binary.size() || size > binary.size() - offset)
+			{
+				return std::nullopt;
+			}
+			return binary.subspan(offset, size);
+		};
+
+		const auto& accessors = json["accessors"];
+		scene.m_accessors.reserve(accessors.GetSize());
+		for (auto accessor_idx = size_t{ 0 }; accessor_idx != accessors.GetSize(); ++accessor_idx)
+		{
+			const auto& accessor = accessors[accessor_idx];
+			const auto view_idx = accessor["bufferView"].GetIndex();
+			if (!view_idx || !accessor["sparse"].IsNull())
+			{
+				return Unsupported(path, "sparse accessor");
+			}
+
+			const auto view_data = get_buffer_view(view_idx.value());
+			if (!view_data)
+			{
+				return Unsupported(path, "buffer view out of the binary chunk");
+			}
+
+			auto& scene_accessor = scene.m_accessors.emplace_back();
+			scene_accessor.m_component_type = static_cast<uint32_t>(accessor["componentType"].GetIndex().value_or(0));
+			scene_accessor.m_components = GetComponentsCount(accessor["type"].GetString());
+			scene_accessor.m_count = accessor["count"].GetIndex().value_or(0);
+
+			const auto element_size = GetComponentSize(scene_accessor.m_component_type) * scene_accessor.m_components;
+			const auto byte_stride = buffer_views[view_idx.value()]["byteStride"].GetIndex();
+			scene_accessor.m_stride = byte_stride.value_or(element_size);
+
+			// glTF strides are 4 byte aligned, a smaller one would have the elements overlap
+			if (element_size == 0 || scene_accessor.m_stride < element_size || (byte_stride && byte_stride.value() % 4 != 0))
+			{
+				return Unsupported(path, "accessor of unknown type or with an invalid stride");
+			}
+
+			// count comes from the file, the span of the elements is computed without overflowing
+			const auto offset = accessor["byteOffset"].GetIndex().value_or(0);
+			if (scene_accessor.m_count != 0 && scene_accessor.m_count - 1 > (std::numeric_limits<size_t>::max() - element_size) / scene_accessor.m_stride)
+			{
+				return Unsupported(path, "accessor out of its buffer view");
+			}
+
+			const auto size = scene_accessor.m_count != 0 ? scene_accessor.m_stride * (scene_accessor.m_count - 1) + element_size : 0;
+			if (offset > view_data->size() || size > view_data->size() - offset)
+			{
+				return Unsupported(path, "accessor out of its buffer view");
+			}
+			scene_accessor.m_data = view_data->subspan(offset, size);
+
+			if (const auto& min = accessor["min"], & max = accessor["max"]; min.GetSize() == 3 && max.GetSize() == 3)
+			{
+				scene_accessor.m_bounds = BoundingBox{
+					{ static_cast<float>(min[0].GetNumber()), static_cast<float>(min[1].GetNumber()), static_cast<float>(min[2].GetNumber()) },
+					{ static_cast<float>(max[0].GetNumber()), static_cast<float>(max[1].GetNumber()), static_cast<float>(max[2].GetNumber()) }
+				};
+			}
+		}
+
+		const auto is_float_accessor = [&](const std::optional<size_t> accessor_idx, const uint32_t components, const size_t count) {
+			if (!accessor_idx || accessor_idx.value() >= scene.m_accessors.size())
+			{
+				return false;
+			}
+			const auto& accessor = scene.m_accessors[accessor_idx.value()];
+			return accessor.m_component_type == GltfFloat && accessor.m_components == components && accessor.m_count == count;
+		};
+
+		// embedded images are named like assimp names them, *index
+		const auto& images = json["images"];
+		for (auto image_idx = size_t{ 0 }; image_idx != images.GetSize(); ++image_idx)
+		{
+			const auto& image = images[image_idx];
+			auto& scene_image = scene.m_images.emplace_back();
+
+			if (const auto view_idx = image["bufferView"].GetIndex())
+			{
+				const auto view_data = get_buffer_view(view_idx.value());
+				if (!view_data)
+				{
+					return Unsupported(path, "image out of the binary chunk");
+				}
+				scene_image.m_source = std::format("*{}", image_idx);
+				scene_image.m_embedded = EmbeddedImage{ view_data.value(), static_cast<uint32_t>(view_data->size()), 0 };
+			}
+			else if (const auto uri = image["uri"].GetString(); !uri.empty() && !uri.starts_with("data:"))
+			{
+				scene_image.m_source = uri;
+			}
+			else
+			{
+				return Unsupported(path, "data uri image");
+			}
+		}
+
+		// the texture types the assimp import looks for in glTF materials, in its order
+		const auto& textures = json["textures"];
+		const auto& materials = json["materials"];
+		for (auto material_idx = size_t{ 0 }; material_idx != materials.GetSize(); ++material_idx)
+		{
+			const auto& material = materials[material_idx];
+			auto& material_textures = scene.m_materials.emplace_back();
+
+			const auto add_texture = [&](const JsonValue& texture_info, const TextureType type) {
+				const auto texture_idx = texture_info["index"].GetIndex();
+				const auto image_idx = texture_idx ? textures[texture_idx.value()]["source"].GetIndex() : std::nullopt;
+				if (image_idx && image_idx.value() < scene.m_images.size())
+				{
+					material_textures.push_back({ type, image_idx.value() });
+				}
+			};
+
+			add_texture(material["pbrMetallicRoughness"]["baseColorTexture"], TextureType::albedo);
+			add_texture(material["normalTexture"], TextureType::normals);
+			add_texture(material["emissiveTexture"], TextureType::emissive);
+		}
+
+		const auto& meshes = json["meshes"];
+		auto mesh_primitives = std::vector<std::vector<size_t>>(meshes.GetSize());
+		for (auto mesh_idx = size_t{ 0 }; mesh_idx != meshes.GetSize(); ++mesh_idx)
+		{
+			const auto& primitives = meshes[mesh_idx]["primitives"];
+			for (auto primitive_idx = size_t{ 0 }; primitive_idx != primitives.GetSize(); ++primitive_idx)
+			{
+				const auto& primitive = primitives[primitive_idx];
+				const auto& attributes = primitive["attributes"];
+
+				if (primitive["mode"].GetIndex().value_or(GltfTriangles) != GltfTriangles)
+				{
+					return Unsupported(path, "primitive other than a triangle list");
+				}
+
+				auto scene_primitive = Primitive{};
+				const auto position = attributes["POSITION"].GetIndex();
+				const auto vertices_count = position && position.value() < scene.m_accessors.size() ? scene.m_accessors[position.value()].m_count : 0;
+				if (!is_float_accessor(position, 3, vertices_count))
+				{
+					return Unsupported(path, "non float positions");
+				}
+				scene_primitive.m_position = position.value();
+
+				// assimp generates the missing normals and tangents, left to it
+				const auto normal = attributes["NORMAL"].GetIndex();
+				if (!is_float_accessor(normal, 3, vertices_count))
+				{
+					return Unsupported(path, "no float normals");
+				}
+				scene_primitive.m_normal = normal.value();
+
+				if (const auto tex_coords = attributes["TEXCOORD_0"].GetIndex())
+				{
+					if (!is_float_accessor(tex_coords, 2, vertices_count))
+					{
+						return Unsupported(path, "non float uvs");
+					}
+					scene_primitive.m_tex_coords = tex_coords;
+				}
+
+				if (const auto tangent = attributes["TANGENT"].GetIndex())
+				{
+					if (!is_float_accessor(tangent, 4, vertices_count))
+					{
+						return Unsupported(path, "non float tangents");
+					}
+					scene_primitive.m_tangent = tangent;
+				}
+
+				if (const auto indices = primitive["indices"].GetIndex())
+				{
+					const auto is_valid = indices.value() < scene.m_accessors.size() && scene.m_accessors[indices.value()].m_components == 1 &&
+						(scene.m_accessors[indices.value()].m_component_type == GltfUnsignedByte || scene.m_accessors[indices.value()].m_component_type == GltfUnsignedShort || scene.m_accessors[indices.value()].m_component_type == GltfUnsignedInt);
+					if (!is_valid)
+					{
+						return Unsupported(path, "malformed indices");
+					}
+					scene_primitive.m_indices = indices;
+				}
+
+				if (const auto material = primitive["material"].GetIndex(); material && material.value() < scene.m_materials.size())
+				{
+					scene_primitive.m_material = material;
+
+					const auto& material_textures = scene.m_materials[material.value()];
+					const auto has_normal_map = std::ranges::any_of(material_textures, [](const MaterialTexture& texture) { return texture.m_type == TextureType::normals; });
+					if (has_normal_map && !scene_primitive.m_tangent)
+					{
+						return Unsupported(path, "normal map without tangents");
+					}
+				}
+
+				mesh_primitives[mesh_idx].push_back(scene.m_primitives.size());
+				scene.m_primitives.push_back(scene_primitive);
+			}
+		}
+
+		// roots of the default scene, of the first one or every node nobody has as a child
+		const auto& nodes = json["nodes"];
+		auto roots = std::vector<size_t>{};
+		if (const auto& scene_nodes = json["scenes"][json["scene"].GetIndex().value_or(0)]["nodes"]; scene_nodes.GetSize() != 0)
+		{
+			for (auto root_idx = size_t{ 0 }; root_idx != scene_nodes.GetSize(); ++root_idx)
+			{
+				if (const auto node_idx = scene_nodes[root_idx].GetIndex(); node_idx && node_idx.value() < nodes.GetSize())
+				{
+					roots.push_back(node_idx.value());
+				}
+			}
+		}
+		else
+		{
+			auto is_child = std::vector<bool>(nodes.GetSize());
+			for (auto node_idx = size_t{ 0 }; node_idx != nodes.GetSize(); ++node_idx)
+			{
+				const auto& children = nodes[node_idx]["children"];
+				for (auto child_idx = size_t{ 0 }; child_idx != children.GetSize(); ++child_idx)
+				{
+					if (const auto child = children[child_idx].GetIndex(); child && child.value() < nodes.GetSize())
+					{
+						is_child[child.value()] = true;
+					}
+				}
+			}
+			for (auto node_idx = size_t{ 0 }; node_idx != nodes.GetSize(); ++node_idx)
+			{
+				if (!is_child[node_idx])
+				{
+					roots.push_back(node_idx);
+				}
+			}
+		}
+
+		// depth first, a node is visited once even if listed twice
+		auto is_visited = std::vector<bool>(nodes.GetSize());
+		const auto visit_node = [&](const auto& self, const size_t node_idx, const int32_t parent_idx, const glm::mat4& parent_transform) -> void {
+			if (is_visited[node_idx])
+			{
+				return;
+			}
+			is_visited[node_idx] = true;
+
+			const auto& node = nodes[node_idx];
+			const auto scene_node_idx = static_cast<int32_t>(scene.m_scene_nodes.size());
+			const auto local_transform = GetNodeTransform(node);
+			const auto transform = parent_transform * local_transform;
+			scene.m_scene_nodes.push_back({ std::string{ node["name"].GetString() }, parent_idx, local_transform });
+
+			if (const auto mesh_idx = node["mesh"].GetIndex(); mesh_idx && mesh_idx.value() < mesh_primitives.size())
+			{
+				const auto& primitives = mesh_primitives[mesh_idx.value()];
+				const auto mesh_name = meshes[mesh_idx.value()]["name"].GetString();
+				for (auto primitive_idx = size_t{ 0 }; primitive_idx != primitives.size(); ++primitive_idx)
+				{
+					scene.m_scene_nodes[scene_node_idx].m_meshes.push_back(static_cast<uint32_t>(scene.m_instances.size()));
+					scene.m_instances.push_back({
+						primitives.size() == 1 ? std::string{ mesh_name } : std::format("{}-{}", mesh_name, primitive_idx),
+						primitives[primitive_idx],
+						transform,
+						transform == glm::mat4{ 1.0f }
+					});
+				}
+			}
+
+			const auto& children = node["children"];
+			for (auto child_idx = size_t{ 0 }; child_idx != children.GetSize(); ++child_idx)
+			{
+				if (const auto child = children[child_idx].GetIndex(); child && child.value() < nodes.GetSize())
+				{
+					self(self, child.value(), scene_node_idx, transform);
+				}
+			}
+		};
+
+		for (const auto root_idx : roots)
+		{
+			visit_node(visit_node, root_idx, -1, glm::mat4{ 1.0f });
+		}
+
+		scene.m_file = std::move(file.value());
+		return scene;
+	}
+
+	auto GlbScene::Collect(ImportedModel& out_model, std::vector<ImportedNode>& out_nodes) const -> void
+	{
+		// decoded once for the whole model, whatever the number of meshes using it
+		auto texture_indices = std::unordered_map<uint64_t, uint32_t>{};
+
+		out_model.m_meshes.resize(m_instances.size());
+		for (auto instance_idx = size_t{ 0 }; instance_idx != m_instances.size(); ++instance_idx)
+		{
+			const auto& instance = m_instances[instance_idx];
+			const auto& primitive = m_primitives[instance.m_primitive];
+			auto& mesh = out_model.m_meshes[instance_idx];
+			mesh.m_name = instance.m_name;
+
+			if (!primitive.m_material)
+			{
+				continue;
+			}
+
+			for (const auto& material_texture : m_materials[primitive.m_material.value()])
+			{
+				const auto key = static_cast<uint64_t>(material_texture.m_image) << 8 | static_cast<uint64_t>(material_texture.m_type);
+				const auto [it, inserted] = texture_indices.try_emplace(key, static_cast<uint32_t>(out_model.m_textures.size()));
+				if (inserted)
+				{
+					const auto& image = m_images[material_texture.m_image];
+					out_model.m_textures.push_back({ image.m_source, material_texture.m_type });
+					out_model.m_textures.back().m_embedded = image.m_embedded;
+				}
+
+				mesh.m_textures.push_back(it->second);
+			}
+		}
+
+		out_nodes = m_scene_nodes;
+	}
+
+	auto GlbScene::ExtractMesh(const size_t mesh_idx, ImportedMesh& out_mesh) const -> void
+	{
+		const auto& instance = m_instances[mesh_idx];
+		const auto& primitive = m_primitives[instance.m_primitive];
+		const auto& positions = m_accessors[primitive.m_position];
+		const auto& normals = m_accessors[primitive.m_normal];
+
+		// one strided copy per attribute, the binary chunk holds them in their own arrays
+		out_mesh.m_vertices.resize(positions.m_count);
+		CopyAttribute(positions.m_data, positions.m_stride, out_mesh.m_vertices, &Vertex::m_position);
+		CopyAttribute(normals.m_data, normals.m_stride, out_mesh.m_vertices, &Vertex::m_normal);
+
+		if (primitive.m_tex_coords)
+		{
+			const auto& tex_coords = m_accessors[primitive.m_tex_coords.value()];
+			CopyAttribute(tex_coords.m_data, tex_coords.m_stride, out_mesh.m_vertices, &Vertex::m_tex_coords);
+		}
+
+		if (primitive.m_tangent)
+		{
+			// w is the handedness of the bitangent
+			const auto& tangents = m_accessors[primitive.m_tangent.value()];
+			for (auto vertex_idx = size_t{ 0 }; vertex_idx != out_mesh.m_vertices.size(); ++vertex_idx)
+			{
+				auto tangent = glm::vec4{};
+				std::memcpy(&tangent, tangents.m_data.data() + vertex_idx * tangents.m_stride, sizeof(tangent));
+
+				auto& vertex = out_mesh.m_vertices[vertex_idx];
+				vertex.m_tangent = glm::vec3{ tangent };
+				vertex.m_bitangent = glm::cross(vertex.m_normal, vertex.m_tangent) * tangent.w;
+			}
+		}
+
+		if (primitive.m_indices)
+		{
+			const auto& indices = m_accessors[primitive.m_indices.value()];
+			out_mesh.m_indices.resize(indices.m_count);
+
+			switch (indices.m_component_type)
+			{
+			case GltfUnsignedInt:
+				if (indices.m_stride == sizeof(uint32_t))
+				{
+					std::memcpy(out_mesh.m_indices.data(), indices.m_data.data(), indices.m_count * sizeof(uint32_t));
+				}
+				else
+				{
+					WidenIndices<uint32_t>(indices.m_data, indices.m_stride, out_mesh.m_indices);
+				}
+				break;
+			case GltfUnsignedShort: WidenIndices<uint16_t>(indices.m_data, indices.m_stride, out_mesh.m_indices); break;
+			default: WidenIndices<uint8_t>(indices.m_data, indices.m_stride, out_mesh.m_indices); break;
+			}
+
+			if (std::ranges::any_of(out_mesh.m_indices, [&](const uint32_t index) { return index >= positions.m_count; }))
+			{
+				CX_CORE_ERROR("Mesh {} has indices past its vertices, dropping it", out_mesh.m_name);
+				out_mesh.m_vertices = {};
+				out_mesh.m_indices = {};
+				return;
+			}
+		}
+		else
+		{
+			out_mesh.m_indices.resize(positions.m_count);
+			std::iota(out_mesh.m_indices.begin(), out_mesh.m_indices.end(), 0u);
+		}
+
+		// what aiProcess_OptimizeGraph does when it collapses the nodes
+		if (!instance.m_is_identity)
+		{
+			const auto normal_matrix = glm::mat3{ glm::transpose(glm::inverse(instance.m_transform)) };
+			const auto tangent_matrix = glm::mat3{ instance.m_transform };
+			for (auto& vertex : out_mesh.m_vertices)
+			{
+				vertex.m_position = glm::vec3{ instance.m_transform * glm::vec4{ vertex.m_position, 1.0f } };
+				vertex.m_normal = glm::normalize(normal_matrix * vertex.m_normal);
+				if (primitive.m_tangent)
+				{
+					vertex.m_tangent = glm::normalize(tangent_matrix * vertex.m_tangent);
+					vertex.m_bitangent = glm::normalize(tangent_matrix * vertex.m_bitangent);
+				}
+			}
+			return;
+		}
+
+		out_mesh.m_bounds = positions.m_bounds;
+	}
+}
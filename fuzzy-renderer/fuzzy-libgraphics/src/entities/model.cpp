@@ -1,8 +1,19 @@
 #include <entities/model.h>
+#include <entities/glb_scene.h>
+#include <entities/imported_model.h>
 
+#include <job_system.h>
 #include <logger.h>
+#include <memory_tracker.h>
+#include <render_profiler.h>
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <optional>
 #include <ranges>
 #include <assimp/Importer.hpp>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
@@ -13,14 +24,19 @@
 
 #include "components/mesh_renderer.h"
 
+#include <asset_file_system.h>
+#include <core.h>
+#include <hot_reloader.h>
+#include <resource_manager.h>
+#include <enums.h>
+#include <rendering/mesh_cache.h>
+#include <rendering/texture.h>
+#include <rendering/texture_cache.h>
+#include <rendering/texture_cooker.h>
+#include <rendering/texture_streamer.h>
+
 namespace libgraphics
 {
-	struct TexturePair
-	{
-		aiTextureType m_type = {};
-		std::string m_path = {};
-	};
-
 #pragma region FREE FUNCTIONS
 
 	auto AssimpTextureTypeToNative(const aiTextureType type) -> TextureType
@@ -40,77 +56,10 @@ namespace libgraphics
 		}
 	}
 
-
-	auto LoadMaterialTextures(const aiScene& scene, const aiMaterial& material, const aiTextureType type, const std::string_view type_name, const std::string_view model_path) -> std::vector<Texture>
-	{
-		auto textures_loaded = std::unordered_map<TextureType, Texture>{};
-		auto textures = std::vector<Texture>{};
-
-		const auto textures_count = std::views::iota(0ul) | std::views::take(material.GetTextureCount(type));
-
-		std::ranges::for_each(textures_count, [&](const auto texture_idx) {
-			auto texture_assimp_path = aiString{};
-			material.GetTexture(type, texture_idx, &texture_assimp_path);
-
-			const auto texture_type = AssimpTextureTypeToNative(type);
-
-			auto skip = false;
-			if (const auto it = textures_loaded.find(texture_type); it != textures_loaded.end())
-			{
-				// Texture with the same type has already been loaded, continue to next one.
-				textures.push_back(it->second);
-				skip = true;
-			}
-
-			if (!skip)
-			{
-				if (const auto ai_texture = scene.GetEmbeddedTexture(texture_assimp_path.C_Str()))
-				{
-					const auto& texture = Texture(reinterpret_cast<stbi_uc*>(ai_texture->pcData), ai_texture->mWidth, ai_texture->mHeight, texture_type);
-					textures.push_back(texture);
-					textures_loaded[texture_type] = texture;
-				}
-				else
-				{
-					auto file_path = std::filesystem::path{ model_path };
-					const auto& model_folder_path = file_path.remove_filename().string();
-					const auto& texture_from_file_path = model_folder_path + texture_assimp_path.C_Str();
-					const auto& texture = Texture(texture_from_file_path, texture_type);
-					textures.push_back(texture);
-					textures_loaded[texture_type] = texture;
-				}
-			}
-			});
-
-		return textures;
-	}
-
-	auto ExtractTextures(const aiMesh& mesh, const aiScene& scene, const std::string_view model_path, auto& out_textures) -> void
-	{
-		const auto texture_pairs = std::vector<TexturePair>
-		{
-			{aiTextureType_DIFFUSE, "texture_diffuse"}, // albedo
-			{aiTextureType_SPECULAR, "texture_specular"},
-			{aiTextureType_NORMALS, "texture_normal"},
-			{aiTextureType_HEIGHT, "texture_height"},
-			{aiTextureType_AMBIENT, "texture_ambient"},
-			{aiTextureType_EMISSIVE, "texture_emissive"},
-			{aiTextureType_OPACITY, "texture_opacity"},
-			{aiTextureType_DISPLACEMENT, "texture_displacement"},
-			{aiTextureType_REFLECTION, "texture_reflection"}
-		};
-
-		const auto material = scene.mMaterials[mesh.mMaterialIndex];
-
-		std::ranges::for_each(std::views::iota(0ul) | std::views::take(texture_pairs.size()), [&](const auto idx) {
-			const auto& [m_type, m_path] = texture_pairs[idx];
-			const auto& current_loaded_texture = LoadMaterialTextures(scene, *material, m_type, m_path, model_path);
-			std::ranges::copy(current_loaded_texture, std::back_inserter(out_textures));
-		});
-	};
-
 	auto ExtractVertices(const aiMesh& mesh, std::vector<Vertex>& out_vertices)
 	{
+		out_vertices.reserve(mesh.mNumVertices);
+
 		// walk through each of the mesh's vertices
 		for (unsigned int i = 0; i < mesh.mNumVertices; i++)
 		{
@@ -145,81 +94,747 @@ namespace libgraphics
 		}
 	}
 
+	auto ComputeBounds(const std::span<const Vertex> vertices) -> BoundingBox
+	{
+		if (vertices.empty())
+		{
+			return {};
+		}
+
+		auto bounds = BoundingBox{ vertices.front().m_position, vertices.front().m_position };
+		for (const auto& vertex : vertices)
+		{
+			bounds.m_min = glm::min(bounds.m_min, vertex.m_position);
+			bounds.m_max = glm::max(bounds.m_max, vertex.m_position);
+		}
+		return bounds;
+	}
+
+	auto ToGlm(const aiMatrix4x4& matrix) -> glm::mat4
+	{
+		// assimp matrices are row major (a1..a4 is the first row), glm ones are indexed by column
+		auto result = glm::mat4{};
+		result[0] = { matrix.a1, matrix.b1, matrix.c1, matrix.d1 };
+		result[1] = { matrix.a2, matrix.b2, matrix.c2, matrix.d2 };
+		result[2] = { matrix.a3, matrix.b3, matrix.c3, matrix.d3 };
+		result[3] = { matrix.a4, matrix.b4, matrix.c4, matrix.d4 };
+		return result;
+	}
+
 	auto ExtractIndices(const aiMesh& mesh, std::vector<uint32_t>& out_indices)
 	{
+		// triangulated on import
+		out_indices.reserve(static_cast<size_t>(mesh.mNumFaces) * 3);
+
 		std::ranges::for_each(std::views::iota(0ul, mesh.mNumFaces), [&](auto face_idx) {
 			const auto& face = mesh.mFaces[face_idx];
 			std::ranges::for_each(std::views::iota(0ul, face.mNumIndices), [&](auto indices_idx) { out_indices.push_back(face.mIndices[indices_idx]); });
 		});
 	}
 
-	auto ProcessMesh(const aiMesh& mesh, const aiScene& scene, const std::string_view model_path) -> GLMesh
+	// texture types looked up in the materials, in the order the meshes list them
+	constexpr aiTextureType material_texture_types[] =
 	{
-		auto vertices = std::vector<Vertex>{};
-		ExtractVertices(mesh, vertices);
+		aiTextureType_DIFFUSE, // albedo
+		aiTextureType_SPECULAR,
+		aiTextureType_NORMALS,
+		aiTextureType_HEIGHT,
+		aiTextureType_AMBIENT,
+		aiTextureType_EMISSIVE,
+		aiTextureType_OPACITY,
+		aiTextureType_DISPLACEMENT,
+		aiTextureType_REFLECTION
+	};
 
-		auto indices = std::vector<uint32_t>{};
-		ExtractIndices(mesh, indices);
+	auto CollectTextures(const aiMesh& mesh, const aiScene& scene, std::unordered_map<std::string, size_t>& texture_indices, ImportedModel& out_model, ImportedMesh& out_mesh) -> void
+	{
+		const auto& material = *scene.mMaterials[mesh.mMaterialIndex];
 
-		auto textures = std::vector<Texture>{};
-		ExtractTextures(mesh, scene, model_path, textures);
+		for (const auto type : material_texture_types)
+		{
+			const auto textures_count = material.GetTextureCount(type);
+			if (textures_count == 0)
+			{
+				continue;
+			}
+
+			// only the first texture of a type is loaded, the mesh gets it once per texture of that type
+			auto texture_assimp_path = aiString{};
+			material.GetTexture(type, 0, &texture_assimp_path);
+
+			// decoded once for the whole model, whatever the number of meshes using it
+			const auto texture_type = AssimpTextureTypeToNative(type);
+			const auto [it, inserted] = texture_indices.try_emplace(std::format("{}#{}", texture_assimp_path.C_Str(), static_cast<int>(texture_type)), out_model.m_textures.size());
+			if (inserted)
+			{
+				out_model.m_textures.push_back({ texture_assimp_path.C_Str(), texture_type });
+				auto& texture = out_model.m_textures.back();
+
+				// mWidth is the size of a compressed image when mHeight is 0, raw texels otherwise
+				if (const auto ai_texture = scene.GetEmbeddedTexture(texture_assimp_path.C_Str()))
+				{
+					const auto bytes_count = ai_texture->mHeight != 0 ? static_cast<size_t>(ai_texture->mWidth) * ai_texture->mHeight * 4 : static_cast<size_t>(ai_texture->mWidth);
+					texture.m_embedded = EmbeddedImage{ { reinterpret_cast<const uint8_t*>(ai_texture->pcData), bytes_count }, ai_texture->mWidth, ai_texture->mHeight };
+				}
+			}
 
-		return { vertices, indices, textures, mesh.mName.C_Str() };
+			out_mesh.m_textures.insert(out_mesh.m_textures.end(), textures_count, static_cast<uint32_t>(it->second));
+		}
 	}
 
-	auto ProcessNode(const aiNode& node, const aiScene& scene, const std::string_view model_path, std::vector<GLMesh>& out_meshes) -> void
+	auto DecodeTexture(const std::string_view model_folder_path, ImportedTexture& texture) -> void
 	{
+		auto& texture_cache = TextureCache::GetInstance();
+		const auto texture_file_path = std::string{ model_folder_path } + texture.m_source;
+		const auto& embedded = texture.m_embedded;
+
+		// embedded images are keyed by their bytes
+		if (embedded)
+		{
+			texture.m_cache_key = TextureCache::MakeContentKey(embedded->m_data);
+		}
+		else
+		{
+			texture.m_cache_key = TextureCache::MakeFileKey(texture_file_path);
+			HotReloader::GetInstance().WatchFile(texture_file_path);
+		}
+
+		if ((texture.m_cached_texture = texture_cache.Find(texture.m_cache_key, texture.m_type)))
+		{
+			return;
+		}
+
+		if (!embedded)
+		{
+			if (const auto cooked_path = GetCookedTexturePath(texture_file_path); AssetFileSystem::GetInstance().Exists(cooked_path))
+			{
+				if ((texture.m_cooked_texture = TextureStreamer::LoadMipTail(cooked_path)))
+				{
+					return;
+				}
+				CX_CORE_WARN("Ignoring malformed cooked texture: {}", cooked_path.string());
+			}
+		}
+
+		int width = {}, height = {}, num_channels = {};
+		stbi_uc* image_data = {};
+
+		if (embedded)
+		{
+			if (embedded->m_height != 0)
+			{
+				// raw texels, used as they are
+				texture.m_pixels.assign(embedded->m_data.begin(), embedded->m_data.end());
+				texture.m_width = static_cast<int>(embedded->m_width);
+				texture.m_height = static_cast<int>(embedded->m_height);
+				return;
+			}
+
+			// compressed image (png, jpg...)
+			image_data = stbi_load_from_memory(embedded->m_data.data(), static_cast<int>(embedded->m_data.size()), &width, &height, &num_channels, STBI_rgb_alpha);
+		}
+		else if (const auto image_file = AssetFileSystem::GetInstance().Read(texture_file_path))
+		{
+			image_data = stbi_load_from_memory(image_file->m_bytes.data(), static_cast<int>(image_file->m_bytes.size()), &width, &height, &num_channels, STBI_rgb_alpha);
+		}
+
+		if (!image_data)
+		{
+			CX_CORE_ERROR("Unable to load texture {}", texture.m_source);
+			return;
+		}
+
+		texture.m_pixels.assign(image_data, image_data + static_cast<size_t>(width) * height * 4);
+		texture.m_width = width;
+		texture.m_height = height;
+		stbi_image_free(image_data);
+	}
+
+	/**
+	 * \brief A file read through the asset file system, what assimp reads from when archives are mounted.
+	 */
+	class AssetIOStream final : public Assimp::IOStream
+	{
+	public:
+		explicit AssetIOStream(AssetData data) : m_data{ std::move(data) } {}
+
+		auto Read(void* buffer, const size_t size, const size_t count) -> size_t override
+		{
+			if (size == 0)
+			{
+				return 0;
+			}
+
+			const auto read_count = std::min(count, (m_data.m_bytes.size() - m_position) / size);
+			std::memcpy(buffer, m_data.m_bytes.data() + m_position, read_count * size);
+			m_position += read_count * size;
+			return read_count;
+		}
+
+		auto Write(const void*, const size_t, const size_t) -> size_t override { return 0; }
+
+		auto Seek(const size_t offset, const aiOrigin origin) -> aiReturn override
+		{
+			const auto base = origin == aiOrigin_SET ? 0 : origin == aiOrigin_CUR ? m_position : m_data.m_bytes.size();
+			if (offset > m_data.m_bytes.size() - base)
+			{
+				return aiReturn_FAILURE;
+			}
+
+			m_position = base + offset;
+			return aiReturn_SUCCESS;
+		}
+
+		auto Tell() const -> size_t override { return m_position; }
+		auto FileSize() const -> size_t override { return m_data.m_bytes.size(); }
+		auto Flush() -> void override {}
+
+	private:
+		AssetData m_data = {};
+		size_t m_position = {};
+	};
+
+	/**
+	 * \brief Opens the model and the files it references (materials, buffers, images) through the asset file system.
+	 */
+	class AssetIOSystem final : public Assimp::IOSystem
+	{
+	public:
+		auto Exists(const char* file_path) const -> bool override { return AssetFileSystem::GetInstance().Exists(file_path); }
+		auto getOsSeparator() const -> char override { return '/'; }
+
+		auto Open(const char* file_path, const char* mode) -> Assimp::IOStream* override
+		{
+			// read only, like the archives
+			if (std::strchr(mode, 'w') || std::strchr(mode, 'a'))
+			{
+				return nullptr;
+			}
+
+			auto data = AssetFileSystem::GetInstance().Read(file_path);
+			return data ? new AssetIOStream{ std::move(data.value()) } : nullptr;
+		}
+
+		auto Close(Assimp::IOStream* file) -> void override { delete file; }
+	};
+
+	auto CollectMeshes(const aiNode& node, const aiScene& scene, const int32_t parent_idx, std::vector<const aiMesh*>& out_meshes, std::vector<ImportedNode>& out_nodes) -> void
+	{
+		const auto node_idx = static_cast<int32_t>(out_nodes.size());
+		out_nodes.push_back({ node.mName.C_Str(), parent_idx, ToGlm(node.mTransformation) });
+
 		// process all the node's meshes (if any)
 		for (auto i = 0ul; i != node.mNumMeshes; ++i)
 		{
-			const auto mesh = scene.mMeshes[node.mMeshes[i]];
-			out_meshes.push_back(ProcessMesh(*mesh, scene, model_path));
+			out_nodes[node_idx].m_meshes.push_back(static_cast<uint32_t>(out_meshes.size()));
+			out_meshes.push_back(scene.mMeshes[node.mMeshes[i]]);
 		}
 
 		// then do the same for each of its children
 		for (auto i = 0ul; i != node.mNumChildren; ++i)
 		{
-			ProcessNode(*node.mChildren[i], scene, model_path, out_meshes);
+			CollectMeshes(*node.mChildren[i], scene, node_idx, out_meshes, out_nodes);
+		}
+	}
+
+	/**
+	 * \brief Lists the textures and meshes of a mesh cache, the vertices and indices are copied by the import jobs
+	 */
+	auto CollectCachedModel(const MeshCacheContents& contents, ImportedModel& out_model) -> void
+	{
+		out_model.m_textures.reserve(contents.m_textures.size());
+		for (const auto& texture : contents.m_textures)
+		{
+			auto& imported_texture = out_model.m_textures.emplace_back();
+			imported_texture.m_source = texture.m_source;
+			imported_texture.m_type = texture.m_type;
+			imported_texture.m_embedded = texture.m_embedded;
+		}
+
+		out_model.m_meshes.resize(contents.m_meshes.size());
+		for (auto mesh_idx = size_t{ 0 }; mesh_idx != contents.m_meshes.size(); ++mesh_idx)
+		{
+			const auto& mesh = contents.m_meshes[mesh_idx];
+			auto& imported_mesh = out_model.m_meshes[mesh_idx];
+			imported_mesh.m_name = mesh.m_name;
+			imported_mesh.m_bounds = mesh.m_bounds;
+			imported_mesh.m_textures.assign(mesh.m_textures.begin(), mesh.m_textures.end());
+		}
+	}
+
+	auto WriteModelCache(const std::filesystem::path& cache_path, const ImportedModel& model, const std::vector<ImportedNode>& nodes) -> void
+	{
+		// no LOD is generated yet, every mesh has the one covering all its indices
+		auto lods = std::vector<MeshLodRange>{};
+		lods.reserve(model.m_meshes.size());
+
+		auto contents = MeshCacheContents{};
+		for (const auto& texture : model.m_textures)
+		{
+			contents.m_textures.push_back({ texture.m_source, texture.m_type, texture.m_embedded });
+		}
+		for (const auto& mesh : model.m_meshes)
+		{
+			lods.push_back({ 0, static_cast<uint32_t>(mesh.m_indices.size()) });
+			contents.m_meshes.push_back({ mesh.m_name, mesh.m_vertices, mesh.m_indices, mesh.m_bounds.value_or(BoundingBox{}), mesh.m_textures, { &lods.back(), 1 } });
+		}
+		for (const auto& node : nodes)
+		{
+			contents.m_nodes.push_back({ node.m_name, node.m_parent, node.m_transform, node.m_meshes });
 		}
+
+		WriteMeshCache(cache_path, contents);
 	}
 
-	auto LoadModel(const std::string_view path, std::vector<GLMesh>& out_meshes) -> void
+	// part of the mesh cache key, caches of other flags aren't used
+	constexpr auto ModelImportFlags = static_cast<uint32_t>(aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_OptimizeGraph | aiProcess_JoinIdenticalVertices);
+
+	/**
+	 * \brief Parses the file, then extracts the meshes and decodes the textures in parallel on the job system. The meshes
+	 * are read from the mesh cache of the file when it has a valid one, otherwise from the file (by GlbScene for the .glb
+	 * it takes, by assimp for anything else) and the cache is written once they are extracted.
+	 * \param items_count set to the number of meshes and textures once the file is parsed
+	 * \param imported_items_count incremented as each of them is done
+	 * \param mesh_cache_mode whether the cache of the file is read and written, see MeshCacheMode
+	 * \return nothing when assimp can't read the file
+	 */
+	auto ImportModel(const std::string_view path, std::atomic<uint32_t>& items_count, std::atomic<uint32_t>& imported_items_count, const MeshCacheMode mesh_cache_mode = MeshCacheMode::read_write) -> std::unique_ptr<ImportedModel>
 	{
+		CX_PROFILE_ZONE("ImportModel");
+
+		const auto cache_path = mesh_cache_mode != MeshCacheMode::bypass ? GetMeshCachePath(path, ModelImportFlags) : std::nullopt;
+		auto mesh_cache = cache_path && mesh_cache_mode == MeshCacheMode::read_write ? OpenMeshCache(cache_path.value()) : std::nullopt;
+
+		const auto glb_scene = !mesh_cache && std::filesystem::path{ path }.extension() == ".glb" ? GlbScene::Open(path) : std::nullopt;
+
+		// the scene, when imported, owns the embedded images until the import is done
 		auto import = Assimp::Importer{};
+		auto meshes = std::vector<const aiMesh*>{};
+		auto nodes = std::vector<ImportedNode>{};
+		auto model = std::make_unique<ImportedModel>();
+
+		if (mesh_cache)
+		{
+			CollectCachedModel(mesh_cache->m_contents, *model);
+		}
+		else if (glb_scene)
+		{
+			glb_scene->Collect(*model, nodes);
+		}
+		else
+		{
+			// Configura i processi di importazione per generare le collisioni
+			import.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_CAMERAS | aiComponent_LIGHTS | aiComponent_ANIMATIONS);
+			import.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);
+			import.SetPropertyBool(AI_CONFIG_PP_PTV_KEEP_HIERARCHY, true);
+
+			// assimp's own file system otherwise, the files packed in an archive aren't on disk
+			if (AssetFileSystem::GetInstance().GetMountedCount() != 0)
+			{
+				import.SetIOHandler(new AssetIOSystem{});
+			}
+
+			const auto scene = import.ReadFile(std::string{ path }.c_str(), ModelImportFlags);
+
+			if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+			{
+				CX_CORE_ERROR("couldn't load assimp model {}", path);
+				return {};
+			}
 
-		// Configura i processi di importazione per generare le collisioni
-		import.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_CAMERAS | aiComponent_LIGHTS | aiComponent_ANIMATIONS);
-		import.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);
-		import.SetPropertyBool(AI_CONFIG_PP_PTV_KEEP_HIERARCHY, true);
+			CollectMeshes(*scene->mRootNode, *scene, -1, meshes, nodes);
+			model->m_meshes.resize(meshes.size());
 
-		const auto scene = import.ReadFile(path.data(), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_OptimizeGraph | aiProcess_JoinIdenticalVertices);
+			auto texture_indices = std::unordered_map<std::string, size_t>{};
+			for (auto mesh_idx = size_t{ 0 }; mesh_idx != meshes.size(); ++mesh_idx)
+			{
+				CollectTextures(*meshes[mesh_idx], *scene, texture_indices, *model, model->m_meshes[mesh_idx]);
+			}
+		}
+
+		// textures are GPU objects, the software backend has no use for them (the cache lists them all the same)
+		const auto decode_textures = Core::GetInstance().GetGraphicsAPI() != GraphicsAPI::software;
+		const auto textures_count = decode_textures ? model->m_textures.size() : 0;
+		const auto meshes_count = model->m_meshes.size();
+		items_count.store(static_cast<uint32_t>(textures_count + meshes_count), std::memory_order_relaxed);
+
+		const auto model_folder_path = std::filesystem::path{ path }.remove_filename().string();
+
+		// one job per texture and per mesh, decoding a texture takes far longer than extracting a mesh
+		auto& job_system = JobSystem::GetInstance();
+		auto counter = JobCounter{};
+		auto has_invalid_indices = std::atomic<bool>{};
 
-		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		for (auto item_idx = size_t{ 0 }; item_idx != textures_count + meshes_count; ++item_idx)
+		{
+			job_system.Dispatch([&, item_idx] {
+				if (item_idx < textures_count)
+				{
+					DecodeTexture(model_folder_path, model->m_textures[item_idx]);
+				}
+				else if (mesh_cache)
+				{
+					// GPU ready already, a plain copy out of the mapping. The indices are checked on the way, a corrupted cache
+					// would have the GPU read past the vertex buffer.
+					const auto& cached_mesh = mesh_cache->m_contents.m_meshes[item_idx - textures_count];
+					auto& imported_mesh = model->m_meshes[item_idx - textures_count];
+					imported_mesh.m_vertices.assign(cached_mesh.m_vertices.begin(), cached_mesh.m_vertices.end());
+					imported_mesh.m_indices.resize(cached_mesh.m_indices.size());
+
+					auto max_index = uint32_t{};
+					for (auto index_idx = size_t{ 0 }; index_idx != cached_mesh.m_indices.size(); ++index_idx)
+					{
+						const auto index = cached_mesh.m_indices[index_idx];
+						max_index = std::max(max_index, index);
+						imported_mesh.m_indices[index_idx] = index;
+					}
+
+					if (!cached_mesh.m_indices.empty() && max_index >= cached_mesh.m_vertices.size())
+					{
+						has_invalid_indices.store(true, std::memory_order_relaxed);
+					}
+				}
+				else if (glb_scene)
+				{
+					auto& imported_mesh = model->m_meshes[item_idx - textures_count];
+					glb_scene->ExtractMesh(item_idx - textures_count, imported_mesh);
+					if (!imported_mesh.m_bounds)
+					{
+						imported_mesh.m_bounds = ComputeBounds(imported_mesh.m_vertices);
+					}
+				}
+				else
+				{
+					const auto& mesh = *meshes[item_idx - textures_count];
+					auto& imported_mesh = model->m_meshes[item_idx - textures_count];
+					imported_mesh.m_name = mesh.mName.C_Str();
+					ExtractVertices(mesh, imported_mesh.m_vertices);
+					ExtractIndices(mesh, imported_mesh.m_indices);
+					imported_mesh.m_bounds = ComputeBounds(imported_mesh.m_vertices);
+				}
+				imported_items_count.fetch_add(1, std::memory_order_relaxed);
+			}, &counter);
+		}
+
+		job_system.Wait(counter);
+
+		if (has_invalid_indices.load(std::memory_order_relaxed))
+		{
+			CX_CORE_WARN("Ignoring mesh cache {}, its indices go past the vertices", cache_path->string());
+
+			// the mapping is released first, the file is written over
+			model.reset();
+			mesh_cache.reset();
+			imported_items_count.store(0, std::memory_order_relaxed);
+			return ImportModel(path, items_count, imported_items_count, MeshCacheMode::rewrite);
+		}
+
+		if (!mesh_cache && cache_path)
+		{
+			WriteModelCache(cache_path.value(), *model, nodes);
+		}
+
+		// views of the scene or of the mapping, both released on return
+		for (auto& texture : model->m_textures)
+		{
+			texture.m_embedded.reset();
+		}
+
+		if (!decode_textures)
+		{
+			model->m_textures.clear();
+			for (auto& mesh : model->m_meshes)
+			{
+				mesh.m_textures.clear();
+			}
+		}
+
+		return model;
+	}
+
+	auto GetUploadBytes(const ImportedMesh& mesh) -> uint64_t
+	{
+		return mesh.m_vertices.size() * sizeof(Vertex) + mesh.m_indices.size() * sizeof(uint32_t);
+	}
+
+	auto GetUploadBytes(const ImportedTexture& texture) -> uint64_t
+	{
+		auto bytes = static_cast<uint64_t>(texture.m_pixels.size());
+		if (texture.m_cooked_texture)
+		{
+			for (const auto& mip : texture.m_cooked_texture->m_mip_tail.m_mips)
+			{
+				bytes += mip.m_data.size();
+			}
+		}
+		return bytes;
+	}
+
+	auto UploadTexture(ImportedTexture& imported_texture) -> Texture
+	{
+		if (imported_texture.m_cached_texture)
+		{
+			return imported_texture.m_cached_texture.value();
+		}
+
+		// another model may have uploaded it since the import looked
+		auto& texture_cache = TextureCache::GetInstance();
+		if (const auto cached_texture = texture_cache.Find(imported_texture.m_cache_key, imported_texture.m_type))
+		{
+			imported_texture.m_pixels = {};
+			imported_texture.m_cooked_texture.reset();
+			return cached_texture.value();
+		}
+
+		if (imported_texture.m_cooked_texture)
+		{
+			auto texture = TextureStreamer::GetInstance().CreateTexture(std::move(imported_texture.m_cooked_texture.value()), imported_texture.m_source, imported_texture.m_type);
+			texture_cache.Insert(imported_texture.m_cache_key, texture);
+			imported_texture.m_cooked_texture.reset();
+			return texture;
+		}
+
+		if (imported_texture.m_pixels.empty())
+		{
+			return {};
+		}
+
+		auto texture = Texture{ imported_texture.m_pixels.data(), static_cast<unsigned>(imported_texture.m_width), static_cast<unsigned>(imported_texture.m_height), imported_texture.m_type };
+		texture_cache.Insert(imported_texture.m_cache_key, texture);
+
+		// the GL texture has its own copy now
+		imported_texture.m_pixels = {};
+
+		return texture;
+	}
+
+	/**
+	 * \brief Creates the mesh and has the resource manager account for it as resource_name
+	 */
+	auto UploadMesh(ImportedMesh& imported_mesh, const std::vector<Texture>& textures, const MeshDataPolicy mesh_data_policy, std::string resource_name) -> std::shared_ptr<IMesh>
+	{
+		auto mesh_textures = std::vector<Texture>{};
+		mesh_textures.reserve(imported_mesh.m_textures.size());
+		for (const auto texture_idx : imported_mesh.m_textures)
+		{
+			mesh_textures.push_back(textures[texture_idx]);
+		}
+
+		const auto bytes = GetUploadBytes(imported_mesh);
+		auto mesh = Core::GetInstance().CreateMesh(std::move(imported_mesh.m_vertices), std::move(imported_mesh.m_indices), std::move(mesh_textures), std::move(imported_mesh.m_name), imported_mesh.m_bounds, mesh_data_policy);
+
+		ResourceManager::GetInstance().Track(ResourceType::meshes, std::move(resource_name), mesh, bytes);
+		return mesh;
+	}
+
+	auto LoadModel(const std::string_view path, std::vector<std::shared_ptr<IMesh>>& out_meshes, const MeshDataPolicy mesh_data_policy, const MeshCacheMode mesh_cache_mode) -> void
+	{
+		const auto memory_owner = MemoryOwnerScope{ std::string{ path } };
+
+		auto items_count = std::atomic<uint32_t>{};
+		auto imported_items_count = std::atomic<uint32_t>{};
+
+		const auto model = ImportModel(path, items_count, imported_items_count, mesh_cache_mode);
+		if (!model)
 		{
-			CX_CORE_ERROR("couldn't load assimp model");
 			return;
 		}
 
-		ProcessNode(*scene->mRootNode, *scene, path, out_meshes);
+		auto textures = std::vector<Texture>{};
+		textures.reserve(model->m_textures.size());
+		for (auto& imported_texture : model->m_textures)
+		{
+			textures.push_back(UploadTexture(imported_texture));
+		}
+
+		for (auto& imported_mesh : model->m_meshes)
+		{
+			out_meshes.push_back(UploadMesh(imported_mesh, textures, mesh_data_policy, std::format("{}#{}", path, out_meshes.size())));
+		}
 	}
 
 #pragma endregion
 
-	Model::Model(const std::string_view path)
+	Model::Model(const std::string_view path, const MeshDataPolicy mesh_data_policy) : m_source_path{ path }
 	{
-		auto meshes = std::vector<GLMesh>{};
+		HotReloader::GetInstance().WatchFile(m_source_path);
 
-		LoadModel(path, meshes);
+		auto meshes = std::vector<std::shared_ptr<IMesh>>{};
 
+		LoadModel(path, meshes, mesh_data_policy);
+
+		AddMeshEntities(meshes);
+	}
+
+	Model::Model(const std::string_view name, const std::vector<std::shared_ptr<IMesh>>& meshes)
+	{
+		SetName(std::string{ name });
+		AddMeshEntities(meshes);
+	}
+
+	auto Model::ReplaceMeshes(const std::vector<std::shared_ptr<IMesh>>& meshes) -> void
+	{
+		const auto& mesh_entities = GetChildrens();
+		if (mesh_entities.size() != meshes.size())
+		{
+			RemoveChildren();
+			AddMeshEntities(meshes);
+			return;
+		}
+
+		for (size_t mesh_index = 0; mesh_index != meshes.size(); ++mesh_index)
+		{
+			if (const auto mesh_renderer = mesh_entities[mesh_index]->GetComponent<MeshRenderer>())
+			{
+				mesh_renderer->SetMesh(meshes[mesh_index]);
+			}
+		}
+	}
+
+	auto Model::AddMeshEntities(const std::vector<std::shared_ptr<IMesh>>& meshes) -> void
+	{
 		for (const auto& mesh : meshes)
 		{
 			auto mesh_renderer = std::make_shared<MeshRenderer>(mesh);
 
 			auto mesh_entity = std::make_shared<Entity>();
-			mesh_entity->SetName(mesh.GetName());
+			mesh_entity->SetName(mesh->GetName());
 			mesh_entity->AddComponent(mesh_renderer);
 
 			AddChild(mesh_entity);
 		}
 	}
+
+	ModelLoadHandle::ModelLoadHandle(std::string path, const MeshDataPolicy mesh_data_policy) : m_path{ std::move(path) }, m_mesh_data_policy{ mesh_data_policy }
+	{
+	}
+
+	ModelLoadHandle::~ModelLoadHandle() = default;
+
+	auto ModelLoadHandle::GetProgress() const -> float
+	{
+		const auto state = GetState();
+		if (state == ModelLoadState::ready)
+		{
+			return 1.0f;
+		}
+
+		if (state == ModelLoadState::uploading)
+		{
+			return 0.5f + 0.5f * static_cast<float>(m_uploaded_bytes.load(std::memory_order_relaxed)) / static_cast<float>(std::max<uint64_t>(m_upload_bytes, 1));
+		}
+
+		const auto items_count = m_items_count.load(std::memory_order_relaxed);
+		return items_count != 0 ? 0.5f * static_cast<float>(m_imported_items_count.load(std::memory_order_relaxed)) / static_cast<float>(items_count) : 0.0f;
+	}
+
+	ModelLoader::~ModelLoader()
+	{
+		CancelAll();
+	}
+
+	auto ModelLoader::Load(std::string path, const MeshDataPolicy mesh_data_policy) -> std::shared_ptr<ModelLoadHandle>
+	{
+		HotReloader::GetInstance().WatchFile(path);
+
+		auto handle = std::make_shared<ModelLoadHandle>(std::move(path), mesh_data_policy);
+		m_loads.push_back(handle);
+
+		// the job keeps the handle alive, a cancelled load finishes its import and drops it
+		JobSystem::GetInstance().DispatchBackground([handle] {
+			auto imported_model = ImportModel(handle->m_path, handle->m_items_count, handle->m_imported_items_count);
+			auto expected_state = ModelLoadState::importing;
+
+			if (!imported_model)
+			{
+				handle->m_state.compare_exchange_strong(expected_state, ModelLoadState::failed, std::memory_order_acq_rel);
+				return;
+			}
+
+			for (const auto& texture : imported_model->m_textures)
+			{
+				handle->m_upload_bytes += GetUploadBytes(texture);
+			}
+			for (const auto& mesh : imported_model->m_meshes)
+			{
+				handle->m_upload_bytes += GetUploadBytes(mesh);
+			}
+			handle->m_imported_model = std::move(imported_model);
+
+			// published with the state, the render thread doesn't look at the imported model before
+			handle->m_state.compare_exchange_strong(expected_state, ModelLoadState::uploading, std::memory_order_acq_rel);
+		});
+
+		return handle;
+	}
+
+	auto ModelLoader::Update(const uint64_t budget_bytes) -> std::vector<std::shared_ptr<Model>>
+	{
+		auto completed_models = std::vector<std::shared_ptr<Model>>{};
+		auto uploaded_bytes = uint64_t{ 0 };
+
+		for (const auto& handle : m_loads)
+		{
+			if (handle->GetState() != ModelLoadState::uploading)
+			{
+				continue;
+			}
+
+			if (uploaded_bytes >= budget_bytes)
+			{
+				break;
+			}
+
+			const auto memory_owner = MemoryOwnerScope{ handle->m_path };
+			auto& imported_model = *handle->m_imported_model;
+
+			// textures first, the meshes are created with them
+			while (uploaded_bytes < budget_bytes)
+			{
+				auto item_bytes = uint64_t{};
+
+				if (handle->m_textures.size() != imported_model.m_textures.size())
+				{
+					auto& imported_texture = imported_model.m_textures[handle->m_textures.size()];
+					item_bytes = GetUploadBytes(imported_texture);
+					handle->m_textures.push_back(UploadTexture(imported_texture));
+				}
+				else if (handle->m_meshes.size() != imported_model.m_meshes.size())
+				{
+					auto& imported_mesh = imported_model.m_meshes[handle->m_meshes.size()];
+					item_bytes = GetUploadBytes(imported_mesh);
+					handle->m_meshes.push_back(UploadMesh(imported_mesh, handle->m_textures, handle->m_mesh_data_policy, std::format("{}#{}", handle->m_path, handle->m_meshes.size())));
+				}
+				else
+				{
+					handle->m_model = std::make_shared<Model>(std::filesystem::path{ handle->m_path }.stem().string(), handle->m_meshes);
+					handle->m_model->SetSourcePath(handle->m_path);
+					handle->m_textures = {};
+					handle->m_meshes = {};
+					handle->m_imported_model.reset();
+					handle->m_state.store(ModelLoadState::ready, std::memory_order_release);
+
+					completed_models.push_back(handle->m_model);
+					break;
+				}
+
+				uploaded_bytes += item_bytes;
+				handle->m_uploaded_bytes.fetch_add(item_bytes, std::memory_order_relaxed);
+			}
+		}
+
+		std::erase_if(m_loads, [](const std::shared_ptr<ModelLoadHandle>& handle) { return handle->IsDone(); });
+
+		return completed_models;
+	}
+
+	auto ModelLoader::CancelAll() -> void
+	{
+		for (const auto& handle : m_loads)
+		{
+			handle->m_state.store(ModelLoadState::failed, std::memory_order_release);
+		}
+
+		m_loads.clear();
+	}
 }
@@ -1,5 +1,12 @@
+#include <engine_constants.h>
 #include <entity_manager.h>
+#include <render_profiler.h>
+#include <components/mesh_renderer.h>
 #include <entities/entity.h>
+#include <rendering/texture.h>
+
+#include <algorithm>
+#include <tuple>
 
 namespace libgraphics
 {
@@ -8,6 +15,11 @@ namespace libgraphics
 		m_entities.push_back(entity);
 	}
 
+	auto EntityManager::RemoveEntity(const std::shared_ptr<Entity>& entity) -> void
+	{
+		std::erase(m_entities, entity);
+	}
+
 	auto EntityManager::GetEntityByName(const std::string_view name) const -> std::shared_ptr<Entity>
 	{
 		for (const auto& entity : m_entities)
@@ -20,6 +32,28 @@ namespace libgraphics
 		return {};
 	}
 
+	auto EntityManager::CountSceneObjects() const -> SceneCounts
+	{
+		auto counts = SceneCounts{};
+
+		const auto count_entity = [&counts](const auto& self, const Entity& entity) -> void {
+			counts.m_entities++;
+			counts.m_components += static_cast<uint32_t>(entity.GetComponentsCount());
+
+			for (const auto& child : entity.GetChildrens())
+			{
+				self(self, *child);
+			}
+		};
+
+		for (const auto& entity : m_entities)
+		{
+			count_entity(count_entity, *entity);
+		}
+
+		return counts;
+	}
+
 	auto EntityManager::Render() const -> void
 	{
 		for (const auto& entity : m_entities)
@@ -35,4 +69,117 @@ namespace libgraphics
 			entity->Update(delta_time);
 		}
 	}
+
+	auto EntityManager::BeginRecording(const RenderView& view) -> void
+	{
+		auto& job_system = JobSystem::GetInstance();
+
+		// a recording nobody finished (the pass got culled) still references the buffers below
+		job_system.Wait(m_recording_counter);
+
+		m_renderers.clear();
+		for (const auto& entity : m_entities)
+		{
+			CollectRenderers(*entity);
+		}
+
+		m_recording_view = view;
+		m_culled_count = 0;
+
+		const auto renderers_count = m_renderers.size();
+		const auto partitions_count = std::clamp<size_t>((renderers_count + constants::RenderersPerCommandList - 1) / constants::RenderersPerCommandList, 1, job_system.GetWorkersCount() + 1);
+		const auto partition_size = (renderers_count + partitions_count - 1) / partitions_count;
+
+		m_command_lists.resize(partitions_count);
+
+		for (auto partition_idx = size_t{}; partition_idx != partitions_count; ++partition_idx)
+		{
+			const auto begin = std::min(partition_idx * partition_size, renderers_count);
+			const auto end = std::min(begin + partition_size, renderers_count);
+
+			job_system.Dispatch([this, partition_idx, begin, end] {
+				RecordPartition(m_recording_view, partition_idx, begin, end);
+			}, &m_recording_counter);
+		}
+	}
+
+	auto EntityManager::FinishRecording() -> std::span<const CommandList>
+	{
+		JobSystem::GetInstance().Wait(m_recording_counter);
+		return m_command_lists;
+	}
+
+	auto EntityManager::CollectRenderers(const Entity& entity) -> void
+	{
+		if (const auto& mesh_renderer = entity.GetComponent<MeshRenderer>())
+		{
+			m_renderers.push_back(mesh_renderer.get());
+		}
+
+		for (const auto& child : entity.GetChildrens())
+		{
+			CollectRenderers(*child);
+		}
+	}
+
+	auto EntityManager::RecordPartition(const RenderView& view, const size_t partition_idx, const size_t begin, const size_t end) -> void
+	{
+		CX_PROFILE_FUNCTION();
+
+		struct DrawItem
+		{
+			const IShader* m_shader = {};
+			uint32_t m_first_texture = {};
+			const IMesh* m_mesh = {};
+			const MeshRenderer* m_renderer = {};
+		};
+
+		auto draw_items = std::vector<DrawItem>{};
+		draw_items.reserve(end - begin);
+
+		for (auto renderer_idx = begin; renderer_idx != end; ++renderer_idx)
+		{
+			const auto renderer = m_renderers[renderer_idx];
+			if (!renderer->IsVisible(view))
+			{
+				m_culled_count.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+
+			const auto& mesh = *renderer->GetMesh();
+			const auto& textures = mesh.GetTextures();
+
+			// streamed textures load the mips the mesh needs at its size on screen
+			if (!textures.empty())
+			{
+				const auto screen_size = renderer->GetScreenSize(view);
+				for (const auto& texture : textures)
+				{
+					texture.RequestScreenSize(screen_size);
+				}
+			}
+
+			draw_items.push_back({ renderer->GetShader().get(), textures.empty() ? 0 : textures.front().GetTextureID(), &mesh, renderer });
+		}
+
+		// group by pipeline first (the most expensive switch), then by textures
+		std::ranges::sort(draw_items, [](const DrawItem& lhs, const DrawItem& rhs) {
+			return std::tie(lhs.m_shader, lhs.m_first_texture, lhs.m_mesh) < std::tie(rhs.m_shader, rhs.m_first_texture, rhs.m_mesh);
+		});
+
+		auto& command_list = m_command_lists[partition_idx];
+		command_list.Reset();
+
+		for (const auto& draw_item : draw_items)
+		{
+			if (command_list.BindPipeline(draw_item.m_shader))
+			{
+				command_list.SetConstant("view", view.m_view);
+				command_list.SetConstant("projection", view.m_projection);
+				command_list.SetConstant("eye", view.m_eye);
+			}
+
+			draw_item.m_renderer->Record(command_list);
+		}
+	}
 }
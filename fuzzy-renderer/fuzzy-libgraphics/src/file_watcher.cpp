@@ -0,0 +1,262 @@
+#include <file_watcher.h>
+
+#include <logger.h>
+#include <render_profiler.h>
+
+#include <algorithm>
+#include <array>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace libgraphics
+{
+	// how long the watching thread waits for the OS before it looks at the directories to add or the stop request
+	constexpr auto WatchPollInterval = std::chrono::milliseconds{ 100 };
+
+#ifdef _WIN32
+
+	struct FileWatcher::WatchedDirectory
+	{
+		std::filesystem::path m_path = {};
+		HANDLE m_handle = INVALID_HANDLE_VALUE;
+		OVERLAPPED m_overlapped = {};
+		alignas(DWORD) std::array<uint8_t, 16 * 1024> m_buffer = {};
+	};
+
+#else
+
+	struct FileWatcher::WatchedDirectory
+	{
+		std::filesystem::path m_path = {};
+		int m_watch_descriptor = -1;
+	};
+
+#endif
+
+	FileWatcher::FileWatcher()
+	{
+#ifndef _WIN32
+		m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_inotify_fd < 0)
+		{
+			CX_CORE_WARN("Unable to start the file watcher, file changes won't be picked up");
+			return;
+		}
+#endif
+
+		m_thread = std::thread{ [this] {
+			utils::profiling::RenderProfiler::GetInstance().SetThreadName("file watcher");
+			Run();
+		} };
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		m_is_stopping.store(true, std::memory_order_release);
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+
+#ifndef _WIN32
+		if (m_inotify_fd >= 0)
+		{
+			close(m_inotify_fd);
+		}
+#endif
+	}
+
+	auto FileWatcher::Watch(const std::filesystem::path& directory) -> void
+	{
+		auto error = std::error_code{};
+		auto canonical_directory = std::filesystem::weakly_canonical(directory, error);
+		if (error)
+		{
+			canonical_directory = directory;
+		}
+
+		const auto lock = std::scoped_lock{ m_mutex };
+		if (std::ranges::find(m_known_directories, canonical_directory) == m_known_directories.end())
+		{
+			m_known_directories.push_back(canonical_directory);
+			m_pending_directories.push_back(std::move(canonical_directory));
+		}
+	}
+
+	auto FileWatcher::TakeChanges(const std::chrono::milliseconds settle_time) -> std::vector<std::filesystem::path>
+	{
+		const auto now = std::chrono::steady_clock::now();
+		auto changed_files = std::vector<std::filesystem::path>{};
+
+		const auto lock = std::scoped_lock{ m_mutex };
+		for (auto change = m_changes.begin(); change != m_changes.end();)
+		{
+			if (now - change->second < settle_time)
+			{
+				++change;
+				continue;
+			}
+
+			changed_files.push_back(change->first);
+			change = m_changes.erase(change);
+		}
+
+		return changed_files;
+	}
+
+	auto FileWatcher::AddChange(const std::filesystem::path& path) -> void
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+		m_changes[path] = std::chrono::steady_clock::now();
+	}
+
+	auto FileWatcher::Run() -> void
+	{
+		while (!m_is_stopping.load(std::memory_order_acquire))
+		{
+			OpenPendingDirectories();
+			ReadEvents();
+		}
+
+		CloseDirectories();
+	}
+
+	auto FileWatcher::OpenPendingDirectories() -> void
+	{
+		auto pending_directories = std::vector<std::filesystem::path>{};
+		{
+			const auto lock = std::scoped_lock{ m_mutex };
+			pending_directories.swap(m_pending_directories);
+		}
+
+		for (auto& path : pending_directories)
+		{
+			auto directory = std::make_unique<WatchedDirectory>();
+			directory->m_path = std::move(path);
+
+#ifdef _WIN32
+			// overlapped reads are issued (and cancelled) by this thread only, they are tied to the thread issuing them
+			directory->m_handle = CreateFileW(directory->m_path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+				OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+			if (directory->m_handle == INVALID_HANDLE_VALUE || !IssueRead(*directory))
+			{
+				if (directory->m_handle != INVALID_HANDLE_VALUE)
+				{
+					CloseHandle(directory->m_handle);
+				}
+				CX_CORE_WARN("Unable to watch {}", directory->m_path.string());
+				continue;
+			}
+#else
+			directory->m_watch_descriptor = inotify_add_watch(m_inotify_fd, directory->m_path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+			if (directory->m_watch_descriptor < 0)
+			{
+				CX_CORE_WARN("Unable to watch {}", directory->m_path.string());
+				continue;
+			}
+#endif
+
+			CX_CORE_DEBUG("Watching {}", directory->m_path.string());
+			m_directories.push_back(std::move(directory));
+		}
+	}
+
+#ifdef _WIN32
+
+	auto FileWatcher::IssueRead(WatchedDirectory& directory) -> bool
+	{
+		directory.m_overlapped = {};
+		return ReadDirectoryChangesW(directory.m_handle, directory.m_buffer.data(), static_cast<DWORD>(directory.m_buffer.size()), FALSE,
+			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr, &directory.m_overlapped, nullptr);
+	}
+
+	auto FileWatcher::ReadEvents() -> void
+	{
+		std::this_thread::sleep_for(WatchPollInterval);
+
+		for (const auto& directory : m_directories)
+		{
+			auto bytes_count = DWORD{};
+			if (!HasOverlappedIoCompleted(&directory->m_overlapped) || !GetOverlappedResult(directory->m_handle, &directory->m_overlapped, &bytes_count, FALSE))
+			{
+				continue;
+			}
+
+			// no bytes when the buffer overflowed, those changes are lost
+			for (auto offset = size_t{ 0 }; bytes_count != 0;)
+			{
+				const auto& information = *reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(directory->m_buffer.data() + offset);
+				if (information.Action == FILE_ACTION_ADDED || information.Action == FILE_ACTION_MODIFIED || information.Action == FILE_ACTION_RENAMED_NEW_NAME)
+				{
+					AddChange(directory->m_path / std::wstring{ information.FileName, information.FileNameLength / sizeof(WCHAR) });
+				}
+
+				if (information.NextEntryOffset == 0)
+				{
+					break;
+				}
+				offset += information.NextEntryOffset;
+			}
+
+			IssueRead(*directory);
+		}
+	}
+
+	auto FileWatcher::CloseDirectories() -> void
+	{
+		for (const auto& directory : m_directories)
+		{
+			auto bytes_count = DWORD{};
+			CancelIoEx(directory->m_handle, &directory->m_overlapped);
+			GetOverlappedResult(directory->m_handle, &directory->m_overlapped, &bytes_count, TRUE);
+			CloseHandle(directory->m_handle);
+		}
+		m_directories.clear();
+	}
+
+#else
+
+	auto FileWatcher::ReadEvents() -> void
+	{
+		auto poll_fd = pollfd{ m_inotify_fd, POLLIN, 0 };
+		if (poll(&poll_fd, 1, static_cast<int>(WatchPollInterval.count())) <= 0)
+		{
+			return;
+		}
+
+		alignas(inotify_event) std::array<char, 16 * 1024> buffer = {};
+		for (auto bytes_count = read(m_inotify_fd, buffer.data(), buffer.size()); bytes_count > 0; bytes_count = read(m_inotify_fd, buffer.data(), buffer.size()))
+		{
+			for (auto offset = ssize_t{ 0 }; offset < bytes_count;)
+			{
+				const auto& event = *reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event.len);
+
+				const auto directory = std::ranges::find(m_directories, event.wd, [](const auto& watched_directory) { return watched_directory->m_watch_descriptor; });
+				if (event.len != 0 && directory != m_directories.end())
+				{
+					AddChange((*directory)->m_path / event.name);
+				}
+			}
+		}
+	}
+
+	auto FileWatcher::CloseDirectories() -> void
+	{
+		for (const auto& directory : m_directories)
+		{
+			inotify_rm_watch(m_inotify_fd, directory->m_watch_descriptor);
+		}
+		m_directories.clear();
+	}
+
+#endif
+}
@@ -0,0 +1,297 @@
+#include <gui/windows/gui_window_profiler.h>
+#include <render_profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <map>
+#include <string_view>
+
+namespace libgraphics::gui
+{
+	using utils::profiling::ProfiledFrame;
+	using utils::profiling::ProfileZone;
+	using utils::profiling::RenderProfiler;
+
+	namespace
+	{
+		constexpr auto LaneHeight = 18.0f;
+
+		auto ToMilliseconds(const int64_t nanoseconds) -> float
+		{
+			return static_cast<float>(static_cast<double>(nanoseconds) * 1e-6);
+		}
+
+		auto ZoneColor(const std::string_view name) -> ImU32
+		{
+			// the same zone keeps the same color from frame to frame
+			const auto hue = static_cast<float>(std::hash<std::string_view>{}(name) % 360) / 360.0f;
+
+			auto color = ImVec4{ 0.0f, 0.0f, 0.0f, 1.0f };
+			ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.8f, color.x, color.y, color.z);
+			return ImGui::GetColorU32(color);
+		}
+
+		/**
+		 * \brief Draws the zones of a track as a flame chart (one lane per depth), returns the zone under the mouse.
+		 */
+		auto DrawTrack(const std::string& title, const std::vector<const ProfileZone*>& zones, const int64_t begin_ns, const int64_t end_ns, const float width) -> const ProfileZone*
+		{
+			ImGui::TextUnformatted(title.c_str());
+
+			auto lanes_count = uint32_t{ 1 };
+			for (const auto* zone : zones)
+			{
+				lanes_count = std::max(lanes_count, zone->m_depth + 1);
+			}
+
+			const auto origin = ImGui::GetCursorScreenPos();
+			const auto pixels_per_ns = width / static_cast<float>(std::max<int64_t>(end_ns - begin_ns, 1));
+
+			auto& draw_list = *ImGui::GetWindowDrawList();
+			const auto* hovered_zone = static_cast<const ProfileZone*>(nullptr);
+
+			for (const auto* zone : zones)
+			{
+				const auto min = ImVec2{ origin.x + (zone->m_start_ns - begin_ns) * pixels_per_ns, origin.y + zone->m_depth * LaneHeight };
+				const auto max = ImVec2{ std::max(origin.x + (zone->m_end_ns - begin_ns) * pixels_per_ns, min.x + 1.0f), min.y + LaneHeight - 1.0f };
+
+				draw_list.AddRectFilled(min, max, ZoneColor(zone->m_name));
+
+				// the label only when it fits
+				if (ImGui::CalcTextSize(zone->m_name).x + 4.0f < max.x - min.x)
+				{
+					draw_list.AddText({ min.x + 2.0f, min.y + 1.0f }, IM_COL32(0, 0, 0, 255), zone->m_name);
+				}
+
+				if (ImGui::IsMouseHoveringRect(min, max))
+				{
+					hovered_zone = zone;
+				}
+			}
+
+			ImGui::Dummy({ width, lanes_count * LaneHeight });
+			return hovered_zone;
+		}
+
+		struct ZoneTotals
+		{
+			const char* m_source = {};
+			uint32_t m_calls = {};
+			int64_t m_total_ns = {};
+			int64_t m_max_ns = {};
+		};
+
+		auto AccumulateZones(const std::vector<ProfileZone>& zones, const char* source, std::map<std::pair<std::string_view, std::string_view>, ZoneTotals>& out_totals) -> void
+		{
+			for (const auto& zone : zones)
+			{
+				auto& totals = out_totals[{ source, zone.m_name }];
+				totals.m_source = source;
+				totals.m_calls++;
+				totals.m_total_ns += zone.m_end_ns - zone.m_start_ns;
+				totals.m_max_ns = std::max(totals.m_max_ns, zone.m_end_ns - zone.m_start_ns);
+			}
+		}
+	}
+
+	GUIWindowProfiler::GUIWindowProfiler()
+	{
+		m_title = "Profiler";
+		m_size = { 900.0f, 420.0f };
+		m_position = { 380.0f, 640.0f };
+	}
+
+	auto GUIWindowProfiler::Render() -> void
+	{
+		auto& profiler = RenderProfiler::GetInstance();
+
+		// unlike the overlays this one can be moved and resized
+		ImGui::SetNextWindowSize(m_size, ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowPos(m_position, ImGuiCond_FirstUseEver);
+
+		if (!ImGui::Begin(m_title.c_str()))
+		{
+			ImGui::End();
+			return;
+		}
+
+		auto is_enabled = profiler.IsEnabled();
+		if (ImGui::Checkbox("Enabled", &is_enabled))
+		{
+			profiler.SetEnabled(is_enabled);
+		}
+
+		ImGui::SameLine();
+		auto is_paused = profiler.IsPaused();
+		if (ImGui::Checkbox("Paused", &is_paused))
+		{
+			profiler.SetPaused(is_paused);
+		}
+
+		ImGui::SameLine();
+		if (ImGui::Button("Export trace"))
+		{
+			const auto path = std::format("profile_{:%Y%m%d_%H%M%S}.json", std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+			m_export_status = profiler.ExportChromeTrace(path) ? "Written " + path : "Export failed, see the log";
+		}
+
+		if (!m_export_status.empty())
+		{
+			ImGui::SameLine();
+			ImGui::TextUnformatted(m_export_status.c_str());
+		}
+
+		if (const auto dropped_zones_count = profiler.GetDroppedZonesCount(); dropped_zones_count != 0)
+		{
+			ImGui::SameLine();
+			ImGui::Text("| %llu zones dropped", static_cast<unsigned long long>(dropped_zones_count));
+		}
+
+		const auto& frames = profiler.GetFrames();
+		if (frames.empty())
+		{
+			ImGui::TextUnformatted("No frames recorded yet");
+			ImGui::End();
+			return;
+		}
+
+		// frame times, left click selects a frame and right click goes back to following the latest ones
+		auto frame_times = std::vector<float>{};
+		frame_times.reserve(frames.size());
+		for (const auto& frame : frames)
+		{
+			frame_times.push_back(ToMilliseconds(frame.m_end_ns - frame.m_start_ns));
+		}
+
+		ImGui::PlotHistogram("##frame_times", frame_times.data(), static_cast<int>(frame_times.size()), 0, nullptr, 0.0f, std::ranges::max(frame_times), { ImGui::GetContentRegionAvail().x, 60.0f });
+
+		if (ImGui::IsItemHovered())
+		{
+			const auto item_min = ImGui::GetItemRectMin();
+			const auto item_max = ImGui::GetItemRectMax();
+			const auto hovered_ratio = (ImGui::GetMousePos().x - item_min.x) / std::max(item_max.x - item_min.x, 1.0f);
+			const auto hovered_idx = std::clamp(static_cast<size_t>(hovered_ratio * frames.size()), size_t{ 0 }, frames.size() - 1);
+
+			if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+			{
+				m_selected_frame_index = frames[hovered_idx].m_frame_index;
+			}
+			else if (ImGui::IsMouseClicked(ImGuiMouseButton_Right))
+			{
+				m_selected_frame_index.reset();
+			}
+		}
+
+		const auto selected_it = m_selected_frame_index ? std::ranges::find(frames, m_selected_frame_index.value(), &ProfiledFrame::m_frame_index) : frames.end();
+		if (selected_it == frames.end())
+		{
+			m_selected_frame_index.reset();
+		}
+
+		// GPU results arrive two frames late, the second to last frame is the newest complete one
+		const auto& frame = selected_it != frames.end() ? *selected_it : frames[frames.size() >= 2 ? frames.size() - 2 : 0];
+
+		auto gpu_end_ns = frame.m_end_ns;
+		auto gpu_total_ns = int64_t{ 0 };
+		for (const auto& zone : frame.m_gpu_zones)
+		{
+			gpu_end_ns = std::max(gpu_end_ns, zone.m_end_ns);
+			gpu_total_ns += zone.m_depth == 0 ? zone.m_end_ns - zone.m_start_ns : 0;
+		}
+
+		ImGui::Text("Frame %llu%s: %.3f ms CPU | %.3f ms GPU", static_cast<unsigned long long>(frame.m_frame_index), m_selected_frame_index ? " (selected)" : "",
+			ToMilliseconds(frame.m_end_ns - frame.m_start_ns), ToMilliseconds(gpu_total_ns));
+
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(150.0f);
+		ImGui::SliderFloat("Zoom", &m_zoom, 1.0f, 64.0f, "%.1fx");
+
+		// timeline: CPU threads, then the GPU, on the same time axis
+		if (ImGui::BeginChild("##timeline", { 0.0f, ImGui::GetContentRegionAvail().y * 0.6f }, true, ImGuiWindowFlags_HorizontalScrollbar))
+		{
+			const auto thread_names = profiler.GetThreadNames();
+			auto thread_zones = std::vector<std::vector<const ProfileZone*>>(thread_names.size());
+			for (const auto& zone : frame.m_cpu_zones)
+			{
+				if (zone.m_thread_index < thread_zones.size())
+				{
+					thread_zones[zone.m_thread_index].push_back(&zone);
+				}
+			}
+
+			const auto width = ImGui::GetContentRegionAvail().x * m_zoom;
+			const auto* hovered_zone = static_cast<const ProfileZone*>(nullptr);
+
+			for (auto thread_idx = size_t{ 0 }; thread_idx != thread_zones.size(); ++thread_idx)
+			{
+				if (!thread_zones[thread_idx].empty())
+				{
+					if (const auto* zone = DrawTrack(thread_names[thread_idx], thread_zones[thread_idx], frame.m_start_ns, gpu_end_ns, width))
+					{
+						hovered_zone = zone;
+					}
+				}
+			}
+
+			auto gpu_zones = std::vector<const ProfileZone*>{};
+			for (const auto& zone : frame.m_gpu_zones)
+			{
+				gpu_zones.push_back(&zone);
+			}
+
+			if (const auto* zone = DrawTrack("GPU", gpu_zones, frame.m_start_ns, gpu_end_ns, width))
+			{
+				hovered_zone = zone;
+			}
+
+			if (hovered_zone)
+			{
+				ImGui::SetTooltip("%s\n%.3f ms (starts at +%.3f ms)", hovered_zone->m_name, ToMilliseconds(hovered_zone->m_end_ns - hovered_zone->m_start_ns),
+					ToMilliseconds(hovered_zone->m_start_ns - frame.m_start_ns));
+			}
+		}
+		ImGui::EndChild();
+
+		// per zone totals of the frame, most expensive first
+		auto zone_totals = std::map<std::pair<std::string_view, std::string_view>, ZoneTotals>{};
+		AccumulateZones(frame.m_cpu_zones, "CPU", zone_totals);
+		AccumulateZones(frame.m_gpu_zones, "GPU", zone_totals);
+
+		auto sorted_totals = std::vector<std::pair<std::string_view, ZoneTotals>>{};
+		for (const auto& [key, totals] : zone_totals)
+		{
+			sorted_totals.emplace_back(key.second, totals);
+		}
+		std::ranges::sort(sorted_totals, std::greater{}, [](const auto& entry) { return entry.second.m_total_ns; });
+
+		if (ImGui::BeginTable("##zones", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollY))
+		{
+			ImGui::TableSetupColumn("Zone");
+			ImGui::TableSetupColumn("Source");
+			ImGui::TableSetupColumn("Calls");
+			ImGui::TableSetupColumn("Total ms");
+			ImGui::TableSetupColumn("Max ms");
+			ImGui::TableHeadersRow();
+
+			for (const auto& [name, totals] : sorted_totals)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(name.data(), name.data() + name.size());
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(totals.m_source);
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", totals.m_calls);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", ToMilliseconds(totals.m_total_ns));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", ToMilliseconds(totals.m_max_ns));
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+}
@@ -1,17 +1,56 @@
 #include <core.h>
 #include <gui_utils.h>
+#include <entities/model.h>
 #include <logger.h>
+#include <memory_tracker.h>
 #include <resource_manager.h>
 #include <gui/windows/gui_window_stats.h>
 #include <opengl/gl_shader.h>
+#include <opengl/gl_state_cache.h>
+#include <rendering/render_stats.h>
+#include <rendering/texture_cache.h>
+#include <rendering/texture_streamer.h>
+
+#include <cfloat>
+#include <filesystem>
+#include <format>
 
 namespace libgraphics::gui
 {
+	namespace
+	{
+		/**
+		 * \brief One value of the render stats history as a small line plot, the overlay shows the last frame.
+		 */
+		template <typename ValueGetter>
+		auto Sparkline(const char* label, const std::deque<FrameRenderStats>& history, const ValueGetter& get_value) -> void
+		{
+			auto values = std::vector<float>{};
+			values.reserve(history.size());
+			for (const auto& frame : history)
+			{
+				values.push_back(static_cast<float>(get_value(frame)));
+			}
+
+			const auto overlay = std::format("{}: {:.0f}", label, values.empty() ? 0.0f : values.back());
+			ImGui::PlotLines(std::format("##{}", label).c_str(), values.data(), static_cast<int>(values.size()), 0, overlay.c_str(), 0.0f, FLT_MAX, { ImGui::GetContentRegionAvail().x, 32.0f });
+		}
+
+		auto FormatBytes(const uint64_t bytes) -> std::string
+		{
+			if (bytes >= 1024ull * 1024ull)
+			{
+				return std::format("{:.2f} MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+			}
+			return std::format("{:.1f} KB", static_cast<double>(bytes) / 1024.0);
+		}
+	}
+
 	GUIWindowStats::GUIWindowStats()
 	{
-		m_title = "Stats Window";
+		m_title = "Render Stats";
 		m_bg_alpha = 0.75f;
-		m_size = { 300.0f, 0.0f };
+		m_size = { 340.0f, 0.0f };
 		m_position = { 1.0f, 1.0f };
 		m_flags = ImGuiWindowFlags_NoDecoration |
 			ImGuiWindowFlags_AlwaysAutoResize |
@@ -23,6 +62,9 @@ namespace libgraphics::gui
 
 	void GUIWindowStats::Render()
 	{
+		// docked to the top right corner, under the menu bar
+		m_position = { ImGui::GetIO().DisplaySize.x - m_size.x - 1.0f, 19.0f };
+
 		utils::gui::RenderWindowContent(m_title, m_is_open, m_size, m_position, m_flags, m_bg_alpha, [&] {
 
 			// running this template without any additional piece of code will open a default window
@@ -34,8 +76,81 @@ namespace libgraphics::gui
 			ImGui::Spacing();
 
 			// Frames (Frame rate && Frame time)
+			const auto& render_stats = RenderStats::GetInstance();
+			const auto& frame_stats = render_stats.GetLastFrame();
+			const auto& history = render_stats.GetHistory();
+			const auto [min_ms, avg_ms, max_ms, p99_ms] = render_stats.GetFrameTimeSummary();
+
 			ImGui::Text("FPS: %.1f", io.Framerate);
-			ImGui::Text("Frame Time: %.3f ms", 1000.0f / io.Framerate);
+			ImGui::Text("Frame Time: %.3f ms", frame_stats.m_frame_ms);
+			ImGui::Text("min %.2f | avg %.2f | max %.2f | p99 %.2f ms", min_ms, avg_ms, max_ms, p99_ms);
+			Sparkline("ms", history, [](const FrameRenderStats& frame) { return frame.m_frame_ms; });
+			ImGui::Text("Resolution scale: %.2f", Core::GetInstance().GetResolutionScale());
+
+			utils::gui::Separator(utils::gui::ColorRed);
+			ImGui::Text("Rendering:");
+			ImGui::Spacing();
+
+			ImGui::Text("Draw calls: %u", frame_stats.m_draw_calls);
+			Sparkline("draws", history, [](const FrameRenderStats& frame) { return frame.m_draw_calls; });
+			ImGui::Text("Triangles: %llu | Vertices: %llu", static_cast<unsigned long long>(frame_stats.m_triangles), static_cast<unsigned long long>(frame_stats.m_vertices));
+			Sparkline("triangles", history, [](const FrameRenderStats& frame) { return frame.m_triangles; });
+			ImGui::Text("Binds: %u program | %u vao | %u texture", frame_stats.m_program_binds, frame_stats.m_vao_binds, frame_stats.m_texture_binds);
+			ImGui::Text("Uniform uploads: %u", frame_stats.m_uniform_uploads);
+			ImGui::Text("Buffer uploads: %.1f KB", static_cast<double>(frame_stats.m_buffer_upload_bytes) / 1024.0);
+
+			const auto& [issued_gl_calls, elided_gl_calls] = GLStateCache::GetInstance().GetFrameCounters();
+			ImGui::Text("GL state calls: %u issued | %u elided", issued_gl_calls, elided_gl_calls);
+
+			utils::gui::Separator(utils::gui::ColorRed);
+			ImGui::Text("Scene:");
+			ImGui::Spacing();
+
+			ImGui::Text("Objects: %u visible | %u culled", frame_stats.m_visible_objects, frame_stats.m_culled_objects);
+			Sparkline("visible", history, [](const FrameRenderStats& frame) { return frame.m_visible_objects; });
+			ImGui::Text("Entities: %u | Components: %u", frame_stats.m_entities, frame_stats.m_components);
+
+			for (const auto& model_load : Core::GetInstance().GetModelLoads())
+			{
+				const auto overlay = std::format("Loading {}", std::filesystem::path{ model_load->GetPath() }.filename().string());
+				ImGui::ProgressBar(model_load->GetProgress(), { ImGui::GetContentRegionAvail().x, 0.0f }, overlay.c_str());
+			}
+
+			utils::gui::Separator(utils::gui::ColorRed);
+			ImGui::Text("Memory:");
+			ImGui::Spacing();
+
+			const auto& memory_tracker = MemoryTracker::GetInstance();
+			ImGui::Text("CPU: %s | GPU: %s", FormatBytes(memory_tracker.GetCpuBytes()).c_str(), FormatBytes(memory_tracker.GetGpuBytes()).c_str());
+
+			const auto& texture_cache = TextureCache::GetInstance();
+			ImGui::Text("Texture cache: %zu | %llu hits | %llu misses", texture_cache.GetTexturesCount(),
+				static_cast<unsigned long long>(texture_cache.GetHitsCount()), static_cast<unsigned long long>(texture_cache.GetMissesCount()));
+
+			const auto& texture_streamer = TextureStreamer::GetInstance();
+			ImGui::Text("Streamed textures: %zu | %s / %s resident | %zu reads", texture_streamer.GetStreamedTexturesCount(),
+				FormatBytes(texture_streamer.GetResidentBytes()).c_str(), FormatBytes(texture_streamer.GetBudget()).c_str(), texture_streamer.GetReadsCount());
+			ImGui::Text("Streamed in: %s | evicted: %s", FormatBytes(texture_streamer.GetUploadedBytes()).c_str(), FormatBytes(texture_streamer.GetEvictedBytes()).c_str());
+
+			if (ImGui::TreeNode("Categories"))
+			{
+				const auto category_totals = memory_tracker.GetCategoryTotals();
+				for (auto category_idx = size_t{ 0 }; category_idx != category_totals.size(); ++category_idx)
+				{
+					const auto& [bytes, peak_bytes, allocations_count] = category_totals[category_idx];
+					ImGui::Text("%s: %s (peak %s) in %u", MemoryCategoryToString(static_cast<MemoryCategory>(category_idx)).data(), FormatBytes(bytes).c_str(), FormatBytes(peak_bytes).c_str(), allocations_count);
+				}
+				ImGui::TreePop();
+			}
+
+			if (ImGui::TreeNode("Top consumers"))
+			{
+				for (const auto& [owner, cpu_bytes, gpu_bytes, allocations_count] : memory_tracker.GetTopConsumers(8))
+				{
+					ImGui::Text("%s: %s CPU | %s GPU", owner.c_str(), FormatBytes(cpu_bytes).c_str(), FormatBytes(gpu_bytes).c_str());
+				}
+				ImGui::TreePop();
+			}
 
 			utils::gui::Separator(utils::gui::ColorRed);
 
@@ -51,22 +166,31 @@ namespace libgraphics::gui
 			ImGui::Text("Engine Cache:");
 			ImGui::Spacing();
 
+			const auto& resource_manager = ResourceManager::GetInstance();
+			ImGui::Text("Evictions: %zu", resource_manager.GetEvictionsCount());
+
 			for (auto resource_type_idx = 0; resource_type_idx != static_cast<int>(ResourceType::max_enum); resource_type_idx++)
 			{
-				const auto& resource_enum_type_name = ResourceTypeToString(static_cast<ResourceType>(resource_type_idx));
+				const auto resource_type = static_cast<ResourceType>(resource_type_idx);
+				const auto resources = resource_manager.GetResources(resource_type);
 
-				if (ImGui::TreeNode(resource_enum_type_name.c_str()))
-				{
-					const auto& resources = ResourceManager::GetAllFromCache<libgraphics::GLShader>();
-					const auto& shaders_count = std::views::iota(0) | std::views::take(resources.size());
+				// the id is what follows ###, the counts before it change without closing the node
+				const auto& tree_label = std::format("{} ({}, {} / {})###{}", ResourceTypeToString(resource_type), resources.size(),
+					FormatBytes(resource_manager.GetLoadedBytes(resource_type)), FormatBytes(resource_manager.GetBudget(resource_type)), resource_type_idx);
 
-					std::ranges::for_each(shaders_count, [&](const auto shader_idx)
+				if (ImGui::TreeNode(tree_label.c_str()))
+				{
+					for (const auto& resource : resources)
 					{
-						if (resources[shader_idx].m_resource_type == static_cast<ResourceType>(resource_type_idx))
+						if (resource.m_is_loaded)
+						{
+							ImGui::Text("%s: %s, %u users", resource.m_name.c_str(), FormatBytes(resource.m_bytes).c_str(), resource.m_users_count);
+						}
+						else
 						{
-							ImGui::MenuItem(resources[shader_idx].m_name.c_str());
+							ImGui::TextDisabled("%s: evicted", resource.m_name.c_str());
 						}
-					});
+					}
 
 					ImGui::TreePop();
 				}
@@ -0,0 +1,267 @@
+#include <hot_reloader.h>
+
+#include <asset_file_system.h>
+#include <entity_manager.h>
+#include <logger.h>
+#include <render_profiler.h>
+#include <components/mesh_renderer.h>
+#include <entities/model.h>
+#include <opengl/gl_shader.h>
+#include <rendering/texture_cache.h>
+#include <rendering/texture_cooker.h>
+#include <stb_image.h>
+
+#include <algorithm>
+
+namespace libgraphics
+{
+	namespace
+	{
+		// changed_path comes from the watcher, canonical already
+		auto IsSameFile(const std::filesystem::path& changed_path, const std::filesystem::path& path) -> bool
+		{
+			auto error = std::error_code{};
+			const auto canonical_path = std::filesystem::weakly_canonical(path, error);
+			return !error && canonical_path == changed_path;
+		}
+
+		/**
+		 * \brief Reads the image like the texture loads do, its cooked version first unless use_cooked is false.
+		 */
+		auto DecodeTextureFile(const std::filesystem::path& path, const bool use_cooked, std::unique_ptr<CookedTexture>& out_cooked_texture, std::vector<uint8_t>& out_pixels, int& out_width, int& out_height) -> void
+		{
+			auto& asset_file_system = AssetFileSystem::GetInstance();
+
+			if (const auto cooked_path = GetCookedTexturePath(path); use_cooked && asset_file_system.Exists(cooked_path))
+			{
+				if (auto cooked_texture = ReadKtx2(cooked_path))
+				{
+					out_cooked_texture = std::make_unique<CookedTexture>(std::move(cooked_texture.value()));
+				}
+				return;
+			}
+
+			const auto image_file = asset_file_system.Read(path);
+			if (!image_file)
+			{
+				return;
+			}
+
+			int num_channels = {};
+			if (const auto image_data = stbi_load_from_memory(image_file->m_bytes.data(), static_cast<int>(image_file->m_bytes.size()), &out_width, &out_height, &num_channels, STBI_rgb_alpha))
+			{
+				out_pixels.assign(image_data, image_data + static_cast<size_t>(out_width) * out_height * 4);
+				stbi_image_free(image_data);
+			}
+		}
+	}
+
+	auto HotReloader::GetInstance() -> HotReloader&
+	{
+		// never destroyed: the shaders held by the resource manager leave it after it would be
+		static auto* instance = new HotReloader{};
+		return *instance;
+	}
+
+	HotReloader::HotReloader() : m_model_loader{ std::make_unique<ModelLoader>() }
+	{
+	}
+
+	HotReloader::~HotReloader() = default;
+
+	auto HotReloader::SetEnabled(const bool is_enabled) -> void
+	{
+		if (is_enabled == IsEnabled())
+		{
+			return;
+		}
+
+		const auto lock = std::scoped_lock{ m_mutex };
+		if (!is_enabled)
+		{
+			m_watcher.reset();
+			return;
+		}
+
+		m_watcher = std::make_unique<FileWatcher>();
+		for (const auto& directory : m_directories)
+		{
+			m_watcher->Watch(directory);
+		}
+	}
+
+	auto HotReloader::WatchFile(const std::filesystem::path& path) -> void
+	{
+		auto directory = path.parent_path().string();
+		if (directory.empty())
+		{
+			directory = ".";
+		}
+
+		const auto lock = std::scoped_lock{ m_mutex };
+		if (m_directories.insert(directory).second && m_watcher)
+		{
+			m_watcher->Watch(directory);
+		}
+	}
+
+	auto HotReloader::TrackShader(GLShader& shader) -> void
+	{
+		WatchFile(shader.GetVertexPath());
+		WatchFile(shader.GetFragmentPath());
+		m_shaders.push_back(&shader);
+	}
+
+	auto HotReloader::UntrackShader(const GLShader& shader) -> void
+	{
+		std::erase(m_shaders, &shader);
+	}
+
+	auto HotReloader::Update(EntityManager& entity_manager) -> void
+	{
+		CX_PROFILE_FUNCTION();
+
+		if (m_watcher)
+		{
+			for (const auto& changed_path : m_watcher->TakeChanges(std::chrono::milliseconds{ constants::HotReloadSettleMs }))
+			{
+				ReloadShaders(changed_path);
+				ReloadTextures(changed_path);
+				ReloadModels(changed_path, entity_manager);
+			}
+		}
+
+		SwapTextures();
+		SwapModels(entity_manager);
+	}
+
+	auto HotReloader::Clear() -> void
+	{
+		m_model_loader->CancelAll();
+
+		JobSystem::GetInstance().Wait(m_decode_counter);
+		m_texture_reloads.clear();
+
+		SetEnabled(false);
+	}
+
+	auto HotReloader::ReloadShaders(const std::filesystem::path& changed_path) -> void
+	{
+		for (const auto shader : m_shaders)
+		{
+			if (!IsSameFile(changed_path, shader->GetVertexPath()) && !IsSameFile(changed_path, shader->GetFragmentPath()))
+			{
+				continue;
+			}
+
+			if (shader->Reload())
+			{
+				CX_CORE_INFO("Reloaded shader {} + {}", shader->GetVertexPath(), shader->GetFragmentPath());
+				m_reloads_count++;
+			}
+			else
+			{
+				CX_CORE_ERROR("Shader {} + {} didn't build, keeping the previous version", shader->GetVertexPath(), shader->GetFragmentPath());
+				m_failed_reloads_count++;
+			}
+		}
+	}
+
+	auto HotReloader::ReloadTextures(const std::filesystem::path& changed_path) -> void
+	{
+		for (auto& cache_key : TextureCache::GetInstance().FindFileKeys(changed_path))
+		{
+			auto texture_reload = std::make_shared<TextureReload>();
+			texture_reload->m_path = cache_key;
+			texture_reload->m_use_cooked = !IsSameFile(changed_path, texture_reload->m_path);
+			texture_reload->m_cache_key = std::move(cache_key);
+
+			// nothing cooks on the fly, the new texels are uploaded uncompressed until the image is cooked again
+			if (const auto cooked_path = GetCookedTexturePath(texture_reload->m_path); !texture_reload->m_use_cooked && AssetFileSystem::GetInstance().Exists(cooked_path))
+			{
+				CX_CORE_WARN("{} is older than the image it was cooked from, reloading {} uncompressed", cooked_path.string(), texture_reload->m_cache_key);
+			}
+
+			// the job keeps the reload alive, Clear waits for it anyway
+			JobSystem::GetInstance().DispatchBackground([texture_reload] {
+				auto& reload = *texture_reload;
+				DecodeTextureFile(reload.m_path, reload.m_use_cooked, reload.m_cooked_texture, reload.m_pixels, reload.m_width, reload.m_height);
+				reload.m_is_decoded.store(true, std::memory_order_release);
+			}, &m_decode_counter);
+
+			m_texture_reloads.push_back(std::move(texture_reload));
+		}
+	}
+
+	auto HotReloader::ReloadModels(const std::filesystem::path& changed_path, const EntityManager& entity_manager) -> void
+	{
+		for (const auto& entity : entity_manager.GetEntities())
+		{
+			// a model in the scene many times is imported once, SwapModels updates them all
+			if (const auto model = std::dynamic_pointer_cast<Model>(entity); model && !model->GetSourcePath().empty() && IsSameFile(changed_path, model->GetSourcePath()))
+			{
+				m_model_loader->Load(model->GetSourcePath());
+				return;
+			}
+		}
+	}
+
+	auto HotReloader::SwapTextures() -> void
+	{
+		std::erase_if(m_texture_reloads, [this](const std::shared_ptr<TextureReload>& texture_reload) {
+			if (!texture_reload->m_is_decoded.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			auto& reload = *texture_reload;
+			auto texture = Texture{};
+			if (reload.m_cooked_texture)
+			{
+				texture = Texture{ *reload.m_cooked_texture, reload.m_cache_key, TextureType::albedo };
+			}
+			else if (!reload.m_pixels.empty())
+			{
+				texture = Texture{ reload.m_pixels.data(), static_cast<unsigned>(reload.m_width), static_cast<unsigned>(reload.m_height), TextureType::albedo };
+			}
+
+			if (TextureCache::GetInstance().Replace(reload.m_cache_key, texture))
+			{
+				CX_CORE_INFO("Reloaded texture {}", reload.m_cache_key);
+				m_reloads_count++;
+			}
+			else
+			{
+				CX_CORE_ERROR("Texture {} didn't decode, keeping the previous version", reload.m_cache_key);
+				m_failed_reloads_count++;
+			}
+			return true;
+		});
+	}
+
+	auto HotReloader::SwapModels(EntityManager& entity_manager) -> void
+	{
+		for (const auto& reloaded_model : m_model_loader->Update(constants::ModelUploadBytesPerFrame))
+		{
+			auto meshes = std::vector<std::shared_ptr<IMesh>>{};
+			for (const auto& mesh_entity : reloaded_model->GetChildrens())
+			{
+				if (const auto mesh_renderer = mesh_entity->GetComponent<MeshRenderer>())
+				{
+					meshes.push_back(mesh_renderer->GetMesh());
+				}
+			}
+
+			for (const auto& entity : entity_manager.GetEntities())
+			{
+				if (const auto model = std::dynamic_pointer_cast<Model>(entity); model && model->GetSourcePath() == reloaded_model->GetSourcePath())
+				{
+					model->ReplaceMeshes(meshes);
+				}
+			}
+
+			CX_CORE_INFO("Reloaded model {}", reloaded_model->GetSourcePath());
+			m_reloads_count++;
+		}
+	}
+}
@@ -0,0 +1,226 @@
+#include <job_system.h>
+#include <logger.h>
+#include <render_profiler.h>
+
+#include <algorithm>
+#include <format>
+#include <utility>
+
+namespace libgraphics
+{
+	JobSystem::JobSystem()
+	{
+		// the workers register with the profiler, constructing it first makes it outlive them
+		utils::profiling::RenderProfiler::GetInstance();
+
+		// leave one core to the render thread
+		const auto workers_count = std::max(1u, std::thread::hardware_concurrency() - 1);
+
+		for (auto worker_idx = 0u; worker_idx != workers_count; ++worker_idx)
+		{
+			m_workers.emplace_back([this, worker_idx] {
+				utils::profiling::RenderProfiler::GetInstance().SetThreadName(std::format("worker {}", worker_idx));
+				WorkerLoop();
+			});
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		Shutdown();
+	}
+
+	auto JobSystem::Shutdown() -> void
+	{
+		{
+			const auto lock = std::scoped_lock{ m_queue_mutex };
+			m_stop = true;
+		}
+		m_queue_condition.notify_all();
+
+		// the workers drain the queue before they leave
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+		m_workers.clear();
+	}
+
+	auto JobSystem::GetInstance() -> JobSystem&
+	{
+		static auto instance = JobSystem{};
+		return instance;
+	}
+
+	auto JobSystem::Dispatch(Job job, JobCounter* counter) -> void
+	{
+		Enqueue(m_queue, std::move(job), counter);
+	}
+
+	auto JobSystem::DispatchBackground(Job job, JobCounter* counter) -> void
+	{
+		Enqueue(m_background_queue, std::move(job), counter);
+	}
+
+	auto JobSystem::Enqueue(std::deque<QueuedJob>& queue, Job job, JobCounter* counter) -> void
+	{
+		if (counter)
+		{
+			counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		auto queued_job = QueuedJob{ std::move(job), counter };
+		{
+			const auto lock = std::scoped_lock{ m_queue_mutex };
+			if (!m_stop)
+			{
+				queue.push_back(std::move(queued_job));
+				m_queue_condition.notify_one();
+				return;
+			}
+		}
+
+		// no worker left to run it
+		RunJob(queued_job);
+	}
+
+	auto JobSystem::Wait(JobCounter& counter) -> void
+	{
+		while (counter.m_pending.load(std::memory_order_acquire) != 0)
+		{
+			if (!TryRunOne())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		auto exception = std::exception_ptr{};
+		{
+			const auto lock = std::scoped_lock{ counter.m_exception_mutex };
+			exception = std::exchange(counter.m_exception, nullptr);
+		}
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	auto JobSystem::ParallelFor(const size_t count, const size_t min_batch_size, const std::function<void(size_t, size_t)>& range_function) -> void
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		const auto batches_count = std::clamp(count / std::max<size_t>(min_batch_size, 1), size_t{ 1 }, m_workers.size() + 1);
+		const auto batch_size = (count + batches_count - 1) / batches_count;
+
+		auto counter = JobCounter{};
+
+		// the calling thread takes the first range itself
+		for (auto begin = batch_size; begin < count; begin += batch_size)
+		{
+			const auto end = std::min(begin + batch_size, count);
+			Dispatch([&range_function, begin, end] { range_function(begin, end); }, &counter);
+		}
+
+		try
+		{
+			range_function(0, std::min(batch_size, count));
+		}
+		catch (...)
+		{
+			// the queued ranges reference counter and range_function, both die with this frame
+			try
+			{
+				Wait(counter);
+			}
+			catch (...)
+			{
+				// the caller's exception wins over the ones of the other ranges
+			}
+			throw;
+		}
+
+		Wait(counter);
+	}
+
+	auto JobSystem::TryRunOne() -> bool
+	{
+		auto queued_job = QueuedJob{};
+		{
+			const auto lock = std::scoped_lock{ m_queue_mutex };
+			if (m_queue.empty())
+			{
+				return false;
+			}
+
+			queued_job = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		RunJob(queued_job);
+		return true;
+	}
+
+	auto JobSystem::WorkerLoop() -> void
+	{
+		while (true)
+		{
+			auto queued_job = QueuedJob{};
+			{
+				auto lock = std::unique_lock{ m_queue_mutex };
+				m_queue_condition.wait(lock, [this] { return m_stop || !m_queue.empty() || !m_background_queue.empty(); });
+
+				if (m_stop && m_queue.empty() && m_background_queue.empty())
+				{
+					return;
+				}
+
+				auto& queue = !m_queue.empty() ? m_queue : m_background_queue;
+				queued_job = std::move(queue.front());
+				queue.pop_front();
+			}
+
+			RunJob(queued_job);
+		}
+	}
+
+	auto JobSystem::RunJob(QueuedJob& queued_job) -> void
+	{
+		// the counter is decremented however the job ends, its waiter would spin forever otherwise
+		struct PendingGuard
+		{
+			JobCounter* m_counter = {};
+			~PendingGuard()
+			{
+				if (m_counter)
+				{
+					m_counter->m_pending.fetch_sub(1, std::memory_order_release);
+				}
+			}
+		};
+		const auto pending_guard = PendingGuard{ queued_job.m_counter };
+
+		try
+		{
+			queued_job.m_job();
+		}
+		catch (...)
+		{
+			if (!queued_job.m_counter)
+			{
+				CX_CORE_ERROR("A job without counter threw, nobody waits for it to rethrow");
+				return;
+			}
+
+			// the first one wins, stored before the decrement publishes it
+			const auto lock = std::scoped_lock{ queued_job.m_counter->m_exception_mutex };
+			if (!queued_job.m_counter->m_exception)
+			{
+				queued_job.m_counter->m_exception = std::current_exception();
+			}
+		}
+	}
+}
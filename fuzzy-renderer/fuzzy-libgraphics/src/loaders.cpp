@@ -0,0 +1,493 @@
+#include <loaders.h>
+
+#include <asset_file_system.h>
+#include <job_system.h>
+#include <logger.h>
+#include <render_profiler.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+namespace libgraphics::loaders
+{
+	namespace
+	{
+		// below this a chunk isn't worth a job
+		constexpr size_t ObjMinChunkBytes = 1024 * 1024;
+
+		constexpr auto AbsentIndex = std::numeric_limits<int32_t>::min();
+
+		enum ObjElement : size_t
+		{
+			position,
+			uv,
+			normal
+		};
+
+		/**
+		 * \brief A face corner, 0 based position/uv/normal indices (AbsentIndex when the face doesn't give one). Negative
+		 * indices of the file are relative to the chunk, their bit set in m_chunk_relative, until the chunk bases are known.
+		 */
+		struct ObjCorner
+		{
+			std::array<int32_t, 3> m_indices = { AbsentIndex, AbsentIndex, AbsentIndex };
+			uint32_t m_chunk_relative = {};
+		};
+
+		/**
+		 * \brief What a chunk of lines holds, faces fanned into triangles (3 corners each).
+		 */
+		struct ObjChunk
+		{
+			std::vector<glm::vec3> m_positions = {};
+			std::vector<glm::vec2> m_uvs = {};
+			std::vector<glm::vec3> m_normals = {};
+			std::vector<ObjCorner> m_corners = {};
+			size_t m_invalid_faces_count = {};
+		};
+
+		auto SkipSpaces(const char*& it, const char* end) -> void
+		{
+			while (it != end && (*it == ' ' || *it == '\t'))
+			{
+				++it;
+			}
+		}
+
+		/**
+		 * \brief Leaves out_value as it is when there's no number, missing coordinates read as 0
+		 */
+		auto ParseFloat(const char*& it, const char* end, float& out_value) -> void
+		{
+			SkipSpaces(it, end);
+
+			// from_chars takes no leading '+'
+			if (it != end && *it == '+')
+			{
+				++it;
+			}
+
+			if (const auto [next, error] = std::from_chars(it, end, out_value); error == std::errc{})
+			{
+				it = next;
+			}
+		}
+
+		/**
+		 * \brief One of v, v/vt, v//vn or v/vt/vn
+		 */
+		auto ParseCorner(const char*& it, const char* end, const ObjChunk& chunk, ObjCorner& out_corner) -> bool
+		{
+			const auto counts = std::array{ chunk.m_positions.size(), chunk.m_uvs.size(), chunk.m_normals.size() };
+
+			for (auto element = size_t{ position }; element <= normal; ++element)
+			{
+				if (element != position)
+				{
+					if (it == end || *it != '/')
+					{
+						break;
+					}
+					++it;
+
+					// empty uv of v//vn
+					if (it != end && *it == '/')
+					{
+						continue;
+					}
+				}
+
+				auto value = int32_t{};
+				const auto [next, error] = std::from_chars(it, end, value);
+				if (error != std::errc{} || value == 0)
+				{
+					if (element == position)
+					{
+						return false;
+					}
+					continue;
+				}
+				it = next;
+
+				if (value > 0)
+				{
+					out_corner.m_indices[element] = value - 1;
+				}
+				else
+				{
+					out_corner.m_indices[element] = static_cast<int32_t>(counts[element]) + value;
+					out_corner.m_chunk_relative |= 1u << element;
+				}
+			}
+
+			return true;
+		}
+
+		auto ParseLine(const char* it, const char* end, ObjChunk& chunk, std::vector<ObjCorner>& face_corners) -> void
+		{
+			SkipSpaces(it, end);
+			if (end - it < 2)
+			{
+				return;
+			}
+
+			const auto keyword = std::string_view{ it, static_cast<size_t>(std::min<ptrdiff_t>(end - it, 3)) };
+			const auto is_keyword = [&](const std::string_view name) {
+				return keyword.starts_with(name) && keyword.size() > name.size() && (keyword[name.size()] == ' ' || keyword[name.size()] == '\t');
+			};
+
+			if (is_keyword("v"))
+			{
+				it += 1;
+				auto& vertex_position = chunk.m_positions.emplace_back();
+				ParseFloat(it, end, vertex_position.x);
+				ParseFloat(it, end, vertex_position.y);
+				ParseFloat(it, end, vertex_position.z);
+			}
+			else if (is_keyword("vt"))
+			{
+				it += 2;
+				auto& vertex_uv = chunk.m_uvs.emplace_back();
+				ParseFloat(it, end, vertex_uv.x);
+				ParseFloat(it, end, vertex_uv.y);
+			}
+			else if (is_keyword("vn"))
+			{
+				it += 2;
+				auto& vertex_normal = chunk.m_normals.emplace_back();
+				ParseFloat(it, end, vertex_normal.x);
+				ParseFloat(it, end, vertex_normal.y);
+				ParseFloat(it, end, vertex_normal.z);
+			}
+			else if (is_keyword("f"))
+			{
+				it += 1;
+				face_corners.clear();
+
+				while (true)
+				{
+					SkipSpaces(it, end);
+					if (it == end || *it == '\r' || *it == '#')
+					{
+						break;
+					}
+
+					auto corner = ObjCorner{};
+					if (!ParseCorner(it, end, chunk, corner))
+					{
+						face_corners.clear();
+						break;
+					}
+					face_corners.push_back(corner);
+				}
+
+				if (face_corners.size() < 3)
+				{
+					++chunk.m_invalid_faces_count;
+					return;
+				}
+
+				// polygons are fanned around their first corner
+				for (auto corner_idx = size_t{ 2 }; corner_idx != face_corners.size(); ++corner_idx)
+				{
+					chunk.m_corners.push_back(face_corners.front());
+					chunk.m_corners.push_back(face_corners[corner_idx - 1]);
+					chunk.m_corners.push_back(face_corners[corner_idx]);
+				}
+			}
+		}
+
+		auto ParseChunk(const std::string_view text, ObjChunk& chunk) -> void
+		{
+			auto face_corners = std::vector<ObjCorner>{};
+
+			auto it = text.data();
+			const auto end = text.data() + text.size();
+			while (it < end)
+			{
+				auto line_end = static_cast<const char*>(std::memchr(it, '\n', static_cast<size_t>(end - it)));
+				if (!line_end)
+				{
+					line_end = end;
+				}
+
+				ParseLine(it, line_end, chunk, face_corners);
+				it = line_end + 1;
+			}
+		}
+
+		/**
+		 * \brief Open addressing table from a position/uv/normal tuple to its vertex, grown at half load.
+		 */
+		class VertexTable
+		{
+		public:
+			explicit VertexTable(const size_t expected_count)
+			{
+				Rehash(std::bit_ceil(std::max<size_t>(expected_count * 2, 64)));
+			}
+
+			/**
+			 * \return the vertex of the tuple, vertices_count when it is new (it is inserted with that index)
+			 */
+			auto FindOrInsert(const std::array<int32_t, 3>& key, const uint32_t vertices_count) -> uint32_t
+			{
+				if ((m_count + 1) * 2 > m_slots.size())
+				{
+					Rehash(m_slots.size() * 2);
+				}
+
+				const auto mask = m_slots.size() - 1;
+				for (auto slot_idx = Hash(key) & mask;; slot_idx = (slot_idx + 1) & mask)
+				{
+					auto& slot = m_slots[slot_idx];
+					if (slot.m_vertex_idx == EmptySlot)
+					{
+						slot = { key, vertices_count };
+						++m_count;
+						return vertices_count;
+					}
+					if (slot.m_key == key)
+					{
+						return slot.m_vertex_idx;
+					}
+				}
+			}
+
+		private:
+			static constexpr auto EmptySlot = std::numeric_limits<uint32_t>::max();
+
+			struct Slot
+			{
+				std::array<int32_t, 3> m_key = {};
+				uint32_t m_vertex_idx = EmptySlot;
+			};
+
+			static auto Hash(const std::array<int32_t, 3>& key) -> size_t
+			{
+				auto hash = (static_cast<uint64_t>(static_cast<uint32_t>(key[position])) << 32 | static_cast<uint32_t>(key[uv])) * 0x9E3779B97F4A7C15ull;
+				hash ^= static_cast<uint32_t>(key[normal]) * 0xC2B2AE3D27D4EB4Full;
+				return static_cast<size_t>(hash ^ (hash >> 29));
+			}
+
+			auto Rehash(const size_t slots_count) -> void
+			{
+				auto slots = std::vector<Slot>(slots_count);
+				std::swap(slots, m_slots);
+
+				const auto mask = m_slots.size() - 1;
+				for (const auto& slot : slots)
+				{
+					if (slot.m_vertex_idx == EmptySlot)
+					{
+						continue;
+					}
+
+					auto slot_idx = Hash(slot.m_key) & mask;
+					while (m_slots[slot_idx].m_vertex_idx != EmptySlot)
+					{
+						slot_idx = (slot_idx + 1) & mask;
+					}
+					m_slots[slot_idx] = slot;
+				}
+			}
+
+			std::vector<Slot> m_slots = {};
+			size_t m_count = {};
+		};
+	}
+
+	auto load_obj(const std::filesystem::path& path) -> std::optional<ObjMesh>
+	{
+		CX_PROFILE_FUNCTION();
+
+		const auto file = AssetFileSystem::GetInstance().Read(path);
+		if (!file)
+		{
+			CX_CORE_ERROR("Unable to read obj file {}", path.string());
+			return std::nullopt;
+		}
+
+		const auto text = file->GetText();
+		auto& job_system = JobSystem::GetInstance();
+
+		// chunks end after a line feed, so every line is parsed by one chunk only
+		const auto chunks_count = std::clamp(text.size() / ObjMinChunkBytes, size_t{ 1 }, job_system.GetWorkersCount() + 1);
+		auto chunk_texts = std::vector<std::string_view>{};
+		for (auto begin = size_t{ 0 }; begin < text.size();)
+		{
+			auto end = chunk_texts.size() + 1 == chunks_count ? text.size() : std::max(begin + 1, text.size() * (chunk_texts.size() + 1) / chunks_count);
+			end = std::min(text.find('\n', end - 1), text.size() - 1) + 1;
+			chunk_texts.push_back(text.substr(begin, end - begin));
+			begin = end;
+		}
+
+		auto chunks = std::vector<ObjChunk>(chunk_texts.size());
+		{
+			CX_PROFILE_ZONE("ParseObjChunks");
+			job_system.ParallelFor(chunks.size(), 1, [&](const size_t begin, const size_t end) {
+				for (auto chunk_idx = begin; chunk_idx != end; ++chunk_idx)
+				{
+					ParseChunk(chunk_texts[chunk_idx], chunks[chunk_idx]);
+				}
+			});
+		}
+
+		// elements of the chunks before each one, what its relative indices are based on
+		auto chunk_bases = std::vector<std::array<int64_t, 3>>(chunks.size());
+		auto totals = std::array<int64_t, 3>{};
+		auto corners_count = size_t{ 0 };
+		auto invalid_faces_count = size_t{ 0 };
+		for (auto chunk_idx = size_t{ 0 }; chunk_idx != chunks.size(); ++chunk_idx)
+		{
+			const auto& chunk = chunks[chunk_idx];
+			chunk_bases[chunk_idx] = totals;
+			totals[position] += static_cast<int64_t>(chunk.m_positions.size());
+			totals[uv] += static_cast<int64_t>(chunk.m_uvs.size());
+			totals[normal] += static_cast<int64_t>(chunk.m_normals.size());
+			corners_count += chunk.m_corners.size();
+			invalid_faces_count += chunk.m_invalid_faces_count;
+		}
+
+		auto positions = std::vector<glm::vec3>{};
+		auto uvs = std::vector<glm::vec2>{};
+		auto normals = std::vector<glm::vec3>{};
+		positions.reserve(static_cast<size_t>(totals[position]));
+		uvs.reserve(static_cast<size_t>(totals[uv]));
+		normals.reserve(static_cast<size_t>(totals[normal]));
+		for (auto& chunk : chunks)
+		{
+			positions.insert(positions.end(), chunk.m_positions.begin(), chunk.m_positions.end());
+			uvs.insert(uvs.end(), chunk.m_uvs.begin(), chunk.m_uvs.end());
+			normals.insert(normals.end(), chunk.m_normals.begin(), chunk.m_normals.end());
+			chunk.m_positions = {};
+			chunk.m_uvs = {};
+			chunk.m_normals = {};
+		}
+
+		// one vertex per distinct tuple, in the order the faces first use them
+		auto mesh = ObjMesh{};
+		mesh.m_indices.reserve(corners_count);
+
+		auto missing_normals = std::vector<bool>{};
+		auto has_missing_normals = false;
+		auto invalid_triangles_count = size_t{ 0 };
+		{
+			CX_PROFILE_ZONE("IndexObjVertices");
+
+			auto vertex_table = VertexTable{ positions.size() };
+			auto triangle = std::array<uint32_t, 3>{};
+
+			for (auto chunk_idx = size_t{ 0 }; chunk_idx != chunks.size(); ++chunk_idx)
+			{
+				const auto& corners = chunks[chunk_idx].m_corners;
+				const auto& bases = chunk_bases[chunk_idx];
+
+				for (auto corner_idx = size_t{ 0 }; corner_idx + 3 <= corners.size(); corner_idx += 3)
+				{
+					auto is_valid = true;
+
+					for (auto triangle_corner = size_t{ 0 }; triangle_corner != 3 && is_valid; ++triangle_corner)
+					{
+						const auto& corner = corners[corner_idx + triangle_corner];
+
+						auto key = corner.m_indices;
+						for (auto element = size_t{ position }; element <= normal; ++element)
+						{
+							if (key[element] == AbsentIndex)
+							{
+								is_valid &= element != position;
+								continue;
+							}
+
+							const auto index = key[element] + ((corner.m_chunk_relative >> element & 1u) ? bases[element] : 0);
+							is_valid &= index >= 0 && index < totals[element];
+							key[element] = static_cast<int32_t>(index);
+						}
+
+						if (!is_valid)
+						{
+							break;
+						}
+
+						const auto vertices_count = static_cast<uint32_t>(mesh.m_vertices.size());
+						triangle[triangle_corner] = vertex_table.FindOrInsert(key, vertices_count);
+						if (triangle[triangle_corner] != vertices_count)
+						{
+							continue;
+						}
+
+						auto& vertex = mesh.m_vertices.emplace_back();
+						vertex.m_position = positions[static_cast<size_t>(key[position])];
+						if (key[uv] != AbsentIndex)
+						{
+							// flipped like aiProcess_FlipUVs does for the assimp import
+							const auto& vertex_uv = uvs[static_cast<size_t>(key[uv])];
+							vertex.m_tex_coords = { vertex_uv.x, 1.0f - vertex_uv.y };
+						}
+
+						const auto has_normal = key[normal] != AbsentIndex;
+						if (has_normal)
+						{
+							vertex.m_normal = normals[static_cast<size_t>(key[normal])];
+						}
+						missing_normals.push_back(!has_normal);
+						has_missing_normals |= !has_normal;
+					}
+
+					// the vertices of the corners before the invalid one stay, unreferenced
+					if (!is_valid)
+					{
+						++invalid_triangles_count;
+						continue;
+					}
+
+					mesh.m_indices.insert(mesh.m_indices.end(), triangle.begin(), triangle.end());
+				}
+			}
+		}
+
+		// area weighted average of the faces around them
+		if (has_missing_normals)
+		{
+			CX_PROFILE_ZONE("ComputeObjNormals");
+
+			for (auto index_idx = size_t{ 0 }; index_idx + 3 <= mesh.m_indices.size(); index_idx += 3)
+			{
+				auto& vertex_0 = mesh.m_vertices[mesh.m_indices[index_idx]];
+				auto& vertex_1 = mesh.m_vertices[mesh.m_indices[index_idx + 1]];
+				auto& vertex_2 = mesh.m_vertices[mesh.m_indices[index_idx + 2]];
+				const auto face_normal = glm::cross(vertex_1.m_position - vertex_0.m_position, vertex_2.m_position - vertex_0.m_position);
+
+				for (const auto vertex_idx : { mesh.m_indices[index_idx], mesh.m_indices[index_idx + 1], mesh.m_indices[index_idx + 2] })
+				{
+					if (missing_normals[vertex_idx])
+					{
+						mesh.m_vertices[vertex_idx].m_normal += face_normal;
+					}
+				}
+			}
+
+			for (auto vertex_idx = size_t{ 0 }; vertex_idx != mesh.m_vertices.size(); ++vertex_idx)
+			{
+				auto& vertex_normal = mesh.m_vertices[vertex_idx].m_normal;
+				if (missing_normals[vertex_idx] && glm::dot(vertex_normal, vertex_normal) > 0.0f)
+				{
+					vertex_normal = glm::normalize(vertex_normal);
+				}
+			}
+		}
+
+		if (invalid_faces_count != 0 || invalid_triangles_count != 0)
+		{
+			CX_CORE_WARN("{}: skipped {} malformed faces and {} triangles with out of range indices", path.string(), invalid_faces_count, invalid_triangles_count);
+		}
+
+		return mesh;
+	}
+}
@@ -0,0 +1,139 @@
+#include <mapped_file.h>
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace libgraphics
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+			m_file = std::exchange(other.m_file, nullptr);
+			m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+#ifdef _WIN32
+
+	auto MappedFile::Open(const std::filesystem::path& path) -> std::optional<MappedFile>
+	{
+		auto mapped_file = MappedFile{};
+
+		mapped_file.m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (mapped_file.m_file == INVALID_HANDLE_VALUE)
+		{
+			mapped_file.m_file = nullptr;
+			return std::nullopt;
+		}
+
+		auto file_size = LARGE_INTEGER{};
+		if (!GetFileSizeEx(mapped_file.m_file, &file_size) || file_size.QuadPart == 0)
+		{
+			return std::nullopt;
+		}
+
+		mapped_file.m_mapping = CreateFileMappingW(mapped_file.m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapped_file.m_mapping)
+		{
+			return std::nullopt;
+		}
+
+		mapped_file.m_data = static_cast<const uint8_t*>(MapViewOfFile(mapped_file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!mapped_file.m_data)
+		{
+			return std::nullopt;
+		}
+
+		mapped_file.m_size = static_cast<size_t>(file_size.QuadPart);
+		return mapped_file;
+	}
+
+	auto MappedFile::Close() -> void
+	{
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping)
+		{
+			CloseHandle(m_mapping);
+		}
+		if (m_file)
+		{
+			CloseHandle(m_file);
+		}
+
+		m_data = {};
+		m_size = {};
+		m_mapping = {};
+		m_file = {};
+	}
+
+#else
+
+	auto MappedFile::Open(const std::filesystem::path& path) -> std::optional<MappedFile>
+	{
+		const auto file_descriptor = open(path.c_str(), O_RDONLY);
+		if (file_descriptor < 0)
+		{
+			return std::nullopt;
+		}
+
+		// the mapping keeps the file referenced, the descriptor isn't needed past mmap
+		struct stat file_status = {};
+		const auto data = fstat(file_descriptor, &file_status) == 0 && file_status.st_size > 0
+			? mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0)
+			: MAP_FAILED;
+		close(file_descriptor);
+
+		if (data == MAP_FAILED)
+		{
+			return std::nullopt;
+		}
+
+		auto mapped_file = MappedFile{};
+		mapped_file.m_data = static_cast<const uint8_t*>(data);
+		mapped_file.m_size = static_cast<size_t>(file_status.st_size);
+		return mapped_file;
+	}
+
+	auto MappedFile::Close() -> void
+	{
+		if (m_data)
+		{
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+		}
+
+		m_data = {};
+		m_size = {};
+	}
+
+#endif
+}
@@ -0,0 +1,272 @@
+#include <memory_tracker.h>
+
+#include <logger.h>
+
+#include <algorithm>
+#include <map>
+#include <ranges>
+
+namespace libgraphics
+{
+	namespace
+	{
+		// owner of the allocations registered by this thread, set by MemoryOwnerScope
+		thread_local auto current_owner = std::string{};
+	}
+
+	auto MemoryCategoryToString(const MemoryCategory category) -> std::string_view
+	{
+		switch (category)
+		{
+		case MemoryCategory::vertex_buffer: return "Vertex buffers";
+		case MemoryCategory::index_buffer: return "Index buffers";
+		case MemoryCategory::uniform_buffer: return "Uniform buffers";
+		case MemoryCategory::storage_buffer: return "Storage buffers";
+		case MemoryCategory::readback_buffer: return "Readback buffers";
+		case MemoryCategory::upload_buffer: return "Upload buffers";
+		case MemoryCategory::texture: return "Textures";
+		case MemoryCategory::render_target: return "Render targets";
+		case MemoryCategory::mesh_cpu_copy: return "Mesh CPU copies";
+		case MemoryCategory::max_enum: return "Invalid";
+		default: break;
+		}
+		return {};
+	}
+
+	auto ComputeTextureBytes(const int width, const int height, const size_t bytes_per_texel, const bool has_mips) -> uint64_t
+	{
+		auto bytes = uint64_t{ 0 };
+		auto mip_width = std::max(width, 1);
+		auto mip_height = std::max(height, 1);
+
+		while (true)
+		{
+			bytes += static_cast<uint64_t>(mip_width) * static_cast<uint64_t>(mip_height) * bytes_per_texel;
+			if (!has_mips || (mip_width == 1 && mip_height == 1))
+			{
+				return bytes;
+			}
+
+			mip_width = std::max(mip_width / 2, 1);
+			mip_height = std::max(mip_height / 2, 1);
+		}
+	}
+
+	auto MemoryTracker::GetInstance() -> MemoryTracker&
+	{
+		// never destroyed: meshes and textures held by other statics are released after it would be
+		static auto* instance = new MemoryTracker{};
+		return *instance;
+	}
+
+	auto MemoryTracker::GetCategoryTotals() const -> std::array<MemoryCategoryTotals, static_cast<size_t>(MemoryCategory::max_enum)>
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+		return m_totals;
+	}
+
+	auto MemoryTracker::GetCpuBytes() const -> uint64_t
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		auto bytes = uint64_t{ 0 };
+		for (auto category_idx = size_t{ 0 }; category_idx != m_totals.size(); ++category_idx)
+		{
+			bytes += IsGpuMemory(static_cast<MemoryCategory>(category_idx)) ? 0 : m_totals[category_idx].m_bytes;
+		}
+
+		return bytes;
+	}
+
+	auto MemoryTracker::GetGpuBytes() const -> uint64_t
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		auto bytes = uint64_t{ 0 };
+		for (auto category_idx = size_t{ 0 }; category_idx != m_totals.size(); ++category_idx)
+		{
+			bytes += IsGpuMemory(static_cast<MemoryCategory>(category_idx)) ? m_totals[category_idx].m_bytes : 0;
+		}
+
+		return bytes;
+	}
+
+	auto MemoryTracker::GetTopConsumers(const size_t count) const -> std::vector<MemoryConsumer>
+	{
+		auto consumers_by_owner = std::unordered_map<std::string_view, MemoryConsumer>{};
+		auto consumers = std::vector<MemoryConsumer>{};
+
+		{
+			const auto lock = std::scoped_lock{ m_mutex };
+			for (const auto& allocation : std::views::values(m_allocations))
+			{
+				auto& consumer = consumers_by_owner[allocation.m_owner];
+				(IsGpuMemory(allocation.m_category) ? consumer.m_gpu_bytes : consumer.m_cpu_bytes) += allocation.m_bytes;
+				consumer.m_allocations_count++;
+			}
+
+			consumers.reserve(consumers_by_owner.size());
+			for (auto& [owner, consumer] : consumers_by_owner)
+			{
+				consumer.m_owner = owner;
+				consumers.push_back(std::move(consumer));
+			}
+		}
+
+		const auto top_count = std::min(count, consumers.size());
+		std::ranges::partial_sort(consumers, consumers.begin() + static_cast<std::ptrdiff_t>(top_count), std::ranges::greater{},
+			[](const MemoryConsumer& consumer) { return consumer.m_cpu_bytes + consumer.m_gpu_bytes; });
+		consumers.resize(top_count);
+
+		return consumers;
+	}
+
+	auto MemoryTracker::GetCheckpoint() const -> uint64_t
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+		return m_next_id;
+	}
+
+	auto MemoryTracker::GetAllocations(const uint64_t checkpoint) const -> std::vector<MemoryAllocationInfo>
+	{
+		auto allocations = std::vector<MemoryAllocationInfo>{};
+
+		{
+			const auto lock = std::scoped_lock{ m_mutex };
+			for (const auto& allocation : std::views::values(m_allocations))
+			{
+				if (allocation.m_id >= checkpoint)
+				{
+					allocations.push_back(allocation);
+				}
+			}
+		}
+
+		std::ranges::sort(allocations, {}, &MemoryAllocationInfo::m_id);
+		return allocations;
+	}
+
+	auto MemoryTracker::LogAllocations(const uint64_t checkpoint) const -> size_t
+	{
+		const auto allocations = GetAllocations(checkpoint);
+
+		// sorted map, the log reads the same from run to run
+		auto allocations_by_owner = std::map<std::string_view, std::vector<const MemoryAllocationInfo*>>{};
+		for (const auto& allocation : allocations)
+		{
+			allocations_by_owner[allocation.m_owner].push_back(&allocation);
+		}
+
+		for (const auto& [owner, owner_allocations] : allocations_by_owner)
+		{
+			CX_CORE_WARN("Memory: {} live allocation(s) of {}", owner_allocations.size(), owner);
+			for (const auto* allocation : owner_allocations)
+			{
+				CX_CORE_WARN("    #{} {} {} bytes {}", allocation->m_id, MemoryCategoryToString(allocation->m_category), allocation->m_bytes, allocation->m_detail);
+			}
+		}
+
+		return allocations.size();
+	}
+
+	auto MemoryTracker::Register(const MemoryCategory category, const uint64_t bytes, std::string detail) -> uint64_t
+	{
+		auto owner = current_owner.empty() ? detail : current_owner;
+
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		const auto id = m_next_id++;
+		m_allocations.emplace(id, MemoryAllocationInfo{ id, category, bytes, std::move(owner), std::move(detail) });
+
+		auto& totals = m_totals[static_cast<size_t>(category)];
+		totals.m_bytes += bytes;
+		totals.m_peak_bytes = std::max(totals.m_peak_bytes, totals.m_bytes);
+		totals.m_allocations_count++;
+
+		return id;
+	}
+
+	auto MemoryTracker::Resize(const uint64_t id, const uint64_t bytes) -> void
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		if (const auto it = m_allocations.find(id); it != m_allocations.end())
+		{
+			auto& totals = m_totals[static_cast<size_t>(it->second.m_category)];
+			totals.m_bytes = totals.m_bytes - it->second.m_bytes + bytes;
+			totals.m_peak_bytes = std::max(totals.m_peak_bytes, totals.m_bytes);
+			it->second.m_bytes = bytes;
+		}
+	}
+
+	auto MemoryTracker::Release(const uint64_t id) -> void
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		if (const auto it = m_allocations.find(id); it != m_allocations.end())
+		{
+			auto& totals = m_totals[static_cast<size_t>(it->second.m_category)];
+			totals.m_bytes -= it->second.m_bytes;
+			totals.m_allocations_count--;
+			m_allocations.erase(it);
+		}
+	}
+
+	auto MemoryTracker::GetBytes(const uint64_t id) const -> uint64_t
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		const auto it = m_allocations.find(id);
+		return it != m_allocations.end() ? it->second.m_bytes : 0;
+	}
+
+	MemoryOwnerScope::MemoryOwnerScope(std::string owner) : m_previous_owner{ std::exchange(current_owner, std::move(owner)) }
+	{
+	}
+
+	MemoryOwnerScope::~MemoryOwnerScope()
+	{
+		current_owner = std::move(m_previous_owner);
+	}
+
+	TrackedMemory::TrackedMemory(const MemoryCategory category, const uint64_t bytes, std::string detail)
+		: m_id{ MemoryTracker::GetInstance().Register(category, bytes, std::move(detail)) }
+	{
+	}
+
+	TrackedMemory::~TrackedMemory()
+	{
+		Reset();
+	}
+
+	auto TrackedMemory::operator=(TrackedMemory&& other) noexcept -> TrackedMemory&
+	{
+		if (this != &other)
+		{
+			Reset();
+			m_id = std::exchange(other.m_id, 0);
+		}
+		return *this;
+	}
+
+	auto TrackedMemory::Resize(const uint64_t bytes) -> void
+	{
+		if (m_id != 0)
+		{
+			MemoryTracker::GetInstance().Resize(m_id, bytes);
+		}
+	}
+
+	auto TrackedMemory::Reset() -> void
+	{
+		if (m_id != 0)
+		{
+			MemoryTracker::GetInstance().Release(std::exchange(m_id, 0));
+		}
+	}
+
+	auto TrackedMemory::GetBytes() const -> uint64_t
+	{
+		return m_id != 0 ? MemoryTracker::GetInstance().GetBytes(m_id) : 0;
+	}
+}
@@ -0,0 +1,65 @@
+#include <opengl/gl_command_executor.h>
+
+#include <opengl/gl_mesh.h>
+#include <opengl/gl_shader.h>
+#include <opengl/gl_state_cache.h>
+#include <rendering/render_stats.h>
+
+namespace libgraphics
+{
+	auto ToGLTextureTarget(const TextureTarget target) -> GLenum
+	{
+		switch (target)
+		{
+		case TextureTarget::texture_2d: return GL_TEXTURE_2D;
+		case TextureTarget::texture_cube: return GL_TEXTURE_CUBE_MAP;
+		}
+		return GL_TEXTURE_2D;
+	}
+
+	auto GLCommandExecutor::Execute(const CommandList& command_list) -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+
+		for (const auto& command : command_list.GetCommands())
+		{
+			switch (command.m_type)
+			{
+			case RenderCommandType::bind_pipeline:
+			{
+				state_cache.UseProgram(static_cast<const GLShader*>(command.m_bind_pipeline.m_shader)->GetID());
+			}
+			break;
+			case RenderCommandType::set_constant:
+			{
+				const auto& set_constant = command.m_set_constant;
+				const auto data = command_list.GetConstantData(set_constant.m_offset);
+				RenderStats::GetInstance().CountUniformUpload();
+
+				switch (set_constant.m_constant_type)
+				{
+				case ConstantType::mat4: glUniformMatrix4fv(set_constant.m_slot, 1, GL_FALSE, reinterpret_cast<const GLfloat*>(data)); break;
+				case ConstantType::vec3: glUniform3fv(set_constant.m_slot, 1, reinterpret_cast<const GLfloat*>(data)); break;
+				case ConstantType::float1: glUniform1fv(set_constant.m_slot, 1, reinterpret_cast<const GLfloat*>(data)); break;
+				case ConstantType::int1:
+				case ConstantType::bool1: glUniform1iv(set_constant.m_slot, 1, reinterpret_cast<const GLint*>(data)); break;
+				case ConstantType::uint1: glUniform1uiv(set_constant.m_slot, 1, reinterpret_cast<const GLuint*>(data)); break;
+				}
+			}
+			break;
+			case RenderCommandType::bind_texture:
+			{
+				const auto& bind_texture = command.m_bind_texture;
+				state_cache.BindTexture(bind_texture.m_unit, ToGLTextureTarget(bind_texture.m_target), bind_texture.m_texture_id);
+			}
+			break;
+			case RenderCommandType::draw_indexed:
+			{
+				const auto& draw_indexed = command.m_draw_indexed;
+				static_cast<const GLMesh*>(draw_indexed.m_mesh)->Submit(draw_indexed.m_instance_count);
+			}
+			break;
+			}
+		}
+	}
+}
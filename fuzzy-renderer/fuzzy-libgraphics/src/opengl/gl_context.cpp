@@ -1,4 +1,5 @@
 #include <opengl/gl_context.h>
+#include <opengl/gl_state_cache.h>
 #include <logger.h>
 
 #include <imgui.h>
@@ -15,7 +16,7 @@ namespace libgraphics
 		auto& window_ptr = *static_cast<GLContext*>(glfwGetWindowUserPointer(window));
 		window_ptr.Data().m_width = width;
 		window_ptr.Data().m_height = height;
-		glViewport(0, 0, width, height);
+		GLStateCache::GetInstance().Viewport(0, 0, width, height);
 	}
 
 	auto GLContext::Init(const int width, const int height, const std::string_view title) -> void
@@ -57,22 +58,29 @@ namespace libgraphics
 			return;
 		}
 
-		glViewport(0, 0, width, height);
-
-		// Enable depth testing and pixel discard function
-		glEnable(GL_DEPTH_TEST);
-		glDepthFunc(GL_LESS);
-
-		// Enable face culling so that we save at least 50% of performances while rendering
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_FRONT);
-		glFrontFace(GL_CW);
+		SetupDefaultState(width, height);
 
 		m_context_data = { width, height };
 
 		CX_CORE_INFO("OpenGL Context initialized!");
 	}
 
+	auto GLContext::SetupDefaultState(const int width, const int height) -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.Invalidate();
+		state_cache.Viewport(0, 0, width, height);
+
+		// Enable depth testing and pixel discard function
+		state_cache.SetCapability(GL_DEPTH_TEST, true);
+		state_cache.DepthFunc(GL_LESS);
+
+		// Enable face culling so that we save at least 50% of performances while rendering
+		state_cache.SetCapability(GL_CULL_FACE, true);
+		state_cache.CullFace(GL_FRONT);
+		state_cache.FrontFace(GL_CW);
+	}
+
 	auto GLContext::Shutdown() -> void
 	{
 		CX_CORE_TRACE("Shutting down GL Context");
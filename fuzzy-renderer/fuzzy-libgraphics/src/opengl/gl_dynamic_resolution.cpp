@@ -0,0 +1,148 @@
+#include <opengl/gl_dynamic_resolution.h>
+#include <opengl/gl_shader.h>
+#include <opengl/gl_state_cache.h>
+#include <rendering/render_stats.h>
+#include <logger.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace libgraphics
+{
+	GLDynamicResolution::GLDynamicResolution(const float target_frame_ms)
+		: m_controller{ target_frame_ms }
+	{
+		m_upscale_shader = std::make_shared<GLShader>("../fuzzy-libgraphics/shaders/glsl/upscale_vert.glsl", "../fuzzy-libgraphics/shaders/glsl/upscale_frag.glsl");
+
+		// core profile wants a vao bound even when the vertex shader makes up its vertices
+		glGenVertexArrays(1, &m_empty_vao);
+		glGenQueries(QueriesCount, m_queries.data());
+	}
+
+	GLDynamicResolution::~GLDynamicResolution()
+	{
+		ReleaseTargets();
+		glDeleteQueries(QueriesCount, m_queries.data());
+		GLStateCache::GetInstance().DeleteVertexArray(m_empty_vao);
+	}
+
+	auto GLDynamicResolution::BeginFrame() -> void
+	{
+		// results arrive in order, stop at the first one the GPU hasn't finished yet
+		while (m_is_query_pending[m_oldest_query])
+		{
+			auto is_available = GLint{};
+			glGetQueryObjectiv(m_queries[m_oldest_query], GL_QUERY_RESULT_AVAILABLE, &is_available);
+			if (!is_available)
+			{
+				break;
+			}
+
+			auto elapsed_ns = GLuint64{};
+			glGetQueryObjectui64v(m_queries[m_oldest_query], GL_QUERY_RESULT, &elapsed_ns);
+
+			m_last_gpu_frame_ms = static_cast<float>(static_cast<double>(elapsed_ns) * 1e-6);
+			m_controller.Update(m_last_gpu_frame_ms);
+
+			m_is_query_pending[m_oldest_query] = false;
+			m_oldest_query = (m_oldest_query + 1) % QueriesCount;
+		}
+
+		// every query still in flight, this frame goes untimed rather than waiting on the GPU
+		m_is_timing = !m_is_query_pending[m_next_query];
+		if (m_is_timing)
+		{
+			glBeginQuery(GL_TIME_ELAPSED, m_queries[m_next_query]);
+		}
+	}
+
+	auto GLDynamicResolution::EndFrame() -> void
+	{
+		if (!m_is_timing)
+		{
+			return;
+		}
+
+		glEndQuery(GL_TIME_ELAPSED);
+		m_is_query_pending[m_next_query] = true;
+		m_next_query = (m_next_query + 1) % QueriesCount;
+		m_is_timing = false;
+	}
+
+	auto GLDynamicResolution::PrepareTargets(const int output_width, const int output_height) -> bool
+	{
+		const auto is_resized = output_width != m_output_width || output_height != m_output_height;
+		if (is_resized)
+		{
+			ReleaseTargets();
+
+			m_output_width = output_width;
+			m_output_height = output_height;
+
+			auto& state_cache = GLStateCache::GetInstance();
+
+			glGenTextures(1, &m_color_texture);
+			state_cache.BindTexture(0, GL_TEXTURE_2D, m_color_texture);
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, output_width, output_height);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+			glGenTextures(1, &m_depth_texture);
+			state_cache.BindTexture(0, GL_TEXTURE_2D, m_depth_texture);
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH24_STENCIL8, output_width, output_height);
+
+			// RGBA8 color and D24S8 depth
+			m_targets_memory = TrackedMemory{ MemoryCategory::render_target, ComputeTextureBytes(output_width, output_height, 8, false), "dynamic resolution targets" };
+
+			CX_CORE_INFO("Dynamic resolution targets allocated ({}x{})", output_width, output_height);
+		}
+
+		const auto scale = m_controller.GetScale();
+		m_render_width = std::clamp(static_cast<int>(std::lround(output_width * scale)), 1, output_width);
+		m_render_height = std::clamp(static_cast<int>(std::lround(output_height * scale)), 1, output_height);
+
+		return is_resized;
+	}
+
+	auto GLDynamicResolution::Upscale() const -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+
+		state_cache.SetCapability(GL_DEPTH_TEST, false);
+		state_cache.SetCapability(GL_CULL_FACE, false);
+
+		m_upscale_shader->Bind();
+		m_upscale_shader->SetInt("source", 0);
+		m_upscale_shader->SetFloat("sharpness", m_sharpness);
+		glUniform2f(m_upscale_shader->GetUniformLocation("uv_scale"), static_cast<float>(m_render_width) / m_output_width, static_cast<float>(m_render_height) / m_output_height);
+		glUniform2f(m_upscale_shader->GetUniformLocation("texel_size"), 1.0f / m_output_width, 1.0f / m_output_height);
+
+		// the two vec2 above bypass the shader setters
+		auto& render_stats = RenderStats::GetInstance();
+		render_stats.CountUniformUpload();
+		render_stats.CountUniformUpload();
+
+		state_cache.BindTexture(0, GL_TEXTURE_2D, m_color_texture);
+		state_cache.BindVertexArray(m_empty_vao);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		render_stats.CountDraw(3, 3, 1);
+
+		state_cache.SetCapability(GL_DEPTH_TEST, true);
+		state_cache.SetCapability(GL_CULL_FACE, true);
+	}
+
+	auto GLDynamicResolution::ReleaseTargets() -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.DeleteTexture(m_color_texture);
+		state_cache.DeleteTexture(m_depth_texture);
+		m_targets_memory.Reset();
+
+		m_color_texture = {};
+		m_depth_texture = {};
+		m_output_width = {};
+		m_output_height = {};
+	}
+}
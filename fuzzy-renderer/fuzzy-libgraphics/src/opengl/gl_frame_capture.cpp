@@ -0,0 +1,160 @@
+#include <opengl/gl_frame_capture.h>
+#include <opengl/gl_state_cache.h>
+#include <logger.h>
+
+#include <algorithm>
+
+namespace libgraphics
+{
+	GLFrameCapture::GLFrameCapture(CaptureCallback callback, const uint32_t ring_size)
+		: m_callback{ std::move(callback) }, m_ring_size{ std::max(ring_size, 2u) }
+	{
+	}
+
+	GLFrameCapture::~GLFrameCapture()
+	{
+		Flush();
+		Release();
+	}
+
+	auto GLFrameCapture::Capture(const GLuint framebuffer_id, const int width, const int height) -> void
+	{
+		if (width <= 0 || height <= 0)
+		{
+			return;
+		}
+
+		if (width != m_width || height != m_height)
+		{
+			Flush();
+			Release();
+			Allocate(width, height);
+		}
+
+		// the ring is full, the oldest frame must be delivered before its buffer can be reused
+		if (m_pending_count == m_slots.size())
+		{
+			m_stalls_count++;
+			DeliverOldest(true);
+		}
+
+		auto& slot = m_slots[m_next_slot];
+
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.BindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_id);
+		state_cache.BindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_buffer);
+
+		// with a pack buffer bound the pointer is an offset and the call returns as soon as the copy is queued
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		state_cache.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		slot.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		slot.m_frame_index = m_frame_index++;
+
+		m_next_slot = (m_next_slot + 1) % m_slots.size();
+		m_pending_count++;
+	}
+
+	auto GLFrameCapture::Poll() -> void
+	{
+		while (m_pending_count != 0 && DeliverOldest(false))
+		{
+		}
+	}
+
+	auto GLFrameCapture::Flush() -> void
+	{
+		while (m_pending_count != 0)
+		{
+			DeliverOldest(true);
+		}
+	}
+
+	auto GLFrameCapture::Allocate(const int width, const int height) -> void
+	{
+		m_width = width;
+		m_height = height;
+		m_slots.resize(m_ring_size);
+		m_next_slot = 0;
+		m_pending_count = 0;
+
+		const auto buffer_size = static_cast<GLsizeiptr>(width) * height * 4;
+		constexpr auto map_flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		auto& state_cache = GLStateCache::GetInstance();
+
+		// mapped once for their whole lifetime, so delivering a frame costs neither a map nor an unmap
+		for (auto& slot : m_slots)
+		{
+			glGenBuffers(1, &slot.m_buffer);
+			state_cache.BindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_buffer);
+			glBufferStorage(GL_PIXEL_PACK_BUFFER, buffer_size, nullptr, map_flags);
+			slot.m_mapped = static_cast<const uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, buffer_size, map_flags));
+			slot.m_memory = TrackedMemory{ MemoryCategory::readback_buffer, static_cast<uint64_t>(buffer_size), "frame capture ring" };
+		}
+
+		state_cache.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		CX_CORE_INFO("Frame capture ring allocated ({} x {}x{} RGBA8)", m_ring_size, width, height);
+	}
+
+	auto GLFrameCapture::Release() -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+
+		for (auto& slot : m_slots)
+		{
+			if (slot.m_fence)
+			{
+				glDeleteSync(slot.m_fence);
+			}
+
+			state_cache.BindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_buffer);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			state_cache.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			state_cache.DeleteBuffer(slot.m_buffer);
+		}
+
+		m_slots.clear();
+		m_pending_count = 0;
+		m_width = 0;
+		m_height = 0;
+	}
+
+	auto GLFrameCapture::DeliverOldest(const bool wait) -> bool
+	{
+		auto& slot = m_slots[(m_next_slot + m_slots.size() - m_pending_count) % m_slots.size()];
+
+		// when waiting, the flush bit makes sure the fence actually reaches the GPU
+		const auto timeout = wait ? GLuint64{ 1'000'000'000 } : GLuint64{ 0 };
+		const auto flags = wait ? GLbitfield{ GL_SYNC_FLUSH_COMMANDS_BIT } : GLbitfield{ 0 };
+
+		auto wait_result = glClientWaitSync(slot.m_fence, flags, timeout);
+		while (wait && wait_result == GL_TIMEOUT_EXPIRED)
+		{
+			wait_result = glClientWaitSync(slot.m_fence, flags, timeout);
+		}
+
+		if (wait_result == GL_TIMEOUT_EXPIRED)
+		{
+			return false;
+		}
+
+		if (wait_result == GL_WAIT_FAILED)
+		{
+			CX_CORE_ERROR("Frame capture fence wait failed, frame {} dropped", slot.m_frame_index);
+		}
+		else if (m_callback)
+		{
+			m_callback({ std::span{ slot.m_mapped, static_cast<size_t>(m_width) * m_height * 4 }, m_width, m_height, slot.m_frame_index });
+		}
+
+		glDeleteSync(slot.m_fence);
+		slot.m_fence = {};
+		m_pending_count--;
+
+		return true;
+	}
+}
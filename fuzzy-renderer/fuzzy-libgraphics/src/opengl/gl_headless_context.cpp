@@ -0,0 +1,63 @@
+#include <opengl/gl_headless_context.h>
+#include <opengl/gl_context.h>
+#include <logger.h>
+
+#include <glad/gl.h>
+
+#include <GLFW/glfw3.h>
+
+namespace libgraphics
+{
+	auto GLHeadlessContext::Init(const int width, const int height, const std::string_view title) -> void
+	{
+		if (!glfwInit())
+		{
+			CX_CORE_ERROR("Unable to initialize glfw3");
+			return;
+		}
+
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, MajorVersion);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, MinorVersion);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+		// the window only carries the context, its own framebuffer is never drawn to
+		m_glfw_native_window_handle = glfwCreateWindow(1, 1, title.data(), nullptr, nullptr);
+		if (!m_glfw_native_window_handle)
+		{
+			CX_CORE_ERROR("Unable to create hidden glfw3 Window");
+			glfwTerminate();
+			return;
+		}
+
+		glfwMakeContextCurrent(m_glfw_native_window_handle);
+
+		if (!gladLoadGL(glfwGetProcAddress))
+		{
+			CX_CORE_ERROR("Unable to load opengl/glad symbols gladLoadGL()");
+			glfwDestroyWindow(m_glfw_native_window_handle);
+			glfwTerminate();
+			return;
+		}
+
+		GLContext::SetupDefaultState(width, height);
+
+		m_context_data = { width, height };
+		m_is_valid = true;
+
+		CX_CORE_INFO("OpenGL headless Context initialized (hidden window)!");
+	}
+
+	auto GLHeadlessContext::Shutdown() -> void
+	{
+		CX_CORE_TRACE("Shutting down GL headless Context");
+
+		glfwDestroyWindow(m_glfw_native_window_handle);
+		glfwTerminate();
+	}
+
+	auto GLHeadlessContext::GetNativeHandle() const -> void*
+	{
+		return m_glfw_native_window_handle;
+	}
+}
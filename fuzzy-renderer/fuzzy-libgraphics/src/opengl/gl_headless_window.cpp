@@ -0,0 +1,96 @@
+#include <opengl/gl_headless_window.h>
+#include <opengl/gl_headless_context.h>
+#include <opengl/gl_state_cache.h>
+#include <logger.h>
+
+namespace libgraphics
+{
+	auto GLHeadlessWindow::Create(const int width, const int height, const std::string_view title) -> void
+	{
+		const auto headless_context = std::make_shared<GLHeadlessContext>();
+		headless_context->Init(width, height, title);
+		m_graphics_context = headless_context;
+
+		if (!headless_context->IsValid())
+		{
+			throw std::runtime_error("Unable to create a headless OpenGL context");
+		}
+
+		CreateFramebuffer(width, height);
+	}
+
+	auto GLHeadlessWindow::Destroy() -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.DeleteFramebuffer(m_framebuffer);
+		state_cache.DeleteTexture(m_color_texture);
+		glDeleteRenderbuffers(1, &m_depth_renderbuffer);
+		m_framebuffer_memory.Reset();
+
+		m_graphics_context->Shutdown();
+	}
+
+	auto GLHeadlessWindow::Clear() -> void
+	{
+		GLStateCache::GetInstance().ClearColor(m_clear_color.r, m_clear_color.g, m_clear_color.b, m_clear_color.a);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	auto GLHeadlessWindow::SwapBuffers() -> void
+	{
+		// nothing to present, just make sure the frame is submitted
+		glFlush();
+	}
+
+	auto GLHeadlessWindow::SetClearColor(const Color& color) -> void
+	{
+		m_clear_color = color;
+	}
+
+	auto GLHeadlessWindow::ReadPixels() const -> std::vector<uint8_t>
+	{
+		const auto& [width, height] = m_graphics_context->Data();
+
+		auto pixels = std::vector<uint8_t>(static_cast<size_t>(width) * height * 4);
+
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.BindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+		state_cache.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+		return pixels;
+	}
+
+	auto GLHeadlessWindow::CreateFramebuffer(const int width, const int height) -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+
+		glGenTextures(1, &m_color_texture);
+		state_cache.BindTexture(0, GL_TEXTURE_2D, m_color_texture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glGenRenderbuffers(1, &m_depth_renderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_depth_renderbuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+		glGenFramebuffers(1, &m_framebuffer);
+		state_cache.BindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_color_texture, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth_renderbuffer);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			CX_CORE_CRITICAL("Headless framebuffer is incomplete ({}x{})", width, height);
+			throw std::runtime_error("Headless framebuffer is incomplete");
+		}
+
+		// RGBA8 color and D24S8 depth
+		m_framebuffer_memory = TrackedMemory{ MemoryCategory::render_target, ComputeTextureBytes(width, height, 8, false), "headless framebuffer" };
+
+		CX_CORE_INFO("Headless framebuffer created ({}x{})", width, height);
+	}
+}
@@ -13,40 +13,117 @@
 
 #include <utils.h>
 
+#include <opengl/gl_state_cache.h>
+#include <rendering/render_stats.h>
+
 namespace libgraphics
 {
+	namespace
+	{
+		auto MemoryDetail(const std::string& mesh_name) -> std::string
+		{
+			return mesh_name.empty() ? "unnamed mesh" : mesh_name;
+		}
+	}
+
 	GLMesh::GLMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
-		: m_vertices{ std::move(vertices) }, m_indices{ std::move(indices) }
-	{ }
+	{
+		SetData(std::move(vertices), std::move(indices));
+		ComputeBounds();
+	}
 
-	GLMesh::GLMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<Texture> textures, std::string name = "")
-		: m_vertices{ std::move(vertices) }, m_indices{ std::move(indices) }, m_textures{ std::move(textures) }, m_name{
-			  std::move(name)
-		  }
+	GLMesh::GLMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::vector<Texture> textures, std::string name, const std::optional<BoundingBox>& bounds,
+		const MeshDataPolicy data_policy)
+		: m_textures{ std::move(textures) }, m_name{ std::move(name) }
 	{
+		SetData(std::move(vertices), std::move(indices));
+		if (bounds)
+		{
+			m_bounds = bounds.value();
+		}
+		else
+		{
+			ComputeBounds();
+		}
 		GenerateMeshDataAndSendToGPU();
+		ApplyDataPolicy(data_policy);
+	}
+
+	GLMesh::~GLMesh()
+	{
+		// meshes built without upload (tools, benchmarks) never created any GL object
+		if (m_vao == 0)
+		{
+			return;
+		}
+
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.DeleteVertexArray(m_vao);
+		state_cache.DeleteBuffer(m_vbo);
+		state_cache.DeleteBuffer(m_ebo);
 	}
 
 	auto GLMesh::Draw(const std::shared_ptr<IShader>& shader) -> void
 	{
-		const auto& core = Core::GetInstance();
-		const auto light_buffer_size = core.GetLights().size();
-		const auto light_buffer_id = shader->GetLightsBufferID();
+		std::static_pointer_cast<GLShader>(shader)->UploadLights(Core::GetInstance().GetLights());
 
-		glBindBuffer(GL_UNIFORM_BUFFER, light_buffer_id);
-		glBufferSubData(GL_UNIFORM_BUFFER, 0, light_buffer_size * sizeof(Light), &core.GetLights().data()->get()[0]);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		Submit(1);
+	}
 
-		glBindVertexArray(m_vao);
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+	auto GLMesh::Submit(const uint32_t instance_count) const -> void
+	{
+		// vertex and index buffers are captured by the vao, no need to bind (or unbind) them for drawing
+		GLStateCache::GetInstance().BindVertexArray(m_vao);
+		RenderStats::GetInstance().CountDraw(m_vertex_count, m_index_count, instance_count);
+
+		if (instance_count == 1)
+		{
+			glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_index_count), GL_UNSIGNED_INT, nullptr);
+		}
+		else
+		{
+			glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(m_index_count), GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(instance_count));
+		}
+	}
 
-		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, nullptr);
+	auto GLMesh::ComputeBounds() -> void
+	{
+		const auto vertices = GetVertexBuffer();
+		if (vertices.empty())
+		{
+			m_bounds = {};
+			return;
+		}
+
+		m_bounds = { vertices.front().m_position, vertices.front().m_position };
+
+		for (const auto& vertex : vertices)
+		{
+			m_bounds.m_min = glm::min(m_bounds.m_min, vertex.m_position);
+			m_bounds.m_max = glm::max(m_bounds.m_max, vertex.m_position);
+		}
+	}
 
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-		glBindTexture(GL_TEXTURE_2D, 0);
+	auto GLMesh::SetData(std::vector<Vertex> vertices, std::vector<uint32_t> indices) -> void
+	{
+		m_vertex_count = static_cast<uint32_t>(vertices.size());
+		m_index_count = static_cast<uint32_t>(indices.size());
+		m_data = std::make_shared<const MeshData>(std::move(vertices), std::move(indices), MemoryDetail(m_name));
+	}
+
+	auto GLMesh::ApplyDataPolicy(const MeshDataPolicy data_policy) -> void
+	{
+		switch (data_policy)
+		{
+		case MeshDataPolicy::keep_all:
+			break;
+		case MeshDataPolicy::keep_positions:
+			m_data = m_data->MakePickingCopy(MemoryDetail(m_name));
+			break;
+		case MeshDataPolicy::discard:
+			m_data.reset();
+			break;
+		}
 	}
 
 	auto GLMesh::SendGPUData(const unsigned slot, const int slot_size, const unsigned attrib_array_index, const void* ptr) -> void
@@ -61,16 +138,23 @@ namespace libgraphics
 		glGenBuffers(1, &m_vbo);
 		glGenBuffers(1, &m_ebo);
 
-		glBindVertexArray(m_vao);
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.BindVertexArray(m_vao);
+		state_cache.BindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
-		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizei>(m_vertices.size() * sizeof(Vertex)), m_vertices.data(), GL_STATIC_DRAW);
+		const auto vertices = GetVertexBuffer();
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizei>(vertices.size_bytes()), vertices.data(), GL_STATIC_DRAW);
+		RenderStats::GetInstance().CountBufferUpload(vertices.size_bytes());
+		m_vertex_memory = TrackedMemory{ MemoryCategory::vertex_buffer, vertices.size_bytes(), MemoryDetail(m_name) };
 	}
 
-	auto GLMesh::GenerateIndexBuffer() const -> void
+	auto GLMesh::GenerateIndexBuffer() -> void
 	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizei>(m_indices.size() * sizeof(uint32_t)), m_indices.data(), GL_STATIC_DRAW);
+		GLStateCache::GetInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+		const auto indices = GetIndexBuffer();
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizei>(indices.size_bytes()), indices.data(), GL_STATIC_DRAW);
+		RenderStats::GetInstance().CountBufferUpload(indices.size_bytes());
+		m_index_memory = TrackedMemory{ MemoryCategory::index_buffer, indices.size_bytes(), MemoryDetail(m_name) };
 	}
 
 	auto GLMesh::GenerateMeshDataAndSendToGPU() -> void
@@ -1,19 +1,21 @@
+#include <asset_file_system.h>
 #include <engine_constants.h>
-#include <fstream>
+#include <array>
 #include <logger.h>
 #include <source_location>
 #include <span>
-#include <sstream>
 #include <glad/gl.h>
+#include <hot_reloader.h>
 #include <opengl/gl_shader.h>
 #include <rendering/light.h>
+#include <rendering/render_stats.h>
 
 namespace libgraphics
 {
 	auto read_shader(const std::string& path) -> std::string
 	{
-		auto shader_file = std::ifstream{ path };
-		if (!shader_file.is_open())
+		const auto shader_file = AssetFileSystem::GetInstance().Read(path);
+		if (!shader_file)
 		{
 			const auto location = std::source_location::current();
 			const auto error_message = std::format("ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: {} [{}:{}]", path, location.file_name(), location.line());
@@ -21,10 +23,27 @@ namespace libgraphics
 			throw std::runtime_error(error_message);
 		}
 
-		std::stringstream shader_stream = {};
-		shader_stream << shader_file.rdbuf();
-		shader_file.close();
-		return shader_stream.str();
+		return std::string{ shader_file->GetText() };
+	}
+
+	auto patch_version_directive(std::string& shader_code) -> void
+	{
+		// shaders are written against 4.6, software drivers (llvmpipe) stop at 4.5 and nothing we use needs more
+		auto major_version = GLint{};
+		auto minor_version = GLint{};
+		glGetIntegerv(GL_MAJOR_VERSION, &major_version);
+		glGetIntegerv(GL_MINOR_VERSION, &minor_version);
+
+		if (major_version > 4 || (major_version == 4 && minor_version >= 6))
+		{
+			return;
+		}
+
+		constexpr auto version_460 = std::string_view{ "#version 460" };
+		if (const auto position = shader_code.find(version_460); position != std::string::npos)
+		{
+			shader_code.replace(position, version_460.size(), std::format("#version {}{}0", major_version, minor_version));
+		}
 	}
 
 	auto compile_shader(const std::span<const char> shader_source, const GLenum shader_type) -> GLuint
@@ -50,26 +69,36 @@ namespace libgraphics
 		return shader;
 	}
 
-	GLShader::GLShader(const std::string_view vertex, const std::string_view fragment)
+	/**
+	 * \brief Reads, compiles and links the two stages, throws with the compiler log when any of it fails.
+	 */
+	auto build_program(const std::string& vertex_path, const std::string& fragment_path) -> GLuint
 	{
-		const auto vertex_shader_code = read_shader(vertex.data());
-		const auto fragment_shader_code = read_shader(fragment.data());
+		auto vertex_shader_code = read_shader(vertex_path);
+		auto fragment_shader_code = read_shader(fragment_path);
+
+		patch_version_directive(vertex_shader_code);
+		patch_version_directive(fragment_shader_code);
 
 		const auto vertex_id = compile_shader(std::span(vertex_shader_code.data(), vertex_shader_code.size()), GL_VERTEX_SHADER);
 		const auto fragment_id = compile_shader(std::span(fragment_shader_code.data(), fragment_shader_code.size()), GL_FRAGMENT_SHADER);
 
 		// Shader program
-		m_program_id = glCreateProgram();
-		glAttachShader(m_program_id, vertex_id);
-		glAttachShader(m_program_id, fragment_id);
-		glLinkProgram(m_program_id);
+		const auto program_id = glCreateProgram();
+		glAttachShader(program_id, vertex_id);
+		glAttachShader(program_id, fragment_id);
+		glLinkProgram(program_id);
+
+		glDeleteShader(vertex_id);
+		glDeleteShader(fragment_id);
 
 		auto success = GLint{};
-		glGetProgramiv(m_program_id, GL_LINK_STATUS, &success);
+		glGetProgramiv(program_id, GL_LINK_STATUS, &success);
 		if (!success) 
 		{
 			GLchar info_log[512] = {};
-			glGetProgramInfoLog(m_program_id, sizeof info_log, nullptr, info_log);
+			glGetProgramInfoLog(program_id, sizeof info_log, nullptr, info_log);
+			glDeleteProgram(program_id);
 
 			const auto location = std::source_location::current();
 			const auto error_message = std::format("ERROR::SHADER::PROGRAM::LINKING_FAILED: [{}:{}]\n{}", location.file_name(), location.line(), info_log);
@@ -77,21 +106,132 @@ namespace libgraphics
 			throw std::runtime_error(error_message);
 		}
 
-		glDeleteShader(vertex_id);
-		glDeleteShader(fragment_id);
+		return program_id;
+	}
+
+	GLShader::GLShader(const std::string_view vertex, const std::string_view fragment) : m_vertex_path{ vertex }, m_fragment_path{ fragment }
+	{
+		m_program_id = build_program(m_vertex_path, m_fragment_path);
+
+		CacheUniformLocations();
+
+		HotReloader::GetInstance().TrackShader(*this);
 
 		CX_CORE_INFO("GLSL Shaders successfully compiled!");
 	}
 
+	GLShader::~GLShader()
+	{
+		HotReloader::GetInstance().UntrackShader(*this);
+
+		auto& state_cache = GLStateCache::GetInstance();
+		if (m_lights_buffer != 0)
+		{
+			state_cache.DeleteBuffer(m_lights_buffer);
+			m_lights_buffer_memory.Reset();
+		}
+		if (m_program_id != 0)
+		{
+			state_cache.DeleteProgram(m_program_id);
+		}
+	}
+
+	auto GLShader::Reload() -> bool
+	{
+		auto program_id = GLuint{};
+		try
+		{
+			program_id = build_program(m_vertex_path, m_fragment_path);
+		}
+		catch (const std::runtime_error&)
+		{
+			// logged already, the program that works stays in use
+			return false;
+		}
+
+		GLStateCache::GetInstance().DeleteProgram(std::exchange(m_program_id, program_id));
+
+		m_uniform_locations.clear();
+		CacheUniformLocations();
+
+		return true;
+	}
+
 	auto GLShader::AllocateLightsBuffer(const std::string& uniform_block_name) -> void
 	{
 		GLint binding_point = {};
 		glGetActiveUniformBlockiv(m_program_id, glGetUniformBlockIndex(m_program_id, uniform_block_name.c_str()), GL_UNIFORM_BLOCK_BINDING, &binding_point);
 
+		auto& state_cache = GLStateCache::GetInstance();
+		if (m_lights_buffer != 0)
+		{
+			state_cache.DeleteBuffer(m_lights_buffer);
+			m_lights_buffer_memory.Reset();
+		}
+
 		glGenBuffers(1, &m_lights_buffer);
-		glBindBuffer(GL_UNIFORM_BUFFER, m_lights_buffer);
+		state_cache.BindBuffer(GL_UNIFORM_BUFFER, m_lights_buffer);
 		glBufferData(GL_UNIFORM_BUFFER, sizeof(Light) * constants::MaxNumberOfLights, nullptr, GL_DYNAMIC_DRAW);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_lights_buffer_memory = TrackedMemory{ MemoryCategory::uniform_buffer, sizeof(Light) * constants::MaxNumberOfLights, uniform_block_name };
 		glBindBufferRange(GL_UNIFORM_BUFFER, binding_point, m_lights_buffer, 0, constants::MaxNumberOfLights * sizeof(Light));
 	}
+
+	auto GLShader::UploadLights(const std::vector<std::shared_ptr<Light>>& lights) const -> void
+	{
+		// lights live in separate allocations, pack them the way the std140 block expects
+		auto packed_lights = std::array<Light, constants::MaxNumberOfLights>{};
+		const auto lights_count = std::min<size_t>(lights.size(), constants::MaxNumberOfLights);
+
+		for (auto light_idx = size_t{}; light_idx != lights_count; ++light_idx)
+		{
+			packed_lights[light_idx] = *lights[light_idx];
+		}
+
+		// the slots past lights_count are zeroed (inactive), stale lights of a bigger upload would still shade otherwise
+		const auto upload_count = std::max(lights_count, m_uploaded_lights_count);
+		m_uploaded_lights_count = lights_count;
+
+		GLStateCache::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, m_lights_buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(upload_count * sizeof(Light)), packed_lights.data());
+		RenderStats::GetInstance().CountBufferUpload(upload_count * sizeof(Light));
+	}
+
+	auto GLShader::GetUniformLocation(const std::string_view name) const -> GLint
+	{
+		const auto it = m_uniform_locations.find(name);
+		return it != m_uniform_locations.end() ? it->second : -1;
+	}
+
+	auto GLShader::CacheUniformLocations() -> void
+	{
+		auto uniforms_count = GLint{};
+		auto max_name_length = GLint{};
+		glGetProgramiv(m_program_id, GL_ACTIVE_UNIFORMS, &uniforms_count);
+		glGetProgramiv(m_program_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+		auto name = std::string(static_cast<size_t>(max_name_length), '\0');
+
+		for (auto uniform_idx = GLuint{}; uniform_idx != static_cast<GLuint>(uniforms_count); ++uniform_idx)
+		{
+			auto name_length = GLsizei{};
+			glGetActiveUniformName(m_program_id, uniform_idx, max_name_length, &name_length, name.data());
+
+			const auto uniform_name = std::string{ name.data(), static_cast<size_t>(name_length) };
+
+			// block members are active uniforms too but have no location
+			const auto location = glGetUniformLocation(m_program_id, uniform_name.c_str());
+			if (location < 0)
+			{
+				continue;
+			}
+
+			m_uniform_locations[uniform_name] = location;
+
+			// arrays are reported as "name[0]", make them reachable by their plain name as well
+			if (uniform_name.ends_with("[0]"))
+			{
+				m_uniform_locations[uniform_name.substr(0, uniform_name.size() - 3)] = location;
+			}
+		}
+	}
 }
@@ -7,6 +7,8 @@
 #include <core.h>
 #include <iostream>
 #include <opengl/gl_context.h>
+#include <opengl/gl_state_cache.h>
+#include <rendering/render_stats.h>
 
 #include <interfaces/ishader.h>
 
@@ -62,6 +64,20 @@ namespace libgraphics
 	{
         Setup();
 		m_cubemap_tex_id = utils::gl::LoadCubemap("../fuzzy-libgraphics/cubemaps/sky_01");
+
+		// the faces are square and share their size
+		GLStateCache::GetInstance().BindTexture(0, GL_TEXTURE_CUBE_MAP, m_cubemap_tex_id);
+		auto face_size = GLint{};
+		glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, GL_TEXTURE_WIDTH, &face_size);
+		m_cubemap_memory = TrackedMemory{ MemoryCategory::texture, 6 * ComputeTextureBytes(face_size, face_size, 4, false), "skybox cubemap" };
+	}
+
+	GLSkybox::~GLSkybox()
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.DeleteVertexArray(m_sky_vao);
+		state_cache.DeleteBuffer(m_sky_vbo);
+		state_cache.DeleteTexture(m_cubemap_tex_id);
 	}
 
 	auto GLSkybox::Render(const std::shared_ptr<IShader>& shader) const -> void
@@ -69,18 +85,19 @@ namespace libgraphics
 		const auto& core = Core::GetInstance();
 		const auto gl_context = ::std::static_pointer_cast<GLContext>(core.GetGraphicsWindow()->GetNativeHandle());
 
-        glDepthMask(GL_FALSE);
+		auto& state_cache = GLStateCache::GetInstance();
+
+		state_cache.DepthMask(false);
 		shader->Bind();
         shader->SetMatrix4x4("view", GetViewMatrix3(core.GetMainCamera().m_camera_props));
         shader->SetFloat("time", core.GetDeltaTime());
 		shader->SetMatrix4x4("projection", ComputeCameraProjection(60.0, gl_context->Data().m_width, gl_context->Data().m_height, 0.01, 1000.0));
 
-		glBindVertexArray(m_sky_vao);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_cubemap_tex_id);
+		state_cache.BindVertexArray(m_sky_vao);
+		state_cache.BindTexture(0, GL_TEXTURE_CUBE_MAP, m_cubemap_tex_id);
 		glDrawArrays(GL_TRIANGLES, 0, utils::common::ArraySize(skybox_vertices) / 3);
-		glBindVertexArray(0);
-        glDepthMask(GL_TRUE);
+		RenderStats::GetInstance().CountDraw(utils::common::ArraySize(skybox_vertices) / 3, utils::common::ArraySize(skybox_vertices) / 3, 1);
+		state_cache.DepthMask(true);
 	}
 
 	auto GLSkybox::Setup() -> void
@@ -88,9 +105,12 @@ namespace libgraphics
         // skybox VAO
         glGenVertexArrays(1, &m_sky_vao);
         glGenBuffers(1, &m_sky_vbo);
-        glBindVertexArray(m_sky_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, m_sky_vbo);
+        auto& state_cache = GLStateCache::GetInstance();
+        state_cache.BindVertexArray(m_sky_vao);
+        state_cache.BindBuffer(GL_ARRAY_BUFFER, m_sky_vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof skybox_vertices, &skybox_vertices, GL_STATIC_DRAW);
+        RenderStats::GetInstance().CountBufferUpload(sizeof skybox_vertices);
+        m_vbo_memory = TrackedMemory{ MemoryCategory::vertex_buffer, sizeof skybox_vertices, "skybox" };
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), static_cast<void*>(nullptr));
 	}
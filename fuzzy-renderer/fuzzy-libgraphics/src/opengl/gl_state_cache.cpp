@@ -0,0 +1,293 @@
+#include <opengl/gl_state_cache.h>
+
+#include <logger.h>
+#include <rendering/render_stats.h>
+
+namespace libgraphics
+{
+	auto BufferTargetIndex(const GLenum target) -> int
+	{
+		switch (target)
+		{
+		case GL_ARRAY_BUFFER: return 0;
+		case GL_ELEMENT_ARRAY_BUFFER: return 1;
+		case GL_UNIFORM_BUFFER: return 2;
+		case GL_SHADER_STORAGE_BUFFER: return 3;
+		case GL_PIXEL_PACK_BUFFER: return 4;
+		case GL_PIXEL_UNPACK_BUFFER: return 5;
+		case GL_COPY_READ_BUFFER: return 6;
+		case GL_COPY_WRITE_BUFFER: return 7;
+		case GL_DRAW_INDIRECT_BUFFER: return 8;
+		default: return -1;
+		}
+	}
+
+	auto TextureTargetIndex(const GLenum target) -> int
+	{
+		switch (target)
+		{
+		case GL_TEXTURE_2D: return 0;
+		case GL_TEXTURE_CUBE_MAP: return 1;
+		case GL_TEXTURE_2D_ARRAY: return 2;
+		default: return -1;
+		}
+	}
+
+	auto CapabilityIndex(const GLenum capability) -> int
+	{
+		switch (capability)
+		{
+		case GL_DEPTH_TEST: return 0;
+		case GL_CULL_FACE: return 1;
+		case GL_BLEND: return 2;
+		case GL_SCISSOR_TEST: return 3;
+		case GL_STENCIL_TEST: return 4;
+		default: return -1;
+		}
+	}
+
+	auto GLStateCache::GetInstance() -> GLStateCache&
+	{
+		static auto instance = GLStateCache{};
+		return instance;
+	}
+
+	auto GLStateCache::UseProgram(const GLuint program) -> void
+	{
+		if (Update(m_program, program))
+		{
+			glUseProgram(program);
+			RenderStats::GetInstance().CountProgramBind();
+		}
+	}
+
+	auto GLStateCache::BindVertexArray(const GLuint vao) -> void
+	{
+		if (Update(m_vao, vao))
+		{
+			glBindVertexArray(vao);
+			RenderStats::GetInstance().CountVaoBind();
+
+			// the element array binding is part of the vertex array object state
+			m_buffers[BufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)].reset();
+		}
+	}
+
+	auto GLStateCache::BindBuffer(const GLenum target, const GLuint buffer) -> void
+	{
+		const auto target_idx = BufferTargetIndex(target);
+		if (target_idx < 0)
+		{
+			m_counters.m_issued++;
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		if (Update(m_buffers[target_idx], buffer))
+		{
+			glBindBuffer(target, buffer);
+		}
+	}
+
+	auto GLStateCache::BindFramebuffer(const GLenum target, const GLuint framebuffer) -> void
+	{
+		if (target == GL_FRAMEBUFFER)
+		{
+			// both targets in one call, counted once
+			if (m_draw_framebuffer == framebuffer && m_read_framebuffer == framebuffer)
+			{
+				m_counters.m_elided++;
+				return;
+			}
+
+			m_draw_framebuffer = framebuffer;
+			m_read_framebuffer = framebuffer;
+			m_counters.m_issued++;
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			return;
+		}
+
+		if (Update(target == GL_READ_FRAMEBUFFER ? m_read_framebuffer : m_draw_framebuffer, framebuffer))
+		{
+			glBindFramebuffer(target, framebuffer);
+		}
+	}
+
+	auto GLStateCache::ActiveTexture(const GLuint unit) -> void
+	{
+		if (Update(m_active_texture_unit, unit))
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+		}
+	}
+
+	auto GLStateCache::BindTexture(const GLuint unit, const GLenum target, const GLuint texture) -> void
+	{
+		const auto target_idx = TextureTargetIndex(target);
+		if (target_idx < 0 || unit >= MaxTextureUnits)
+		{
+			ActiveTexture(unit);
+			m_counters.m_issued++;
+			glBindTexture(target, texture);
+			RenderStats::GetInstance().CountTextureBind();
+			return;
+		}
+
+		auto& cached = m_textures[unit][target_idx];
+		if (cached.has_value() && cached.value() == texture)
+		{
+			m_counters.m_elided++;
+			return;
+		}
+
+		ActiveTexture(unit);
+		Update(cached, texture);
+		glBindTexture(target, texture);
+		RenderStats::GetInstance().CountTextureBind();
+	}
+
+	auto GLStateCache::SetCapability(const GLenum capability, const bool enabled) -> void
+	{
+		const auto capability_idx = CapabilityIndex(capability);
+		if (capability_idx >= 0 && !Update(m_capabilities[capability_idx], enabled))
+		{
+			return;
+		}
+
+		if (capability_idx < 0)
+		{
+			m_counters.m_issued++;
+		}
+
+		enabled ? glEnable(capability) : glDisable(capability);
+	}
+
+	auto GLStateCache::DepthMask(const bool enabled) -> void
+	{
+		if (Update(m_depth_mask, enabled))
+		{
+			glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+		}
+	}
+
+	auto GLStateCache::DepthFunc(const GLenum func) -> void
+	{
+		if (Update(m_depth_func, func))
+		{
+			glDepthFunc(func);
+		}
+	}
+
+	auto GLStateCache::CullFace(const GLenum mode) -> void
+	{
+		if (Update(m_cull_face, mode))
+		{
+			glCullFace(mode);
+		}
+	}
+
+	auto GLStateCache::FrontFace(const GLenum mode) -> void
+	{
+		if (Update(m_front_face, mode))
+		{
+			glFrontFace(mode);
+		}
+	}
+
+	auto GLStateCache::BlendFunc(const GLenum source_factor, const GLenum destination_factor) -> void
+	{
+		if (Update(m_blend_func, std::array{ source_factor, destination_factor }))
+		{
+			glBlendFunc(source_factor, destination_factor);
+		}
+	}
+
+	auto GLStateCache::Viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height) -> void
+	{
+		if (Update(m_viewport, std::array{ x, y, width, height }))
+		{
+			glViewport(x, y, width, height);
+		}
+	}
+
+	auto GLStateCache::ClearColor(const float r, const float g, const float b, const float a) -> void
+	{
+		if (Update(m_clear_color, std::array{ r, g, b, a }))
+		{
+			glClearColor(r, g, b, a);
+		}
+	}
+
+#pragma region DELETION
+
+	auto GLStateCache::DeleteProgram(const GLuint program) -> void
+	{
+		if (m_program == program) m_program.reset();
+		glDeleteProgram(program);
+	}
+
+	auto GLStateCache::DeleteVertexArray(const GLuint vao) -> void
+	{
+		if (m_vao == vao)
+		{
+			m_vao.reset();
+			m_buffers[BufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)].reset();
+		}
+		glDeleteVertexArrays(1, &vao);
+	}
+
+	auto GLStateCache::DeleteBuffer(const GLuint buffer) -> void
+	{
+		for (auto& cached : m_buffers)
+		{
+			if (cached == buffer) cached.reset();
+		}
+		glDeleteBuffers(1, &buffer);
+	}
+
+	auto GLStateCache::DeleteTexture(const GLuint texture) -> void
+	{
+		for (auto& unit : m_textures)
+		{
+			for (auto& cached : unit)
+			{
+				if (cached == texture) cached.reset();
+			}
+		}
+		glDeleteTextures(1, &texture);
+	}
+
+	auto GLStateCache::DeleteFramebuffer(const GLuint framebuffer) -> void
+	{
+		if (m_draw_framebuffer == framebuffer) m_draw_framebuffer.reset();
+		if (m_read_framebuffer == framebuffer) m_read_framebuffer.reset();
+		glDeleteFramebuffers(1, &framebuffer);
+	}
+
+#pragma endregion
+
+	auto GLStateCache::Invalidate() -> void
+	{
+		m_program.reset();
+		m_vao.reset();
+		m_draw_framebuffer.reset();
+		m_read_framebuffer.reset();
+		m_active_texture_unit.reset();
+		m_buffers = {};
+		m_textures = {};
+		m_capabilities = {};
+		m_depth_mask.reset();
+		m_depth_func.reset();
+		m_cull_face.reset();
+		m_front_face.reset();
+		m_blend_func.reset();
+		m_viewport.reset();
+		m_clear_color.reset();
+	}
+
+	auto GLStateCache::BeginFrame() -> void
+	{
+		m_last_frame_counters = m_counters;
+		m_counters = {};
+	}
+}
@@ -1,5 +1,6 @@
 #include <opengl/gl_window.h>
 #include <opengl/gl_context.h>
+#include <opengl/gl_state_cache.h>
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -19,7 +20,7 @@ namespace libgraphics
 
 	auto GLWindow::Clear() -> void
 	{
-		glClearColor(m_clear_color.r, m_clear_color.g, m_clear_color.b, m_clear_color.a);
+		GLStateCache::GetInstance().ClearColor(m_clear_color.r, m_clear_color.g, m_clear_color.b, m_clear_color.a);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
@@ -31,6 +32,11 @@ namespace libgraphics
 		glfwPollEvents();
 	}
 
+	auto GLWindow::ShouldClose() const -> bool
+	{
+		return glfwWindowShouldClose(static_cast<GLFWwindow*>(m_graphics_context->GetNativeHandle()));
+	}
+
 	auto GLWindow::SetClearColor(const Color& color) -> void
 	{
 		m_clear_color = color;
@@ -1,16 +1,375 @@
 #include <render_profiler.h>
+#include <logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <limits>
 
 namespace libgraphics::utils::profiling
 {
+	/**
+	 * \brief Zones of one thread: written by that thread only, read by the render thread only.
+	 */
+	struct ThreadZoneRing
+	{
+		std::array<ProfileZone, constants::ProfilerZonesPerThread> m_zones = {};
+		std::atomic<uint64_t> m_write_index = {};
+		std::atomic<uint64_t> m_read_index = {};
+		uint32_t m_thread_index = {};
+		std::string m_name = {};
+	};
+
+	namespace
+	{
+		thread_local ThreadZoneRing* t_thread_ring = {};
+		thread_local uint32_t t_zone_depth = {};
+
+		auto AppendJsonEscaped(std::string& out, const std::string_view text) -> void
+		{
+			for (const auto character : text)
+			{
+				switch (character)
+				{
+				case '"': out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				default: out += character; break;
+				}
+			}
+		}
+	}
+
+	RenderProfiler::RenderProfiler() = default;
+	RenderProfiler::~RenderProfiler() = default;
+
 	auto RenderProfiler::GetInstance() -> RenderProfiler&
 	{
 		static auto instance = RenderProfiler{};
 		return instance;
 	}
 
+	auto RenderProfiler::Now() -> int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
 	auto RenderProfiler::Update() -> void
 	{
-		
+		const auto now = Now();
+
+		if (m_has_current_frame)
+		{
+			m_current_frame.m_end_ns = now;
+			CollectCpuZones(m_current_frame.m_cpu_zones);
+
+			if (IsEnabled() && !m_is_paused)
+			{
+				m_frames.push_back(std::move(m_current_frame));
+				while (m_frames.size() > constants::ProfilerFramesHistory)
+				{
+					m_frames.pop_front();
+				}
+			}
+		}
+
+		const auto frame_index = m_has_current_frame ? m_current_frame.m_frame_index + 1 : 0;
+		m_current_frame = { frame_index, now };
+		m_has_current_frame = true;
+
+		// this set was last used two frames ago, its results are read before it's reused
+		CollectGpuZones(m_gpu_query_sets[frame_index % m_gpu_query_sets.size()]);
+		m_open_gpu_zones.clear();
+	}
+
+	auto RenderProfiler::ReleaseGpuResources() -> void
+	{
+		for (auto& query_set : m_gpu_query_sets)
+		{
+			if (!query_set.m_queries.empty())
+			{
+				glDeleteQueries(static_cast<GLsizei>(query_set.m_queries.size()), query_set.m_queries.data());
+			}
+			query_set = {};
+		}
+		m_open_gpu_zones.clear();
+	}
+
+	auto RenderProfiler::SetThreadName(const std::string_view name) -> void
+	{
+		auto& thread_ring = GetThreadRing();
+
+		const auto lock = std::scoped_lock{ m_threads_mutex };
+		thread_ring.m_name = name;
+	}
+
+	auto RenderProfiler::InternName(const std::string_view name) -> const char*
+	{
+		const auto lock = std::scoped_lock{ m_names_mutex };
+
+		// nodes never move, the pointer stays valid for the lifetime of the profiler
+		return m_interned_names.emplace(name).first->c_str();
+	}
+
+	auto RenderProfiler::RecordZone(const char* name, const int64_t start_ns, const int64_t end_ns, const uint32_t depth) -> void
+	{
+		auto& thread_ring = GetThreadRing();
+
+		const auto write_index = thread_ring.m_write_index.load(std::memory_order_relaxed);
+		if (write_index - thread_ring.m_read_index.load(std::memory_order_acquire) == thread_ring.m_zones.size())
+		{
+			m_dropped_zones_count.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		thread_ring.m_zones[write_index % thread_ring.m_zones.size()] = { name, start_ns, end_ns, depth, thread_ring.m_thread_index };
+		thread_ring.m_write_index.store(write_index + 1, std::memory_order_release);
+	}
+
+	auto RenderProfiler::BeginGpuZone(const char* name) -> void
+	{
+		if (!IsEnabled() || !m_has_current_frame)
+		{
+			return;
+		}
+
+		auto& query_set = m_gpu_query_sets[m_current_frame.m_frame_index % m_gpu_query_sets.size()];
+
+		if (query_set.m_queries.empty())
+		{
+			query_set.m_queries.resize(constants::ProfilerGpuZonesPerFrame * 2);
+			glGenQueries(static_cast<GLsizei>(query_set.m_queries.size()), query_set.m_queries.data());
+		}
+
+		// GL_TIMESTAMP values live on their own clock, sampling both clocks once per frame lines them up
+		if (!query_set.m_has_clock_offset)
+		{
+			auto gpu_now = GLint64{};
+			glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+
+			query_set.m_cpu_minus_gpu_ns = Now() - gpu_now;
+			query_set.m_has_clock_offset = true;
+			query_set.m_frame_index = m_current_frame.m_frame_index;
+		}
+
+		if (query_set.m_zones.size() == constants::ProfilerGpuZonesPerFrame)
+		{
+			m_dropped_zones_count.fetch_add(1, std::memory_order_relaxed);
+			m_open_gpu_zones.push_back(std::numeric_limits<size_t>::max());
+			return;
+		}
+
+		const auto zone_idx = query_set.m_zones.size();
+		query_set.m_zones.push_back({ name, 0, 0, static_cast<uint32_t>(m_open_gpu_zones.size()), 0 });
+		query_set.m_closed_zones.push_back(false);
+		m_open_gpu_zones.push_back(zone_idx);
+
+		query_set.m_last_issued_query = query_set.m_queries[zone_idx * 2];
+		glQueryCounter(query_set.m_last_issued_query, GL_TIMESTAMP);
+	}
+
+	auto RenderProfiler::EndGpuZone() -> void
+	{
+		if (m_open_gpu_zones.empty())
+		{
+			return;
+		}
+
+		const auto zone_idx = m_open_gpu_zones.back();
+		m_open_gpu_zones.pop_back();
+
+		if (zone_idx != std::numeric_limits<size_t>::max())
+		{
+			auto& query_set = m_gpu_query_sets[m_current_frame.m_frame_index % m_gpu_query_sets.size()];
+			query_set.m_closed_zones[zone_idx] = true;
+			query_set.m_last_issued_query = query_set.m_queries[zone_idx * 2 + 1];
+			glQueryCounter(query_set.m_last_issued_query, GL_TIMESTAMP);
+		}
 	}
 
+	auto RenderProfiler::ExportChromeTrace(const std::filesystem::path& path) const -> bool
+	{
+		if (m_frames.empty())
+		{
+			CX_CORE_WARN("Profiler: no frames to export");
+			return false;
+		}
+
+		auto file = std::ofstream{ path, std::ios::binary };
+		if (!file.is_open())
+		{
+			CX_CORE_ERROR("Profiler: unable to open {}", path.string());
+			return false;
+		}
+
+		// timestamps are microseconds from the first frame, CPU threads are pid 1 (tid 0 holds the frames), GPU is pid 2
+		const auto origin_ns = m_frames.front().m_start_ns;
+		const auto to_us = [origin_ns](const int64_t time_ns) { return static_cast<double>(time_ns - origin_ns) / 1000.0; };
+
+		auto json = std::string{ "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" };
+		json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+		json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"GPU\"}},\n";
+		json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}},\n";
+		json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"GL queue\"}}";
+
+		const auto thread_names = GetThreadNames();
+		for (auto thread_idx = size_t{ 0 }; thread_idx != thread_names.size(); ++thread_idx)
+		{
+			json += std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"", thread_idx + 1);
+			AppendJsonEscaped(json, thread_names[thread_idx]);
+			json += "\"}}";
+		}
+
+		const auto append_zone = [&](const ProfileZone& zone, const int pid, const uint32_t tid) {
+			json += ",\n{\"name\":\"";
+			AppendJsonEscaped(json, zone.m_name);
+			json += std::format("\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", pid, tid, to_us(zone.m_start_ns), static_cast<double>(zone.m_end_ns - zone.m_start_ns) / 1000.0);
+		};
+
+		for (const auto& frame : m_frames)
+		{
+			json += std::format(",\n{{\"name\":\"Frame {}\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":{:.3f},\"dur\":{:.3f}}}",
+				frame.m_frame_index, to_us(frame.m_start_ns), static_cast<double>(frame.m_end_ns - frame.m_start_ns) / 1000.0);
+
+			for (const auto& zone : frame.m_cpu_zones)
+			{
+				append_zone(zone, 1, zone.m_thread_index + 1);
+			}
+
+			for (const auto& zone : frame.m_gpu_zones)
+			{
+				append_zone(zone, 2, 0);
+			}
+		}
+
+		json += "\n]}\n";
+		file.write(json.data(), static_cast<std::streamsize>(json.size()));
+
+		if (!file)
+		{
+			CX_CORE_ERROR("Profiler: failed writing {}", path.string());
+			return false;
+		}
+
+		CX_CORE_INFO("Profiler: {} frames exported to {}", m_frames.size(), path.string());
+		return true;
+	}
+
+	auto RenderProfiler::GetThreadNames() const -> std::vector<std::string>
+	{
+		const auto lock = std::scoped_lock{ m_threads_mutex };
+
+		auto thread_names = std::vector<std::string>{};
+		thread_names.reserve(m_thread_rings.size());
+		for (const auto& thread_ring : m_thread_rings)
+		{
+			thread_names.push_back(thread_ring->m_name);
+		}
+		return thread_names;
+	}
+
+	auto RenderProfiler::GetThreadRing() -> ThreadZoneRing&
+	{
+		// registration takes the lock, once per thread
+		if (!t_thread_ring)
+		{
+			const auto lock = std::scoped_lock{ m_threads_mutex };
+
+			auto& thread_ring = m_thread_rings.emplace_back(std::make_unique<ThreadZoneRing>());
+			thread_ring->m_thread_index = static_cast<uint32_t>(m_thread_rings.size() - 1);
+			thread_ring->m_name = std::format("thread {}", thread_ring->m_thread_index);
+			t_thread_ring = thread_ring.get();
+		}
+
+		return *t_thread_ring;
+	}
+
+	auto RenderProfiler::CollectCpuZones(std::vector<ProfileZone>& out_zones) -> void
+	{
+		const auto lock = std::scoped_lock{ m_threads_mutex };
+
+		for (const auto& thread_ring : m_thread_rings)
+		{
+			const auto read_index = thread_ring->m_read_index.load(std::memory_order_relaxed);
+			const auto write_index = thread_ring->m_write_index.load(std::memory_order_acquire);
+
+			for (auto zone_idx = read_index; zone_idx != write_index; ++zone_idx)
+			{
+				out_zones.push_back(thread_ring->m_zones[zone_idx % thread_ring->m_zones.size()]);
+			}
+
+			thread_ring->m_read_index.store(write_index, std::memory_order_release);
+		}
+	}
+
+	auto RenderProfiler::CollectGpuZones(GpuQuerySet& query_set) -> void
+	{
+		if (query_set.m_zones.empty())
+		{
+			query_set.m_has_clock_offset = false;
+			return;
+		}
+
+		// queries complete in order, when the last one issued is done every other one is too (zones nest, it isn't the
+		// end of the zone begun last)
+		auto is_available = GLint{};
+		glGetQueryObjectiv(query_set.m_last_issued_query, GL_QUERY_RESULT_AVAILABLE, &is_available);
+
+		const auto frame_it = std::ranges::find(m_frames, query_set.m_frame_index, &ProfiledFrame::m_frame_index);
+
+		if (is_available && frame_it != m_frames.end())
+		{
+			auto gpu_zones = std::vector<ProfileZone>{};
+			gpu_zones.reserve(query_set.m_zones.size());
+
+			for (auto zone_idx = size_t{ 0 }; zone_idx != query_set.m_zones.size(); ++zone_idx)
+			{
+				// left open when the frame ended, it has no end
+				if (!query_set.m_closed_zones[zone_idx])
+				{
+					m_dropped_zones_count.fetch_add(1, std::memory_order_relaxed);
+					continue;
+				}
+
+				auto start_ns = GLuint64{};
+				auto end_ns = GLuint64{};
+				glGetQueryObjectui64v(query_set.m_queries[zone_idx * 2], GL_QUERY_RESULT, &start_ns);
+				glGetQueryObjectui64v(query_set.m_queries[zone_idx * 2 + 1], GL_QUERY_RESULT, &end_ns);
+
+				auto& zone = gpu_zones.emplace_back(query_set.m_zones[zone_idx]);
+				zone.m_start_ns = static_cast<int64_t>(start_ns) + query_set.m_cpu_minus_gpu_ns;
+				zone.m_end_ns = static_cast<int64_t>(end_ns) + query_set.m_cpu_minus_gpu_ns;
+			}
+
+			frame_it->m_gpu_zones = std::move(gpu_zones);
+		}
+		else if (!is_available)
+		{
+			m_dropped_zones_count.fetch_add(query_set.m_zones.size(), std::memory_order_relaxed);
+		}
+
+		query_set.m_zones.clear();
+		query_set.m_closed_zones.clear();
+		query_set.m_has_clock_offset = false;
+	}
+
+	ScopedZone::ScopedZone(const char* name)
+		: m_name{ name }, m_is_recording{ RenderProfiler::GetInstance().IsEnabled() }
+	{
+		if (m_is_recording)
+		{
+			m_start_ns = RenderProfiler::Now();
+			t_zone_depth++;
+		}
+	}
+
+	ScopedZone::~ScopedZone()
+	{
+		if (m_is_recording)
+		{
+			t_zone_depth--;
+			RenderProfiler::GetInstance().RecordZone(m_name, m_start_ns, RenderProfiler::Now(), t_zone_depth);
+		}
+	}
 }
@@ -0,0 +1,107 @@
+#include <rendering/camera_path.h>
+#include <logger.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace libgraphics
+{
+	namespace
+	{
+		constexpr auto Magic = std::array{ 'C', 'X', 'C', 'P' };
+		constexpr auto Version = uint32_t{ 1 };
+
+		// packed on disk, without the padding of CameraPathFrame
+		constexpr auto FrameSize = sizeof(double) * 5 + sizeof(float);
+
+		auto WriteValue(std::vector<char>& out_bytes, const auto value) -> void
+		{
+			const auto offset = out_bytes.size();
+			out_bytes.resize(offset + sizeof(value));
+			std::memcpy(out_bytes.data() + offset, &value, sizeof(value));
+		}
+
+		template <typename T>
+		auto ReadValue(const char*& cursor) -> T
+		{
+			auto value = T{};
+			std::memcpy(&value, cursor, sizeof(T));
+			cursor += sizeof(T);
+			return value;
+		}
+	}
+
+	auto SaveCameraPath(const std::filesystem::path& path, const CameraPath& camera_path) -> bool
+	{
+		auto bytes = std::vector<char>{ Magic.begin(), Magic.end() };
+		bytes.reserve(Magic.size() + sizeof(uint32_t) * 2 + camera_path.size() * FrameSize);
+
+		WriteValue(bytes, Version);
+		WriteValue(bytes, static_cast<uint32_t>(camera_path.size()));
+
+		for (const auto& frame : camera_path)
+		{
+			WriteValue(bytes, frame.m_position.x);
+			WriteValue(bytes, frame.m_position.y);
+			WriteValue(bytes, frame.m_position.z);
+			WriteValue(bytes, frame.m_yaw);
+			WriteValue(bytes, frame.m_pitch);
+			WriteValue(bytes, frame.m_delta_time);
+		}
+
+		auto file = std::ofstream{ path, std::ios::binary };
+		if (!file.is_open())
+		{
+			CX_CORE_ERROR("Camera path: unable to open {}", path.string());
+			return false;
+		}
+
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		return file.good();
+	}
+
+	auto LoadCameraPath(const std::filesystem::path& path) -> std::optional<CameraPath>
+	{
+		auto file = std::ifstream{ path, std::ios::binary };
+		if (!file.is_open())
+		{
+			CX_CORE_ERROR("Camera path: unable to open {}", path.string());
+			return std::nullopt;
+		}
+
+		const auto bytes = std::vector<char>{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+
+		constexpr auto header_size = Magic.size() + sizeof(uint32_t) * 2;
+		if (bytes.size() < header_size || !std::equal(Magic.begin(), Magic.end(), bytes.begin()))
+		{
+			CX_CORE_ERROR("Camera path: {} is not a camera path", path.string());
+			return std::nullopt;
+		}
+
+		auto cursor = bytes.data() + Magic.size();
+		const auto version = ReadValue<uint32_t>(cursor);
+		const auto frames_count = ReadValue<uint32_t>(cursor);
+
+		if (version != Version || bytes.size() != header_size + frames_count * FrameSize)
+		{
+			CX_CORE_ERROR("Camera path: {} has version {} and {} bytes, expected version {} and {} bytes", path.string(), version, bytes.size(), Version, header_size + frames_count * FrameSize);
+			return std::nullopt;
+		}
+
+		auto camera_path = CameraPath(frames_count);
+		for (auto& frame : camera_path)
+		{
+			frame.m_position.x = ReadValue<double>(cursor);
+			frame.m_position.y = ReadValue<double>(cursor);
+			frame.m_position.z = ReadValue<double>(cursor);
+			frame.m_yaw = ReadValue<double>(cursor);
+			frame.m_pitch = ReadValue<double>(cursor);
+			frame.m_delta_time = ReadValue<float>(cursor);
+		}
+
+		return camera_path;
+	}
+}
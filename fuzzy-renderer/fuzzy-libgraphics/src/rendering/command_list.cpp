@@ -0,0 +1,71 @@
+#include <rendering/command_list.h>
+
+#include <interfaces/imesh.h>
+#include <interfaces/ishader.h>
+
+#include <cstring>
+
+namespace libgraphics
+{
+	auto CommandList::Reset() -> void
+	{
+		m_commands.clear();
+		m_constants.clear();
+		m_current_pipeline = {};
+		m_draws_count = {};
+	}
+
+	auto CommandList::BindPipeline(const IShader* shader) -> bool
+	{
+		if (shader == m_current_pipeline)
+		{
+			return false;
+		}
+
+		m_current_pipeline = shader;
+
+		auto& command = m_commands.emplace_back();
+		command.m_type = RenderCommandType::bind_pipeline;
+		command.m_bind_pipeline = { shader };
+		return true;
+	}
+
+	auto CommandList::BindTexture(const uint32_t unit, const TextureTarget target, const uint32_t texture_id) -> void
+	{
+		auto& command = m_commands.emplace_back();
+		command.m_type = RenderCommandType::bind_texture;
+		command.m_bind_texture = { unit, texture_id, target };
+	}
+
+	auto CommandList::DrawIndexed(const IMesh& mesh, const uint32_t instance_count) -> void
+	{
+		auto& command = m_commands.emplace_back();
+		command.m_type = RenderCommandType::draw_indexed;
+		command.m_draw_indexed = { &mesh, mesh.GetIndexCount(), instance_count };
+
+		m_draws_count++;
+	}
+
+	auto CommandList::PushConstant(const std::string_view name, const ConstantType type, const void* data, const size_t size) -> void
+	{
+		if (!m_current_pipeline)
+		{
+			return;
+		}
+
+		// resolved here so the executor never has to look names up, constants the shader doesn't use are dropped
+		const auto slot = m_current_pipeline->GetConstantSlot(name);
+		if (slot < 0)
+		{
+			return;
+		}
+
+		const auto offset = static_cast<uint32_t>(m_constants.size());
+		m_constants.resize(m_constants.size() + size);
+		std::memcpy(m_constants.data() + offset, data, size);
+
+		auto& command = m_commands.emplace_back();
+		command.m_type = RenderCommandType::set_constant;
+		command.m_set_constant = { slot, offset, type };
+	}
+}
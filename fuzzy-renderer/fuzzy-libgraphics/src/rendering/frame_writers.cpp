@@ -0,0 +1,317 @@
+#include <rendering/frame_writers.h>
+
+#include <engine_constants.h>
+#include <job_system.h>
+#include <logger.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace libgraphics
+{
+#pragma region FREE FUNCTIONS
+
+	// GL rows are bottom first, files want them top first
+	auto CopyFlipped(const CapturedFrame& frame, uint8_t* destination) -> void
+	{
+		const auto row_size = static_cast<size_t>(frame.m_width) * 4;
+
+		JobSystem::GetInstance().ParallelFor(frame.m_height, 64, [&](const size_t begin, const size_t end) {
+			for (auto row = begin; row != end; ++row)
+			{
+				std::memcpy(destination + row * row_size, frame.m_pixels.data() + (frame.m_height - 1 - row) * row_size, row_size);
+			}
+		});
+	}
+
+	// 4:2:0 full range BT.601 in 16.16 fixed point, chroma from the average of each 2x2 block
+	auto ConvertToI420(const CapturedFrame& frame, uint8_t* destination) -> void
+	{
+		const auto width = static_cast<size_t>(frame.m_width);
+		const auto height = static_cast<size_t>(frame.m_height);
+		const auto chroma_width = (width + 1) / 2;
+		const auto chroma_height = (height + 1) / 2;
+
+		const auto y_plane = destination;
+		const auto u_plane = y_plane + width * height;
+		const auto v_plane = u_plane + chroma_width * chroma_height;
+
+		const auto source_pixel = [&](const size_t x, const size_t row) { return frame.m_pixels.data() + ((height - 1 - row) * width + x) * 4; };
+		const auto to_byte = [](const int value) { return static_cast<uint8_t>(std::clamp(value, 0, 255)); };
+
+		JobSystem::GetInstance().ParallelFor(chroma_height, 8, [&](const size_t begin, const size_t end) {
+			for (auto chroma_row = begin; chroma_row != end; ++chroma_row)
+			{
+				const auto row0 = chroma_row * 2;
+				const auto row1 = std::min(row0 + 1, height - 1);
+
+				for (auto row = row0; row <= row1; ++row)
+				{
+					for (auto x = size_t{ 0 }; x != width; ++x)
+					{
+						const auto pixel = source_pixel(x, row);
+						y_plane[row * width + x] = static_cast<uint8_t>((19595 * pixel[0] + 38470 * pixel[1] + 7471 * pixel[2] + 32768) >> 16);
+					}
+				}
+
+				for (auto chroma_x = size_t{ 0 }; chroma_x != chroma_width; ++chroma_x)
+				{
+					const auto x0 = chroma_x * 2;
+					const auto x1 = std::min(x0 + 1, width - 1);
+
+					auto r = 0, g = 0, b = 0;
+					for (const auto& pixel : { source_pixel(x0, row0), source_pixel(x1, row0), source_pixel(x0, row1), source_pixel(x1, row1) })
+					{
+						r += pixel[0];
+						g += pixel[1];
+						b += pixel[2];
+					}
+
+					u_plane[chroma_row * chroma_width + chroma_x] = to_byte(((-11059 * r - 21709 * g + 32768 * b + (1 << 17)) >> 18) + 128);
+					v_plane[chroma_row * chroma_width + chroma_x] = to_byte(((32768 * r - 27439 * g - 5329 * b + (1 << 17)) >> 18) + 128);
+				}
+			}
+		});
+	}
+
+	auto FrameSize(const FrameStreamFormat format, const int width, const int height) -> size_t
+	{
+		if (format == FrameStreamFormat::y4m)
+		{
+			const auto chroma_size = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+			return static_cast<size_t>(width) * height + chroma_size * 2;
+		}
+		return static_cast<size_t>(width) * height * 4;
+	}
+
+#pragma endregion
+
+#pragma region FRAME STREAM WRITER
+
+	FrameStreamWriter::FrameStreamWriter(const std::filesystem::path& path, const FrameStreamFormat format, const int fps)
+		: m_stream{ path, std::ios::binary | std::ios::trunc }, m_format{ format }, m_fps{ fps }
+	{
+		if (!m_stream.is_open())
+		{
+			CX_CORE_ERROR("Unable to open capture stream \"{}\"", path.string());
+			return;
+		}
+
+		m_writer = std::thread{ [this] { WriterLoop(); } };
+	}
+
+	FrameStreamWriter::~FrameStreamWriter()
+	{
+		Close();
+	}
+
+	auto FrameStreamWriter::Write(const CapturedFrame& frame) -> void
+	{
+		if (!m_stream.is_open())
+		{
+			return;
+		}
+
+		if (m_width == 0)
+		{
+			m_width = frame.m_width;
+			m_height = frame.m_height;
+		}
+		else if (frame.m_width != m_width || frame.m_height != m_height)
+		{
+			CX_CORE_ERROR("Capture stream is {}x{}, frame {} ({}x{}) skipped", m_width, m_height, frame.m_frame_index, frame.m_width, frame.m_height);
+			return;
+		}
+
+		auto buffer = AcquireBuffer();
+		buffer.resize(FrameSize(m_format, m_width, m_height));
+
+		if (m_format == FrameStreamFormat::y4m)
+		{
+			ConvertToI420(frame, buffer.data());
+		}
+		else
+		{
+			CopyFlipped(frame, buffer.data());
+		}
+
+		{
+			const auto lock = std::scoped_lock{ m_mutex };
+			m_queue.push_back(std::move(buffer));
+		}
+		m_queue_condition.notify_one();
+	}
+
+	auto FrameStreamWriter::Close() -> void
+	{
+		if (!m_writer.joinable())
+		{
+			return;
+		}
+
+		{
+			const auto lock = std::scoped_lock{ m_mutex };
+			m_stop = true;
+		}
+		m_queue_condition.notify_one();
+
+		m_writer.join();
+		m_stream.close();
+
+		CX_CORE_INFO("Capture stream closed, {} frames written", m_written_frames_count.load());
+	}
+
+	auto FrameStreamWriter::AcquireBuffer() -> std::vector<uint8_t>
+	{
+		auto lock = std::unique_lock{ m_mutex };
+		m_pool_condition.wait(lock, [this] { return !m_free_buffers.empty() || m_allocated_buffers_count < constants::CaptureMaxQueuedFrames; });
+
+		if (m_free_buffers.empty())
+		{
+			m_allocated_buffers_count++;
+			return {};
+		}
+
+		auto buffer = std::move(m_free_buffers.back());
+		m_free_buffers.pop_back();
+		return buffer;
+	}
+
+	auto FrameStreamWriter::WriterLoop() -> void
+	{
+		auto is_header_written = false;
+
+		while (true)
+		{
+			auto buffer = std::vector<uint8_t>{};
+			{
+				auto lock = std::unique_lock{ m_mutex };
+				m_queue_condition.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+
+				if (m_queue.empty())
+				{
+					return;
+				}
+
+				buffer = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+
+			if (m_format == FrameStreamFormat::y4m)
+			{
+				if (!is_header_written)
+				{
+					m_stream << std::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", m_width, m_height, m_fps);
+					is_header_written = true;
+				}
+				m_stream << "FRAME\n";
+			}
+
+			m_stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+			m_written_frames_count++;
+
+			{
+				const auto lock = std::scoped_lock{ m_mutex };
+				m_free_buffers.push_back(std::move(buffer));
+			}
+			m_pool_condition.notify_one();
+		}
+	}
+
+#pragma endregion
+
+#pragma region PNG FRAME ENCODER
+
+	PNGFrameEncoder::PNGFrameEncoder(std::filesystem::path output_directory, std::string file_prefix)
+		: m_output_directory{ std::move(output_directory) }, m_file_prefix{ std::move(file_prefix) }
+	{
+		auto error = std::error_code{};
+		std::filesystem::create_directories(m_output_directory, error);
+
+		if (error)
+		{
+			CX_CORE_ERROR("Unable to create capture directory \"{}\": {}", m_output_directory.string(), error.message());
+		}
+	}
+
+	PNGFrameEncoder::~PNGFrameEncoder()
+	{
+		Wait();
+	}
+
+	auto PNGFrameEncoder::Encode(const CapturedFrame& frame) -> void
+	{
+		Encode(frame, std::format("{}_{:06}.png", m_file_prefix, frame.m_frame_index));
+	}
+
+	auto PNGFrameEncoder::Encode(const CapturedFrame& frame, const std::filesystem::path& file_name) -> void
+	{
+		auto buffer = AcquireBuffer(frame.m_pixels.size());
+		CopyFlipped(frame, buffer.data());
+
+		// a whole PNG compression, kept off the shared queue the render thread helps draining while it waits
+		JobSystem::GetInstance().DispatchBackground([this, buffer = std::move(buffer), file_path = m_output_directory / file_name, width = frame.m_width, height = frame.m_height]() mutable {
+			const auto start_time = std::chrono::steady_clock::now();
+			const auto is_written = stbi_write_png(file_path.string().c_str(), width, height, 4, buffer.data(), width * 4) != 0;
+			m_encode_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+			if (is_written)
+			{
+				m_encoded_frames_count++;
+			}
+			else
+			{
+				m_failed_frames_count++;
+				CX_CORE_ERROR("Unable to write \"{}\"", file_path.string());
+			}
+
+			ReleaseBuffer(std::move(buffer));
+		});
+	}
+
+	auto PNGFrameEncoder::Wait() -> void
+	{
+		auto lock = std::unique_lock{ m_mutex };
+		m_pool_condition.wait(lock, [this] { return m_in_flight_count == 0; });
+	}
+
+	auto PNGFrameEncoder::AcquireBuffer(const size_t size) -> std::vector<uint8_t>
+	{
+		auto buffer = std::vector<uint8_t>{};
+		{
+			auto lock = std::unique_lock{ m_mutex };
+			m_pool_condition.wait(lock, [this] { return !m_free_buffers.empty() || m_allocated_buffers_count < constants::CaptureMaxQueuedFrames; });
+
+			if (m_free_buffers.empty())
+			{
+				m_allocated_buffers_count++;
+			}
+			else
+			{
+				buffer = std::move(m_free_buffers.back());
+				m_free_buffers.pop_back();
+			}
+
+			m_in_flight_count++;
+		}
+
+		buffer.resize(size);
+		return buffer;
+	}
+
+	auto PNGFrameEncoder::ReleaseBuffer(std::vector<uint8_t> buffer) -> void
+	{
+		{
+			const auto lock = std::scoped_lock{ m_mutex };
+			m_free_buffers.push_back(std::move(buffer));
+			m_in_flight_count--;
+		}
+		m_pool_condition.notify_all();
+	}
+
+#pragma endregion
+}
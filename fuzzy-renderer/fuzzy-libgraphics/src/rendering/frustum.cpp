@@ -0,0 +1,55 @@
+#include <rendering/frustum.h>
+
+#include <cmath>
+
+namespace libgraphics
+{
+	Frustum::Frustum(const glm::mat4& view_projection)
+	{
+		// glm is column major, rows have to be gathered by hand
+		const auto row = [&](const int row_idx) {
+			return glm::vec4{ view_projection[0][row_idx], view_projection[1][row_idx], view_projection[2][row_idx], view_projection[3][row_idx] };
+		};
+
+		const auto x = row(0);
+		const auto y = row(1);
+		const auto z = row(2);
+		const auto w = row(3);
+
+		m_planes = { w + x, w - x, w + y, w - y, w + z, w - z };
+
+		for (auto& plane : m_planes)
+		{
+			plane /= glm::length(glm::vec3{ plane });
+		}
+	}
+
+	auto Frustum::Intersects(const BoundingBox& local_bounds, const glm::mat4& model) const -> bool
+	{
+		// move the box center to world space and take the extents along the world axes
+		const auto local_center = (local_bounds.m_min + local_bounds.m_max) * 0.5f;
+		const auto local_extents = (local_bounds.m_max - local_bounds.m_min) * 0.5f;
+
+		const auto world_center = glm::vec3{ model * glm::vec4{ local_center, 1.0f } };
+
+		auto world_extents = glm::vec3{};
+		for (auto axis = 0; axis != 3; ++axis)
+		{
+			world_extents[axis] = std::abs(model[0][axis]) * local_extents.x + std::abs(model[1][axis]) * local_extents.y + std::abs(model[2][axis]) * local_extents.z;
+		}
+
+		for (const auto& plane : m_planes)
+		{
+			const auto normal = glm::vec3{ plane };
+			const auto radius = glm::dot(world_extents, glm::abs(normal));
+			const auto distance = glm::dot(normal, world_center) + plane.w;
+
+			if (distance < -radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
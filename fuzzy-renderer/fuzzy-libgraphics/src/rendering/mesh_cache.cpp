@@ -0,0 +1,426 @@
+#include <rendering/mesh_cache.h>
+
+#include <asset_file_system.h>
+#include <engine_constants.h>
+#include <logger.h>
+#include <render_profiler.h>
+
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <type_traits>
+
+namespace libgraphics
+{
+	namespace
+	{
+		constexpr auto MeshCacheMagic = std::array<char, 8>{ 'F', 'Z', 'M', 'E', 'S', 'H', '\r', '\n' };
+
+		// bumped whenever the layout below or what the import produces changes, older caches are then rebuilt
+		constexpr uint32_t MeshCacheVersion = 1;
+
+		constexpr uint64_t MeshCacheAlignment = 16;
+
+		// every record is a multiple of the alignment, so the arrays of records stay aligned as well
+		struct FileHeader
+		{
+			std::array<char, 8> m_magic = {};
+			uint32_t m_version = {};
+			uint32_t m_vertex_size = {};
+			uint32_t m_textures_count = {};
+			uint32_t m_meshes_count = {};
+			uint32_t m_nodes_count = {};
+			uint32_t m_padding = {};
+			uint64_t m_textures_offset = {};
+			uint64_t m_meshes_offset = {};
+			uint64_t m_nodes_offset = {};
+			uint64_t m_file_size = {};
+		};
+
+		struct TextureRecord
+		{
+			uint64_t m_source_offset = {};
+			uint32_t m_source_size = {};
+			uint32_t m_type = {};
+			uint64_t m_embedded_offset = {};
+			uint64_t m_embedded_size = {};
+			uint32_t m_embedded_width = {};
+			uint32_t m_embedded_height = {};
+			uint32_t m_has_embedded = {};
+			uint32_t m_padding = {};
+		};
+
+		struct MeshRecord
+		{
+			uint64_t m_name_offset = {};
+			uint32_t m_name_size = {};
+			uint32_t m_vertices_count = {};
+			uint64_t m_vertices_offset = {};
+			uint64_t m_indices_offset = {};
+			uint32_t m_indices_count = {};
+			uint32_t m_textures_count = {};
+			uint64_t m_textures_offset = {};
+			uint64_t m_lods_offset = {};
+			uint32_t m_lods_count = {};
+			std::array<float, 6> m_bounds = {};
+			std::array<uint32_t, 3> m_padding = {};
+		};
+
+		struct NodeRecord
+		{
+			std::array<float, 16> m_transform = {};
+			uint64_t m_name_offset = {};
+			uint32_t m_name_size = {};
+			int32_t m_parent = {};
+			uint64_t m_meshes_offset = {};
+			uint32_t m_meshes_count = {};
+			uint32_t m_padding = {};
+		};
+
+		static_assert(sizeof(FileHeader) == 64 && sizeof(TextureRecord) == 48 && sizeof(MeshRecord) == 96 && sizeof(NodeRecord) == 96);
+		static_assert(std::is_trivially_copyable_v<Vertex> && std::is_trivially_copyable_v<MeshLodRange>);
+
+		/**
+		 * \brief Grows the file image, every array appended starts aligned.
+		 */
+		class CacheWriter
+		{
+		public:
+			auto Reserve(const uint64_t size) -> uint64_t
+			{
+				const auto offset = Align();
+				m_bytes.resize(offset + size);
+				return offset;
+			}
+
+			template <typename T>
+			auto Append(const std::span<const T> values) -> uint64_t
+			{
+				const auto offset = Reserve(values.size_bytes());
+				if (!values.empty())
+				{
+					std::memcpy(m_bytes.data() + offset, values.data(), values.size_bytes());
+				}
+				return offset;
+			}
+
+			auto Append(const std::string_view text) -> uint64_t { return Append(std::span{ text.data(), text.size() }); }
+
+			template <typename T>
+			auto Write(const uint64_t offset, const T& value) -> void { std::memcpy(m_bytes.data() + offset, &value, sizeof(T)); }
+
+			[[nodiscard]] auto GetBytes() -> std::vector<uint8_t>& { return m_bytes; }
+
+		private:
+			auto Align() -> uint64_t
+			{
+				const auto offset = (m_bytes.size() + MeshCacheAlignment - 1) / MeshCacheAlignment * MeshCacheAlignment;
+				m_bytes.resize(offset);
+				return offset;
+			}
+
+			std::vector<uint8_t> m_bytes = {};
+		};
+
+		/**
+		 * \brief count values of T at offset in the mapped file
+		 * \return nothing when they aren't inside it or not aligned for T
+		 */
+		template <typename T>
+		auto GetArray(const std::span<const uint8_t> file, const uint64_t offset, const uint64_t count) -> std::optional<std::span<const T>>
+		{
+			if (offset > file.size() || count > (file.size() - offset) / sizeof(T) || offset % alignof(T) != 0)
+			{
+				return std::nullopt;
+			}
+
+			// the file was written from arrays of T, the mapping is page aligned
+			return std::span{ reinterpret_cast<const T*>(file.data() + offset), static_cast<size_t>(count) };
+		}
+
+		auto GetText(const std::span<const uint8_t> file, const uint64_t offset, const uint64_t size) -> std::optional<std::string_view>
+		{
+			const auto chars = GetArray<char>(file, offset, size);
+			return chars ? std::optional{ std::string_view{ chars->data(), chars->size() } } : std::nullopt;
+		}
+
+		auto ReadContents(const std::span<const uint8_t> file) -> std::optional<MeshCacheContents>
+		{
+			const auto header_bytes = GetArray<FileHeader>(file, 0, 1);
+			if (!header_bytes)
+			{
+				return std::nullopt;
+			}
+
+			const auto& header = header_bytes->front();
+			if (header.m_magic != MeshCacheMagic || header.m_version != MeshCacheVersion || header.m_vertex_size != sizeof(Vertex) || header.m_file_size != file.size())
+			{
+				return std::nullopt;
+			}
+
+			const auto texture_records = GetArray<TextureRecord>(file, header.m_textures_offset, header.m_textures_count);
+			const auto mesh_records = GetArray<MeshRecord>(file, header.m_meshes_offset, header.m_meshes_count);
+			const auto node_records = GetArray<NodeRecord>(file, header.m_nodes_offset, header.m_nodes_count);
+			if (!texture_records || !mesh_records || !node_records)
+			{
+				return std::nullopt;
+			}
+
+			auto contents = MeshCacheContents{};
+			contents.m_textures.reserve(texture_records->size());
+			contents.m_meshes.reserve(mesh_records->size());
+			contents.m_nodes.reserve(node_records->size());
+
+			for (const auto& record : *texture_records)
+			{
+				auto& texture = contents.m_textures.emplace_back();
+				const auto source = GetText(file, record.m_source_offset, record.m_source_size);
+				if (!source)
+				{
+					return std::nullopt;
+				}
+				texture.m_source = source.value();
+				texture.m_type = static_cast<TextureType>(record.m_type);
+
+				if (record.m_has_embedded)
+				{
+					const auto data = GetArray<uint8_t>(file, record.m_embedded_offset, record.m_embedded_size);
+					if (!data)
+					{
+						return std::nullopt;
+					}
+					texture.m_embedded = EmbeddedImage{ data.value(), record.m_embedded_width, record.m_embedded_height };
+				}
+			}
+
+			for (const auto& record : *mesh_records)
+			{
+				const auto name = GetText(file, record.m_name_offset, record.m_name_size);
+				const auto vertices = GetArray<Vertex>(file, record.m_vertices_offset, record.m_vertices_count);
+				const auto indices = GetArray<uint32_t>(file, record.m_indices_offset, record.m_indices_count);
+				const auto textures = GetArray<uint32_t>(file, record.m_textures_offset, record.m_textures_count);
+				const auto lods = GetArray<MeshLodRange>(file, record.m_lods_offset, record.m_lods_count);
+				if (!name || !vertices || !indices || !textures || !lods || lods->empty())
+				{
+					return std::nullopt;
+				}
+
+				// indices are checked against the vertices as the import copies them, a pass here would read them twice
+				for (const auto texture_idx : *textures)
+				{
+					if (texture_idx >= contents.m_textures.size())
+					{
+						return std::nullopt;
+					}
+				}
+
+				for (const auto& lod : *lods)
+				{
+					if (lod.m_first_index > indices->size() || lod.m_indices_count > indices->size() - lod.m_first_index)
+					{
+						return std::nullopt;
+					}
+				}
+
+				const auto& bounds = record.m_bounds;
+				contents.m_meshes.push_back({ name.value(), vertices.value(), indices.value(), { { bounds[0], bounds[1], bounds[2] }, { bounds[3], bounds[4], bounds[5] } }, textures.value(), lods.value() });
+			}
+
+			for (const auto& record : *node_records)
+			{
+				const auto name = GetText(file, record.m_name_offset, record.m_name_size);
+				const auto meshes = GetArray<uint32_t>(file, record.m_meshes_offset, record.m_meshes_count);
+				if (!name || !meshes || record.m_parent >= static_cast<int32_t>(contents.m_nodes.size()))
+				{
+					return std::nullopt;
+				}
+
+				for (const auto mesh_idx : *meshes)
+				{
+					if (mesh_idx >= contents.m_meshes.size())
+					{
+						return std::nullopt;
+					}
+				}
+
+				auto& node = contents.m_nodes.emplace_back();
+				node.m_name = name.value();
+				node.m_parent = record.m_parent;
+				// column major, like glm stores it
+				for (auto column = 0; column != 4; ++column)
+				{
+					for (auto row = 0; row != 4; ++row)
+					{
+						node.m_transform[column][row] = record.m_transform[column * 4 + row];
+					}
+				}
+				node.m_meshes = meshes.value();
+			}
+
+			return contents;
+		}
+	}
+
+	auto GetMeshCachePath(const std::filesystem::path& model_path, const uint32_t import_flags) -> std::optional<std::filesystem::path>
+	{
+		CX_PROFILE_FUNCTION();
+
+		const auto model_file = AssetFileSystem::GetInstance().Read(model_path);
+		if (!model_file)
+		{
+			return std::nullopt;
+		}
+
+		// FNV-1a over 8 byte words, byte by byte hashing big models would cost a good part of what the cache saves
+		const auto data = model_file->m_bytes;
+		auto hash = uint64_t{ 14695981039346656037ull };
+		auto byte_idx = size_t{ 0 };
+		for (; byte_idx + sizeof(uint64_t) <= data.size(); byte_idx += sizeof(uint64_t))
+		{
+			auto word = uint64_t{};
+			std::memcpy(&word, data.data() + byte_idx, sizeof(word));
+			hash = (hash ^ word) * 1099511628211ull;
+		}
+		for (; byte_idx != data.size(); ++byte_idx)
+		{
+			hash = (hash ^ data[byte_idx]) * 1099511628211ull;
+		}
+
+		const auto file_name = std::format("{}-{:016x}-{:08x}.fzmesh", model_path.stem().string(), hash, import_flags);
+		return std::filesystem::path{ constants::MeshCacheDirectory } / file_name;
+	}
+
+	auto WriteMeshCache(const std::filesystem::path& cache_path, const MeshCacheContents& contents) -> bool
+	{
+		CX_PROFILE_FUNCTION();
+
+		auto writer = CacheWriter{};
+		const auto header_offset = writer.Reserve(sizeof(FileHeader));
+		const auto textures_offset = writer.Reserve(contents.m_textures.size() * sizeof(TextureRecord));
+		const auto meshes_offset = writer.Reserve(contents.m_meshes.size() * sizeof(MeshRecord));
+		const auto nodes_offset = writer.Reserve(contents.m_nodes.size() * sizeof(NodeRecord));
+
+		for (auto texture_idx = size_t{ 0 }; texture_idx != contents.m_textures.size(); ++texture_idx)
+		{
+			const auto& texture = contents.m_textures[texture_idx];
+
+			auto record = TextureRecord{};
+			record.m_source_offset = writer.Append(texture.m_source);
+			record.m_source_size = static_cast<uint32_t>(texture.m_source.size());
+			record.m_type = static_cast<uint32_t>(texture.m_type);
+			if (texture.m_embedded)
+			{
+				record.m_embedded_offset = writer.Append(texture.m_embedded->m_data);
+				record.m_embedded_size = texture.m_embedded->m_data.size();
+				record.m_embedded_width = texture.m_embedded->m_width;
+				record.m_embedded_height = texture.m_embedded->m_height;
+				record.m_has_embedded = 1;
+			}
+
+			writer.Write(textures_offset + texture_idx * sizeof(TextureRecord), record);
+		}
+
+		for (auto mesh_idx = size_t{ 0 }; mesh_idx != contents.m_meshes.size(); ++mesh_idx)
+		{
+			const auto& mesh = contents.m_meshes[mesh_idx];
+			const auto& bounds = mesh.m_bounds;
+
+			auto record = MeshRecord{};
+			record.m_name_offset = writer.Append(mesh.m_name);
+			record.m_name_size = static_cast<uint32_t>(mesh.m_name.size());
+			record.m_vertices_offset = writer.Append(mesh.m_vertices);
+			record.m_vertices_count = static_cast<uint32_t>(mesh.m_vertices.size());
+			record.m_indices_offset = writer.Append(mesh.m_indices);
+			record.m_indices_count = static_cast<uint32_t>(mesh.m_indices.size());
+			record.m_textures_offset = writer.Append(mesh.m_textures);
+			record.m_textures_count = static_cast<uint32_t>(mesh.m_textures.size());
+			record.m_lods_offset = writer.Append(mesh.m_lods);
+			record.m_lods_count = static_cast<uint32_t>(mesh.m_lods.size());
+			record.m_bounds = { bounds.m_min.x, bounds.m_min.y, bounds.m_min.z, bounds.m_max.x, bounds.m_max.y, bounds.m_max.z };
+
+			writer.Write(meshes_offset + mesh_idx * sizeof(MeshRecord), record);
+		}
+
+		for (auto node_idx = size_t{ 0 }; node_idx != contents.m_nodes.size(); ++node_idx)
+		{
+			const auto& node = contents.m_nodes[node_idx];
+
+			auto record = NodeRecord{};
+			for (auto column = 0; column != 4; ++column)
+			{
+				for (auto row = 0; row != 4; ++row)
+				{
+					record.m_transform[column * 4 + row] = node.m_transform[column][row];
+				}
+			}
+			record.m_name_offset = writer.Append(node.m_name);
+			record.m_name_size = static_cast<uint32_t>(node.m_name.size());
+			record.m_parent = node.m_parent;
+			record.m_meshes_offset = writer.Append(node.m_meshes);
+			record.m_meshes_count = static_cast<uint32_t>(node.m_meshes.size());
+
+			writer.Write(nodes_offset + node_idx * sizeof(NodeRecord), record);
+		}
+
+		auto& bytes = writer.GetBytes();
+
+		auto header = FileHeader{};
+		header.m_magic = MeshCacheMagic;
+		header.m_version = MeshCacheVersion;
+		header.m_vertex_size = sizeof(Vertex);
+		header.m_textures_count = static_cast<uint32_t>(contents.m_textures.size());
+		header.m_meshes_count = static_cast<uint32_t>(contents.m_meshes.size());
+		header.m_nodes_count = static_cast<uint32_t>(contents.m_nodes.size());
+		header.m_textures_offset = textures_offset;
+		header.m_meshes_offset = meshes_offset;
+		header.m_nodes_offset = nodes_offset;
+		header.m_file_size = bytes.size();
+		writer.Write(header_offset, header);
+
+		auto error = std::error_code{};
+		std::filesystem::create_directories(cache_path.parent_path(), error);
+
+		auto temporary_path = cache_path;
+		temporary_path += ".tmp";
+
+		{
+			auto file = std::ofstream{ temporary_path, std::ios::binary | std::ios::trunc };
+			if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+			{
+				CX_CORE_WARN("Unable to write mesh cache {}", temporary_path.string());
+				return false;
+			}
+		}
+
+		std::filesystem::rename(temporary_path, cache_path, error);
+		if (error)
+		{
+			CX_CORE_WARN("Unable to write mesh cache {}: {}", cache_path.string(), error.message());
+			std::filesystem::remove(temporary_path, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	auto OpenMeshCache(const std::filesystem::path& cache_path) -> std::optional<MappedMeshCache>
+	{
+		CX_PROFILE_FUNCTION();
+
+		auto file = MappedFile::Open(cache_path);
+		if (!file)
+		{
+			return std::nullopt;
+		}
+
+		auto contents = ReadContents(file->GetData());
+		if (!contents)
+		{
+			CX_CORE_WARN("Ignoring malformed or outdated mesh cache {}", cache_path.string());
+			return std::nullopt;
+		}
+
+		return MappedMeshCache{ std::move(file.value()), std::move(contents.value()) };
+	}
+}
@@ -0,0 +1,44 @@
+#include <rendering/mesh_data.h>
+
+#include <algorithm>
+
+namespace libgraphics
+{
+	MeshData::MeshData(std::vector<Vertex> vertices, std::vector<uint32_t> indices, const std::string& detail)
+		: m_vertices{ std::move(vertices) }, m_indices{ std::move(indices) }
+	{
+		TrackMemory(detail);
+	}
+
+	MeshData::MeshData(std::vector<glm::vec3> positions, std::vector<uint32_t> indices, const std::string& detail)
+		: m_positions{ std::move(positions) }, m_indices{ std::move(indices) }
+	{
+		TrackMemory(detail);
+	}
+
+	auto MeshData::MakePickingCopy(const std::string& detail) const -> std::shared_ptr<const MeshData>
+	{
+		auto positions = std::vector<glm::vec3>{};
+		if (m_vertices.empty())
+		{
+			positions = m_positions;
+		}
+		else
+		{
+			positions.resize(m_vertices.size());
+			std::ranges::transform(m_vertices, positions.begin(), &Vertex::m_position);
+		}
+
+		// not make_shared, the constructor is private
+		return std::shared_ptr<const MeshData>{ new MeshData{ std::move(positions), m_indices, detail } };
+	}
+
+	auto MeshData::TrackMemory(const std::string& detail) -> void
+	{
+		const auto bytes = m_vertices.size() * sizeof(Vertex) + m_positions.size() * sizeof(glm::vec3) + m_indices.size() * sizeof(uint32_t);
+		if (bytes != 0)
+		{
+			m_memory = TrackedMemory{ MemoryCategory::mesh_cpu_copy, bytes, detail };
+		}
+	}
+}
@@ -0,0 +1,539 @@
+#include <rendering/render_graph.h>
+
+#include <logger.h>
+#include <render_profiler.h>
+#include <opengl/gl_state_cache.h>
+
+#include <algorithm>
+#include <format>
+#include <optional>
+#include <ranges>
+#include <stack>
+
+namespace libgraphics
+{
+	auto IsDepthFormat(const GLenum internal_format) -> bool
+	{
+		switch (internal_format)
+		{
+		case GL_DEPTH_COMPONENT16:
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32F:
+		case GL_DEPTH24_STENCIL8:
+		case GL_DEPTH32F_STENCIL8: return true;
+		default: return false;
+		}
+	}
+
+	auto HasStencil(const GLenum internal_format) -> bool
+	{
+		return internal_format == GL_DEPTH24_STENCIL8 || internal_format == GL_DEPTH32F_STENCIL8;
+	}
+
+	// Bytes of a texel of the sized formats pooled textures are created with, for the memory accounting.
+	auto GetTexelSize(const GLenum internal_format) -> size_t
+	{
+		switch (internal_format)
+		{
+		case GL_R8: return 1;
+		case GL_R16F:
+		case GL_RG8:
+		case GL_DEPTH_COMPONENT16: return 2;
+		case GL_DEPTH_COMPONENT24:
+		case GL_RGB8: return 3;
+		case GL_R32F:
+		case GL_RG16F:
+		case GL_RGBA8:
+		case GL_SRGB8_ALPHA8:
+		case GL_R11F_G11F_B10F:
+		case GL_RGB10_A2:
+		case GL_DEPTH_COMPONENT32F:
+		case GL_DEPTH24_STENCIL8: return 4;
+		case GL_RG32F:
+		case GL_RGBA16F:
+		case GL_DEPTH32F_STENCIL8: return 8;
+		case GL_RGBA32F: return 16;
+		default: return 4;
+		}
+	}
+
+	// Barrier needed before a pass accesses (reader_access) something that was last written with writer_access.
+	// Only incoherent writes (image/buffer stores) need one: render target writes followed by sampling are ordered by GL itself.
+	auto ComputeBarrier(const RenderResourceType type, const RenderResourceAccess writer_access, const RenderResourceAccess reader_access) -> GLbitfield
+	{
+		if (writer_access != RenderResourceAccess::storage)
+		{
+			return {};
+		}
+
+		if (type == RenderResourceType::texture)
+		{
+			switch (reader_access)
+			{
+			case RenderResourceAccess::render_target: return GL_FRAMEBUFFER_BARRIER_BIT;
+			case RenderResourceAccess::sampled: return GL_TEXTURE_FETCH_BARRIER_BIT;
+			case RenderResourceAccess::storage: return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+			default: return GL_ALL_BARRIER_BITS;
+			}
+		}
+
+		switch (reader_access)
+		{
+		case RenderResourceAccess::uniform: return GL_UNIFORM_BARRIER_BIT;
+		case RenderResourceAccess::vertex: return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT;
+		case RenderResourceAccess::storage: return GL_SHADER_STORAGE_BARRIER_BIT;
+		default: return GL_ALL_BARRIER_BITS;
+		}
+	}
+
+#pragma region BUILDER / CONTEXT
+
+	auto RenderGraphBuilder::CreateTexture(const std::string_view name, const RenderTextureDesc& desc) const -> RenderResourceHandle
+	{
+		const auto handle = m_graph.CreateResource(name, RenderResourceType::texture);
+		m_graph.m_resources[m_graph.m_nodes[handle].m_resource].m_texture_desc = desc;
+		return handle;
+	}
+
+	auto RenderGraphBuilder::CreateBuffer(const std::string_view name, const RenderBufferDesc& desc) const -> RenderResourceHandle
+	{
+		const auto handle = m_graph.CreateResource(name, RenderResourceType::buffer);
+		m_graph.m_resources[m_graph.m_nodes[handle].m_resource].m_buffer_desc = desc;
+		return handle;
+	}
+
+	auto RenderGraphBuilder::Read(const RenderResourceHandle handle, const RenderResourceAccess access) const -> RenderResourceHandle
+	{
+		auto& pass = m_graph.m_passes[m_pass_index];
+		if (std::ranges::find(pass.m_reads, handle, &RenderGraph::ResourceAccessInfo::m_node) == pass.m_reads.end())
+		{
+			pass.m_reads.push_back({ handle, access });
+		}
+		return handle;
+	}
+
+	auto RenderGraphBuilder::Write(const RenderResourceHandle handle, const RenderResourceAccess access) const -> RenderResourceHandle
+	{
+		// the previous version is kept (load), so it becomes a dependency of this pass only if somebody produced it
+		if (m_graph.m_nodes[handle].m_producer != std::numeric_limits<uint32_t>::max())
+		{
+			Read(handle, access);
+		}
+
+		const auto new_handle = static_cast<RenderResourceHandle>(m_graph.m_nodes.size());
+		m_graph.m_nodes.push_back({ m_graph.m_nodes[handle].m_resource, m_pass_index, 0, access });
+		m_graph.m_passes[m_pass_index].m_writes.push_back({ new_handle, access });
+
+		return new_handle;
+	}
+
+	auto RenderGraphBuilder::SideEffect() const -> void
+	{
+		m_graph.m_passes[m_pass_index].m_has_side_effect = true;
+	}
+
+	auto RenderPassContext::GetTexture(const RenderResourceHandle handle) const -> GLuint
+	{
+		return m_graph.m_resources[m_graph.m_nodes[handle].m_resource].m_id;
+	}
+
+	auto RenderPassContext::GetBuffer(const RenderResourceHandle handle) const -> GLuint
+	{
+		return m_graph.m_resources[m_graph.m_nodes[handle].m_resource].m_id;
+	}
+
+	auto RenderPassContext::GetTextureDesc(const RenderResourceHandle handle) const -> const RenderTextureDesc&
+	{
+		return m_graph.m_resources[m_graph.m_nodes[handle].m_resource].m_texture_desc;
+	}
+
+#pragma endregion
+
+	RenderGraph::~RenderGraph()
+	{
+		TrimPool(0);
+	}
+
+	auto RenderGraph::Reset() -> void
+	{
+		m_passes.clear();
+		m_resources.clear();
+		m_nodes.clear();
+		m_compiled = false;
+		m_culled_passes_count = {};
+	}
+
+	auto RenderGraph::AddPass(const std::string_view name, const RenderPassSetup& setup, RenderPassExecute execute) -> void
+	{
+		const auto pass_index = static_cast<uint32_t>(m_passes.size());
+		m_passes.push_back({ std::string{ name }, utils::profiling::RenderProfiler::GetInstance().InternName(name), std::move(execute) });
+
+		auto builder = RenderGraphBuilder{ *this, pass_index };
+		setup(builder);
+	}
+
+	auto RenderGraph::ImportBackbuffer(const std::string_view name, const RenderTextureDesc& desc, const GLuint framebuffer_id) -> RenderResourceHandle
+	{
+		// for the backbuffer the id is the framebuffer itself, not a texture
+		const auto handle = ImportTexture(name, framebuffer_id, desc);
+		m_resources[m_nodes[handle].m_resource].m_backbuffer = true;
+		return handle;
+	}
+
+	auto RenderGraph::ImportTexture(const std::string_view name, const GLuint texture_id, const RenderTextureDesc& desc) -> RenderResourceHandle
+	{
+		const auto handle = CreateResource(name, RenderResourceType::texture);
+		auto& resource = m_resources[m_nodes[handle].m_resource];
+		resource.m_texture_desc = desc;
+		resource.m_id = texture_id;
+		resource.m_imported = true;
+		return handle;
+	}
+
+	auto RenderGraph::CreateResource(const std::string_view name, const RenderResourceType type) -> RenderResourceHandle
+	{
+		const auto resource_index = static_cast<uint32_t>(m_resources.size());
+		m_resources.push_back({ std::string{ name }, type });
+
+		const auto handle = static_cast<RenderResourceHandle>(m_nodes.size());
+		m_nodes.push_back({ resource_index });
+		return handle;
+	}
+
+	auto RenderGraph::Compile() -> void
+	{
+		CX_PROFILE_FUNCTION();
+
+		// 1) reference counts: a pass is referenced by every version it writes, a version by every pass reading it
+		for (auto& pass : m_passes)
+		{
+			pass.m_ref_count = static_cast<uint32_t>(pass.m_writes.size());
+			for (const auto& read : pass.m_reads)
+			{
+				m_nodes[read.m_node].m_ref_count++;
+			}
+		}
+
+		// 2) cull: start from unreferenced versions of transient resources and walk back to their producers
+		auto unreferenced = std::stack<RenderResourceHandle>{};
+		for (auto node_idx = 0u; node_idx != m_nodes.size(); ++node_idx)
+		{
+			if (m_nodes[node_idx].m_ref_count == 0 && !m_resources[m_nodes[node_idx].m_resource].m_imported)
+			{
+				unreferenced.push(node_idx);
+			}
+		}
+
+		while (!unreferenced.empty())
+		{
+			const auto& node = m_nodes[unreferenced.top()];
+			unreferenced.pop();
+
+			if (node.m_producer == std::numeric_limits<uint32_t>::max())
+			{
+				continue;
+			}
+
+			auto& producer = m_passes[node.m_producer];
+			if (producer.m_has_side_effect || producer.m_ref_count == 0)
+			{
+				continue;
+			}
+
+			if (--producer.m_ref_count == 0)
+			{
+				for (const auto& read : producer.m_reads)
+				{
+					if (auto& read_node = m_nodes[read.m_node]; --read_node.m_ref_count == 0 && !m_resources[read_node.m_resource].m_imported)
+					{
+						unreferenced.push(read.m_node);
+					}
+				}
+			}
+		}
+
+		// 3) lifetimes and barriers of the surviving passes (declaration order is the execution order)
+		for (auto pass_idx = 0u; pass_idx != m_passes.size(); ++pass_idx)
+		{
+			auto& pass = m_passes[pass_idx];
+			if (pass.m_ref_count == 0 && !pass.m_has_side_effect)
+			{
+				m_culled_passes_count++;
+				continue;
+			}
+
+			for (const auto& [node_handle, access] : pass.m_reads)
+			{
+				const auto& node = m_nodes[node_handle];
+				auto& resource = m_resources[node.m_resource];
+				resource.m_first_pass = std::min(resource.m_first_pass, pass_idx);
+				resource.m_last_pass = std::max(resource.m_last_pass, pass_idx);
+
+				if (node.m_producer != std::numeric_limits<uint32_t>::max())
+				{
+					pass.m_barriers |= ComputeBarrier(resource.m_type, node.m_last_write_access, access);
+				}
+			}
+
+			for (const auto& write : pass.m_writes)
+			{
+				auto& resource = m_resources[m_nodes[write.m_node].m_resource];
+				resource.m_first_pass = std::min(resource.m_first_pass, pass_idx);
+				resource.m_last_pass = std::max(resource.m_last_pass, pass_idx);
+			}
+		}
+
+		for (auto resource_idx = 0u; resource_idx != m_resources.size(); ++resource_idx)
+		{
+			const auto& resource = m_resources[resource_idx];
+			if (resource.m_imported || resource.m_first_pass == std::numeric_limits<uint32_t>::max())
+			{
+				continue;
+			}
+
+			m_passes[resource.m_first_pass].m_acquire.push_back(resource_idx);
+			m_passes[resource.m_last_pass].m_release.push_back(resource_idx);
+		}
+
+		m_compiled = true;
+	}
+
+	auto RenderGraph::Execute() -> void
+	{
+		if (!m_compiled)
+		{
+			CX_CORE_ERROR("RenderGraph::Execute() called before Compile()");
+			return;
+		}
+
+		for (auto& pooled_texture : m_texture_pool) { pooled_texture.m_unused_frames++; }
+		for (auto& pooled_buffer : m_buffer_pool) { pooled_buffer.m_unused_frames++; }
+
+		const auto context = RenderPassContext{ *this };
+
+		for (auto& pass : m_passes)
+		{
+			if (pass.m_ref_count == 0 && !pass.m_has_side_effect)
+			{
+				continue;
+			}
+
+			for (const auto resource_idx : pass.m_acquire)
+			{
+				auto& resource = m_resources[resource_idx];
+				resource.m_id = resource.m_type == RenderResourceType::texture ? AcquireTexture(resource.m_texture_desc) : AcquireBuffer(resource.m_buffer_desc);
+			}
+
+			CX_PROFILE_ZONE(pass.m_profile_name);
+			CX_PROFILE_GPU_ZONE(pass.m_profile_name);
+
+			if (pass.m_barriers)
+			{
+				glMemoryBarrier(pass.m_barriers);
+			}
+
+			BindPassFramebuffer(pass);
+
+			if (pass.m_execute)
+			{
+				pass.m_execute(context);
+			}
+
+			// whatever ends its lifetime here goes back to the pool and can be aliased by the next passes
+			for (const auto resource_idx : pass.m_release)
+			{
+				const auto& resource = m_resources[resource_idx];
+				resource.m_type == RenderResourceType::texture ? ReleaseTexture(resource.m_id) : ReleaseBuffer(resource.m_id);
+			}
+		}
+	}
+
+	auto RenderGraph::BindPassFramebuffer(const RenderPass& pass) -> void
+	{
+		auto color_attachments = std::vector<GLuint>{};
+		auto depth_attachment = GLuint{};
+		auto depth_format = GLenum{};
+		auto target_desc = std::optional<RenderTextureDesc>{};
+		auto writes_backbuffer = false;
+		auto backbuffer_id = GLuint{};
+
+		for (const auto& [node_handle, access] : pass.m_writes)
+		{
+			const auto& resource = m_resources[m_nodes[node_handle].m_resource];
+			if (resource.m_type != RenderResourceType::texture || access != RenderResourceAccess::render_target)
+			{
+				continue;
+			}
+
+			target_desc = resource.m_texture_desc;
+
+			if (resource.m_backbuffer)
+			{
+				writes_backbuffer = true;
+				backbuffer_id = resource.m_id;
+			}
+			else if (IsDepthFormat(resource.m_texture_desc.m_internal_format))
+			{
+				depth_attachment = resource.m_id;
+				depth_format = resource.m_texture_desc.m_internal_format;
+			}
+			else
+			{
+				color_attachments.push_back(resource.m_id);
+			}
+		}
+
+		if (!target_desc.has_value())
+		{
+			return;
+		}
+
+		auto& state_cache = GLStateCache::GetInstance();
+
+		if (writes_backbuffer)
+		{
+			if (!color_attachments.empty() || depth_attachment)
+			{
+				CX_CORE_ERROR("RenderGraph: pass '{}' writes both the backbuffer and offscreen targets, only the backbuffer is bound", pass.m_name);
+			}
+
+			state_cache.BindFramebuffer(GL_FRAMEBUFFER, backbuffer_id);
+			state_cache.Viewport(0, 0, target_desc->m_width, target_desc->m_height);
+			return;
+		}
+
+		auto key = std::string{};
+		for (const auto id : color_attachments) { key += std::format("c{}", id); }
+		key += std::format("d{}", depth_attachment);
+
+		auto [it, inserted] = m_framebuffers.try_emplace(key, GLuint{});
+		if (inserted)
+		{
+			glGenFramebuffers(1, &it->second);
+			state_cache.BindFramebuffer(GL_FRAMEBUFFER, it->second);
+
+			auto draw_buffers = std::vector<GLenum>{};
+			for (auto attachment_idx = 0u; attachment_idx != color_attachments.size(); ++attachment_idx)
+			{
+				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachment_idx, GL_TEXTURE_2D, color_attachments[attachment_idx], 0);
+				draw_buffers.push_back(GL_COLOR_ATTACHMENT0 + attachment_idx);
+			}
+
+			if (depth_attachment)
+			{
+				glFramebufferTexture2D(GL_FRAMEBUFFER, HasStencil(depth_format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth_attachment, 0);
+			}
+
+			glDrawBuffers(static_cast<GLsizei>(draw_buffers.size()), draw_buffers.data());
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				CX_CORE_ERROR("RenderGraph: framebuffer for pass '{}' is incomplete", pass.m_name);
+			}
+		}
+		else
+		{
+			state_cache.BindFramebuffer(GL_FRAMEBUFFER, it->second);
+		}
+
+		state_cache.Viewport(0, 0, target_desc->m_width, target_desc->m_height);
+	}
+
+#pragma region POOL
+
+	auto RenderGraph::AcquireTexture(const RenderTextureDesc& desc) -> GLuint
+	{
+		if (const auto it = std::ranges::find_if(m_texture_pool, [&](const PooledTexture& texture) { return !texture.m_in_use && texture.m_desc == desc; }); it != m_texture_pool.end())
+		{
+			it->m_in_use = true;
+			it->m_unused_frames = {};
+			return it->m_id;
+		}
+
+		auto texture_id = GLuint{};
+		glGenTextures(1, &texture_id);
+		GLStateCache::GetInstance().BindTexture(0, GL_TEXTURE_2D, texture_id);
+		glTexStorage2D(GL_TEXTURE_2D, 1, desc.m_internal_format, desc.m_width, desc.m_height);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		const auto bytes = ComputeTextureBytes(desc.m_width, desc.m_height, GetTexelSize(desc.m_internal_format), false);
+		m_texture_pool.push_back({ desc, texture_id, true, 0, TrackedMemory{ MemoryCategory::render_target, bytes, std::format("render graph texture {}x{}", desc.m_width, desc.m_height) } });
+		return texture_id;
+	}
+
+	auto RenderGraph::ReleaseTexture(const GLuint id) -> void
+	{
+		if (const auto it = std::ranges::find(m_texture_pool, id, &PooledTexture::m_id); it != m_texture_pool.end())
+		{
+			it->m_in_use = false;
+			it->m_unused_frames = {};
+		}
+	}
+
+	auto RenderGraph::AcquireBuffer(const RenderBufferDesc& desc) -> GLuint
+	{
+		if (const auto it = std::ranges::find_if(m_buffer_pool, [&](const PooledBuffer& buffer) { return !buffer.m_in_use && buffer.m_desc == desc; }); it != m_buffer_pool.end())
+		{
+			it->m_in_use = true;
+			it->m_unused_frames = {};
+			return it->m_id;
+		}
+
+		auto buffer_id = GLuint{};
+		glGenBuffers(1, &buffer_id);
+		GLStateCache::GetInstance().BindBuffer(GL_SHADER_STORAGE_BUFFER, buffer_id);
+		glBufferStorage(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(desc.m_size), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		m_buffer_pool.push_back({ desc, buffer_id, true, 0, TrackedMemory{ MemoryCategory::storage_buffer, desc.m_size, "render graph buffer" } });
+		return buffer_id;
+	}
+
+	auto RenderGraph::ReleaseBuffer(const GLuint id) -> void
+	{
+		if (const auto it = std::ranges::find(m_buffer_pool, id, &PooledBuffer::m_id); it != m_buffer_pool.end())
+		{
+			it->m_in_use = false;
+			it->m_unused_frames = {};
+		}
+	}
+
+	auto RenderGraph::TrimPool(const uint32_t max_unused_frames) -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+		auto released_any = false;
+
+		std::erase_if(m_texture_pool, [&](const PooledTexture& texture) {
+			if (texture.m_in_use || texture.m_unused_frames < max_unused_frames) return false;
+			state_cache.DeleteTexture(texture.m_id);
+			released_any = true;
+			return true;
+		});
+
+		std::erase_if(m_buffer_pool, [&](const PooledBuffer& buffer) {
+			if (buffer.m_in_use || buffer.m_unused_frames < max_unused_frames) return false;
+			state_cache.DeleteBuffer(buffer.m_id);
+			return true;
+		});
+
+		// cached framebuffers may reference released attachments, they are cheap to rebuild
+		if (released_any)
+		{
+			ReleaseFramebuffers();
+		}
+	}
+
+	auto RenderGraph::ReleaseFramebuffers() -> void
+	{
+		auto& state_cache = GLStateCache::GetInstance();
+		for (const auto& framebuffer_id : std::views::values(m_framebuffers))
+		{
+			state_cache.DeleteFramebuffer(framebuffer_id);
+		}
+		m_framebuffers.clear();
+	}
+
+#pragma endregion
+}
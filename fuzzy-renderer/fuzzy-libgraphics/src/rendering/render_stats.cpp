@@ -0,0 +1,66 @@
+#include <rendering/render_stats.h>
+#include <engine_constants.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace libgraphics
+{
+	auto RenderStats::GetInstance() -> RenderStats&
+	{
+		static auto instance = RenderStats{};
+		return instance;
+	}
+
+	auto RenderStats::BeginFrame(const float previous_frame_ms) -> void
+	{
+		// the very first call has nothing to close
+		if (m_is_counting)
+		{
+			m_current_frame.m_frame_ms = previous_frame_ms;
+			m_last_frame = m_current_frame;
+
+			m_history.push_back(m_last_frame);
+			while (m_history.size() > constants::RenderStatsHistoryFrames)
+			{
+				m_history.pop_front();
+			}
+		}
+
+		m_current_frame = { m_is_counting ? m_last_frame.m_frame_index + 1 : 0 };
+		m_is_counting = true;
+	}
+
+	auto RenderStats::Reset() -> void
+	{
+		m_history.clear();
+		m_last_frame = {};
+	}
+
+	auto RenderStats::GetFrameTimeSummary() const -> FrameTimeSummary
+	{
+		if (m_history.empty())
+		{
+			return {};
+		}
+
+		auto frame_times = std::vector<float>{};
+		frame_times.reserve(m_history.size());
+		for (const auto& frame : m_history)
+		{
+			frame_times.push_back(frame.m_frame_ms);
+		}
+
+		// nearest rank: the smallest time at least 99% of the frames don't exceed
+		const auto p99_idx = static_cast<size_t>(std::ceil(0.99 * frame_times.size())) - 1;
+		std::ranges::nth_element(frame_times, frame_times.begin() + p99_idx);
+
+		auto summary = FrameTimeSummary{};
+		summary.m_p99_ms = frame_times[p99_idx];
+		summary.m_min_ms = std::ranges::min(frame_times);
+		summary.m_max_ms = std::ranges::max(frame_times);
+		summary.m_avg_ms = std::accumulate(frame_times.begin(), frame_times.end(), 0.0f) / static_cast<float>(frame_times.size());
+		return summary;
+	}
+}
@@ -0,0 +1,49 @@
+#include <rendering/resolution_controller.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace libgraphics
+{
+	static constexpr auto SmoothingFactor = 0.1f;
+
+	// aim slightly below the target, a frame right at the deadline is already late half of the times
+	static constexpr auto TargetHeadroom = 0.9f;
+
+	static constexpr auto DeadZone = 0.02f;
+	static constexpr auto MaxDecreaseStep = 0.1f;
+	static constexpr auto MaxIncreaseStep = 0.02f;
+
+	ResolutionController::ResolutionController(const float target_frame_ms, const float min_scale, const float max_scale)
+		: m_target_frame_ms{ target_frame_ms }, m_min_scale{ min_scale }, m_max_scale{ max_scale }, m_scale{ max_scale }
+	{
+	}
+
+	auto ResolutionController::Update(const float gpu_frame_ms) -> float
+	{
+		if (gpu_frame_ms <= 0.0f)
+		{
+			return m_scale;
+		}
+
+		m_smoothed_frame_ms = m_has_samples ? m_smoothed_frame_ms + (gpu_frame_ms - m_smoothed_frame_ms) * SmoothingFactor : gpu_frame_ms;
+		m_has_samples = true;
+
+		const auto desired_scale = m_scale * std::sqrt(m_target_frame_ms * TargetHeadroom / m_smoothed_frame_ms);
+		const auto delta = desired_scale - m_scale;
+
+		if (std::abs(delta) < DeadZone)
+		{
+			return m_scale;
+		}
+
+		const auto previous_scale = m_scale;
+		m_scale = std::clamp(m_scale + std::clamp(delta, -MaxDecreaseStep, MaxIncreaseStep), m_min_scale, m_max_scale);
+
+		// the average was measured at the old scale, predict it at the new one so the next frames don't overshoot
+		const auto ratio = m_scale / previous_scale;
+		m_smoothed_frame_ms *= ratio * ratio;
+
+		return m_scale;
+	}
+}
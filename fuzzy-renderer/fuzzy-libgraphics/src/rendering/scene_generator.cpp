@@ -0,0 +1,417 @@
+#include <rendering/scene_generator.h>
+
+#include <core.h>
+#include <enums.h>
+#include <logger.h>
+#include <memory_tracker.h>
+#include <components/mesh_renderer.h>
+#include <components/transform.h>
+#include <entities/entity.h>
+#include <interfaces/imesh.h>
+#include <rendering/light.h>
+#include <rendering/material.h>
+#include <rendering/texture.h>
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <random>
+
+namespace libgraphics
+{
+	namespace
+	{
+		/**
+		 * \brief Uniform values computed from the raw engine output: the std distributions are implementation
+		 * defined, mt19937 and seed_seq are not, so scenes don't change between compilers.
+		 */
+		class Random
+		{
+		public:
+			// one independent stream per aspect of the scene, so that e.g. more textures don't move the entities
+			Random(const uint32_t seed, const uint32_t stream) : m_engine{ MakeEngine(seed, stream) } {}
+
+			auto NextFloat() -> float { return static_cast<float>(m_engine() >> 8) * (1.0f / 16777216.0f); }
+			auto Range(const float min, const float max) -> float { return min + (max - min) * NextFloat(); }
+			auto Index(const uint32_t count) -> uint32_t { return static_cast<uint32_t>((static_cast<uint64_t>(m_engine()) * count) >> 32); }
+			auto Color(const float min, const float max) -> glm::vec3 { return { Range(min, max), Range(min, max), Range(min, max) }; }
+			auto Direction() -> glm::vec3
+			{
+				const auto z = Range(-1.0f, 1.0f);
+				const auto angle = Range(0.0f, glm::two_pi<float>());
+				const auto radius = std::sqrt(1.0f - z * z);
+				return { radius * std::cos(angle), radius * std::sin(angle), z };
+			}
+
+		private:
+			static auto MakeEngine(const uint32_t seed, const uint32_t stream) -> std::mt19937
+			{
+				auto seed_sequence = std::seed_seq{ seed, stream };
+				return std::mt19937{ seed_sequence };
+			}
+
+			std::mt19937 m_engine;
+		};
+
+		enum RandomStream : uint32_t
+		{
+			meshes_stream,
+			textures_stream,
+			materials_stream,
+			entities_stream,
+			lights_stream
+		};
+
+		// children sit this far from their parent (in the parent space), deep chains wander away from their root
+		constexpr auto ChildOffset = 2.5f;
+
+		/**
+		 * \brief Unit sphere pushed in and out by a few random lobes, (detail + 1) * (2 * detail + 1) vertices.
+		 */
+		auto GenerateRockMesh(Random& random, const uint32_t detail, std::vector<Texture> textures, std::string name) -> std::shared_ptr<IMesh>
+		{
+			const auto rings = std::max(detail, 3u);
+			const auto segments = rings * 2;
+			const auto row_size = segments + 1;
+
+			auto lobes = std::array<glm::vec4, 3>{};
+			for (auto& lobe : lobes)
+			{
+				lobe = glm::vec4{ random.Direction() * random.Range(1.0f, 4.0f), random.Range(0.05f, 0.2f) };
+			}
+
+			auto vertices = std::vector<Vertex>{};
+			vertices.reserve(static_cast<size_t>(rings + 1) * row_size);
+
+			for (auto ring_idx = 0u; ring_idx <= rings; ++ring_idx)
+			{
+				const auto theta = glm::pi<float>() * static_cast<float>(ring_idx) / static_cast<float>(rings);
+				for (auto segment_idx = 0u; segment_idx <= segments; ++segment_idx)
+				{
+					const auto phi = glm::two_pi<float>() * static_cast<float>(segment_idx) / static_cast<float>(segments);
+					const auto direction = glm::vec3{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+
+					auto radius = 1.0f;
+					for (const auto& lobe : lobes)
+					{
+						radius += lobe.w * std::sin(glm::dot(direction, glm::vec3{ lobe }));
+					}
+
+					auto vertex = Vertex{};
+					vertex.m_position = direction * radius;
+					vertex.m_tex_coords = { static_cast<float>(segment_idx) / static_cast<float>(segments), static_cast<float>(ring_idx) / static_cast<float>(rings) };
+					vertex.m_tangent = { -std::sin(phi), 0.0f, std::cos(phi) };
+					vertices.push_back(vertex);
+				}
+			}
+
+			auto indices = std::vector<uint32_t>{};
+			indices.reserve(static_cast<size_t>(rings) * segments * 6);
+
+			for (auto ring_idx = 0u; ring_idx != rings; ++ring_idx)
+			{
+				for (auto segment_idx = 0u; segment_idx != segments; ++segment_idx)
+				{
+					// counter clockwise seen from outside
+					const auto top = ring_idx * row_size + segment_idx;
+					const auto bottom = top + row_size;
+					indices.insert(indices.end(), { top, top + 1, bottom, top + 1, bottom + 1, bottom });
+				}
+			}
+
+			// area weighted face normals, the two columns of the uv seam share theirs
+			for (auto index_idx = size_t{ 0 }; index_idx < indices.size(); index_idx += 3)
+			{
+				auto& v0 = vertices[indices[index_idx]];
+				auto& v1 = vertices[indices[index_idx + 1]];
+				auto& v2 = vertices[indices[index_idx + 2]];
+
+				const auto face_normal = glm::cross(v1.m_position - v0.m_position, v2.m_position - v0.m_position);
+				v0.m_normal += face_normal;
+				v1.m_normal += face_normal;
+				v2.m_normal += face_normal;
+			}
+
+			for (auto ring_idx = 0u; ring_idx <= rings; ++ring_idx)
+			{
+				auto& first = vertices[ring_idx * row_size];
+				auto& last = vertices[ring_idx * row_size + segments];
+				first.m_normal = last.m_normal = first.m_normal + last.m_normal;
+			}
+
+			for (auto& vertex : vertices)
+			{
+				// the poles collapse to a point, their normal is the axis
+				vertex.m_normal = glm::length(vertex.m_normal) > 0.0f ? glm::normalize(vertex.m_normal) : glm::normalize(vertex.m_position);
+				vertex.m_bitangent = glm::cross(vertex.m_normal, vertex.m_tangent);
+			}
+
+			return Core::GetInstance().CreateMesh(std::move(vertices), std::move(indices), std::move(textures), std::move(name));
+		}
+
+		/**
+		 * \brief Checker of two random colors under a diagonal gradient, so mips and filtering have something to do.
+		 */
+		auto GenerateAlbedoTexture(Random& random, const uint32_t size) -> Texture
+		{
+			const auto colors = std::array{ random.Color(0.2f, 1.0f), random.Color(0.0f, 0.6f) };
+			const auto cell_size = std::max(size / (4 + random.Index(12)), 1u);
+
+			auto pixels = std::vector<unsigned char>(static_cast<size_t>(size) * size * 4);
+			for (auto y = 0u; y != size; ++y)
+			{
+				for (auto x = 0u; x != size; ++x)
+				{
+					const auto gradient = 0.6f + 0.4f * static_cast<float>(x + y) / static_cast<float>(2 * size);
+					const auto color = colors[(x / cell_size + y / cell_size) % 2] * gradient;
+
+					auto* pixel = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+					pixel[0] = static_cast<unsigned char>(color.x * 255.0f);
+					pixel[1] = static_cast<unsigned char>(color.y * 255.0f);
+					pixel[2] = static_cast<unsigned char>(color.z * 255.0f);
+					pixel[3] = 255;
+				}
+			}
+
+			return Texture{ pixels.data(), size, size, TextureType::albedo };
+		}
+
+		auto GenerateFlatNormalTexture() -> Texture
+		{
+			auto pixels = std::array<unsigned char, 4 * 4 * 4>{};
+			for (auto pixel_idx = size_t{ 0 }; pixel_idx < pixels.size(); pixel_idx += 4)
+			{
+				pixels[pixel_idx] = 128;
+				pixels[pixel_idx + 1] = 128;
+				pixels[pixel_idx + 2] = 255;
+				pixels[pixel_idx + 3] = 255;
+			}
+
+			return Texture{ pixels.data(), 4, 4, TextureType::normals };
+		}
+
+		auto GenerateLight(Random& random, const bool is_spot, const float extent) -> std::shared_ptr<Light>
+		{
+			const auto light = std::make_shared<Light>();
+			light->m_color = glm::vec4{ random.Color(0.3f, 1.0f), 1.0f };
+			light->m_is_active = true;
+
+			if (is_spot)
+			{
+				// above the scene, pointing down with some tilt
+				light->m_type = 2;
+				light->m_position = { random.Range(-extent, extent), extent, random.Range(0.0f, 2.0f * extent) };
+				light->m_direction = glm::normalize(glm::vec3{ random.Range(-0.5f, 0.5f), -1.0f, random.Range(-0.5f, 0.5f) });
+				light->m_intensity = random.Range(2.0f, 4.0f);
+				light->m_attenuation = { 1.0f, 0.045f, 0.0075f };
+			}
+			else
+			{
+				light->m_type = 1;
+				light->m_position = { random.Range(-extent, extent), random.Range(-extent, extent), random.Range(0.0f, 2.0f * extent) };
+				light->m_intensity = random.Range(1.0f, 3.0f);
+				light->m_attenuation = { 1.0f, 0.09f, 0.032f };
+			}
+
+			return light;
+		}
+
+		auto ParseValue(const std::string_view text, auto& out_value) -> bool
+		{
+			const auto result = std::from_chars(text.data(), text.data() + text.size(), out_value);
+			return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+		}
+
+		constexpr auto SpecKeys = std::array{
+			std::pair{ std::string_view{ "seed" }, &SceneGeneratorParams::m_seed },
+			std::pair{ std::string_view{ "entities" }, &SceneGeneratorParams::m_entities_count },
+			std::pair{ std::string_view{ "depth" }, &SceneGeneratorParams::m_hierarchy_depth },
+			std::pair{ std::string_view{ "branching" }, &SceneGeneratorParams::m_hierarchy_branching },
+			std::pair{ std::string_view{ "meshes" }, &SceneGeneratorParams::m_meshes_count },
+			std::pair{ std::string_view{ "detail" }, &SceneGeneratorParams::m_mesh_detail },
+			std::pair{ std::string_view{ "materials" }, &SceneGeneratorParams::m_materials_count },
+			std::pair{ std::string_view{ "textures" }, &SceneGeneratorParams::m_textures_count },
+			std::pair{ std::string_view{ "texture_size" }, &SceneGeneratorParams::m_texture_size },
+			std::pair{ std::string_view{ "points" }, &SceneGeneratorParams::m_point_lights_count },
+			std::pair{ std::string_view{ "spots" }, &SceneGeneratorParams::m_spot_lights_count }
+		};
+	}
+
+	auto GenerateScene(const SceneGeneratorParams& params) -> GeneratedScene
+	{
+		const auto memory_owner = MemoryOwnerScope{ ToSceneGeneratorSpec(params) };
+
+		auto scene = GeneratedScene{};
+		scene.m_root = std::make_shared<Entity>();
+		scene.m_root->SetName(std::format("generated_{}", params.m_seed));
+
+		// textures are GPU objects, the software backend has no use for them
+		auto textures = std::vector<Texture>{};
+		auto flat_normal_texture = Texture{};
+		if (params.m_textures_count != 0 && Core::GetInstance().GetGraphicsAPI() != GraphicsAPI::software)
+		{
+			auto random = Random{ params.m_seed, textures_stream };
+			for (auto texture_idx = 0u; texture_idx != params.m_textures_count; ++texture_idx)
+			{
+				textures.push_back(GenerateAlbedoTexture(random, std::max(params.m_texture_size, 1u)));
+			}
+			flat_normal_texture = GenerateFlatNormalTexture();
+		}
+
+		auto meshes = std::vector<std::shared_ptr<IMesh>>{};
+		{
+			auto random = Random{ params.m_seed, meshes_stream };
+			for (auto mesh_idx = 0u; mesh_idx != std::max(params.m_meshes_count, 1u); ++mesh_idx)
+			{
+				auto mesh_textures = std::vector<Texture>{};
+				if (!textures.empty())
+				{
+					mesh_textures = { textures[mesh_idx % textures.size()], flat_normal_texture };
+				}
+				meshes.push_back(GenerateRockMesh(random, params.m_mesh_detail, std::move(mesh_textures), std::format("rock_{}", mesh_idx)));
+			}
+		}
+
+		auto materials = std::vector<std::shared_ptr<lighting::Material>>{};
+		{
+			auto random = Random{ params.m_seed, materials_stream };
+			for (auto material_idx = 0u; material_idx != std::max(params.m_materials_count, 1u); ++material_idx)
+			{
+				auto material = std::make_shared<lighting::Material>();
+				material->SetName(std::format("material_{}", material_idx));
+				material->SetAlbedoColor(random.Color(0.1f, 1.0f));
+				material->SetMetallic(random.NextFloat());
+				material->SetRoughness(random.Range(0.1f, 1.0f));
+				materials.push_back(std::move(material));
+			}
+		}
+
+		// trees filled level by level (node n has parent (n - 1) / branching), a new tree starts once one is full
+		auto random = Random{ params.m_seed, entities_stream };
+		const auto branching = std::max(params.m_hierarchy_branching, 1u);
+		const auto max_depth = std::max(params.m_hierarchy_depth, 1u);
+
+		auto tree = std::vector<std::shared_ptr<Entity>>{};
+		auto tree_depths = std::vector<uint32_t>{};
+
+		for (auto entity_idx = 0u; entity_idx != params.m_entities_count; ++entity_idx)
+		{
+			auto depth = tree.empty() ? 0u : tree_depths[(tree.size() - 1) / branching] + 1;
+			if (depth == max_depth)
+			{
+				tree.clear();
+				tree_depths.clear();
+				depth = 0;
+			}
+
+			const auto& mesh = meshes[random.Index(static_cast<uint32_t>(meshes.size()))];
+			scene.m_triangles_count += mesh->GetIndexCount() / 3;
+
+			auto mesh_renderer = std::make_shared<MeshRenderer>(mesh);
+
+			auto entity = std::make_shared<Entity>();
+			entity->SetName(std::format("entity_{}", entity_idx));
+			entity->AddComponent(mesh_renderer);
+			mesh_renderer->SetMaterial(materials[random.Index(static_cast<uint32_t>(materials.size()))]);
+
+			const auto& transform = entity->GetTransformComponent();
+			transform->SetLocalRotation(glm::vec3{ random.Range(0.0f, 360.0f), random.Range(0.0f, 360.0f), random.Range(0.0f, 360.0f) });
+
+			if (depth == 0)
+			{
+				const auto extent = params.m_extent;
+				transform->SetLocalTranslation({ random.Range(-extent, extent), random.Range(-extent, extent), random.Range(0.0f, 2.0f * extent) });
+				transform->SetLocalScale(glm::vec3{ random.Range(0.5f, 1.5f) });
+				scene.m_root->AddChild(entity);
+			}
+			else
+			{
+				transform->SetLocalTranslation(random.Direction() * ChildOffset);
+				transform->SetLocalScale(glm::vec3{ 1.0f });
+				tree[(tree.size() - 1) / branching]->AddChild(entity);
+			}
+
+			tree.push_back(std::move(entity));
+			tree_depths.push_back(depth);
+		}
+
+		{
+			auto lights_random = Random{ params.m_seed, lights_stream };
+			for (auto light_idx = 0u; light_idx != params.m_point_lights_count + params.m_spot_lights_count; ++light_idx)
+			{
+				scene.m_lights.push_back(GenerateLight(lights_random, light_idx >= params.m_point_lights_count, params.m_extent));
+			}
+		}
+
+		CX_CORE_INFO("Generated scene {}: {} entities, {} meshes, {} materials, {} textures, {} lights, {} triangles", ToSceneGeneratorSpec(params), params.m_entities_count,
+			meshes.size(), materials.size(), textures.size(), scene.m_lights.size(), scene.m_triangles_count);
+
+		return scene;
+	}
+
+	auto ParseSceneGeneratorSpec(const std::string_view spec) -> std::optional<SceneGeneratorParams>
+	{
+		if (!spec.starts_with(SceneGeneratorSpecPrefix))
+		{
+			return std::nullopt;
+		}
+
+		auto params = SceneGeneratorParams{};
+		auto remaining = spec.substr(SceneGeneratorSpecPrefix.size());
+
+		while (!remaining.empty())
+		{
+			const auto separator = remaining.find(',');
+			const auto entry = remaining.substr(0, separator);
+			remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+
+			const auto equal = entry.find('=');
+			if (equal == std::string_view::npos)
+			{
+				CX_CORE_ERROR("Scene generator: expected key=value, got '{}'", entry);
+				return std::nullopt;
+			}
+
+			const auto key = entry.substr(0, equal);
+			const auto value = entry.substr(equal + 1);
+
+			auto is_valid = false;
+			if (key == "extent")
+			{
+				is_valid = ParseValue(value, params.m_extent) && params.m_extent > 0.0f;
+			}
+			else if (const auto it = std::ranges::find(SpecKeys, key, &decltype(SpecKeys)::value_type::first); it != SpecKeys.end())
+			{
+				is_valid = ParseValue(value, params.*(it->second));
+			}
+			else
+			{
+				CX_CORE_ERROR("Scene generator: unknown key '{}'", key);
+				return std::nullopt;
+			}
+
+			if (!is_valid)
+			{
+				CX_CORE_ERROR("Scene generator: bad value '{}' for '{}'", value, key);
+				return std::nullopt;
+			}
+		}
+
+		return params;
+	}
+
+	auto ToSceneGeneratorSpec(const SceneGeneratorParams& params) -> std::string
+	{
+		auto spec = std::string{ SceneGeneratorSpecPrefix };
+		for (const auto& [key, member] : SpecKeys)
+		{
+			spec += std::format("{}={},", key, params.*member);
+		}
+
+		return spec + std::format("extent={}", params.m_extent);
+	}
+}
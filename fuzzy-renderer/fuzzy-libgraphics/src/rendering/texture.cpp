@@ -1,36 +1,195 @@
 #include <rendering/texture.h>
 
+#include <asset_file_system.h>
+#include <hot_reloader.h>
 #include <logger.h>
+#include <opengl/gl_state_cache.h>
+#include <rendering/texture_cache.h>
+#include <rendering/texture_cooker.h>
+#include <rendering/texture_streamer.h>
 #include <stb_image.h>
 
+#include <algorithm>
+#include <bit>
+#include <format>
+
 namespace libgraphics
 {
-	[[nodiscard]] auto LoadTexture(const unsigned char* data, const int width, const int height, const GLenum format) -> GLuint
+	// S3TC formats, not part of the core profile glad is generated for
+	static constexpr GLenum CompressedRgbS3tcDxt1 = 0x83F0;
+	static constexpr GLenum CompressedRgbaS3tcDxt5 = 0x83F3;
+	static constexpr GLenum CompressedSrgbS3tcDxt1 = 0x8C4C;
+	static constexpr GLenum CompressedSrgbAlphaS3tcDxt5 = 0x8C4F;
+
+	[[nodiscard]] auto GetMipsCount(const int width, const int height) -> int
 	{
-		auto texture_id = GLuint{};
+		return std::bit_width(static_cast<unsigned>(std::max({ width, height, 1 })));
+	}
 
-		glGenTextures(1, &texture_id);
-		glBindTexture(GL_TEXTURE_2D, texture_id);
-		glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(format), width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
+	auto ToGLFormat(const BlockFormat format, const bool is_srgb) -> GLenum
+	{
+		switch (format)
+		{
+		case BlockFormat::bc1: return is_srgb ? CompressedSrgbS3tcDxt1 : CompressedRgbS3tcDxt1;
+		case BlockFormat::bc3: return is_srgb ? CompressedSrgbAlphaS3tcDxt5 : CompressedRgbaS3tcDxt5;
+		case BlockFormat::bc4: return GL_COMPRESSED_RED_RGTC1;
+		case BlockFormat::bc5: return GL_COMPRESSED_RG_RGTC2;
+		}
+		return {};
+	}
 
+	[[nodiscard]] auto ToString(const BlockFormat format) -> std::string_view
+	{
+		switch (format)
+		{
+		case BlockFormat::bc1: return "BC1";
+		case BlockFormat::bc3: return "BC3";
+		case BlockFormat::bc4: return "BC4";
+		case BlockFormat::bc5: return "BC5";
+		}
+		return {};
+	}
+
+	auto SetSamplingParameters() -> void
+	{
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
+	[[nodiscard]] auto LoadTexture(const unsigned char* data, const int width, const int height, const GLenum format) -> GLuint
+	{
+		auto texture_id = GLuint{};
+
+		glGenTextures(1, &texture_id);
+		GLStateCache::GetInstance().BindTexture(0, GL_TEXTURE_2D, texture_id);
+		glTexStorage2D(GL_TEXTURE_2D, GetMipsCount(width, height), format == GL_RGB ? GL_RGB8 : GL_RGBA8, width, height);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+
+		SetSamplingParameters();
 		glGenerateMipmap(GL_TEXTURE_2D);
 
 		return texture_id;
 	}
 
+	auto CreateCompressedTexture(const BlockFormat format, const bool is_srgb, const int width, const int height, const int levels_count) -> GLuint
+	{
+		auto texture_id = GLuint{};
+
+		glGenTextures(1, &texture_id);
+		GLStateCache::GetInstance().BindTexture(0, GL_TEXTURE_2D, texture_id);
+		glTexStorage2D(GL_TEXTURE_2D, levels_count, ToGLFormat(format, is_srgb), width, height);
+
+		SetSamplingParameters();
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels_count - 1);
+
+		// masks are sampled as .rgb like the uncompressed maps were
+		if (format == BlockFormat::bc4)
+		{
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+		}
+
+		return texture_id;
+	}
+
+	[[nodiscard]] auto LoadCompressedTexture(const CookedTexture& cooked_texture) -> GLuint
+	{
+		const auto gl_format = ToGLFormat(cooked_texture.m_format, cooked_texture.m_is_srgb);
+		const auto& base_mip = cooked_texture.m_mips.front();
+
+		const auto texture_id = CreateCompressedTexture(cooked_texture.m_format, cooked_texture.m_is_srgb, base_mip.m_width, base_mip.m_height, static_cast<int>(cooked_texture.m_mips.size()));
+
+		for (auto level_idx = size_t{ 0 }; level_idx != cooked_texture.m_mips.size(); ++level_idx)
+		{
+			const auto& mip = cooked_texture.m_mips[level_idx];
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(level_idx), 0, 0, mip.m_width, mip.m_height, gl_format, static_cast<GLsizei>(mip.m_data.size()), mip.m_data.data());
+		}
+
+		return texture_id;
+	}
+
+	Texture::Storage::~Storage()
+	{
+		GLStateCache::GetInstance().DeleteTexture(m_texture_id);
+	}
+
+	auto Texture::SetStorage(const GLuint texture_id, const int width, const int height, const GLenum format, const std::string_view source) -> void
+	{
+		// RGB8 is stored with 4 bytes per texel by the drivers as well, LoadTexture always builds the whole chain
+		const auto detail = std::format("{} {}x{} {} {} mips", source, width, height, format == GL_RGB ? "RGB8" : "RGBA8", GetMipsCount(width, height));
+
+		m_storage = std::make_shared<Storage>(texture_id, TrackedMemory{ MemoryCategory::texture, ComputeTextureBytes(width, height, 4, true), detail });
+	}
+
+	auto Texture::SetCompressedStorage(const CookedTexture& cooked_texture, const std::string_view source) -> void
+	{
+		auto bytes = uint64_t{ 0 };
+		for (const auto& mip : cooked_texture.m_mips)
+		{
+			bytes += mip.m_data.size();
+		}
+
+		const auto& base_mip = cooked_texture.m_mips.front();
+		const auto detail = std::format("{} {}x{} {} {} mips", source, base_mip.m_width, base_mip.m_height, ToString(cooked_texture.m_format), cooked_texture.m_mips.size());
+
+		m_storage = std::make_shared<Storage>(LoadCompressedTexture(cooked_texture), TrackedMemory{ MemoryCategory::texture, bytes, detail });
+	}
+
+	auto Texture::RequestScreenSize(const float pixels) const -> void
+	{
+		if (!m_storage || !m_storage->m_streamed)
+		{
+			return;
+		}
+
+		auto& requested_pixels = m_storage->m_streamed->m_requested_pixels;
+		const auto value = static_cast<uint32_t>(std::max(pixels, 1.0f));
+
+		auto current_value = requested_pixels.load(std::memory_order_relaxed);
+		while (current_value < value && !requested_pixels.compare_exchange_weak(current_value, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
 	Texture::Texture(const std::string_view file_path, const TextureType type) : m_file_path{ file_path }, m_type{ type }
 	{
+		auto& texture_cache = TextureCache::GetInstance();
+		const auto cache_key = TextureCache::MakeFileKey(file_path);
+
+		if (const auto cached_texture = texture_cache.Find(cache_key, type))
+		{
+			m_storage = cached_texture->m_storage;
+			return;
+		}
+
+		HotReloader::GetInstance().WatchFile(file_path);
+
+		auto& asset_file_system = AssetFileSystem::GetInstance();
+
+		// the cooked version next to the image wins, it is already compressed and mipmapped (and streamed)
+		if (const auto cooked_path = GetCookedTexturePath(file_path); asset_file_system.Exists(cooked_path))
+		{
+			if (auto streamable_texture = TextureStreamer::LoadMipTail(cooked_path))
+			{
+				m_storage = TextureStreamer::GetInstance().CreateTexture(std::move(streamable_texture.value()), file_path, type).m_storage;
+				texture_cache.Insert(cache_key, *this);
+				return;
+			}
+			CX_CORE_WARN("Ignoring malformed cooked texture: {}", cooked_path.string());
+		}
+
+		const auto image_file = asset_file_system.Read(file_path);
+
 		int width, height, num_channels;
-		if (const auto image_data = stbi_load(file_path.data(), &width, &height, &num_channels, STBI_rgb_alpha))
+		if (const auto image_data = image_file ? stbi_load_from_memory(image_file->m_bytes.data(), static_cast<int>(image_file->m_bytes.size()), &width, &height, &num_channels, STBI_rgb_alpha) : nullptr)
 		{
 			const auto format = (num_channels == 3) ? GL_RGB : GL_RGBA;
-			m_texture_id = LoadTexture(image_data, width, height, format);
+			SetStorage(LoadTexture(image_data, width, height, format), width, height, format, file_path);
 			stbi_image_free(image_data);
+
+			texture_cache.Insert(cache_key, *this);
 		}
 		else
 		{
@@ -70,7 +229,7 @@ namespace libgraphics
 
 		if (image_data)
 		{
-			m_texture_id = LoadTexture(image_data, out_width, out_height, texture_format);
+			SetStorage(LoadTexture(image_data, out_width, out_height, texture_format), out_width, out_height, texture_format, height == 0 ? "embedded" : "raw");
 
 			// If the image_data was loaded using stbi_load_from_memory, free the decoded image data
 			if (height == 0)
@@ -79,4 +238,12 @@ namespace libgraphics
 			}
 		}
 	}
+
+	Texture::Texture(const CookedTexture& cooked_texture, const std::string_view source, const TextureType type) : m_type{ type }
+	{
+		if (!cooked_texture.m_mips.empty())
+		{
+			SetCompressedStorage(cooked_texture, source);
+		}
+	}
 }
\ No newline at end of file
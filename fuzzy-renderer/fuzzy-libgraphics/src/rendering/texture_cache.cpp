@@ -0,0 +1,147 @@
+#include <rendering/texture_cache.h>
+
+#include <resource_manager.h>
+#include <rendering/texture_cooker.h>
+#include <rendering/texture_streamer.h>
+
+#include <filesystem>
+#include <format>
+
+namespace libgraphics
+{
+	auto TextureCache::GetInstance() -> TextureCache&
+	{
+		static auto instance = TextureCache{};
+		return instance;
+	}
+
+	auto TextureCache::MakeFileKey(const std::string_view file_path) -> std::string
+	{
+		// "models/../textures/a.png" and "textures/a.png" are the same image
+		auto error = std::error_code{};
+		const auto canonical_path = std::filesystem::weakly_canonical(std::filesystem::path{ file_path }, error);
+		return error ? std::string{ file_path } : canonical_path.generic_string();
+	}
+
+	auto TextureCache::MakeContentKey(const std::span<const uint8_t> data) -> std::string
+	{
+		// FNV-1a, the size goes in the key as well to make collisions even less likely
+		auto hash = uint64_t{ 14695981039346656037ull };
+		for (const auto byte : data)
+		{
+			hash = (hash ^ byte) * 1099511628211ull;
+		}
+
+		return std::format("embedded:{:016x}:{}", hash, data.size());
+	}
+
+	auto TextureCache::Find(const std::string_view key, const TextureType type) -> std::optional<Texture>
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		const auto it = m_textures.find(std::string{ key });
+		auto storage = it != m_textures.end() ? it->second.m_storage.lock() : nullptr;
+		if (!storage)
+		{
+			m_misses_count.fetch_add(1, std::memory_order_relaxed);
+			return std::nullopt;
+		}
+
+		m_hits_count.fetch_add(1, std::memory_order_relaxed);
+
+		// same GL texture, the role is the one of the material asking for it
+		auto texture = it->second.m_texture;
+		texture.m_storage = std::move(storage);
+		texture.m_type = type;
+		return texture;
+	}
+
+	auto TextureCache::Insert(std::string key, const Texture& texture) -> void
+	{
+		if (!texture.m_storage)
+		{
+			return;
+		}
+
+		const auto bytes = texture.m_storage->m_memory.GetBytes();
+		ResourceManager::GetInstance().Track(ResourceType::textures, key, texture.m_storage, bytes);
+
+		auto cached_texture = CachedTexture{ texture, texture.m_storage };
+		cached_texture.m_texture.m_storage.reset();
+
+		const auto lock = std::scoped_lock{ m_mutex };
+		m_textures.insert_or_assign(std::move(key), std::move(cached_texture));
+	}
+
+	auto TextureCache::FindFileKeys(const std::filesystem::path& changed_path) const -> std::vector<std::string>
+	{
+		const auto changed_key = changed_path.generic_string();
+		auto keys = std::vector<std::string>{};
+
+		const auto lock = std::scoped_lock{ m_mutex };
+		for (const auto& [key, cached_texture] : m_textures)
+		{
+			// embedded images have no file, their model is reloaded instead
+			if (key.starts_with("embedded:") || cached_texture.m_storage.expired())
+			{
+				continue;
+			}
+
+			if (key == changed_key || MakeFileKey(GetCookedTexturePath(key).generic_string()) == changed_key)
+			{
+				keys.push_back(key);
+			}
+		}
+		return keys;
+	}
+
+	auto TextureCache::Replace(const std::string_view key, Texture& replacement) -> bool
+	{
+		if (!replacement.m_storage)
+		{
+			return false;
+		}
+
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		const auto it = m_textures.find(std::string{ key });
+		const auto cached_storage = it != m_textures.end() ? it->second.m_storage.lock() : nullptr;
+		if (!cached_storage)
+		{
+			return false;
+		}
+
+		// the streamer lets go of the previous texture, the new one is fully resident
+		auto& storage = *cached_storage;
+		if (storage.m_streamed)
+		{
+			TextureStreamer::GetInstance().Forget(storage);
+		}
+
+		std::swap(storage.m_texture_id, replacement.m_storage->m_texture_id);
+		std::swap(storage.m_memory, replacement.m_storage->m_memory);
+		std::swap(storage.m_streamed, replacement.m_storage->m_streamed);
+
+		ResourceManager::GetInstance().Track(ResourceType::textures, std::string{ key }, cached_storage, storage.m_memory.GetBytes());
+		return true;
+	}
+
+	auto TextureCache::Trim() -> void
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+
+		std::erase_if(m_textures, [](const auto& entry) { return entry.second.m_storage.expired(); });
+	}
+
+	auto TextureCache::Clear() -> void
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+		m_textures.clear();
+	}
+
+	auto TextureCache::GetTexturesCount() const -> size_t
+	{
+		const auto lock = std::scoped_lock{ m_mutex };
+		return m_textures.size();
+	}
+}
@@ -0,0 +1,736 @@
+#include <rendering/texture_cooker.h>
+
+#include <asset_file_system.h>
+#include <job_system.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define TEXTURE_COOKER_X64
+#include <xmmintrin.h>
+#endif
+
+namespace libgraphics
+{
+#pragma region FREE FUNCTIONS
+
+	// block rows a job encodes at least, a row of a 4K level is 1024 blocks
+	static constexpr size_t BlockRowsPerJob = 4;
+
+	[[nodiscard]] auto IsColorRole(const TextureRole role) -> bool
+	{
+		return role == TextureRole::color || role == TextureRole::color_alpha;
+	}
+
+	auto SrgbToLinear(const float value) -> float
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	auto LinearToSrgb(const float value) -> float
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	auto GetSrgbToLinearTable() -> const std::array<float, 256>&
+	{
+		static const auto table = [] {
+			auto values = std::array<float, 256>{};
+			for (auto value_idx = 0; value_idx != 256; ++value_idx)
+			{
+				values[value_idx] = SrgbToLinear(static_cast<float>(value_idx) / 255.0f);
+			}
+			return values;
+		}();
+		return table;
+	}
+
+	auto ToFloatTexels(const std::span<const uint8_t> rgba, const TextureRole role) -> std::vector<float>
+	{
+		const auto& srgb_to_linear = GetSrgbToLinearTable();
+		const auto is_color = IsColorRole(role);
+
+		auto texels = std::vector<float>(rgba.size());
+		for (auto channel_idx = size_t{ 0 }; channel_idx != rgba.size(); ++channel_idx)
+		{
+			// alpha is always linear
+			texels[channel_idx] = is_color && channel_idx % 4 != 3 ? srgb_to_linear[rgba[channel_idx]] : static_cast<float>(rgba[channel_idx]) / 255.0f;
+		}
+
+		return texels;
+	}
+
+	auto ToByteTexels(const std::vector<float>& texels, const TextureRole role) -> std::vector<uint8_t>
+	{
+		const auto is_color = IsColorRole(role);
+
+		auto rgba = std::vector<uint8_t>(texels.size());
+		for (auto channel_idx = size_t{ 0 }; channel_idx != texels.size(); ++channel_idx)
+		{
+			const auto value = is_color && channel_idx % 4 != 3 ? LinearToSrgb(texels[channel_idx]) : texels[channel_idx];
+			rgba[channel_idx] = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+		}
+
+		return rgba;
+	}
+
+	/**
+	 * \brief 2x2 box filter of a linear RGBA float level, the last row/column is repeated for odd sizes.
+	 */
+	auto Downsample(const std::vector<float>& texels, const int width, const int height, const int mip_width, const int mip_height) -> std::vector<float>
+	{
+		auto mip_texels = std::vector<float>(static_cast<size_t>(mip_width) * mip_height * 4);
+
+		for (auto y = 0; y != mip_height; ++y)
+		{
+			const auto* row0 = texels.data() + static_cast<size_t>(std::min(y * 2, height - 1)) * width * 4;
+			const auto* row1 = texels.data() + static_cast<size_t>(std::min(y * 2 + 1, height - 1)) * width * 4;
+			auto* mip_row = mip_texels.data() + static_cast<size_t>(y) * mip_width * 4;
+
+			for (auto x = 0; x != mip_width; ++x)
+			{
+				const auto x0 = static_cast<size_t>(std::min(x * 2, width - 1)) * 4;
+				const auto x1 = static_cast<size_t>(std::min(x * 2 + 1, width - 1)) * 4;
+
+#ifdef TEXTURE_COOKER_X64
+				// one RGBA texel per register
+				const auto sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)), _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+				_mm_storeu_ps(mip_row + static_cast<size_t>(x) * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+				for (auto channel_idx = 0; channel_idx != 4; ++channel_idx)
+				{
+					mip_row[x * 4 + channel_idx] = (row0[x0 + channel_idx] + row0[x1 + channel_idx] + row1[x0 + channel_idx] + row1[x1 + channel_idx]) * 0.25f;
+				}
+#endif
+			}
+		}
+
+		return mip_texels;
+	}
+
+	auto RenormalizeNormals(std::vector<float>& texels) -> void
+	{
+		for (auto texel_idx = size_t{ 0 }; texel_idx < texels.size(); texel_idx += 4)
+		{
+			const auto x = texels[texel_idx] * 2.0f - 1.0f;
+			const auto y = texels[texel_idx + 1] * 2.0f - 1.0f;
+			const auto z = texels[texel_idx + 2] * 2.0f - 1.0f;
+
+			const auto length = std::sqrt(x * x + y * y + z * z);
+			if (length > 1e-6f)
+			{
+				texels[texel_idx] = x / length * 0.5f + 0.5f;
+				texels[texel_idx + 1] = y / length * 0.5f + 0.5f;
+				texels[texel_idx + 2] = z / length * 0.5f + 0.5f;
+			}
+		}
+	}
+
+	/**
+	 * \brief The 16 texels of the block at (block_x, block_y), clamped to the level for levels smaller than a block.
+	 */
+	auto GatherBlock(const CookedMip& mip, const int block_x, const int block_y) -> std::array<std::array<float, 4>, 16>
+	{
+		auto block = std::array<std::array<float, 4>, 16>{};
+
+		for (auto texel_idx = 0; texel_idx != 16; ++texel_idx)
+		{
+			const auto x = std::min(block_x * 4 + texel_idx % 4, mip.m_width - 1);
+			const auto y = std::min(block_y * 4 + texel_idx / 4, mip.m_height - 1);
+			const auto* texel = mip.m_data.data() + (static_cast<size_t>(y) * mip.m_width + x) * 4;
+
+			for (auto channel_idx = 0; channel_idx != 4; ++channel_idx)
+			{
+				block[texel_idx][channel_idx] = static_cast<float>(texel[channel_idx]);
+			}
+		}
+
+		return block;
+	}
+
+	auto PackColor565(const std::array<float, 3>& color) -> uint16_t
+	{
+		const auto quantize = [](const float value, const float max_value) { return static_cast<uint16_t>(std::clamp(std::round(value * max_value / 255.0f), 0.0f, max_value)); };
+		return static_cast<uint16_t>(quantize(color[0], 31.0f) << 11 | quantize(color[1], 63.0f) << 5 | quantize(color[2], 31.0f));
+	}
+
+	auto UnpackColor565(const uint16_t color) -> std::array<float, 3>
+	{
+		// bit replication, what the hardware decodes
+		const auto r = (color >> 11) & 31;
+		const auto g = (color >> 5) & 63;
+		const auto b = color & 31;
+		return { static_cast<float>(r << 3 | r >> 2), static_cast<float>(g << 2 | g >> 4), static_cast<float>(b << 3 | b >> 2) };
+	}
+
+	/**
+	 * \brief BC1 color block (always in 4 colors mode, so it is valid as the color half of BC3 too): endpoints fitted along
+	 * the principal axis of the block colors, then every texel takes the closest of the 4 palette entries.
+	 */
+	auto EncodeBC1Block(const std::array<std::array<float, 4>, 16>& block, uint8_t* out_block) -> void
+	{
+		auto mean = std::array<float, 3>{};
+		for (const auto& texel : block)
+		{
+			for (auto channel_idx = 0; channel_idx != 3; ++channel_idx)
+			{
+				mean[channel_idx] += texel[channel_idx] / 16.0f;
+			}
+		}
+
+		// covariance of the colors, its principal axis by power iteration
+		auto covariance = std::array<float, 6>{};
+		for (const auto& texel : block)
+		{
+			const auto r = texel[0] - mean[0], g = texel[1] - mean[1], b = texel[2] - mean[2];
+			covariance[0] += r * r; covariance[1] += r * g; covariance[2] += r * b;
+			covariance[3] += g * g; covariance[4] += g * b; covariance[5] += b * b;
+		}
+
+		auto axis = std::array<float, 3>{ 1.0f, 1.0f, 1.0f };
+		for (auto iteration_idx = 0; iteration_idx != 8; ++iteration_idx)
+		{
+			const auto next_axis = std::array<float, 3>{
+				covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+				covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+				covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2] };
+
+			const auto length = std::sqrt(next_axis[0] * next_axis[0] + next_axis[1] * next_axis[1] + next_axis[2] * next_axis[2]);
+			if (length < 1e-6f)
+			{
+				break;
+			}
+			axis = { next_axis[0] / length, next_axis[1] / length, next_axis[2] / length };
+		}
+
+		auto min_t = 0.0f, max_t = 0.0f;
+		for (const auto& texel : block)
+		{
+			const auto t = (texel[0] - mean[0]) * axis[0] + (texel[1] - mean[1]) * axis[1] + (texel[2] - mean[2]) * axis[2];
+			min_t = std::min(min_t, t);
+			max_t = std::max(max_t, t);
+		}
+
+		// inset the endpoints a little, the extremes are rarely worth a whole palette entry
+		const auto inset = (max_t - min_t) / 16.0f;
+		min_t += inset;
+		max_t -= inset;
+
+		auto color0 = PackColor565({ mean[0] + axis[0] * max_t, mean[1] + axis[1] * max_t, mean[2] + axis[2] * max_t });
+		auto color1 = PackColor565({ mean[0] + axis[0] * min_t, mean[1] + axis[1] * min_t, mean[2] + axis[2] * min_t });
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+		}
+
+		auto indices = uint32_t{ 0 };
+		if (color0 != color1)
+		{
+			const auto endpoint0 = UnpackColor565(color0);
+			const auto endpoint1 = UnpackColor565(color1);
+
+			auto palette = std::array<std::array<float, 3>, 4>{ endpoint0, endpoint1 };
+			for (auto channel_idx = 0; channel_idx != 3; ++channel_idx)
+			{
+				palette[2][channel_idx] = (2.0f * endpoint0[channel_idx] + endpoint1[channel_idx]) / 3.0f;
+				palette[3][channel_idx] = (endpoint0[channel_idx] + 2.0f * endpoint1[channel_idx]) / 3.0f;
+			}
+
+			for (auto texel_idx = 0; texel_idx != 16; ++texel_idx)
+			{
+				auto best_index = 0u;
+				auto best_distance = FLT_MAX;
+				for (auto palette_idx = 0u; palette_idx != 4; ++palette_idx)
+				{
+					const auto r = block[texel_idx][0] - palette[palette_idx][0];
+					const auto g = block[texel_idx][1] - palette[palette_idx][1];
+					const auto b = block[texel_idx][2] - palette[palette_idx][2];
+					const auto distance = r * r + g * g + b * b;
+					if (distance < best_distance)
+					{
+						best_distance = distance;
+						best_index = palette_idx;
+					}
+				}
+				indices |= best_index << (texel_idx * 2);
+			}
+		}
+
+		std::memcpy(out_block, &color0, 2);
+		std::memcpy(out_block + 2, &color1, 2);
+		std::memcpy(out_block + 4, &indices, 4);
+	}
+
+	/**
+	 * \brief BC4 block of one channel of the texels, in the 8 values mode between the channel min and max.
+	 */
+	auto EncodeBC4Block(const std::array<std::array<float, 4>, 16>& block, const int channel_idx, uint8_t* out_block) -> void
+	{
+		auto min_value = 255.0f, max_value = 0.0f;
+		for (const auto& texel : block)
+		{
+			min_value = std::min(min_value, texel[channel_idx]);
+			max_value = std::max(max_value, texel[channel_idx]);
+		}
+
+		const auto value0 = static_cast<uint8_t>(std::round(max_value));
+		const auto value1 = static_cast<uint8_t>(std::round(min_value));
+
+		auto indices = uint64_t{ 0 };
+		if (value0 != value1)
+		{
+			// codes 0 and 1 are the endpoints, 2..7 the interpolated values from value0 towards value1
+			auto palette = std::array<float, 8>{ static_cast<float>(value0), static_cast<float>(value1) };
+			for (auto palette_idx = 2; palette_idx != 8; ++palette_idx)
+			{
+				palette[palette_idx] = (static_cast<float>(8 - palette_idx) * value0 + static_cast<float>(palette_idx - 1) * value1) / 7.0f;
+			}
+
+			for (auto texel_idx = 0; texel_idx != 16; ++texel_idx)
+			{
+				auto best_index = uint64_t{ 0 };
+				auto best_distance = FLT_MAX;
+				for (auto palette_idx = uint64_t{ 0 }; palette_idx != 8; ++palette_idx)
+				{
+					const auto distance = std::abs(block[texel_idx][channel_idx] - palette[palette_idx]);
+					if (distance < best_distance)
+					{
+						best_distance = distance;
+						best_index = palette_idx;
+					}
+				}
+				indices |= best_index << (texel_idx * 3);
+			}
+		}
+
+		out_block[0] = value0;
+		out_block[1] = value1;
+		for (auto byte_idx = 0; byte_idx != 6; ++byte_idx)
+		{
+			out_block[2 + byte_idx] = static_cast<uint8_t>(indices >> (byte_idx * 8));
+		}
+	}
+
+	auto EncodeBlock(const std::array<std::array<float, 4>, 16>& block, const BlockFormat format, uint8_t* out_block) -> void
+	{
+		switch (format)
+		{
+		case BlockFormat::bc1: EncodeBC1Block(block, out_block); break;
+		case BlockFormat::bc3: EncodeBC4Block(block, 3, out_block); EncodeBC1Block(block, out_block + 8); break;
+		case BlockFormat::bc4: EncodeBC4Block(block, 0, out_block); break;
+		case BlockFormat::bc5: EncodeBC4Block(block, 0, out_block); EncodeBC4Block(block, 1, out_block + 8); break;
+		}
+	}
+
+	auto GetBlocksCount(const int size) -> int
+	{
+		return (size + 3) / 4;
+	}
+
+#pragma endregion
+
+#pragma region KTX2
+
+	// Vulkan formats and data format descriptor values of the KTX2 specification
+	static constexpr uint32_t VkFormatBC1RgbUnorm = 131;
+	static constexpr uint32_t VkFormatBC1RgbSrgb = 132;
+	static constexpr uint32_t VkFormatBC3Unorm = 137;
+	static constexpr uint32_t VkFormatBC3Srgb = 138;
+	static constexpr uint32_t VkFormatBC4Unorm = 139;
+	static constexpr uint32_t VkFormatBC5Unorm = 141;
+
+	static constexpr std::array<uint8_t, 12> Ktx2Identifier = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+	static constexpr size_t Ktx2HeaderSize = 80;
+	static constexpr size_t Ktx2LevelIndexEntrySize = 24;
+
+	auto ToVkFormat(const BlockFormat format, const bool is_srgb) -> uint32_t
+	{
+		switch (format)
+		{
+		case BlockFormat::bc1: return is_srgb ? VkFormatBC1RgbSrgb : VkFormatBC1RgbUnorm;
+		case BlockFormat::bc3: return is_srgb ? VkFormatBC3Srgb : VkFormatBC3Unorm;
+		case BlockFormat::bc4: return VkFormatBC4Unorm;
+		case BlockFormat::bc5: return VkFormatBC5Unorm;
+		}
+		return {};
+	}
+
+	auto FromVkFormat(const uint32_t vk_format) -> std::optional<std::pair<BlockFormat, bool>>
+	{
+		switch (vk_format)
+		{
+		case VkFormatBC1RgbUnorm: return std::pair{ BlockFormat::bc1, false };
+		case VkFormatBC1RgbSrgb: return std::pair{ BlockFormat::bc1, true };
+		case VkFormatBC3Unorm: return std::pair{ BlockFormat::bc3, false };
+		case VkFormatBC3Srgb: return std::pair{ BlockFormat::bc3, true };
+		case VkFormatBC4Unorm: return std::pair{ BlockFormat::bc4, false };
+		case VkFormatBC5Unorm: return std::pair{ BlockFormat::bc5, false };
+		default: return std::nullopt;
+		}
+	}
+
+	auto AppendU32(std::vector<uint8_t>& bytes, const uint32_t value) -> void
+	{
+		for (auto byte_idx = 0; byte_idx != 4; ++byte_idx)
+		{
+			bytes.push_back(static_cast<uint8_t>(value >> (byte_idx * 8)));
+		}
+	}
+
+	auto AppendU64(std::vector<uint8_t>& bytes, const uint64_t value) -> void
+	{
+		AppendU32(bytes, static_cast<uint32_t>(value));
+		AppendU32(bytes, static_cast<uint32_t>(value >> 32));
+	}
+
+	auto ReadU32(const std::span<const uint8_t> bytes, const size_t offset) -> uint32_t
+	{
+		auto value = uint32_t{ 0 };
+		for (auto byte_idx = 0; byte_idx != 4; ++byte_idx)
+		{
+			value |= static_cast<uint32_t>(bytes[offset + byte_idx]) << (byte_idx * 8);
+		}
+		return value;
+	}
+
+	auto ReadU64(const std::span<const uint8_t> bytes, const size_t offset) -> uint64_t
+	{
+		return ReadU32(bytes, offset) | static_cast<uint64_t>(ReadU32(bytes, offset + 4)) << 32;
+	}
+
+	/**
+	 * \brief Basic data format descriptor of a block compressed format, one sample per 64 bits half block.
+	 */
+	auto BuildDataFormatDescriptor(const BlockFormat format, const bool is_srgb) -> std::vector<uint8_t>
+	{
+		struct Sample
+		{
+			uint32_t m_bit_offset = {};
+			uint32_t m_channel_type = {};
+		};
+
+		// color models BC1A, BC3, BC4, BC5; channel ids: color/red/data 0, green 1, alpha 15; 0x10 marks a linear alpha in an sRGB format
+		auto color_model = uint32_t{};
+		auto samples = std::vector<Sample>{};
+		switch (format)
+		{
+		case BlockFormat::bc1: color_model = 128; samples = { { 0, 0 } }; break;
+		case BlockFormat::bc3: color_model = 130; samples = { { 0, is_srgb ? 15u | 0x10u : 15u }, { 64, 0 } }; break;
+		case BlockFormat::bc4: color_model = 131; samples = { { 0, 0 } }; break;
+		case BlockFormat::bc5: color_model = 132; samples = { { 0, 0 }, { 64, 1 } }; break;
+		}
+
+		const auto block_size = static_cast<uint32_t>(24 + 16 * samples.size());
+
+		auto descriptor = std::vector<uint8_t>{};
+		AppendU32(descriptor, 4 + block_size);
+		AppendU32(descriptor, 0);									// Khronos vendor, basic descriptor type
+		AppendU32(descriptor, 2 | block_size << 16);				// version 1.3
+		AppendU32(descriptor, color_model | 1 << 8 | (is_srgb ? 2u : 1u) << 16);	// BT.709 primaries, sRGB or linear transfer
+		AppendU32(descriptor, 3 | 3 << 8);							// 4x4 texel blocks
+		AppendU32(descriptor, static_cast<uint32_t>(GetBlockBytes(format)));
+		AppendU32(descriptor, 0);
+
+		for (const auto& [bit_offset, channel_type] : samples)
+		{
+			AppendU32(descriptor, bit_offset | 63 << 16 | channel_type << 24);
+			AppendU32(descriptor, 0);
+			AppendU32(descriptor, 0);
+			AppendU32(descriptor, UINT32_MAX);
+		}
+
+		return descriptor;
+	}
+
+#pragma endregion
+
+	auto TextureRoleToString(const TextureRole role) -> std::string_view
+	{
+		switch (role)
+		{
+		case TextureRole::color: return "color";
+		case TextureRole::color_alpha: return "color_alpha";
+		case TextureRole::normal: return "normal";
+		case TextureRole::mask: return "mask";
+		}
+		return {};
+	}
+
+	auto ParseTextureRole(const std::string_view name) -> std::optional<TextureRole>
+	{
+		for (const auto role : { TextureRole::color, TextureRole::color_alpha, TextureRole::normal, TextureRole::mask })
+		{
+			if (TextureRoleToString(role) == name)
+			{
+				return role;
+			}
+		}
+		return std::nullopt;
+	}
+
+	auto GuessTextureRole(const std::filesystem::path& path, const bool has_alpha) -> TextureRole
+	{
+		auto stem = path.stem().string();
+		std::ranges::transform(stem, stem.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+		if (stem.find("normal") != std::string::npos || stem.ends_with("_n") || stem.ends_with("_nrm"))
+		{
+			return TextureRole::normal;
+		}
+
+		for (const auto mask_name : { "rough", "metal", "_ao", "occlusion", "height", "mask", "gloss", "spec", "disp" })
+		{
+			if (stem.find(mask_name) != std::string::npos)
+			{
+				return TextureRole::mask;
+			}
+		}
+
+		return has_alpha ? TextureRole::color_alpha : TextureRole::color;
+	}
+
+	auto LoadSourceImage(const std::filesystem::path& path) -> std::optional<SourceImage>
+	{
+		int width = {}, height = {}, num_channels = {};
+		const auto image_data = stbi_load(path.string().c_str(), &width, &height, &num_channels, STBI_rgb_alpha);
+		if (!image_data)
+		{
+			return std::nullopt;
+		}
+
+		auto image = SourceImage{ width, height, { image_data, image_data + static_cast<size_t>(width) * height * 4 } };
+		stbi_image_free(image_data);
+
+		for (auto texel_idx = size_t{ 3 }; texel_idx < image.m_pixels.size() && !image.m_has_alpha; texel_idx += 4)
+		{
+			image.m_has_alpha = image.m_pixels[texel_idx] != 255;
+		}
+
+		return image;
+	}
+
+	auto GenerateMipChain(const std::span<const uint8_t> rgba, const int width, const int height, const TextureRole role) -> std::vector<CookedMip>
+	{
+		auto mips = std::vector<CookedMip>{};
+		mips.push_back({ width, height, { rgba.begin(), rgba.end() } });
+
+		// filtered in float, linear light for colors, each level from the previous one
+		auto texels = ToFloatTexels(rgba, role);
+		auto mip_width = width;
+		auto mip_height = height;
+
+		while (mip_width > 1 || mip_height > 1)
+		{
+			const auto next_width = std::max(mip_width / 2, 1);
+			const auto next_height = std::max(mip_height / 2, 1);
+
+			texels = Downsample(texels, mip_width, mip_height, next_width, next_height);
+			if (role == TextureRole::normal)
+			{
+				RenormalizeNormals(texels);
+			}
+
+			mip_width = next_width;
+			mip_height = next_height;
+			mips.push_back({ mip_width, mip_height, ToByteTexels(texels, role) });
+		}
+
+		return mips;
+	}
+
+	auto CookTexture(const std::span<const uint8_t> rgba, const int width, const int height, const TextureRole role) -> CookedTexture
+	{
+		auto cooked_texture = CookedTexture{ GetBlockFormat(role), IsColorRole(role) };
+		const auto block_bytes = GetBlockBytes(cooked_texture.m_format);
+
+		for (const auto& mip : GenerateMipChain(rgba, width, height, role))
+		{
+			const auto blocks_x = GetBlocksCount(mip.m_width);
+			const auto blocks_y = GetBlocksCount(mip.m_height);
+
+			auto cooked_mip = CookedMip{ mip.m_width, mip.m_height, std::vector<uint8_t>(static_cast<size_t>(blocks_x) * blocks_y * block_bytes) };
+
+			JobSystem::GetInstance().ParallelFor(static_cast<size_t>(blocks_y), BlockRowsPerJob, [&](const size_t begin, const size_t end) {
+				for (auto block_y = begin; block_y != end; ++block_y)
+				{
+					for (auto block_x = 0; block_x != blocks_x; ++block_x)
+					{
+						auto* out_block = cooked_mip.m_data.data() + (block_y * blocks_x + block_x) * block_bytes;
+						EncodeBlock(GatherBlock(mip, block_x, static_cast<int>(block_y)), cooked_texture.m_format, out_block);
+					}
+				}
+			});
+
+			cooked_texture.m_mips.push_back(std::move(cooked_mip));
+		}
+
+		return cooked_texture;
+	}
+
+	auto WriteKtx2(const std::filesystem::path& path, const CookedTexture& texture) -> bool
+	{
+		if (texture.m_mips.empty())
+		{
+			return false;
+		}
+
+		const auto levels_count = texture.m_mips.size();
+		const auto descriptor = BuildDataFormatDescriptor(texture.m_format, texture.m_is_srgb);
+		const auto descriptor_offset = Ktx2HeaderSize + levels_count * Ktx2LevelIndexEntrySize;
+
+		// levels are stored from the smallest, each aligned to its block size
+		const auto alignment = GetBlockBytes(texture.m_format);
+		auto level_offsets = std::vector<size_t>(levels_count);
+		auto data_end = descriptor_offset + descriptor.size();
+		for (auto level_idx = levels_count; level_idx-- != 0;)
+		{
+			data_end = (data_end + alignment - 1) / alignment * alignment;
+			level_offsets[level_idx] = data_end;
+			data_end += texture.m_mips[level_idx].m_data.size();
+		}
+
+		auto bytes = std::vector<uint8_t>{ Ktx2Identifier.begin(), Ktx2Identifier.end() };
+		AppendU32(bytes, ToVkFormat(texture.m_format, texture.m_is_srgb));
+		AppendU32(bytes, 1);														// type size, 1 for block compressed formats
+		AppendU32(bytes, static_cast<uint32_t>(texture.m_mips.front().m_width));
+		AppendU32(bytes, static_cast<uint32_t>(texture.m_mips.front().m_height));
+		AppendU32(bytes, 0);														// depth
+		AppendU32(bytes, 0);														// layers
+		AppendU32(bytes, 1);														// faces
+		AppendU32(bytes, static_cast<uint32_t>(levels_count));
+		AppendU32(bytes, 0);														// no supercompression
+		AppendU32(bytes, static_cast<uint32_t>(descriptor_offset));
+		AppendU32(bytes, static_cast<uint32_t>(descriptor.size()));
+		AppendU32(bytes, 0);														// no key/value data
+		AppendU32(bytes, 0);
+		AppendU64(bytes, 0);														// no supercompression global data
+		AppendU64(bytes, 0);
+
+		for (auto level_idx = size_t{ 0 }; level_idx != levels_count; ++level_idx)
+		{
+			AppendU64(bytes, level_offsets[level_idx]);
+			AppendU64(bytes, texture.m_mips[level_idx].m_data.size());
+			AppendU64(bytes, texture.m_mips[level_idx].m_data.size());
+		}
+
+		bytes.insert(bytes.end(), descriptor.begin(), descriptor.end());
+
+		bytes.resize(data_end);
+		for (auto level_idx = size_t{ 0 }; level_idx != levels_count; ++level_idx)
+		{
+			std::ranges::copy(texture.m_mips[level_idx].m_data, bytes.begin() + static_cast<std::ptrdiff_t>(level_offsets[level_idx]));
+		}
+
+		auto file = std::ofstream{ path, std::ios::binary };
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return static_cast<bool>(file);
+	}
+
+	/**
+	 * \brief Header and level index of the KTX2 file in bytes.
+	 */
+	auto ParseKtx2Layout(const std::span<const uint8_t> bytes) -> std::optional<Ktx2Layout>
+	{
+		if (bytes.size() < Ktx2HeaderSize || !std::equal(Ktx2Identifier.begin(), Ktx2Identifier.end(), bytes.begin()))
+		{
+			return std::nullopt;
+		}
+
+		const auto format = FromVkFormat(ReadU32(bytes, 12));
+		const auto width = ReadU32(bytes, 20);
+		const auto height = ReadU32(bytes, 24);
+		const auto depth = ReadU32(bytes, 28);
+		const auto layers_count = ReadU32(bytes, 32);
+		const auto faces_count = ReadU32(bytes, 36);
+		const auto levels_count = ReadU32(bytes, 40);
+		const auto supercompression = ReadU32(bytes, 44);
+
+		// 2D textures with their mips stored, as written by WriteKtx2
+		if (!format || width == 0 || height == 0 || depth > 1 || layers_count > 1 || faces_count != 1 || levels_count == 0 || levels_count > 32 || supercompression != 0)
+		{
+			return std::nullopt;
+		}
+
+		if (bytes.size() < Ktx2HeaderSize + static_cast<size_t>(levels_count) * Ktx2LevelIndexEntrySize)
+		{
+			return std::nullopt;
+		}
+
+		const auto level_index = bytes.subspan(Ktx2HeaderSize);
+		const auto file_size = static_cast<uint64_t>(bytes.size());
+
+		auto layout = Ktx2Layout{ format->first, format->second };
+		const auto block_bytes = GetBlockBytes(layout.m_format);
+
+		for (auto level_idx = uint32_t{ 0 }; level_idx != levels_count; ++level_idx)
+		{
+			const auto entry_offset = static_cast<size_t>(level_idx) * Ktx2LevelIndexEntrySize;
+			const auto level_offset = ReadU64(level_index, entry_offset);
+			const auto level_size = ReadU64(level_index, entry_offset + 8);
+
+			const auto mip_width = std::max(static_cast<int>(width >> level_idx), 1);
+			const auto mip_height = std::max(static_cast<int>(height >> level_idx), 1);
+			const auto expected_size = static_cast<uint64_t>(GetBlocksCount(mip_width)) * GetBlocksCount(mip_height) * block_bytes;
+
+			if (level_size != expected_size || level_offset > file_size || level_size > file_size - level_offset)
+			{
+				return std::nullopt;
+			}
+
+			layout.m_levels.push_back({ level_offset, level_size, mip_width, mip_height });
+		}
+
+		return layout;
+	}
+
+	auto ReadKtx2Layout(const std::filesystem::path& path) -> std::optional<Ktx2Layout>
+	{
+		// mapped, only the pages of the header and the level index are read
+		const auto file = AssetFileSystem::GetInstance().Read(path);
+		return file ? ParseKtx2Layout(file->m_bytes) : std::nullopt;
+	}
+
+	auto ReadKtx2Levels(const std::filesystem::path& path, const Ktx2Layout& layout, const size_t first_level, const size_t levels_count) -> std::optional<CookedTexture>
+	{
+		const auto file = AssetFileSystem::GetInstance().Read(path);
+		if (!file || first_level + levels_count > layout.m_levels.size())
+		{
+			return std::nullopt;
+		}
+
+		auto texture = CookedTexture{ layout.m_format, layout.m_is_srgb };
+
+		for (auto level_idx = first_level; level_idx != first_level + levels_count; ++level_idx)
+		{
+			const auto& level = layout.m_levels[level_idx];
+
+			// the layout may come from an older version of the file
+			if (level.m_offset > file->m_bytes.size() || level.m_size > file->m_bytes.size() - level.m_offset)
+			{
+				return std::nullopt;
+			}
+
+			const auto level_bytes = file->m_bytes.subspan(level.m_offset, level.m_size);
+			texture.m_mips.push_back({ level.m_width, level.m_height, { level_bytes.begin(), level_bytes.end() } });
+		}
+
+		return texture;
+	}
+
+	auto ReadKtx2(const std::filesystem::path& path) -> std::optional<CookedTexture>
+	{
+		const auto layout = ReadKtx2Layout(path);
+		return layout ? ReadKtx2Levels(path, layout.value(), 0, layout->m_levels.size()) : std::nullopt;
+	}
+
+	auto GetCookedTexturePath(const std::filesystem::path& image_path) -> std::filesystem::path
+	{
+		return std::filesystem::path{ image_path }.replace_extension(".ktx2");
+	}
+}
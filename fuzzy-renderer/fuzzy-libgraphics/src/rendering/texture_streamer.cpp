@@ -0,0 +1,421 @@
+#include <rendering/texture_streamer.h>
+
+#include <logger.h>
+#include <render_profiler.h>
+#include <opengl/gl_state_cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace libgraphics
+{
+	// each frame of the upload ring has a segment this big
+	static constexpr uint64_t RingSegmentSize = constants::TextureStreamingUploadBytesPerFrame;
+
+	auto GetLevelsBytes(const Ktx2Layout& layout, const size_t first_level) -> uint64_t
+	{
+		auto bytes = uint64_t{ 0 };
+		for (auto level_idx = first_level; level_idx < layout.m_levels.size(); ++level_idx)
+		{
+			bytes += layout.m_levels[level_idx].m_size;
+		}
+		return bytes;
+	}
+
+	/**
+	 * \brief Finest level worth having for a texture covering pixels on screen, the one with about as many texels across.
+	 */
+	auto GetWantedLevel(const StreamedTexture& streamed, const uint32_t pixels) -> size_t
+	{
+		const auto& base_level = streamed.m_layout.m_levels.front();
+		const auto texels = static_cast<float>(std::max(base_level.m_width, base_level.m_height));
+		const auto level = static_cast<int>(std::floor(std::log2(texels / static_cast<float>(std::max(pixels, 1u)))));
+		return std::min(static_cast<size_t>(std::max(level, 0)), streamed.m_tail_level);
+	}
+
+	auto TextureStreamer::GetInstance() -> TextureStreamer&
+	{
+		static auto instance = TextureStreamer{};
+		return instance;
+	}
+
+	auto TextureStreamer::LoadMipTail(const std::filesystem::path& cooked_path) -> std::optional<StreamableTexture>
+	{
+		auto layout = ReadKtx2Layout(cooked_path);
+		if (!layout)
+		{
+			return std::nullopt;
+		}
+
+		auto tail_level = size_t{ 0 };
+		while (tail_level + 1 < layout->m_levels.size() && std::max(layout->m_levels[tail_level].m_width, layout->m_levels[tail_level].m_height) > constants::TextureStreamingMipTailSize)
+		{
+			tail_level++;
+		}
+
+		auto mip_tail = ReadKtx2Levels(cooked_path, layout.value(), tail_level, layout->m_levels.size() - tail_level);
+		if (!mip_tail)
+		{
+			return std::nullopt;
+		}
+
+		return StreamableTexture{ cooked_path, std::move(layout.value()), std::move(mip_tail.value()), tail_level };
+	}
+
+	auto TextureStreamer::CreateTexture(StreamableTexture streamable_texture, const std::string_view source, const TextureType type) -> Texture
+	{
+		auto texture = Texture{ streamable_texture.m_mip_tail, source, type };
+
+		// small enough to be all tail, nothing to stream
+		if (streamable_texture.m_tail_level == 0 || !texture.m_storage)
+		{
+			return texture;
+		}
+
+		auto streamed = std::make_shared<StreamedTexture>();
+		streamed->m_path = std::move(streamable_texture.m_path);
+		streamed->m_layout = std::move(streamable_texture.m_layout);
+		streamed->m_tail_level = streamable_texture.m_tail_level;
+		streamed->m_resident_level = streamed->m_tail_level;
+		streamed->m_resident_bytes = GetLevelsBytes(streamed->m_layout, streamed->m_tail_level);
+		streamed->m_wanted_level = streamed->m_tail_level;
+		streamed->m_last_needed_frame = m_frame_index;
+
+		texture.m_storage->m_streamed = streamed;
+		m_resident_bytes += streamed->m_resident_bytes;
+		m_textures.push_back({ texture.m_storage, std::move(streamed) });
+
+		return texture;
+	}
+
+	auto TextureStreamer::Update() -> void
+	{
+		CX_PROFILE_FUNCTION();
+
+		m_frame_index++;
+
+		// the segment of this frame was last written TextureStreamingRingSize - 1 frames ago, its uploads are long done
+		if (m_ring_buffer)
+		{
+			m_ring_segment_idx = (m_ring_segment_idx + 1) % m_ring_segments.size();
+			m_ring_segment_used = 0;
+
+			if (auto& fence = m_ring_segments[m_ring_segment_idx].m_fence)
+			{
+				while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000) == GL_TIMEOUT_EXPIRED)
+				{
+				}
+				glDeleteSync(std::exchange(fence, {}));
+			}
+		}
+
+		std::erase_if(m_textures, [this](const Entry& entry) {
+			if (!entry.m_storage.expired())
+			{
+				return false;
+			}
+
+			// a read in flight completes into the state its job keeps alive
+			const auto& streamed = *entry.m_streamed;
+			if (streamed.m_reading_level)
+			{
+				m_reserved_bytes -= streamed.m_layout.m_levels[streamed.m_reading_level.value()].m_size;
+				m_reads_count--;
+			}
+			m_resident_bytes -= streamed.m_resident_bytes;
+			return true;
+		});
+
+		// requests of the last recording
+		for (const auto& entry : m_textures)
+		{
+			auto& streamed = *entry.m_streamed;
+			if (const auto pixels = streamed.m_requested_pixels.exchange(0, std::memory_order_relaxed); pixels != 0)
+			{
+				streamed.m_wanted_level = GetWantedLevel(streamed, pixels);
+				streamed.m_last_needed_frame = m_frame_index;
+			}
+		}
+
+		UploadReadLevels();
+
+		// a lowered budget
+		MakeRoom(0);
+
+		IssueReads();
+
+		if (m_ring_buffer && m_ring_segment_used != 0)
+		{
+			m_ring_segments[m_ring_segment_idx].m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+	}
+
+	auto TextureStreamer::Forget(const Texture::Storage& storage) -> void
+	{
+		for (auto& entry : m_textures)
+		{
+			if (entry.m_streamed == storage.m_streamed)
+			{
+				entry.m_storage.reset();
+			}
+		}
+	}
+
+	auto TextureStreamer::Clear() -> void
+	{
+		JobSystem::GetInstance().Wait(m_reads_counter);
+
+		m_textures.clear();
+		m_resident_bytes = 0;
+		m_reserved_bytes = 0;
+		m_reads_count = 0;
+
+		ReleaseRing();
+	}
+
+	auto TextureStreamer::IssueReads() -> void
+	{
+		auto candidates = std::vector<const Entry*>{};
+		for (const auto& entry : m_textures)
+		{
+			const auto& streamed = *entry.m_streamed;
+			if (streamed.m_last_needed_frame == m_frame_index && streamed.m_wanted_level < streamed.m_resident_level && !streamed.m_reading_level)
+			{
+				candidates.push_back(&entry);
+			}
+		}
+
+		// the textures furthest from what they need first
+		std::ranges::sort(candidates, std::ranges::greater{}, [](const Entry* entry) { return entry->m_streamed->m_resident_level - entry->m_streamed->m_wanted_level; });
+
+		for (const auto* entry : candidates)
+		{
+			if (m_reads_count == constants::TextureStreamingMaxReads)
+			{
+				return;
+			}
+
+			// one level at a time, from coarse to fine, so a texture improves as soon as possible
+			auto& streamed = *entry->m_streamed;
+			const auto level = streamed.m_resident_level - 1;
+			const auto level_bytes = streamed.m_layout.m_levels[level].m_size;
+
+			// whatever is left is needed this frame
+			if (!MakeRoom(level_bytes))
+			{
+				return;
+			}
+
+			m_reserved_bytes += level_bytes;
+			m_reads_count++;
+
+			streamed.m_reading_level = level;
+			streamed.m_is_read.store(false, std::memory_order_relaxed);
+
+			// disk reads, a render thread waiting on the shared queue must never end up running one
+			JobSystem::GetInstance().DispatchBackground([streamed = entry->m_streamed, level] {
+				streamed->m_read_level = ReadKtx2Levels(streamed->m_path, streamed->m_layout, level, 1);
+				streamed->m_is_read.store(true, std::memory_order_release);
+			}, &m_reads_counter);
+		}
+	}
+
+	auto TextureStreamer::UploadReadLevels() -> void
+	{
+		auto uploaded_bytes = uint64_t{ 0 };
+
+		for (const auto& entry : m_textures)
+		{
+			auto& streamed = *entry.m_streamed;
+			if (!streamed.m_reading_level || !streamed.m_is_read.load(std::memory_order_acquire))
+			{
+				continue;
+			}
+
+			const auto level = streamed.m_reading_level.value();
+			const auto level_bytes = streamed.m_layout.m_levels[level].m_size;
+
+			// at least one level per frame, whatever its size
+			if (uploaded_bytes != 0 && uploaded_bytes + level_bytes > constants::TextureStreamingUploadBytesPerFrame)
+			{
+				continue;
+			}
+
+			m_reserved_bytes -= level_bytes;
+			m_reads_count--;
+			streamed.m_reading_level.reset();
+			const auto read_level = std::exchange(streamed.m_read_level, std::nullopt);
+
+			if (!read_level)
+			{
+				// the file changed or went away, the texture keeps the levels it has
+				CX_CORE_ERROR("Unable to read level {} of {}, the texture stops streaming", level, streamed.m_path.string());
+				streamed.m_tail_level = streamed.m_resident_level;
+				continue;
+			}
+
+			if (const auto storage = entry.m_storage.lock())
+			{
+				SetResidentLevel(*storage, streamed, level, read_level->m_mips.front().m_data.data());
+				uploaded_bytes += level_bytes;
+				m_uploaded_bytes += level_bytes;
+			}
+		}
+	}
+
+	auto TextureStreamer::MakeRoom(const uint64_t bytes) -> bool
+	{
+		while (m_resident_bytes + m_reserved_bytes + bytes > m_budget_bytes)
+		{
+			// levels finer than the texture needs first, then the least recently needed textures
+			const auto get_eviction_order = [](const StreamedTexture& streamed) { return std::pair{ streamed.m_resident_level >= streamed.m_wanted_level, streamed.m_last_needed_frame }; };
+
+			const Entry* victim = {};
+			for (const auto& entry : m_textures)
+			{
+				const auto& streamed = *entry.m_streamed;
+				if (streamed.m_resident_level == streamed.m_tail_level || streamed.m_reading_level)
+				{
+					continue;
+				}
+
+				const auto has_surplus = streamed.m_resident_level < streamed.m_wanted_level;
+				if (!has_surplus && streamed.m_last_needed_frame == m_frame_index)
+				{
+					continue;
+				}
+
+				if (!victim || get_eviction_order(streamed) < get_eviction_order(*victim->m_streamed))
+				{
+					victim = &entry;
+				}
+			}
+
+			if (!victim)
+			{
+				return false;
+			}
+
+			auto& streamed = *victim->m_streamed;
+			m_evicted_bytes += streamed.m_layout.m_levels[streamed.m_resident_level].m_size;
+			SetResidentLevel(*victim->m_storage.lock(), streamed, streamed.m_resident_level + 1, nullptr);
+		}
+
+		return true;
+	}
+
+	auto TextureStreamer::SetResidentLevel(Texture::Storage& storage, StreamedTexture& streamed, const size_t resident_level, const void* level_data) -> void
+	{
+		const auto& layout = streamed.m_layout;
+		const auto& base_level = layout.m_levels[resident_level];
+		const auto levels_count = static_cast<int>(layout.m_levels.size() - resident_level);
+
+		const auto texture_id = CreateCompressedTexture(layout.m_format, layout.m_is_srgb, base_level.m_width, base_level.m_height, levels_count);
+
+		// the levels both textures have never leave the GPU
+		for (auto level_idx = std::max(resident_level, streamed.m_resident_level); level_idx != layout.m_levels.size(); ++level_idx)
+		{
+			const auto& level = layout.m_levels[level_idx];
+			glCopyImageSubData(storage.m_texture_id, GL_TEXTURE_2D, static_cast<GLint>(level_idx - streamed.m_resident_level), 0, 0, 0,
+				texture_id, GL_TEXTURE_2D, static_cast<GLint>(level_idx - resident_level), 0, 0, 0, level.m_width, level.m_height, 1);
+		}
+
+		if (level_data)
+		{
+			const auto gl_format = ToGLFormat(layout.m_format, layout.m_is_srgb);
+			const auto level_size = static_cast<GLsizei>(base_level.m_size);
+
+			if (const auto offset = AllocateUpload(base_level.m_size))
+			{
+				// with an unpack buffer bound the pointer is an offset, the driver copies from the ring when it gets to it
+				std::memcpy(m_ring_mapped + offset.value(), level_data, base_level.m_size);
+
+				auto& state_cache = GLStateCache::GetInstance();
+				state_cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_ring_buffer);
+				glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, base_level.m_width, base_level.m_height, gl_format, level_size, reinterpret_cast<const void*>(static_cast<uintptr_t>(offset.value())));
+				state_cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			}
+			else
+			{
+				// more than the segment has left, straight from memory
+				glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, base_level.m_width, base_level.m_height, gl_format, level_size, level_data);
+			}
+		}
+
+		GLStateCache::GetInstance().DeleteTexture(storage.m_texture_id);
+		storage.m_texture_id = texture_id;
+
+		const auto resident_bytes = GetLevelsBytes(layout, resident_level);
+		m_resident_bytes = m_resident_bytes - streamed.m_resident_bytes + resident_bytes;
+		streamed.m_resident_bytes = resident_bytes;
+		streamed.m_resident_level = resident_level;
+		storage.m_memory.Resize(resident_bytes);
+	}
+
+	auto TextureStreamer::AllocateUpload(const uint64_t size) -> std::optional<uint64_t>
+	{
+		if (!m_ring_buffer)
+		{
+			AllocateRing();
+		}
+
+		if (m_ring_segment_used + size > RingSegmentSize)
+		{
+			return std::nullopt;
+		}
+
+		const auto offset = m_ring_segment_idx * RingSegmentSize + m_ring_segment_used;
+
+		// block rows are copied with 16 bytes loads by some drivers
+		m_ring_segment_used += (size + 15) & ~uint64_t{ 15 };
+
+		return offset;
+	}
+
+	auto TextureStreamer::AllocateRing() -> void
+	{
+		const auto buffer_size = static_cast<GLsizeiptr>(RingSegmentSize * constants::TextureStreamingRingSize);
+		constexpr auto map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		auto& state_cache = GLStateCache::GetInstance();
+
+		glGenBuffers(1, &m_ring_buffer);
+		state_cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_ring_buffer);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, buffer_size, nullptr, map_flags);
+		m_ring_mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, buffer_size, map_flags));
+		state_cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		m_ring_segments.resize(constants::TextureStreamingRingSize);
+		m_ring_segment_idx = 0;
+		m_ring_segment_used = 0;
+		m_ring_memory = TrackedMemory{ MemoryCategory::upload_buffer, static_cast<uint64_t>(buffer_size), "texture streaming ring" };
+	}
+
+	auto TextureStreamer::ReleaseRing() -> void
+	{
+		if (!m_ring_buffer)
+		{
+			return;
+		}
+
+		for (auto& segment : m_ring_segments)
+		{
+			if (segment.m_fence)
+			{
+				glDeleteSync(std::exchange(segment.m_fence, {}));
+			}
+		}
+
+		auto& state_cache = GLStateCache::GetInstance();
+		state_cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_ring_buffer);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		state_cache.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		state_cache.DeleteBuffer(std::exchange(m_ring_buffer, 0));
+
+		m_ring_mapped = {};
+		m_ring_segments.clear();
+		m_ring_memory.Reset();
+	}
+}
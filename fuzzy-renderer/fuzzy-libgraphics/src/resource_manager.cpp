@@ -0,0 +1,227 @@
+#include <resource_manager.h>
+
+#include <engine_constants.h>
+#include <logger.h>
+#include <memory_tracker.h>
+
+#include <algorithm>
+#include <ranges>
+
+namespace libgraphics
+{
+	auto ResourceManager::GetInstance() -> ResourceManager&
+	{
+		static auto instance = ResourceManager{};
+		return instance;
+	}
+
+	ResourceManager::ResourceManager()
+	{
+		m_budgets.fill(constants::ResourceBudgetBytes);
+	}
+
+	auto ResourceManager::Update() -> void
+	{
+		// what is in use now is recently used, however it is reached (a mesh renderer, a material...)
+		for (auto& entry : std::views::values(m_entries))
+		{
+			if (entry.m_resource.use_count() > 1)
+			{
+				entry.m_last_used_frame = m_frame_index;
+			}
+		}
+
+		for (auto type_idx = size_t{ 0 }; type_idx != TypesCount; ++type_idx)
+		{
+			if (m_loaded_bytes[type_idx] > m_budgets[type_idx])
+			{
+				Evict(static_cast<ResourceType>(type_idx));
+			}
+		}
+
+		m_frame_index++;
+	}
+
+	auto ResourceManager::Clear() -> void
+	{
+		// m_next_id goes on, the handles of the previous entries don't alias new ones
+		m_entries.clear();
+		for (auto& ids_by_name : m_ids_by_name)
+		{
+			ids_by_name.clear();
+		}
+		m_loaded_bytes.fill(0);
+	}
+
+	auto ResourceManager::GetResources(const ResourceType type) const -> std::vector<ResourceInfo>
+	{
+		auto ids = std::vector<uint32_t>{};
+		for (const auto& [id, entry] : m_entries)
+		{
+			if (entry.m_type == type)
+			{
+				ids.push_back(id);
+			}
+		}
+		std::ranges::sort(ids);
+
+		auto resources = std::vector<ResourceInfo>{};
+		resources.reserve(ids.size());
+		for (const auto id : ids)
+		{
+			const auto& entry = m_entries.at(id);
+			const auto users_count = entry.m_resource ? static_cast<uint32_t>(entry.m_resource.use_count() - 1) : 0u;
+			resources.push_back({ entry.m_name, entry.m_bytes, users_count, entry.m_resource != nullptr });
+		}
+		return resources;
+	}
+
+	auto ResourceManager::FindId(const ResourceType type, const std::string_view name, const std::type_index resource_type) const -> uint32_t
+	{
+		const auto& ids_by_name = m_ids_by_name[static_cast<size_t>(type)];
+		const auto it = ids_by_name.find(std::string{ name });
+		if (it == ids_by_name.end())
+		{
+			return InvalidResourceId;
+		}
+
+		if (m_entries.at(it->second).m_resource_type != resource_type)
+		{
+			CX_CORE_ERROR("{} {} is registered as another kind of resource", ResourceTypeToString(type), name);
+			return InvalidResourceId;
+		}
+		return it->second;
+	}
+
+	auto ResourceManager::IsRegistered(const ResourceType type, const std::string_view name) const -> bool
+	{
+		return m_ids_by_name[static_cast<size_t>(type)].contains(std::string{ name });
+	}
+
+	auto ResourceManager::Register(const ResourceType type, std::string name, const std::type_index resource_type, std::function<std::shared_ptr<void>()> loader) -> uint32_t
+	{
+		const auto id = m_next_id++;
+		m_ids_by_name[static_cast<size_t>(type)].emplace(name, id);
+		m_entries.emplace(id, Entry{ std::move(name), type, resource_type, std::move(loader) });
+		return id;
+	}
+
+	auto ResourceManager::Adopt(const ResourceType type, std::string name, const std::type_index resource_type, std::shared_ptr<void> resource, const uint64_t bytes) -> uint32_t
+	{
+		auto id = InvalidResourceId;
+		if (IsRegistered(type, name))
+		{
+			id = FindId(type, name, resource_type);
+			if (id == InvalidResourceId)
+			{
+				return InvalidResourceId;
+			}
+		}
+		else
+		{
+			id = Register(type, std::move(name), resource_type, {});
+		}
+
+		auto& entry = m_entries.at(id);
+		auto& loaded_bytes = m_loaded_bytes[static_cast<size_t>(type)];
+		if (entry.m_resource)
+		{
+			loaded_bytes -= entry.m_bytes;
+		}
+
+		entry.m_loader = {};
+		entry.m_resource = std::move(resource);
+		entry.m_bytes = bytes;
+		entry.m_last_used_frame = m_frame_index;
+		loaded_bytes += bytes;
+		return id;
+	}
+
+	auto ResourceManager::GetResource(const uint32_t id) -> std::shared_ptr<void>
+	{
+		const auto it = m_entries.find(id);
+		if (it == m_entries.end())
+		{
+			return nullptr;
+		}
+
+		auto& entry = it->second;
+		if (!entry.m_resource)
+		{
+			LoadEntry(entry);
+		}
+
+		entry.m_last_used_frame = m_frame_index;
+		return entry.m_resource;
+	}
+
+	auto ResourceManager::LoadEntry(Entry& entry) -> void
+	{
+		const auto& type_name = ResourceTypeToString(entry.m_type);
+
+		// what the loader allocated and still holds is the size of the resource, shared textures found in the
+		// texture cache aren't counted as they aren't freed with it
+		auto& memory_tracker = MemoryTracker::GetInstance();
+		const auto checkpoint = memory_tracker.GetCheckpoint();
+		{
+			const auto memory_owner = MemoryOwnerScope{ entry.m_name };
+			entry.m_resource = entry.m_loader();
+		}
+
+		if (!entry.m_resource)
+		{
+			CX_CORE_ERROR("Unable to load {} {}", type_name, entry.m_name);
+			return;
+		}
+
+		entry.m_bytes = 0;
+		for (const auto& allocation : memory_tracker.GetAllocations(checkpoint))
+		{
+			entry.m_bytes += allocation.m_bytes;
+		}
+		m_loaded_bytes[static_cast<size_t>(entry.m_type)] += entry.m_bytes;
+
+		CX_CORE_DEBUG("Loaded {} {} ({} bytes)", type_name, entry.m_name, entry.m_bytes);
+	}
+
+	auto ResourceManager::Evict(const ResourceType type) -> void
+	{
+		// whatever is used elsewhere would stay alive anyway, evicting it frees nothing. A texture the texture cache
+		// hands out meanwhile (it finds them from the import jobs) merely outlives its entry, unaccounted for.
+		auto candidates = std::vector<std::pair<uint32_t, Entry*>>{};
+		for (auto& [id, entry] : m_entries)
+		{
+			if (entry.m_type == type && entry.m_resource && entry.m_resource.use_count() == 1 && entry.m_last_used_frame != m_frame_index)
+			{
+				candidates.emplace_back(id, &entry);
+			}
+		}
+
+		std::ranges::sort(candidates, std::ranges::less{}, [](const auto& candidate) { return candidate.second->m_last_used_frame; });
+
+		auto& loaded_bytes = m_loaded_bytes[static_cast<size_t>(type)];
+		for (const auto& [id, entry] : candidates)
+		{
+			if (loaded_bytes <= m_budgets[static_cast<size_t>(type)])
+			{
+				return;
+			}
+
+			CX_CORE_DEBUG("Evicted {} {} ({} bytes)", ResourceTypeToString(type), entry->m_name, entry->m_bytes);
+
+			loaded_bytes -= entry->m_bytes;
+			m_evictions_count++;
+
+			// nothing could load a tracked resource again
+			if (!entry->m_loader)
+			{
+				m_ids_by_name[static_cast<size_t>(type)].erase(entry->m_name);
+				m_entries.erase(id);
+				continue;
+			}
+
+			entry->m_resource.reset();
+			entry->m_bytes = 0;
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#include <software/sw_command_executor.h>
+
+#include <software/sw_mesh.h>
+#include <software/sw_rasterizer.h>
+#include <software/sw_shader.h>
+#include <rendering/render_stats.h>
+
+namespace libgraphics
+{
+	auto SWCommandExecutor::Execute(const CommandList& command_list, SWRasterizer& rasterizer) -> void
+	{
+		auto constants = SWShaderConstants{};
+
+		for (const auto& command : command_list.GetCommands())
+		{
+			switch (command.m_type)
+			{
+			case RenderCommandType::bind_pipeline:
+			{
+				constants = static_cast<const SWShader*>(command.m_bind_pipeline.m_shader)->GetConstants();
+			}
+			break;
+			case RenderCommandType::set_constant:
+			{
+				const auto& set_constant = command.m_set_constant;
+				SWShader::WriteConstant(constants, set_constant.m_slot, command_list.GetConstantData(set_constant.m_offset));
+				RenderStats::GetInstance().CountUniformUpload();
+			}
+			break;
+			case RenderCommandType::bind_texture: break;
+			case RenderCommandType::draw_indexed:
+			{
+				const auto& draw_indexed = command.m_draw_indexed;
+				rasterizer.DrawIndexed(*static_cast<const SWMesh*>(draw_indexed.m_mesh), constants, draw_indexed.m_instance_count);
+			}
+			break;
+			}
+		}
+	}
+}
@@ -0,0 +1,25 @@
+#include <software/sw_context.h>
+#include <software/sw_rasterizer.h>
+#include <job_system.h>
+#include <logger.h>
+
+namespace libgraphics
+{
+	SWContext::~SWContext() = default;
+
+	auto SWContext::Init(const int width, const int height, const std::string_view title) -> void
+	{
+		m_context_data.m_width = width;
+		m_context_data.m_height = height;
+
+		m_rasterizer = std::make_unique<SWRasterizer>(width, height);
+
+		CX_CORE_INFO("Software rasterizer for \"{}\" ({}x{}, {}, {} workers)", title, width, height,
+			m_rasterizer->IsUsingAVX2() ? "AVX2" : "scalar", JobSystem::GetInstance().GetWorkersCount());
+	}
+
+	auto SWContext::Shutdown() -> void
+	{
+		m_rasterizer.reset();
+	}
+}
@@ -0,0 +1,55 @@
+#include <software/sw_mesh.h>
+#include <software/sw_context.h>
+#include <software/sw_rasterizer.h>
+#include <software/sw_shader.h>
+
+#include <core.h>
+
+namespace libgraphics
+{
+	SWMesh::SWMesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices, std::string name, const std::optional<BoundingBox>& bounds)
+		: m_name{ std::move(name) }
+	{
+		SetData(std::move(vertices), std::move(indices));
+		if (bounds)
+		{
+			m_bounds = bounds.value();
+		}
+		else
+		{
+			ComputeBounds();
+		}
+	}
+
+	auto SWMesh::Draw(const std::shared_ptr<IShader>& shader) -> void
+	{
+		const auto& core = Core::GetInstance();
+		auto& rasterizer = std::static_pointer_cast<SWContext>(core.GetGraphicsWindow()->GetNativeHandle())->GetRasterizer();
+
+		rasterizer.SetLights(core.GetLights());
+		rasterizer.DrawIndexed(*this, std::static_pointer_cast<SWShader>(shader)->GetConstants());
+	}
+
+	auto SWMesh::SetData(std::vector<Vertex> vertices, std::vector<uint32_t> indices) -> void
+	{
+		m_data = std::make_shared<const MeshData>(std::move(vertices), std::move(indices), m_name.empty() ? "unnamed mesh" : m_name);
+	}
+
+	auto SWMesh::ComputeBounds() -> void
+	{
+		const auto vertices = GetVertices();
+		if (vertices.empty())
+		{
+			m_bounds = {};
+			return;
+		}
+
+		m_bounds = { vertices.front().m_position, vertices.front().m_position };
+
+		for (const auto& vertex : vertices)
+		{
+			m_bounds.m_min = glm::min(m_bounds.m_min, vertex.m_position);
+			m_bounds.m_max = glm::max(m_bounds.m_max, vertex.m_position);
+		}
+	}
+}
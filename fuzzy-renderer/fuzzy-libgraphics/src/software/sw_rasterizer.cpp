@@ -0,0 +1,627 @@
+#include <software/sw_rasterizer.h>
+#include <software/sw_mesh.h>
+
+#include <job_system.h>
+#include <render_profiler.h>
+#include <rendering/render_stats.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SW_RASTERIZER_X64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SW_TARGET_AVX2
+#else
+#define SW_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace libgraphics
+{
+#pragma region FREE FUNCTIONS
+
+	// clip space vertices are kept inside x, y in [-GuardBand * w, GuardBand * w] so window coordinates stay small
+	static constexpr auto GuardBand = 4.0f;
+	static constexpr auto SubpixelSteps = 256.0f;
+
+	auto CpuSupportsAVX2() -> bool
+	{
+#if defined(SW_RASTERIZER_X64) && defined(_MSC_VER)
+		int cpu_info[4] = {};
+		__cpuid(cpu_info, 1);
+		const auto has_avx = (cpu_info[2] & (1 << 28)) != 0;
+		const auto has_osxsave = (cpu_info[2] & (1 << 27)) != 0;
+
+		__cpuidex(cpu_info, 7, 0);
+		const auto has_avx2 = (cpu_info[1] & (1 << 5)) != 0;
+
+		// the OS must save the ymm registers too
+		return has_avx && has_osxsave && has_avx2 && (_xgetbv(0) & 0x6) == 0x6;
+#elif defined(SW_RASTERIZER_X64)
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	}
+
+	auto PackColor(const glm::vec4& color) -> uint32_t
+	{
+		const auto to_byte = [](const float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+		return to_byte(color.x) | to_byte(color.y) << 8 | to_byte(color.z) << 16 | to_byte(color.w) << 24;
+	}
+
+	auto Reflect(const glm::vec3& incident, const glm::vec3& normal) -> glm::vec3
+	{
+		return incident - normal * (2.0f * glm::dot(normal, incident));
+	}
+
+	auto SmoothStep(const float edge0, const float edge1, const float x) -> float
+	{
+		const auto t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+	// port of fragment.glsl, textures excluded
+	auto CalculateSpecular(const SWShaderConstants& constants, const glm::vec3& light_direction, const glm::vec3& view_direction, const glm::vec3& normal) -> float
+	{
+		const auto reflect_direction = Reflect(-light_direction, normal);
+		const auto dispersion_factor = 1.0f - constants.m_roughness;
+		const auto metallic = std::max(constants.m_metallic, 0.01f);
+		const auto intensity = 1.0f - constants.m_roughness;
+
+		return std::pow(std::max(glm::dot(view_direction, reflect_direction), 0.0f), metallic * 256.0f) * dispersion_factor * intensity;
+	}
+
+	auto CalculateLighting(const SWShaderConstants& constants, const std::vector<Light>& lights, const glm::vec3& world_position, const glm::vec3& normal) -> glm::vec3
+	{
+		constexpr auto ambient_strength = 0.25f;
+		constexpr auto specular_strength = 0.9f;
+
+		const auto& albedo = constants.m_albedo_color;
+		const auto view_direction = glm::normalize(constants.m_eye - world_position);
+
+		auto diffuse_color = glm::vec3{};
+		auto specular_color = glm::vec3{};
+
+		for (const auto& light : lights)
+		{
+			if (light.m_is_active == 0)
+			{
+				continue;
+			}
+
+			const auto light_color = glm::vec3{ light.m_color } * light.m_intensity;
+
+			auto light_direction = glm::vec3{};
+			auto attenuation = 1.0f;
+			auto spotlight_effect = 1.0f;
+
+			if (light.m_type == 0)
+			{
+				light_direction = glm::normalize(light.m_direction);
+			}
+			else if (light.m_type == 1 || light.m_type == 2)
+			{
+				light_direction = glm::normalize(light.m_position - world_position);
+				const auto distance = glm::length(light.m_position - world_position);
+				attenuation = 1.0f / (light.m_attenuation.x + light.m_attenuation.y * distance + light.m_attenuation.z * distance * distance);
+
+				if (light.m_type == 2)
+				{
+					const auto theta = glm::dot(light_direction, glm::normalize(-light.m_direction));
+					spotlight_effect = SmoothStep(std::cos(glm::radians(73.4f)), std::cos(glm::radians(50.2f)), theta);
+				}
+			}
+			else
+			{
+				continue;
+			}
+
+			const auto diffuse = std::max(glm::dot(light_direction, normal), 0.0f);
+			const auto specular = CalculateSpecular(constants, light_direction, view_direction, normal);
+
+			diffuse_color += albedo * light_color * (diffuse * attenuation * spotlight_effect);
+			specular_color += albedo * light_color * (specular_strength * specular * attenuation * spotlight_effect);
+		}
+
+		return albedo * ambient_strength + diffuse_color + specular_color;
+	}
+
+	auto LerpVertex(const auto& a, const auto& b, const float t)
+	{
+		auto result = a;
+		result.m_clip_position = a.m_clip_position + (b.m_clip_position - a.m_clip_position) * t;
+		result.m_world_position = a.m_world_position + (b.m_world_position - a.m_world_position) * t;
+		result.m_world_normal = a.m_world_normal + (b.m_world_normal - a.m_world_normal) * t;
+		return result;
+	}
+
+	// signed distances to the clip planes (near + guard band), positive inside
+	auto ClipDistance(const glm::vec4& position, const int plane_idx) -> float
+	{
+		switch (plane_idx)
+		{
+		case 0: return position.z + position.w;
+		case 1: return GuardBand * position.w - position.x;
+		case 2: return GuardBand * position.w + position.x;
+		case 3: return GuardBand * position.w - position.y;
+		case 4: return GuardBand * position.w + position.y;
+		default: return 0.0f;
+		}
+	}
+
+	static constexpr auto ClipPlanesCount = 5;
+
+	struct EdgeSetup
+	{
+		std::array<float, 3> m_a = {};
+		std::array<float, 3> m_b = {};
+		std::array<float, 3> m_origin_x = {};
+		std::array<float, 3> m_origin_y = {};
+		std::array<bool, 3> m_inclusive = {};
+	};
+
+	// edge k is the one opposite to vertex k, its function is the (unnormalized) barycentric weight of vertex k
+	auto MakeEdgeSetup(const std::array<float, 3>& x, const std::array<float, 3>& y) -> EdgeSetup
+	{
+		auto setup = EdgeSetup{};
+		for (auto edge_idx = 0; edge_idx != 3; ++edge_idx)
+		{
+			const auto a = (edge_idx + 1) % 3;
+			const auto b = (edge_idx + 2) % 3;
+
+			setup.m_a[edge_idx] = y[a] - y[b];
+			setup.m_b[edge_idx] = x[b] - x[a];
+			setup.m_origin_x[edge_idx] = x[a];
+			setup.m_origin_y[edge_idx] = y[a];
+
+			// top-left rule, pixels exactly on a shared edge belong to one triangle only
+			setup.m_inclusive[edge_idx] = setup.m_a[edge_idx] > 0.0f || (setup.m_a[edge_idx] == 0.0f && setup.m_b[edge_idx] < 0.0f);
+		}
+		return setup;
+	}
+
+	template <typename PixelFunction>
+	auto RasterizeScalar(const EdgeSetup& edges, const std::array<float, 3>& z, const float inv_area, const int x0, const int x1, const int y0, const int y1,
+		const float* depth, const int stride, PixelFunction&& pixel_function) -> void
+	{
+		for (auto y = y0; y <= y1; ++y)
+		{
+			const auto pixel_y = static_cast<float>(y) + 0.5f;
+			const auto pixel_x = static_cast<float>(x0) + 0.5f;
+
+			auto row = std::array<float, 3>{};
+			for (auto edge_idx = 0; edge_idx != 3; ++edge_idx)
+			{
+				row[edge_idx] = edges.m_b[edge_idx] * (pixel_y - edges.m_origin_y[edge_idx]) + edges.m_a[edge_idx] * (pixel_x - edges.m_origin_x[edge_idx]);
+			}
+
+			const auto depth_row = depth + static_cast<size_t>(y) * stride;
+
+			for (auto x = x0; x <= x1; ++x)
+			{
+				const auto step = static_cast<float>(x - x0);
+
+				auto inside = true;
+				auto e = std::array<float, 3>{};
+				for (auto edge_idx = 0; edge_idx != 3; ++edge_idx)
+				{
+					e[edge_idx] = row[edge_idx] + edges.m_a[edge_idx] * step;
+					inside &= edges.m_inclusive[edge_idx] ? e[edge_idx] >= 0.0f : e[edge_idx] > 0.0f;
+				}
+
+				if (!inside)
+				{
+					continue;
+				}
+
+				const auto l0 = e[0] * inv_area;
+				const auto l1 = e[1] * inv_area;
+				const auto l2 = e[2] * inv_area;
+				const auto pixel_z = (z[0] * l0 + z[1] * l1) + z[2] * l2;
+
+				if (pixel_z < depth_row[x])
+				{
+					pixel_function(x, y, l0, l1, l2, pixel_z);
+				}
+			}
+		}
+	}
+
+#ifdef SW_RASTERIZER_X64
+	template <typename PixelFunction>
+	SW_TARGET_AVX2 auto RasterizeAVX2(const EdgeSetup& edges, const std::array<float, 3>& z, const float inv_area, const int x0, const int x1, const int y0, const int y1,
+		const float* depth, const int stride, PixelFunction&& pixel_function) -> void
+	{
+		const auto lane_offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+		const auto zero = _mm256_setzero_ps();
+		const auto inv_area_v = _mm256_set1_ps(inv_area);
+		const auto z0 = _mm256_set1_ps(z[0]);
+		const auto z1 = _mm256_set1_ps(z[1]);
+		const auto z2 = _mm256_set1_ps(z[2]);
+		const auto span = static_cast<float>(x1 - x0 + 1);
+
+		__m256 a[3] = {};
+		for (auto edge_idx = 0; edge_idx != 3; ++edge_idx)
+		{
+			a[edge_idx] = _mm256_set1_ps(edges.m_a[edge_idx]);
+		}
+
+		alignas(32) float l0[8], l1[8], l2[8], pixel_z[8];
+
+		for (auto y = y0; y <= y1; ++y)
+		{
+			const auto pixel_y = static_cast<float>(y) + 0.5f;
+			const auto pixel_x = static_cast<float>(x0) + 0.5f;
+
+			__m256 row[3] = {};
+			for (auto edge_idx = 0; edge_idx != 3; ++edge_idx)
+			{
+				row[edge_idx] = _mm256_set1_ps(edges.m_b[edge_idx] * (pixel_y - edges.m_origin_y[edge_idx]) + edges.m_a[edge_idx] * (pixel_x - edges.m_origin_x[edge_idx]));
+			}
+
+			const auto depth_row = depth + static_cast<size_t>(y) * stride;
+
+			for (auto x = x0; x <= x1; x += 8)
+			{
+				const auto step = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x - x0)), lane_offsets);
+				auto mask = _mm256_cmp_ps(step, _mm256_set1_ps(span), _CMP_LT_OQ);
+
+				__m256 e[3] = {};
+				for (auto edge_idx = 0; edge_idx != 3; ++edge_idx)
+				{
+					e[edge_idx] = _mm256_add_ps(row[edge_idx], _mm256_mul_ps(a[edge_idx], step));
+					const auto edge_mask = edges.m_inclusive[edge_idx] ? _mm256_cmp_ps(e[edge_idx], zero, _CMP_GE_OQ) : _mm256_cmp_ps(e[edge_idx], zero, _CMP_GT_OQ);
+					mask = _mm256_and_ps(mask, edge_mask);
+				}
+
+				if (_mm256_movemask_ps(mask) == 0)
+				{
+					continue;
+				}
+
+				const auto l0_v = _mm256_mul_ps(e[0], inv_area_v);
+				const auto l1_v = _mm256_mul_ps(e[1], inv_area_v);
+				const auto l2_v = _mm256_mul_ps(e[2], inv_area_v);
+				const auto z_v = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(z0, l0_v), _mm256_mul_ps(z1, l1_v)), _mm256_mul_ps(z2, l2_v));
+
+				// lanes past the span are already masked out, load them anyway only when they exist
+				const auto lanes_count = std::min(8, x1 - x + 1);
+				alignas(32) float stored_depth[8] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+				std::copy_n(depth_row + x, lanes_count, stored_depth);
+
+				mask = _mm256_and_ps(mask, _mm256_cmp_ps(z_v, _mm256_load_ps(stored_depth), _CMP_LT_OQ));
+
+				auto bits = static_cast<uint32_t>(_mm256_movemask_ps(mask));
+				if (bits == 0)
+				{
+					continue;
+				}
+
+				_mm256_store_ps(l0, l0_v);
+				_mm256_store_ps(l1, l1_v);
+				_mm256_store_ps(l2, l2_v);
+				_mm256_store_ps(pixel_z, z_v);
+
+				while (bits)
+				{
+					const auto lane = std::countr_zero(bits);
+					bits &= bits - 1;
+					pixel_function(x + lane, y, l0[lane], l1[lane], l2[lane], pixel_z[lane]);
+				}
+			}
+		}
+	}
+#endif
+
+#pragma endregion
+
+	SWRasterizer::SWRasterizer(const int width, const int height)
+	{
+		m_framebuffer.m_width = width;
+		m_framebuffer.m_height = height;
+		m_framebuffer.m_color.assign(static_cast<size_t>(width) * height, 0u);
+		m_framebuffer.m_depth.assign(static_cast<size_t>(width) * height, 1.0f);
+
+		m_tiles_x = (width + TileSize - 1) / TileSize;
+		m_tiles_y = (height + TileSize - 1) / TileSize;
+		m_tile_bins.resize(static_cast<size_t>(m_tiles_x) * m_tiles_y);
+
+		m_use_avx2 = CpuSupportsAVX2();
+	}
+
+	auto SWRasterizer::Clear(const glm::vec4& color) -> void
+	{
+		// whatever was submitted before is overwritten anyway
+		m_draws.clear();
+		m_triangles.clear();
+		for (auto& bin : m_tile_bins)
+		{
+			bin.clear();
+		}
+
+		m_pending_clear_color = PackColor(color);
+	}
+
+	auto SWRasterizer::SetLights(const std::vector<std::shared_ptr<Light>>& lights) -> void
+	{
+		m_lights.clear();
+		for (const auto& light : lights)
+		{
+			m_lights.push_back(*light);
+		}
+	}
+
+	auto SWRasterizer::DrawIndexed(const SWMesh& mesh, const SWShaderConstants& constants, const uint32_t instance_count) -> void
+	{
+		const auto vertices = mesh.GetVertices();
+		const auto indices = mesh.GetIndices();
+		if (vertices.empty() || indices.size() < 3)
+		{
+			return;
+		}
+
+		RenderStats::GetInstance().CountDraw(vertices.size(), indices.size(), instance_count);
+
+		auto& job_system = JobSystem::GetInstance();
+
+		const auto view_projection = constants.m_projection * constants.m_view;
+		const auto normal_matrix = glm::mat3{ glm::transpose(glm::inverse(constants.m_model)) };
+
+		// vertex stage
+		m_clip_vertices.resize(vertices.size());
+		job_system.ParallelFor(vertices.size(), 1024, [&](const size_t begin, const size_t end) {
+			for (auto vertex_idx = begin; vertex_idx != end; ++vertex_idx)
+			{
+				const auto& vertex = vertices[vertex_idx];
+				const auto world_position = constants.m_model * glm::vec4{ vertex.m_position, 1.0f };
+
+				auto& clip_vertex = m_clip_vertices[vertex_idx];
+				clip_vertex.m_clip_position = view_projection * world_position;
+				clip_vertex.m_world_position = glm::vec3{ world_position };
+				clip_vertex.m_world_normal = normal_matrix * vertex.m_normal;
+			}
+		});
+
+		const auto triangles_count = indices.size() / 3;
+		const auto batches_count = std::clamp<size_t>(triangles_count / 1024, 1, job_system.GetWorkersCount() + 1);
+		const auto batch_size = (triangles_count + batches_count - 1) / batches_count;
+
+		m_setup_batches.resize(batches_count);
+
+		for (auto instance_idx = 0u; instance_idx != instance_count; ++instance_idx)
+		{
+			const auto draw_idx = static_cast<uint32_t>(m_draws.size());
+			m_draws.push_back(constants);
+
+			// clipping and triangle setup, every batch keeps its own output so the submission order is preserved
+			job_system.ParallelFor(batches_count, 1, [&](const size_t begin, const size_t end) {
+				for (auto batch_idx = begin; batch_idx != end; ++batch_idx)
+				{
+					auto& batch = m_setup_batches[batch_idx];
+					batch.clear();
+
+					const auto first_triangle = batch_idx * batch_size;
+					const auto last_triangle = std::min(first_triangle + batch_size, triangles_count);
+
+					for (auto triangle_idx = first_triangle; triangle_idx < last_triangle; ++triangle_idx)
+					{
+						SetupTriangle({
+							m_clip_vertices[indices[triangle_idx * 3 + 0]],
+							m_clip_vertices[indices[triangle_idx * 3 + 1]],
+							m_clip_vertices[indices[triangle_idx * 3 + 2]]
+						}, draw_idx, batch);
+					}
+				}
+			});
+
+			// binning
+			for (const auto& batch : m_setup_batches)
+			{
+				for (const auto& triangle : batch)
+				{
+					const auto triangle_idx = static_cast<uint32_t>(m_triangles.size());
+					m_triangles.push_back(triangle);
+
+					for (auto tile_y = triangle.m_min_y / TileSize; tile_y <= triangle.m_max_y / TileSize; ++tile_y)
+					{
+						for (auto tile_x = triangle.m_min_x / TileSize; tile_x <= triangle.m_max_x / TileSize; ++tile_x)
+						{
+							m_tile_bins[tile_y * m_tiles_x + tile_x].push_back(triangle_idx);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	auto SWRasterizer::Flush() -> void
+	{
+		CX_PROFILE_FUNCTION();
+
+		JobSystem::GetInstance().ParallelFor(m_tile_bins.size(), 1, [this](const size_t begin, const size_t end) {
+			for (auto tile_idx = begin; tile_idx != end; ++tile_idx)
+			{
+				RasterizeTile(static_cast<int>(tile_idx));
+			}
+		});
+
+		m_flushed_triangles_count = static_cast<uint32_t>(m_triangles.size());
+
+		m_pending_clear_color.reset();
+		m_draws.clear();
+		m_triangles.clear();
+		for (auto& bin : m_tile_bins)
+		{
+			bin.clear();
+		}
+	}
+
+	auto SWRasterizer::SetupTriangle(const std::array<ClipVertex, 3>& vertices, const uint32_t draw_idx, std::vector<Triangle>& out_triangles) const -> void
+	{
+		// a convex polygon clipped by 5 planes has at most 3 + 5 vertices
+		auto polygon = std::array<ClipVertex, 3 + ClipPlanesCount>{};
+		auto polygon_size = 3;
+		std::ranges::copy(vertices, polygon.begin());
+
+		for (auto plane_idx = 0; plane_idx != ClipPlanesCount; ++plane_idx)
+		{
+			auto all_inside = true;
+			for (auto vertex_idx = 0; vertex_idx != polygon_size; ++vertex_idx)
+			{
+				all_inside &= ClipDistance(polygon[vertex_idx].m_clip_position, plane_idx) >= 0.0f;
+			}
+
+			if (all_inside)
+			{
+				continue;
+			}
+
+			auto clipped = std::array<ClipVertex, 3 + ClipPlanesCount>{};
+			auto clipped_size = 0;
+
+			for (auto vertex_idx = 0; vertex_idx != polygon_size; ++vertex_idx)
+			{
+				const auto& current = polygon[vertex_idx];
+				const auto& next = polygon[(vertex_idx + 1) % polygon_size];
+				const auto current_distance = ClipDistance(current.m_clip_position, plane_idx);
+				const auto next_distance = ClipDistance(next.m_clip_position, plane_idx);
+
+				if (current_distance >= 0.0f)
+				{
+					clipped[clipped_size++] = current;
+				}
+
+				if ((current_distance >= 0.0f) != (next_distance >= 0.0f))
+				{
+					clipped[clipped_size++] = LerpVertex(current, next, current_distance / (current_distance - next_distance));
+				}
+			}
+
+			polygon = clipped;
+			polygon_size = clipped_size;
+
+			if (polygon_size < 3)
+			{
+				return;
+			}
+		}
+
+		const auto width = static_cast<float>(m_framebuffer.m_width);
+		const auto height = static_cast<float>(m_framebuffer.m_height);
+
+		// fan triangulation of the clipped polygon
+		for (auto fan_idx = 1; fan_idx + 1 < polygon_size; ++fan_idx)
+		{
+			const auto fan = std::array{ &polygon[0], &polygon[fan_idx], &polygon[fan_idx + 1] };
+
+			auto triangle = Triangle{};
+			triangle.m_draw = draw_idx;
+
+			for (auto vertex_idx = 0; vertex_idx != 3; ++vertex_idx)
+			{
+				const auto& vertex = *fan[vertex_idx];
+				const auto inv_w = 1.0f / vertex.m_clip_position.w;
+				const auto ndc = glm::vec3{ vertex.m_clip_position } * inv_w;
+
+				// snapped to a fixed subpixel grid, so shared vertices produce exactly the same edges
+				triangle.m_x[vertex_idx] = std::round((ndc.x * 0.5f + 0.5f) * width * SubpixelSteps) / SubpixelSteps;
+				triangle.m_y[vertex_idx] = std::round((ndc.y * 0.5f + 0.5f) * height * SubpixelSteps) / SubpixelSteps;
+				triangle.m_z[vertex_idx] = ndc.z * 0.5f + 0.5f;
+				triangle.m_inv_w[vertex_idx] = inv_w;
+				triangle.m_world_position[vertex_idx] = vertex.m_world_position * inv_w;
+				triangle.m_world_normal[vertex_idx] = vertex.m_world_normal * inv_w;
+			}
+
+			const auto& x = triangle.m_x;
+			const auto& y = triangle.m_y;
+
+			// counter clockwise (window space, y up) is the front, clockwise faces are culled like GL does
+			const auto area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+			if (area <= 0.0f)
+			{
+				continue;
+			}
+
+			triangle.m_inv_area = 1.0f / area;
+
+			// pixels whose center is inside the bounding box
+			triangle.m_min_x = std::max(0, static_cast<int>(std::ceil(std::min({ x[0], x[1], x[2] }) - 0.5f)));
+			triangle.m_min_y = std::max(0, static_cast<int>(std::ceil(std::min({ y[0], y[1], y[2] }) - 0.5f)));
+			triangle.m_max_x = std::min(m_framebuffer.m_width - 1, static_cast<int>(std::floor(std::max({ x[0], x[1], x[2] }) - 0.5f)));
+			triangle.m_max_y = std::min(m_framebuffer.m_height - 1, static_cast<int>(std::floor(std::max({ y[0], y[1], y[2] }) - 0.5f)));
+
+			if (triangle.m_min_x > triangle.m_max_x || triangle.m_min_y > triangle.m_max_y)
+			{
+				continue;
+			}
+
+			out_triangles.push_back(triangle);
+		}
+	}
+
+	auto SWRasterizer::RasterizeTile(const int tile_idx) -> void
+	{
+		const auto tile_min_x = (tile_idx % m_tiles_x) * TileSize;
+		const auto tile_min_y = (tile_idx / m_tiles_x) * TileSize;
+		const auto tile_max_x = std::min(tile_min_x + TileSize, m_framebuffer.m_width) - 1;
+		const auto tile_max_y = std::min(tile_min_y + TileSize, m_framebuffer.m_height) - 1;
+		const auto stride = m_framebuffer.m_width;
+
+		auto& color = m_framebuffer.m_color;
+		auto& depth = m_framebuffer.m_depth;
+
+		if (m_pending_clear_color.has_value())
+		{
+			for (auto y = tile_min_y; y <= tile_max_y; ++y)
+			{
+				const auto row_begin = static_cast<size_t>(y) * stride;
+				std::fill(color.begin() + row_begin + tile_min_x, color.begin() + row_begin + tile_max_x + 1, m_pending_clear_color.value());
+				std::fill(depth.begin() + row_begin + tile_min_x, depth.begin() + row_begin + tile_max_x + 1, 1.0f);
+			}
+		}
+
+		for (const auto triangle_idx : m_tile_bins[tile_idx])
+		{
+			const auto& triangle = m_triangles[triangle_idx];
+
+			const auto x0 = std::max(triangle.m_min_x, tile_min_x);
+			const auto x1 = std::min(triangle.m_max_x, tile_max_x);
+			const auto y0 = std::max(triangle.m_min_y, tile_min_y);
+			const auto y1 = std::min(triangle.m_max_y, tile_max_y);
+
+			const auto edges = MakeEdgeSetup(triangle.m_x, triangle.m_y);
+
+			const auto write_pixel = [&](const int x, const int y, const float l0, const float l1, const float l2, const float pixel_z) {
+				const auto pixel_idx = static_cast<size_t>(y) * stride + x;
+				depth[pixel_idx] = pixel_z;
+				color[pixel_idx] = ShadePixel(triangle, l0, l1, l2);
+			};
+
+#ifdef SW_RASTERIZER_X64
+			if (m_use_avx2)
+			{
+				RasterizeAVX2(edges, triangle.m_z, triangle.m_inv_area, x0, x1, y0, y1, depth.data(), stride, write_pixel);
+				continue;
+			}
+#endif
+			RasterizeScalar(edges, triangle.m_z, triangle.m_inv_area, x0, x1, y0, y1, depth.data(), stride, write_pixel);
+		}
+	}
+
+	auto SWRasterizer::ShadePixel(const Triangle& triangle, const float l0, const float l1, const float l2) const -> uint32_t
+	{
+		// perspective correct interpolation
+		const auto inv_w = (triangle.m_inv_w[0] * l0 + triangle.m_inv_w[1] * l1) + triangle.m_inv_w[2] * l2;
+		const auto w = 1.0f / inv_w;
+
+		const auto world_position = (triangle.m_world_position[0] * l0 + triangle.m_world_position[1] * l1 + triangle.m_world_position[2] * l2) * w;
+		const auto world_normal = glm::normalize((triangle.m_world_normal[0] * l0 + triangle.m_world_normal[1] * l1 + triangle.m_world_normal[2] * l2) * w);
+
+		return PackColor(glm::vec4{ CalculateLighting(m_draws[triangle.m_draw], m_lights, world_position, world_normal), 1.0f });
+	}
+}
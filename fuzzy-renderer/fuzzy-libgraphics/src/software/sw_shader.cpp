@@ -0,0 +1,50 @@
+#include <software/sw_shader.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+namespace libgraphics
+{
+	struct SWConstantSlot
+	{
+		std::string_view m_name = {};
+		size_t m_offset = {};
+		size_t m_size = {};
+	};
+
+	static constexpr auto ConstantSlots = std::array{
+		SWConstantSlot{ "model", offsetof(SWShaderConstants, m_model), sizeof(glm::mat4) },
+		SWConstantSlot{ "view", offsetof(SWShaderConstants, m_view), sizeof(glm::mat4) },
+		SWConstantSlot{ "projection", offsetof(SWShaderConstants, m_projection), sizeof(glm::mat4) },
+		SWConstantSlot{ "eye", offsetof(SWShaderConstants, m_eye), sizeof(glm::vec3) },
+		SWConstantSlot{ "material.albedo_color", offsetof(SWShaderConstants, m_albedo_color), sizeof(glm::vec3) },
+		SWConstantSlot{ "material.emission_color", offsetof(SWShaderConstants, m_emission_color), sizeof(glm::vec3) },
+		SWConstantSlot{ "material.metallic", offsetof(SWShaderConstants, m_metallic), sizeof(float) },
+		SWConstantSlot{ "material.roughness", offsetof(SWShaderConstants, m_roughness), sizeof(float) },
+		SWConstantSlot{ "material.use_textures", offsetof(SWShaderConstants, m_use_textures), sizeof(int) },
+	};
+
+	auto SWShader::GetConstantSlot(const std::string_view name) const -> int32_t
+	{
+		for (auto slot = 0; slot != static_cast<int32_t>(ConstantSlots.size()); ++slot)
+		{
+			if (ConstantSlots[slot].m_name == name)
+			{
+				return slot;
+			}
+		}
+		return -1;
+	}
+
+	auto SWShader::WriteConstant(SWShaderConstants& constants, const int32_t slot, const void* data) -> void
+	{
+		if (slot < 0 || slot >= static_cast<int32_t>(ConstantSlots.size()))
+		{
+			return;
+		}
+
+		const auto& [name, offset, size] = ConstantSlots[slot];
+		std::memcpy(reinterpret_cast<std::byte*>(&constants) + offset, data, size);
+	}
+}
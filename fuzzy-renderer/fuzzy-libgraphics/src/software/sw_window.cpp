@@ -0,0 +1,45 @@
+#include <software/sw_window.h>
+#include <software/sw_context.h>
+#include <software/sw_rasterizer.h>
+
+#include <cstring>
+
+namespace libgraphics
+{
+	auto SWWindow::Create(const int width, const int height, const std::string_view title) -> void
+	{
+		m_graphics_context = std::make_shared<SWContext>();
+		m_graphics_context->Init(width, height, title);
+	}
+
+	auto SWWindow::Destroy() -> void
+	{
+		m_graphics_context->Shutdown();
+	}
+
+	auto SWWindow::Clear() -> void
+	{
+		std::static_pointer_cast<SWContext>(m_graphics_context)->GetRasterizer().Clear({ m_clear_color.r, m_clear_color.g, m_clear_color.b, m_clear_color.a });
+	}
+
+	auto SWWindow::SwapBuffers() -> void
+	{
+		std::static_pointer_cast<SWContext>(m_graphics_context)->GetRasterizer().Flush();
+	}
+
+	auto SWWindow::SetClearColor(const Color& color) -> void
+	{
+		m_clear_color = color;
+	}
+
+	auto SWWindow::ReadPixels() const -> std::vector<uint8_t>
+	{
+		const auto& color = std::static_pointer_cast<SWContext>(m_graphics_context)->GetRasterizer().GetFramebuffer().m_color;
+
+		// texels are packed as r | g << 8 | b << 16 | a << 24, on little endian that's already the RGBA byte order
+		auto pixels = std::vector<uint8_t>(color.size() * sizeof(uint32_t));
+		std::memcpy(pixels.data(), color.data(), pixels.size());
+
+		return pixels;
+	}
+}
@@ -1,5 +1,6 @@
 #include <utils.h>
 
+#include <asset_file_system.h>
 #include <filesystem>
 #include <logger.h>
 #include <stb_image.h>
@@ -12,6 +13,7 @@
 #include <interfaces/imesh.h>
 
 #include <opengl/gl_mesh.h>
+#include <opengl/gl_state_cache.h>
 
 #include <ray_hit.h>
 
@@ -59,19 +61,18 @@ namespace utils::gl
 
 		const auto allowed_extensions = std::vector<std::string>{ ".jpg", ".png", ".jpeg" };
 
-		for (const auto& entry : std::filesystem::directory_iterator(folder_path)) 
+		auto& asset_file_system = libgraphics::AssetFileSystem::GetInstance();
+
+		for (const auto& face_path : asset_file_system.ListFiles(folder_path))
 		{
-			if (entry.is_regular_file()) 
-			{
-				auto extension = entry.path().extension().string();
-				std::ranges::transform(extension, extension.begin(), [](const auto& c) { return std::tolower(c); });
+			auto extension = face_path.extension().string();
+			std::ranges::transform(extension, extension.begin(), [](const auto& c) { return std::tolower(c); });
 
-				if (std::ranges::find(allowed_extensions, extension) != allowed_extensions.end()) 
-				{
-					auto file_path = entry.path().string();
-					std::ranges::replace(file_path, '\\', '/');
-					faces.push_back(file_path);
-				}
+			if (std::ranges::find(allowed_extensions, extension) != allowed_extensions.end()) 
+			{
+				auto file_path = face_path.string();
+				std::ranges::replace(file_path, '\\', '/');
+				faces.push_back(file_path);
 			}
 		}
 
@@ -80,13 +81,14 @@ namespace utils::gl
 
 		auto texture_id = uint32_t{};
 		glGenTextures(1, &texture_id);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, texture_id);
+		libgraphics::GLStateCache::GetInstance().BindTexture(0, GL_TEXTURE_CUBE_MAP, texture_id);
 
 		int width = {}, height = {}, channels = {};
 
 		for (auto face_idx = 0ul; face_idx != faces.size(); ++face_idx)
 		{
-			if (const auto data = stbi_load(faces[face_idx].c_str(), &width, &height, &channels, 0))
+			const auto face_file = asset_file_system.Read(faces[face_idx]);
+			if (const auto data = face_file ? stbi_load_from_memory(face_file->m_bytes.data(), static_cast<int>(face_file->m_bytes.size()), &width, &height, &channels, 0) : nullptr)
 			{
 				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face_idx, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
 				stbi_image_free(data);
@@ -109,20 +111,26 @@ namespace utils::gl
 
 	auto CheckRayMeshIntersection(const glm::vec3& ray_origin, const glm::vec3& ray_direction, const libgraphics::GLMesh& mesh) -> std::optional<libgraphics::RayHit>
 	{
+		// nothing to pick from once the mesh data is discarded
+		const auto& mesh_data = mesh.GetData();
+		if (!mesh_data)
+		{
+			return std::nullopt;
+		}
+
 		auto closest_distance = std::numeric_limits<float>::max();
 		auto ray_hit = libgraphics::RayHit{};
 
-		const auto& index_buffer = mesh.GetIndexBuffer();
-		const auto& vertex_buffer = mesh.GetVertexBuffer();
+		const auto index_buffer = mesh_data->GetIndices();
 
 		for (auto vertex_idx = 0ul; vertex_idx < index_buffer.size(); vertex_idx += 3)
 		{
-			const auto& v0 = vertex_buffer[index_buffer[vertex_idx]];
-			const auto& v1 = vertex_buffer[index_buffer[vertex_idx + 1]];
-			const auto& v2 = vertex_buffer[index_buffer[vertex_idx + 2]];
+			const auto& p0 = mesh_data->GetPosition(index_buffer[vertex_idx]);
+			const auto& p1 = mesh_data->GetPosition(index_buffer[vertex_idx + 1]);
+			const auto& p2 = mesh_data->GetPosition(index_buffer[vertex_idx + 2]);
 
 			auto barycentric_coords = glm::vec2{};
-			if (auto distance = 0.0f; glm::intersectRayTriangle(ray_origin, ray_direction, v0.m_position, v1.m_position, v2.m_position, barycentric_coords, distance))
+			if (auto distance = 0.0f; glm::intersectRayTriangle(ray_origin, ray_direction, p0, p1, p2, barycentric_coords, distance))
 			{
 				const auto& intersection_point = ray_origin + ray_direction * distance;
 				if (distance < closest_distance)
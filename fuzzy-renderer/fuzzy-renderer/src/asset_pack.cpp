@@ -0,0 +1,64 @@
+#include "asset_pack.h"
+
+#include <asset_archive.h>
+
+#include <format>
+#include <iostream>
+#include <string_view>
+
+namespace pack
+{
+	auto ParseAssetPackOptions(const int argc, char** argv) -> std::optional<AssetPackOptions>
+	{
+		// argv[1] is --pack
+		if (argc < 3)
+		{
+			std::cerr << "usage: --pack <archive.fzpak> [--root directory] [files or directories...]\n";
+			return std::nullopt;
+		}
+
+		auto options = AssetPackOptions{};
+		options.m_archive_path = argv[2];
+
+		for (auto arg_idx = 3; arg_idx < argc; ++arg_idx)
+		{
+			const auto argument = std::string_view{ argv[arg_idx] };
+
+			if (argument == "--root" && arg_idx + 1 < argc)
+			{
+				options.m_root = argv[++arg_idx];
+			}
+			else if (argument.starts_with("--"))
+			{
+				std::cerr << "unknown pack option " << argument << "\n";
+				return std::nullopt;
+			}
+			else
+			{
+				options.m_inputs.emplace_back(argument);
+			}
+		}
+
+		if (options.m_inputs.empty())
+		{
+			options.m_inputs = { "fuzzy-libgraphics/shaders", "fuzzy-libgraphics/cubemaps", "resources" };
+		}
+
+		return options;
+	}
+
+	auto RunAssetPack(const AssetPackOptions& options) -> int
+	{
+		const auto stats = libgraphics::WriteAssetArchive(options.m_archive_path, options.m_root, options.m_inputs);
+		if (!stats)
+		{
+			std::cerr << "unable to write " << options.m_archive_path.string() << "\n";
+			return 1;
+		}
+
+		std::cout << std::format("{}: {} file(s), {} compressed, {} KB -> {} KB\n", options.m_archive_path.string(), stats->m_entries_count, stats->m_compressed_count,
+			stats->m_source_bytes / 1024, stats->m_archive_bytes / 1024);
+
+		return 0;
+	}
+}
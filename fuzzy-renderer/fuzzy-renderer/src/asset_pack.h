@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace pack
+{
+	struct AssetPackOptions
+	{
+		std::filesystem::path m_archive_path = {};
+
+		// the entries are named relative to it, and looked up relative to it once the archive is mounted
+		std::filesystem::path m_root = "..";
+
+		// files or directories (recursively) relative to the root, the engine shaders, cubemaps and resources when empty
+		std::vector<std::filesystem::path> m_inputs = {};
+	};
+
+	/**
+	 * \brief --pack <archive.fzpak> [--root directory] [files or directories...]
+	 */
+	auto ParseAssetPackOptions(const int argc, char** argv) -> std::optional<AssetPackOptions>;
+
+	/**
+	 * \brief Packs the inputs in an asset archive, mounted instead of the loose files when named assets.fzpak and in the
+	 * working directory, and prints how much the compression saved.
+	 * \return process exit code
+	 */
+	auto RunAssetPack(const AssetPackOptions& options) -> int;
+}
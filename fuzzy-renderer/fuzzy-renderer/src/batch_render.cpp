@@ -0,0 +1,395 @@
+#include "batch_render.h"
+
+#include <core.h>
+#include <opengl/camera.h>
+#include <rendering/frame_writers.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif
+
+namespace batch
+{
+	struct CameraPose
+	{
+		std::string m_name = {};
+		glm::dvec3 m_position = {};
+		double m_yaw = {};
+		double m_pitch = {};
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	auto SecondsSince(const Clock::time_point start_time) -> double
+	{
+		return std::chrono::duration<double>(Clock::now() - start_time).count();
+	}
+
+	/**
+	 * \brief The whole of value as an int, false on anything else (empty, trailing characters, out of range)
+	 */
+	auto ParseInt(const std::string_view value, int& out_value) -> bool
+	{
+		const auto [parse_end, parse_error] = std::from_chars(value.data(), value.data() + value.size(), out_value);
+		return parse_error == std::errc{} && parse_end == value.data() + value.size();
+	}
+
+	/**
+	 * \brief Two ints around the separator, "1920x1080" or "0/4"
+	 */
+	auto ParseIntPair(const std::string_view value, const char separator, int& out_first, int& out_second) -> bool
+	{
+		const auto separator_idx = value.find(separator);
+		return separator_idx != std::string_view::npos && ParseInt(value.substr(0, separator_idx), out_first) && ParseInt(value.substr(separator_idx + 1), out_second);
+	}
+
+	auto ReadPoses(const std::filesystem::path& path) -> std::optional<std::vector<CameraPose>>
+	{
+		auto file = std::ifstream{ path };
+		if (!file.is_open())
+		{
+			std::cerr << "unable to open poses file " << path << "\n";
+			return std::nullopt;
+		}
+
+		auto poses = std::vector<CameraPose>{};
+		auto line = std::string{};
+		auto line_number = 0;
+
+		while (std::getline(file, line))
+		{
+			line_number++;
+
+			if (const auto comment = line.find('#'); comment != std::string::npos)
+			{
+				line.erase(comment);
+			}
+
+			auto stream = std::istringstream{ line };
+			auto pose = CameraPose{};
+			if (!(stream >> pose.m_name))
+			{
+				continue;
+			}
+
+			if (!(stream >> pose.m_position.x >> pose.m_position.y >> pose.m_position.z >> pose.m_yaw >> pose.m_pitch))
+			{
+				std::cerr << path.string() << ":" << line_number << ": expected \"name x y z yaw pitch\"\n";
+				return std::nullopt;
+			}
+
+			poses.push_back(std::move(pose));
+		}
+
+		return poses;
+	}
+
+	// paths are passed as the OS takes them, wide on Windows
+	using ProcessArgument = std::filesystem::path::string_type;
+
+#ifdef _WIN32
+	using ProcessHandle = HANDLE;
+
+	/**
+	 * \brief Quotes an argument so that the child's CommandLineToArgvW gives it back as is: backslashes are literal
+	 * unless they precede a quote, then they are escaped along with it.
+	 */
+	auto QuoteArgument(const ProcessArgument& argument) -> ProcessArgument
+	{
+		auto quoted_argument = ProcessArgument{ L"\"" };
+		auto backslashes_count = size_t{ 0 };
+
+		for (const auto character : argument)
+		{
+			if (character == L'\\')
+			{
+				backslashes_count++;
+				continue;
+			}
+
+			quoted_argument.append(character == L'"' ? backslashes_count * 2 + 1 : backslashes_count, L'\\');
+			quoted_argument += character;
+			backslashes_count = 0;
+		}
+
+		// the closing quote must not be escaped
+		quoted_argument.append(backslashes_count * 2, L'\\');
+		quoted_argument += L'"';
+		return quoted_argument;
+	}
+
+	auto SpawnProcess(const std::vector<ProcessArgument>& arguments) -> std::optional<ProcessHandle>
+	{
+		auto command_line = ProcessArgument{};
+		for (const auto& argument : arguments)
+		{
+			command_line += (command_line.empty() ? L"" : L" ") + QuoteArgument(argument);
+		}
+
+		auto startup_info = STARTUPINFOW{ sizeof(STARTUPINFOW) };
+		auto process_info = PROCESS_INFORMATION{};
+		if (!CreateProcessW(nullptr, command_line.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup_info, &process_info))
+		{
+			return std::nullopt;
+		}
+
+		CloseHandle(process_info.hThread);
+		return process_info.hProcess;
+	}
+
+	auto WaitProcess(const ProcessHandle process) -> int
+	{
+		WaitForSingleObject(process, INFINITE);
+
+		auto exit_code = DWORD{ 1 };
+		GetExitCodeProcess(process, &exit_code);
+		CloseHandle(process);
+		return static_cast<int>(exit_code);
+	}
+#else
+	using ProcessHandle = pid_t;
+
+	auto SpawnProcess(std::vector<ProcessArgument> arguments) -> std::optional<ProcessHandle>
+	{
+		// no shell in between, each argument reaches the child as it is (argv[0] may be found through PATH)
+		auto argv = std::vector<char*>{};
+		for (auto& argument : arguments)
+		{
+			argv.push_back(argument.data());
+		}
+		argv.push_back(nullptr);
+
+		auto process = pid_t{};
+		if (posix_spawnp(&process, argv.front(), nullptr, nullptr, argv.data(), environ) != 0)
+		{
+			return std::nullopt;
+		}
+		return process;
+	}
+
+	auto WaitProcess(const ProcessHandle process) -> int
+	{
+		auto status = 0;
+		if (waitpid(process, &status, 0) != process)
+		{
+			return 1;
+		}
+		return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+	}
+#endif
+
+	auto ParseBatchRenderOptions(const int argc, char** argv) -> std::optional<BatchRenderOptions>
+	{
+		// argv[1] is --batch
+		if (argc < 5)
+		{
+			std::cerr << "usage: --batch <scene> <poses> <output dir> [--size WxH] [--processes N] [--shard i/N] [--software]\n";
+			return std::nullopt;
+		}
+
+		auto options = BatchRenderOptions{};
+		options.m_scene_path = argv[2];
+		options.m_poses_path = argv[3];
+		options.m_output_directory = argv[4];
+
+		for (auto arg_idx = 5; arg_idx < argc; ++arg_idx)
+		{
+			const auto argument = std::string_view{ argv[arg_idx] };
+			const auto has_value = arg_idx + 1 < argc;
+			auto is_value_valid = true;
+
+			if (argument == "--software")
+			{
+				options.m_graphics_api = libgraphics::GraphicsAPI::software;
+			}
+			else if (argument == "--size" && has_value)
+			{
+				is_value_valid = ParseIntPair(argv[++arg_idx], 'x', options.m_width, options.m_height);
+			}
+			else if (argument == "--processes" && has_value)
+			{
+				is_value_valid = ParseInt(argv[++arg_idx], options.m_processes_count) && options.m_processes_count > 0;
+			}
+			else if (argument == "--shard" && has_value)
+			{
+				is_value_valid = ParseIntPair(argv[++arg_idx], '/', options.m_shard_index, options.m_shards_count);
+			}
+			else
+			{
+				std::cerr << "unknown batch option " << argument << "\n";
+				return std::nullopt;
+			}
+
+			if (!is_value_valid)
+			{
+				std::cerr << std::format("malformed value {} for {}\n", argv[arg_idx], argument);
+				return std::nullopt;
+			}
+		}
+
+		if (options.m_width <= 0 || options.m_height <= 0 || options.m_shards_count <= 0 || options.m_shard_index < 0 || options.m_shard_index >= options.m_shards_count)
+		{
+			std::cerr << "invalid size or shard\n";
+			return std::nullopt;
+		}
+
+		return options;
+	}
+
+	auto RunShardProcesses(const BatchRenderOptions& options, const std::filesystem::path& executable_path, const size_t poses_count) -> int
+	{
+		const auto start_time = Clock::now();
+
+		// the options are forwarded as they are, only --processes becomes --shard
+		const auto make_arguments = [&](const int shard_idx) {
+			auto arguments = std::vector<ProcessArgument>{ executable_path.native() };
+			for (const auto& argument : { std::filesystem::path{ "--batch" }, options.m_scene_path, options.m_poses_path, options.m_output_directory,
+				std::filesystem::path{ "--size" }, std::filesystem::path{ std::format("{}x{}", options.m_width, options.m_height) },
+				std::filesystem::path{ "--shard" }, std::filesystem::path{ std::format("{}/{}", shard_idx, options.m_processes_count) } })
+			{
+				arguments.push_back(argument.native());
+			}
+
+			if (options.m_graphics_api == libgraphics::GraphicsAPI::software)
+			{
+				arguments.push_back(std::filesystem::path{ "--software" }.native());
+			}
+			return arguments;
+		};
+
+		auto processes = std::vector<ProcessHandle>{};
+		auto failures_count = 0;
+
+		for (auto shard_idx = 0; shard_idx != options.m_processes_count; ++shard_idx)
+		{
+			if (const auto process = SpawnProcess(make_arguments(shard_idx)))
+			{
+				processes.push_back(process.value());
+			}
+			else
+			{
+				std::cerr << std::format("unable to launch shard {}/{}\n", shard_idx, options.m_processes_count);
+				failures_count++;
+			}
+		}
+
+		for (const auto process : processes)
+		{
+			if (WaitProcess(process) != 0)
+			{
+				failures_count++;
+			}
+		}
+
+		const auto elapsed_seconds = SecondsSince(start_time);
+
+		std::cout << std::format("{} poses on {} processes in {:.3f} s ({:.1f} fps)\n", poses_count, options.m_processes_count, elapsed_seconds, poses_count / elapsed_seconds);
+
+		return failures_count == 0 ? 0 : 1;
+	}
+
+	auto RunBatchRender(const BatchRenderOptions& options, const std::filesystem::path& executable_path) -> int
+	{
+		// read here as well when sharding, a malformed file fails before any process is launched
+		const auto all_poses = ReadPoses(options.m_poses_path);
+		if (!all_poses)
+		{
+			return 1;
+		}
+
+		if (options.m_processes_count > 1 && options.m_shards_count == 1)
+		{
+			return RunShardProcesses(options, executable_path, all_poses->size());
+		}
+
+		auto poses = std::vector<CameraPose>{};
+		for (auto pose_idx = size_t{ 0 }; pose_idx != all_poses->size(); ++pose_idx)
+		{
+			if (pose_idx % options.m_shards_count == static_cast<size_t>(options.m_shard_index))
+			{
+				poses.push_back(all_poses->at(pose_idx));
+			}
+		}
+
+		const auto shard_name = std::format("shard {}/{}", options.m_shard_index, options.m_shards_count);
+
+		if (poses.empty())
+		{
+			std::cout << std::format("[{}] no poses to render\n", shard_name);
+			return 0;
+		}
+
+		const auto start_time = Clock::now();
+		auto& core = libgraphics::Core::GetInstance();
+
+		// init: context, default resources and scene
+		auto stage_start_time = Clock::now();
+		core.Init(options.m_graphics_api, options.m_width, options.m_height, "BatchRender");
+		core.LoadScene(options.m_scene_path.string());
+		const auto init_seconds = SecondsSince(stage_start_time);
+
+		// readback: time the render thread spends handing frames over to the encoder (mapped memory copy)
+		auto encoder = libgraphics::PNGFrameEncoder{ options.m_output_directory };
+		auto readback_seconds = 0.0;
+
+		core.BeginCapture([&](const libgraphics::CapturedFrame& frame) {
+			const auto readback_start_time = Clock::now();
+			encoder.Encode(frame, poses[frame.m_frame_index].m_name + ".png");
+			readback_seconds += SecondsSince(readback_start_time);
+		});
+
+		// render: one frame per pose, the capture of a frame completes a couple of frames later
+		stage_start_time = Clock::now();
+		for (const auto& pose : poses)
+		{
+			auto& camera_props = core.GetMainCamera().m_camera_props;
+			camera_props.m_world_position = pose.m_position;
+			camera_props.m_yaw = pose.m_yaw;
+			camera_props.m_pitch = pose.m_pitch;
+
+			core.RenderFrame({});
+		}
+		const auto render_seconds = SecondsSince(stage_start_time) - readback_seconds;
+
+		// drain: frames still in flight in the readback ring
+		stage_start_time = Clock::now();
+		core.Shutdown();
+		const auto drain_seconds = SecondsSince(stage_start_time);
+
+		stage_start_time = Clock::now();
+		encoder.Wait();
+		const auto encode_wait_seconds = SecondsSince(stage_start_time);
+
+		const auto elapsed_seconds = SecondsSince(start_time);
+		const auto frames_count = static_cast<double>(poses.size());
+
+		std::cout << std::format("[{}] {} poses in {:.3f} s ({:.1f} fps), {} written, {} failed\n", shard_name, poses.size(), elapsed_seconds,
+			frames_count / elapsed_seconds, encoder.GetEncodedFramesCount(), encoder.GetFailedFramesCount());
+		std::cout << std::format("  init       {:8.3f} s\n", init_seconds);
+		std::cout << std::format("  render     {:8.3f} s ({:.2f} ms/frame)\n", render_seconds, render_seconds * 1000.0 / frames_count);
+		std::cout << std::format("  readback   {:8.3f} s ({:.2f} ms/frame)\n", readback_seconds, readback_seconds * 1000.0 / frames_count);
+		std::cout << std::format("  drain      {:8.3f} s\n", drain_seconds);
+		std::cout << std::format("  encode     {:8.3f} s on workers ({:.2f} ms/frame), {:.3f} s waiting at the end\n",
+			encoder.GetEncodeSeconds(), encoder.GetEncodeSeconds() * 1000.0 / frames_count, encode_wait_seconds);
+
+		return encoder.GetFailedFramesCount() == 0 ? 0 : 1;
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <enums.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace batch
+{
+	struct BatchRenderOptions
+	{
+		std::filesystem::path m_scene_path = {};
+		std::filesystem::path m_poses_path = {};
+		std::filesystem::path m_output_directory = {};
+		int m_width = 1920;
+		int m_height = 1080;
+
+		// > 1 relaunches this executable once per shard and waits for all of them
+		int m_processes_count = 1;
+
+		// this process renders the poses whose index % m_shards_count == m_shard_index
+		int m_shard_index = 0;
+		int m_shards_count = 1;
+
+		libgraphics::GraphicsAPI m_graphics_api = libgraphics::GraphicsAPI::opengl_headless;
+	};
+
+	/**
+	 * \brief --batch <scene> <poses> <output dir> [--size WxH] [--processes N] [--shard i/N] [--software]
+	 * Poses file: one "name x y z yaw pitch" per line (degrees, same convention as CameraProps), # starts a comment.
+	 */
+	auto ParseBatchRenderOptions(const int argc, char** argv) -> std::optional<BatchRenderOptions>;
+
+	/**
+	 * \brief Renders every pose of the shard offscreen into <output dir>/<name>.png and prints fps and stage timings.
+	 * \return process exit code
+	 */
+	auto RunBatchRender(const BatchRenderOptions& options, const std::filesystem::path& executable_path) -> int;
+}
@@ -0,0 +1,142 @@
+#include "camera_replay.h"
+#include "frame_timings.h"
+
+#include <core.h>
+#include <render_profiler.h>
+#include <rendering/camera_path.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace replay
+{
+	auto ParseCameraReplayOptions(const int argc, char** argv) -> std::optional<CameraReplayOptions>
+	{
+		// argv[1] is --replay
+		if (argc < 4)
+		{
+			std::cerr << "usage: --replay <scene> <camera path> [--size WxH] [--warmup N] [--dt seconds] [--csv frames.csv] [--software]\n";
+			return std::nullopt;
+		}
+
+		auto options = CameraReplayOptions{};
+		options.m_scene_path = argv[2];
+		options.m_camera_path = argv[3];
+
+		try
+		{
+			for (auto arg_idx = 4; arg_idx < argc; ++arg_idx)
+			{
+				const auto argument = std::string_view{ argv[arg_idx] };
+				const auto has_value = arg_idx + 1 < argc;
+
+				if (argument == "--software")
+				{
+					options.m_graphics_api = libgraphics::GraphicsAPI::software;
+				}
+				else if (argument == "--size" && has_value)
+				{
+					const auto value = std::string{ argv[++arg_idx] };
+					const auto separator = value.find('x');
+					options.m_width = std::stoi(value.substr(0, separator));
+					options.m_height = std::stoi(value.substr(separator + 1));
+				}
+				else if (argument == "--warmup" && has_value)
+				{
+					options.m_warmup_frames = std::max(0, std::stoi(argv[++arg_idx]));
+				}
+				else if (argument == "--dt" && has_value)
+				{
+					options.m_fixed_delta_time = std::stof(argv[++arg_idx]);
+				}
+				else if (argument == "--csv" && has_value)
+				{
+					options.m_csv_path = argv[++arg_idx];
+				}
+				else
+				{
+					std::cerr << "unknown replay option " << argument << "\n";
+					return std::nullopt;
+				}
+			}
+		}
+		catch (const std::exception&)
+		{
+			std::cerr << "malformed replay option value\n";
+			return std::nullopt;
+		}
+
+		if (options.m_width <= 0 || options.m_height <= 0 || options.m_fixed_delta_time <= 0.0f)
+		{
+			std::cerr << "invalid size or time step\n";
+			return std::nullopt;
+		}
+
+		return options;
+	}
+
+	auto RunCameraReplay(const CameraReplayOptions& options) -> int
+	{
+		auto& core = libgraphics::Core::GetInstance();
+		auto& profiler = libgraphics::utils::profiling::RenderProfiler::GetInstance();
+
+		// the core first, it initializes the logger the loader reports to
+		core.Init(options.m_graphics_api, options.m_width, options.m_height, "CameraReplay");
+
+		const auto camera_path = libgraphics::LoadCameraPath(options.m_camera_path);
+		if (!camera_path || camera_path->empty())
+		{
+			std::cerr << "no frames to replay in " << options.m_camera_path << "\n";
+			core.Shutdown();
+			return 1;
+		}
+
+		core.LoadScene(options.m_scene_path.string());
+		profiler.SetEnabled(true);
+
+		// warm-up along the start of the path (holding the last pose if the path is shorter)
+		core.BeginCameraReplay(camera_path.value(), options.m_fixed_delta_time);
+		for (auto frame_idx = 0; frame_idx != options.m_warmup_frames; ++frame_idx)
+		{
+			core.RenderFrame({});
+		}
+
+		// measured run, every frame of the path exactly once (then a few more on the last pose, see MeasureFrames)
+		const auto frames_count = camera_path->size();
+
+		core.BeginCameraReplay(camera_path.value(), options.m_fixed_delta_time);
+		const auto measured_frames = timings::MeasureFrames(core, frames_count);
+
+		core.EndCameraReplay();
+		core.Shutdown();
+
+		std::cout << std::format("{} frames of {} at {}x{}, {:.4f} s per frame, {} warm-up frames\n", frames_count, options.m_camera_path.filename().string(),
+			options.m_width, options.m_height, options.m_fixed_delta_time, options.m_warmup_frames);
+		timings::PrintDistribution("CPU", timings::ComputeDistribution(measured_frames.m_cpu_times_ms));
+		timings::PrintDistribution("GPU", timings::ComputeDistribution(measured_frames.GetGpuSamples()));
+
+		if (options.m_csv_path)
+		{
+			auto file = std::ofstream{ options.m_csv_path.value() };
+			if (!file.is_open())
+			{
+				std::cerr << "unable to write " << options.m_csv_path.value() << "\n";
+				return 1;
+			}
+
+			file << "frame,cpu_ms,gpu_ms\n";
+			for (auto frame_idx = size_t{ 0 }; frame_idx != frames_count; ++frame_idx)
+			{
+				const auto& gpu_time_ms = measured_frames.m_gpu_times_ms[frame_idx];
+				file << std::format("{},{:.4f},{}\n", frame_idx, measured_frames.m_cpu_times_ms[frame_idx], gpu_time_ms ? std::format("{:.4f}", gpu_time_ms.value()) : "");
+			}
+		}
+
+		return 0;
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <enums.h>
+#include <engine_constants.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace replay
+{
+	struct CameraReplayOptions
+	{
+		std::filesystem::path m_scene_path = {};
+		std::filesystem::path m_camera_path = {};
+		std::optional<std::filesystem::path> m_csv_path = {};
+		int m_width = 1920;
+		int m_height = 1080;
+
+		// frames rendered along the start of the path before measuring (caches, driver shader compiles, pools)
+		int m_warmup_frames = 60;
+
+		float m_fixed_delta_time = libgraphics::constants::CameraReplayDeltaTime;
+
+		libgraphics::GraphicsAPI m_graphics_api = libgraphics::GraphicsAPI::opengl_headless;
+	};
+
+	/**
+	 * \brief --replay <scene> <camera path> [--size WxH] [--warmup N] [--dt seconds] [--csv frames.csv] [--software]
+	 * Camera paths are recorded with --record <camera path> [scene] (interactive, written on exit).
+	 */
+	auto ParseCameraReplayOptions(const int argc, char** argv) -> std::optional<CameraReplayOptions>;
+
+	/**
+	 * \brief Renders the scene offscreen along the camera path with a fixed time step and prints the CPU and GPU
+	 * frame time distributions (GPU times come from the profiler, none on the software backend).
+	 * \return process exit code
+	 */
+	auto RunCameraReplay(const CameraReplayOptions& options) -> int;
+}
@@ -1,14 +1,169 @@
+#include "asset_pack.h"
+#include "batch_render.h"
+#include "camera_replay.h"
+#include "scene_sweep.h"
+#include "texture_cook.h"
+
 #include <core.h>
 #include <enums.h>
+#include <rendering/frame_writers.h>
+#include <rendering/render_stats.h>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <format>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 int main(int argc, char** argv)
 {
+	// --batch <scene> <poses> <output dir> [...]: renders a list of camera poses offscreen to png files
+	if (argc > 1 && std::string_view{ argv[1] } == "--batch")
+	{
+		const auto options = batch::ParseBatchRenderOptions(argc, argv);
+		return options ? batch::RunBatchRender(options.value(), argv[0]) : 1;
+	}
+
+	// --replay <scene> <camera path> [...]: flies a recorded camera path offscreen and prints the frame time distributions
+	if (argc > 1 && std::string_view{ argv[1] } == "--replay")
+	{
+		const auto options = replay::ParseCameraReplayOptions(argc, argv);
+		return options ? replay::RunCameraReplay(options.value()) : 1;
+	}
+
+	// --sweep <parameter> <v1,v2,...> [...]: renders one generated scene per value and prints frame time against the value
+	if (argc > 1 && std::string_view{ argv[1] } == "--sweep")
+	{
+		const auto options = sweep::ParseSceneSweepOptions(argc, argv);
+		return options ? sweep::RunSceneSweep(options.value()) : 1;
+	}
+
+	// --cook <image or directory> [...]: writes the block compressed .ktx2 the texture loads pick up instead of the images
+	if (argc > 1 && std::string_view{ argv[1] } == "--cook")
+	{
+		const auto options = cook::ParseTextureCookOptions(argc, argv);
+		return options ? cook::RunTextureCook(options.value()) : 1;
+	}
+
+	// --pack <archive> [...]: packs the engine assets in one archive, read instead of the loose files once mounted
+	if (argc > 1 && std::string_view{ argv[1] } == "--pack")
+	{
+		const auto options = pack::ParseAssetPackOptions(argc, argv);
+		return options ? pack::RunAssetPack(options.value()) : 1;
+	}
+
 	auto& core = libgraphics::Core::GetInstance();
+
+	// --headless [frames] [capture] [--scene s]: offscreen rendering without window, prints the throughput (CI/benchmarks)
+	// --software [frames] [capture] [--scene s]: same on the CPU rasterizer, for machines without any GL driver
+	// capture is a .y4m or .rgba stream, anything else is a directory receiving one png per frame
+	// the scene is a model file or a scene generator spec ("generated:entities=10000,points=64,...")
+	if (argc > 1 && (std::string_view{ argv[1] } == "--headless" || std::string_view{ argv[1] } == "--software"))
+	{
+		auto positional_args = std::vector<std::string_view>{};
+		auto scene = std::optional<std::string_view>{};
+		for (auto arg_idx = 2; arg_idx < argc; ++arg_idx)
+		{
+			if (std::string_view{ argv[arg_idx] } == "--scene" && arg_idx + 1 < argc)
+			{
+				scene = argv[++arg_idx];
+				continue;
+			}
+			positional_args.emplace_back(argv[arg_idx]);
+		}
+
+		auto frames_count = 300;
+		if (!positional_args.empty())
+		{
+			const auto frames_arg = positional_args[0];
+			const auto [parse_end, parse_error] = std::from_chars(frames_arg.data(), frames_arg.data() + frames_arg.size(), frames_count);
+			if (parse_error != std::errc{} || parse_end != frames_arg.data() + frames_arg.size() || frames_count <= 0)
+			{
+				std::cerr << std::format("invalid frames count {}\n", frames_arg);
+				return 1;
+			}
+		}
+
+		if (std::string_view{ argv[1] } == "--software")
+		{
+			core.Init(libgraphics::GraphicsAPI::software, 1920, 1080, "SWContext");
+		}
+		else
+		{
+			core.Init(libgraphics::GraphicsAPI::opengl_headless, 1920, 1080, "GLHeadlessContext");
+		}
+
+		if (scene)
+		{
+			core.LoadScene(scene.value());
+		}
+
+		auto stream_writer = std::unique_ptr<libgraphics::FrameStreamWriter>{};
+		auto png_encoder = std::unique_ptr<libgraphics::PNGFrameEncoder>{};
+
+		if (positional_args.size() > 1)
+		{
+			const auto capture_path = std::filesystem::path{ positional_args[1] };
+
+			if (capture_path.extension() == ".y4m" || capture_path.extension() == ".rgba")
+			{
+				const auto format = capture_path.extension() == ".y4m" ? libgraphics::FrameStreamFormat::y4m : libgraphics::FrameStreamFormat::rgba;
+				stream_writer = std::make_unique<libgraphics::FrameStreamWriter>(capture_path, format);
+				core.BeginCapture([&](const libgraphics::CapturedFrame& frame) { stream_writer->Write(frame); });
+			}
+			else
+			{
+				png_encoder = std::make_unique<libgraphics::PNGFrameEncoder>(capture_path);
+				core.BeginCapture([&](const libgraphics::CapturedFrame& frame) { png_encoder->Encode(frame); });
+			}
+		}
+
+		const auto start_time = std::chrono::steady_clock::now();
+		for (auto frame_idx = 0; frame_idx != frames_count; ++frame_idx)
+		{
+			core.RenderFrame({});
+		}
+		const auto elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+		std::cout << std::format("{} frames in {:.3f} s ({:.1f} fps)\n", frames_count, elapsed_seconds, frames_count / elapsed_seconds);
+
+		const auto& render_stats = libgraphics::RenderStats::GetInstance();
+		const auto [min_ms, avg_ms, max_ms, p99_ms] = render_stats.GetFrameTimeSummary();
+		const auto& last_frame = render_stats.GetLastFrame();
+		std::cout << std::format("frame ms min {:.3f} | avg {:.3f} | max {:.3f} | p99 {:.3f}\n", min_ms, avg_ms, max_ms, p99_ms);
+		std::cout << std::format("{} draws, {} triangles, {} visible / {} culled objects\n", last_frame.m_draw_calls, last_frame.m_triangles, last_frame.m_visible_objects, last_frame.m_culled_objects);
+
+		// delivers the frames still in flight before the writers go away
+		core.Shutdown();
+		return 0;
+	}
+
 	core.Init(libgraphics::GraphicsAPI::opengl, 1920, 1080, "GLContext");
 
-	core.Update([&](const double delta_time) {
+	// --record <camera path> [scene]: records the fly-through for --replay, the file is written when the window closes
+	if (argc > 2 && std::string_view{ argv[1] } == "--record")
+	{
+		if (argc > 3)
+		{
+			core.LoadScene(argv[3]);
+		}
+		core.BeginCameraRecording(argv[2]);
+	}
+
+	// --open <model>: adds the model to the default scene once loaded, the window stays responsive meanwhile
+	if (argc > 2 && std::string_view{ argv[1] } == "--open")
+	{
+		core.LoadModelAsync(argv[2]);
+	}
+
+	// keeps the scene at 60 fps on slower GPUs by lowering its resolution, the ui stays sharp
+	core.SetDynamicResolution(true);
+
+	core.Update([&](const double) {
 	});
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,121 @@
+#include "frame_timings.h"
+
+#include <core.h>
+#include <render_profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numeric>
+
+namespace timings
+{
+	using Clock = std::chrono::steady_clock;
+
+	// GPU zones of a frame reach the profiler two frames after it
+	constexpr auto GpuLatencyFrames = 2;
+
+	auto MeasuredFrames::GetGpuSamples() const -> std::vector<double>
+	{
+		auto samples = std::vector<double>{};
+		for (const auto& gpu_time_ms : m_gpu_times_ms)
+		{
+			if (gpu_time_ms)
+			{
+				samples.push_back(gpu_time_ms.value());
+			}
+		}
+
+		return samples;
+	}
+
+	auto ComputeDistribution(std::vector<double> times_ms) -> std::optional<TimeDistribution>
+	{
+		if (times_ms.empty())
+		{
+			return std::nullopt;
+		}
+
+		std::ranges::sort(times_ms);
+
+		const auto percentile = [&times_ms](const double fraction) {
+			const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(times_ms.size())));
+			return times_ms[std::clamp(rank, size_t{ 1 }, times_ms.size()) - 1];
+		};
+
+		auto distribution = TimeDistribution{};
+		distribution.m_min_ms = times_ms.front();
+		distribution.m_average_ms = std::accumulate(times_ms.begin(), times_ms.end(), 0.0) / static_cast<double>(times_ms.size());
+		distribution.m_p50_ms = percentile(0.5);
+		distribution.m_p90_ms = percentile(0.9);
+		distribution.m_p99_ms = percentile(0.99);
+		distribution.m_max_ms = times_ms.back();
+		distribution.m_samples_count = times_ms.size();
+		return distribution;
+	}
+
+	auto PrintDistribution(const std::string_view label, const std::optional<TimeDistribution>& distribution) -> void
+	{
+		if (!distribution)
+		{
+			std::cout << std::format("  {:<4} no samples\n", label);
+			return;
+		}
+
+		std::cout << std::format("  {:<4} min {:7.3f} | avg {:7.3f} | p50 {:7.3f} | p90 {:7.3f} | p99 {:7.3f} | max {:7.3f} ms ({} frames)\n", label,
+			distribution->m_min_ms, distribution->m_average_ms, distribution->m_p50_ms, distribution->m_p90_ms, distribution->m_p99_ms, distribution->m_max_ms,
+			distribution->m_samples_count);
+	}
+
+	auto MeasureFrames(libgraphics::Core& core, const size_t frames_count) -> MeasuredFrames
+	{
+		const auto& profiler = libgraphics::utils::profiling::RenderProfiler::GetInstance();
+
+		auto measured_frames = MeasuredFrames{};
+		measured_frames.m_cpu_times_ms.resize(frames_count);
+		measured_frames.m_gpu_times_ms.resize(frames_count);
+
+		auto first_profiled_frame = uint64_t{};
+		const auto collect_gpu_times = [&] {
+			// only the newest frames can have received their GPU zones since the last call
+			const auto& frames = profiler.GetFrames();
+			for (auto it = frames.rbegin(); it != frames.rend() && it - frames.rbegin() <= GpuLatencyFrames + 1; ++it)
+			{
+				if (it->m_frame_index < first_profiled_frame || it->m_frame_index - first_profiled_frame >= frames_count || it->m_gpu_zones.empty())
+				{
+					continue;
+				}
+
+				auto gpu_ns = int64_t{ 0 };
+				for (const auto& zone : it->m_gpu_zones)
+				{
+					gpu_ns += zone.m_depth == 0 ? zone.m_end_ns - zone.m_start_ns : 0;
+				}
+				measured_frames.m_gpu_times_ms[it->m_frame_index - first_profiled_frame] = static_cast<double>(gpu_ns) * 1e-6;
+			}
+		};
+
+		for (auto frame_idx = size_t{ 0 }; frame_idx != frames_count; ++frame_idx)
+		{
+			const auto frame_start_time = Clock::now();
+			core.RenderFrame({});
+			measured_frames.m_cpu_times_ms[frame_idx] = std::chrono::duration<double, std::milli>(Clock::now() - frame_start_time).count();
+
+			if (frame_idx == 0)
+			{
+				first_profiled_frame = profiler.GetCurrentFrameIndex();
+			}
+			collect_gpu_times();
+		}
+
+		for (auto frame_idx = 0; frame_idx != GpuLatencyFrames + 1; ++frame_idx)
+		{
+			core.RenderFrame({});
+			collect_gpu_times();
+		}
+
+		return measured_frames;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace libgraphics
+{
+	class Core;
+}
+
+namespace timings
+{
+	struct TimeDistribution
+	{
+		double m_min_ms = {};
+		double m_average_ms = {};
+		double m_p50_ms = {};
+		double m_p90_ms = {};
+		double m_p99_ms = {};
+		double m_max_ms = {};
+		size_t m_samples_count = {};
+	};
+
+	struct MeasuredFrames
+	{
+		std::vector<double> m_cpu_times_ms = {};
+
+		// empty for the frames whose GPU zones never came back (always on the software backend)
+		std::vector<std::optional<double>> m_gpu_times_ms = {};
+
+		[[nodiscard]] auto GetGpuSamples() const -> std::vector<double>;
+	};
+
+	/**
+	 * \return nothing when there are no samples
+	 */
+	auto ComputeDistribution(std::vector<double> times_ms) -> std::optional<TimeDistribution>;
+
+	auto PrintDistribution(const std::string_view label, const std::optional<TimeDistribution>& distribution) -> void;
+
+	/**
+	 * \brief Renders frames_count measured frames, then a few more so the GPU times of the last ones come back.
+	 * The profiler must be enabled for GPU times. CPU times are the wall time of Core::RenderFrame.
+	 */
+	auto MeasureFrames(libgraphics::Core& core, const size_t frames_count) -> MeasuredFrames;
+}
@@ -0,0 +1,187 @@
+#include "scene_sweep.h"
+#include "frame_timings.h"
+
+#include <core.h>
+#include <render_profiler.h>
+#include <rendering/render_stats.h>
+#include <rendering/scene_generator.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+namespace sweep
+{
+	// a step is a cliff when the frame time grows this much more than the swept value
+	constexpr auto CliffTolerance = 1.25;
+
+	auto ParseSceneSweepOptions(const int argc, char** argv) -> std::optional<SceneSweepOptions>
+	{
+		// argv[1] is --sweep
+		if (argc < 4)
+		{
+			std::cerr << "usage: --sweep <parameter> <v1,v2,...> [--scene generated:...] [--frames N] [--warmup N] [--size WxH] [--csv sweep.csv] [--software]\n";
+			return std::nullopt;
+		}
+
+		auto options = SceneSweepOptions{};
+		options.m_parameter = argv[2];
+
+		auto values = std::string_view{ argv[3] };
+		while (!values.empty())
+		{
+			const auto separator = values.find(',');
+			options.m_values.emplace_back(values.substr(0, separator));
+			values = separator == std::string_view::npos ? std::string_view{} : values.substr(separator + 1);
+		}
+
+		try
+		{
+			for (auto arg_idx = 4; arg_idx < argc; ++arg_idx)
+			{
+				const auto argument = std::string_view{ argv[arg_idx] };
+				const auto has_value = arg_idx + 1 < argc;
+
+				if (argument == "--software")
+				{
+					options.m_graphics_api = libgraphics::GraphicsAPI::software;
+				}
+				else if (argument == "--scene" && has_value)
+				{
+					options.m_base_spec = argv[++arg_idx];
+				}
+				else if (argument == "--size" && has_value)
+				{
+					const auto value = std::string{ argv[++arg_idx] };
+					const auto separator = value.find('x');
+					options.m_width = std::stoi(value.substr(0, separator));
+					options.m_height = std::stoi(value.substr(separator + 1));
+				}
+				else if (argument == "--frames" && has_value)
+				{
+					options.m_frames_count = std::stoi(argv[++arg_idx]);
+				}
+				else if (argument == "--warmup" && has_value)
+				{
+					options.m_warmup_frames = std::max(0, std::stoi(argv[++arg_idx]));
+				}
+				else if (argument == "--csv" && has_value)
+				{
+					options.m_csv_path = argv[++arg_idx];
+				}
+				else
+				{
+					std::cerr << "unknown sweep option " << argument << "\n";
+					return std::nullopt;
+				}
+			}
+		}
+		catch (const std::exception&)
+		{
+			std::cerr << "malformed sweep option value\n";
+			return std::nullopt;
+		}
+
+		if (options.m_values.empty() || options.m_width <= 0 || options.m_height <= 0 || options.m_frames_count <= 0)
+		{
+			std::cerr << "invalid values, size or frames count\n";
+			return std::nullopt;
+		}
+
+		if (!options.m_base_spec.starts_with(libgraphics::SceneGeneratorSpecPrefix))
+		{
+			std::cerr << "--scene takes a scene generator spec (" << libgraphics::SceneGeneratorSpecPrefix << "key=value,...)\n";
+			return std::nullopt;
+		}
+
+		return options;
+	}
+
+	auto RunSceneSweep(const SceneSweepOptions& options) -> int
+	{
+		auto& core = libgraphics::Core::GetInstance();
+
+		// the core first, it initializes the logger the spec parser reports to
+		core.Init(options.m_graphics_api, options.m_width, options.m_height, "SceneSweep");
+		libgraphics::utils::profiling::RenderProfiler::GetInstance().SetEnabled(true);
+
+		auto csv_file = std::ofstream{};
+		if (options.m_csv_path)
+		{
+			csv_file.open(options.m_csv_path.value());
+			if (!csv_file.is_open())
+			{
+				std::cerr << "unable to write " << options.m_csv_path.value() << "\n";
+				core.Shutdown();
+				return 1;
+			}
+			csv_file << "parameter,value,cpu_avg_ms,cpu_p50_ms,cpu_p99_ms,gpu_avg_ms,gpu_p50_ms,gpu_p99_ms,draw_calls,triangles,visible_objects,culled_objects\n";
+		}
+
+		const auto separator = options.m_base_spec.ends_with(':') || options.m_base_spec.ends_with(',') ? "" : ",";
+
+		std::cout << std::format("{:>10} | {:>9} {:>9} | {:>9} {:>9} | {:>7} {:>10} {:>8}\n", options.m_parameter, "cpu p50", "cpu p99", "gpu p50", "gpu p99", "draws", "triangles", "culled");
+
+		auto previous_value = 0.0;
+		auto previous_cpu_ms = 0.0;
+		auto previous_gpu_ms = 0.0;
+
+		for (const auto& value : options.m_values)
+		{
+			const auto spec = std::format("{}{}{}={}", options.m_base_spec, separator, options.m_parameter, value);
+			const auto params = libgraphics::ParseSceneGeneratorSpec(spec);
+			if (!params)
+			{
+				std::cerr << "invalid scene spec " << spec << "\n";
+				core.Shutdown();
+				return 1;
+			}
+
+			core.LoadScene(params.value());
+
+			for (auto frame_idx = 0; frame_idx != options.m_warmup_frames; ++frame_idx)
+			{
+				core.RenderFrame({});
+			}
+
+			const auto measured_frames = timings::MeasureFrames(core, static_cast<size_t>(options.m_frames_count));
+			const auto cpu = timings::ComputeDistribution(measured_frames.m_cpu_times_ms).value();
+			const auto gpu = timings::ComputeDistribution(measured_frames.GetGpuSamples()).value_or(timings::TimeDistribution{});
+			const auto& frame_stats = libgraphics::RenderStats::GetInstance().GetLastFrame();
+
+			// super linear growth against the previous point, only meaningful for growing numeric values
+			auto is_cliff = false;
+			try
+			{
+				const auto numeric_value = std::stod(value);
+				if (previous_value > 0.0 && numeric_value > previous_value)
+				{
+					const auto value_ratio = numeric_value / previous_value;
+					is_cliff = (previous_cpu_ms > 0.0 && cpu.m_p50_ms / previous_cpu_ms > value_ratio * CliffTolerance) ||
+						(previous_gpu_ms > 0.0 && gpu.m_p50_ms / previous_gpu_ms > value_ratio * CliffTolerance);
+				}
+				previous_value = numeric_value;
+			}
+			catch (const std::exception&)
+			{
+				previous_value = 0.0;
+			}
+			previous_cpu_ms = cpu.m_p50_ms;
+			previous_gpu_ms = gpu.m_p50_ms;
+
+			std::cout << std::format("{:>10} | {:9.3f} {:9.3f} | {:9.3f} {:9.3f} | {:>7} {:>10} {:>8}{}\n", value, cpu.m_p50_ms, cpu.m_p99_ms, gpu.m_p50_ms, gpu.m_p99_ms,
+				frame_stats.m_draw_calls, frame_stats.m_triangles, frame_stats.m_culled_objects, is_cliff ? "  <- cliff" : "");
+
+			if (csv_file.is_open())
+			{
+				csv_file << std::format("{},{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{},{},{},{}\n", options.m_parameter, value, cpu.m_average_ms, cpu.m_p50_ms, cpu.m_p99_ms,
+					gpu.m_average_ms, gpu.m_p50_ms, gpu.m_p99_ms, frame_stats.m_draw_calls, frame_stats.m_triangles, frame_stats.m_visible_objects, frame_stats.m_culled_objects);
+			}
+		}
+
+		core.Shutdown();
+		return 0;
+	}
+}
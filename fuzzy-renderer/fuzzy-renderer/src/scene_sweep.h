@@ -0,0 +1,42 @@
+#pragma once
+
+#include <enums.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sweep
+{
+	struct SceneSweepOptions
+	{
+		// scene generator key swept (entities, points, depth...) and the values it takes, one scene each
+		std::string m_parameter = {};
+		std::vector<std::string> m_values = {};
+
+		// generator spec every point starts from, the swept key is appended to it
+		std::string m_base_spec = "generated:";
+
+		std::optional<std::filesystem::path> m_csv_path = {};
+		int m_width = 1920;
+		int m_height = 1080;
+		int m_warmup_frames = 30;
+		int m_frames_count = 120;
+
+		libgraphics::GraphicsAPI m_graphics_api = libgraphics::GraphicsAPI::opengl_headless;
+	};
+
+	/**
+	 * \brief --sweep <parameter> <v1,v2,...> [--scene generated:...] [--frames N] [--warmup N] [--size WxH] [--csv sweep.csv] [--software]
+	 * e.g. --sweep entities 1000,2000,4000,8000 --scene generated:meshes=16,points=32
+	 */
+	auto ParseSceneSweepOptions(const int argc, char** argv) -> std::optional<SceneSweepOptions>;
+
+	/**
+	 * \brief Generates and renders one scene per value from the default camera, prints a row of CPU/GPU frame times
+	 * per value and flags the steps where the frame time grows faster than the swept value (the cliffs).
+	 * \return process exit code
+	 */
+	auto RunSceneSweep(const SceneSweepOptions& options) -> int;
+}
@@ -0,0 +1,133 @@
+#include "texture_cook.h"
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cook
+{
+	auto IsImageFile(const std::filesystem::path& path) -> bool
+	{
+		auto extension = path.extension().string();
+		std::ranges::transform(extension, extension.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+		return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga";
+	}
+
+	auto ParseTextureCookOptions(const int argc, char** argv) -> std::optional<TextureCookOptions>
+	{
+		// argv[1] is --cook
+		if (argc < 3)
+		{
+			std::cerr << "usage: --cook <image or directory> [--output path.ktx2] [--role color|color_alpha|normal|mask]\n";
+			return std::nullopt;
+		}
+
+		auto options = TextureCookOptions{};
+		options.m_input_path = argv[2];
+
+		for (auto arg_idx = 3; arg_idx < argc; ++arg_idx)
+		{
+			const auto argument = std::string_view{ argv[arg_idx] };
+			const auto has_value = arg_idx + 1 < argc;
+
+			if (argument == "--output" && has_value)
+			{
+				options.m_output_path = argv[++arg_idx];
+			}
+			else if (argument == "--role" && has_value)
+			{
+				options.m_role = libgraphics::ParseTextureRole(argv[++arg_idx]);
+				if (!options.m_role)
+				{
+					std::cerr << "unknown texture role " << argv[arg_idx] << "\n";
+					return std::nullopt;
+				}
+			}
+			else
+			{
+				std::cerr << "unknown cook option " << argument << "\n";
+				return std::nullopt;
+			}
+		}
+
+		if (options.m_output_path && std::filesystem::is_directory(options.m_input_path))
+		{
+			std::cerr << "--output takes a single image, directories are cooked in place\n";
+			return std::nullopt;
+		}
+
+		return options;
+	}
+
+	auto RunTextureCook(const TextureCookOptions& options) -> int
+	{
+		auto image_paths = std::vector<std::filesystem::path>{};
+
+		if (std::filesystem::is_directory(options.m_input_path))
+		{
+			for (const auto& entry : std::filesystem::recursive_directory_iterator{ options.m_input_path })
+			{
+				if (entry.is_regular_file() && IsImageFile(entry.path()))
+				{
+					image_paths.push_back(entry.path());
+				}
+			}
+			std::ranges::sort(image_paths);
+		}
+		else
+		{
+			image_paths.push_back(options.m_input_path);
+		}
+
+		auto failures_count = size_t{ 0 };
+		auto source_bytes = uint64_t{ 0 };
+		auto cooked_bytes = uint64_t{ 0 };
+
+		for (const auto& image_path : image_paths)
+		{
+			const auto image = libgraphics::LoadSourceImage(image_path);
+			if (!image)
+			{
+				std::cerr << "unable to decode " << image_path.string() << "\n";
+				failures_count++;
+				continue;
+			}
+
+			const auto role = options.m_role.value_or(libgraphics::GuessTextureRole(image_path, image->m_has_alpha));
+			const auto cooked_texture = libgraphics::CookTexture(image->m_pixels, image->m_width, image->m_height, role);
+			const auto output_path = options.m_output_path.value_or(libgraphics::GetCookedTexturePath(image_path));
+
+			if (!libgraphics::WriteKtx2(output_path, cooked_texture))
+			{
+				std::cerr << "unable to write " << output_path.string() << "\n";
+				failures_count++;
+				continue;
+			}
+
+			// against what the GL texture would take uncompressed, mips included
+			auto image_bytes = uint64_t{ 0 };
+			auto texture_bytes = uint64_t{ 0 };
+			for (const auto& mip : cooked_texture.m_mips)
+			{
+				image_bytes += static_cast<uint64_t>(mip.m_width) * mip.m_height * 4;
+				texture_bytes += mip.m_data.size();
+			}
+			source_bytes += image_bytes;
+			cooked_bytes += texture_bytes;
+
+			std::cout << std::format("{} -> {} ({}x{} {}, {} mips, {} KB -> {} KB, {:.1f}:1)\n", image_path.string(), output_path.filename().string(), image->m_width, image->m_height,
+				libgraphics::TextureRoleToString(role), cooked_texture.m_mips.size(), image_bytes / 1024, texture_bytes / 1024, static_cast<double>(image_bytes) / static_cast<double>(texture_bytes));
+		}
+
+		if (image_paths.size() > 1 && cooked_bytes != 0)
+		{
+			std::cout << std::format("{} texture(s), {} KB -> {} KB ({:.1f}:1)\n", image_paths.size() - failures_count, source_bytes / 1024, cooked_bytes / 1024, static_cast<double>(source_bytes) / static_cast<double>(cooked_bytes));
+		}
+
+		return failures_count == 0 && !image_paths.empty() ? 0 : 1;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <rendering/texture_cooker.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace cook
+{
+	struct TextureCookOptions
+	{
+		// an image, or a directory whose images are all cooked (recursively)
+		std::filesystem::path m_input_path = {};
+
+		// .ktx2 file for a single image, next to the image when not set
+		std::optional<std::filesystem::path> m_output_path = {};
+
+		// guessed from the file name and the alpha channel of each image when not set
+		std::optional<libgraphics::TextureRole> m_role = {};
+	};
+
+	/**
+	 * \brief --cook <image or directory> [--output path.ktx2] [--role color|color_alpha|normal|mask]
+	 */
+	auto ParseTextureCookOptions(const int argc, char** argv) -> std::optional<TextureCookOptions>;
+
+	/**
+	 * \brief Writes the block compressed, mipmapped .ktx2 of every input image, picked up instead of the image by the
+	 * texture loads, and prints the size of each against its RGBA8 mip chain.
+	 * \return process exit code
+	 */
+	auto RunTextureCook(const TextureCookOptions& options) -> int;
+}